@@ -0,0 +1,410 @@
+#include <systemc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <bitset>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "fpu_models.h"
+#include "fpu_pipelines.h"
+
+#define MAX_BLOCK 32
+
+// OpRegister: carries the operation select alongside the block being converted
+SC_MODULE(OpRegister) {
+    sc_in<bool> multiply_in;
+    sc_out<bool> multiply_out;
+    sc_in<bool> clock;
+
+    void latch() {
+        while (true) {
+            wait();
+            multiply_out.write(multiply_in.read());
+        }
+    }
+
+    SC_CTOR(OpRegister) {
+        SC_THREAD(latch);
+        sensitive << clock.pos();
+    }
+};
+
+// Block floating point: one biased exponent per block and a signed mantissa of
+// `bits` bits per element. The largest element's hidden bit lands on bit
+// bits - 2, so element k holds m_k * 2^(exp - 127 - (bits - 2)).
+
+// Shift an extracted significand (hidden bit at bit 30) right by shift and round
+// to nearest even; a round-up past the largest mantissa saturates
+int align_mantissa(bool sign, unsigned int significand, int shift, int bits) {
+    if (shift >= 32) {
+        return 0;
+    }
+    unsigned int m = significand >> shift;
+    unsigned int guard = (significand >> (shift - 1)) & 1;
+    bool sticky = (significand & ((1u << (shift - 1)) - 1)) != 0;
+    if (guard == 1 && (sticky || (m & 1) == 1)) {
+        m += 1;
+    }
+    int limit = (1 << (bits - 1)) - 1;
+    int value = std::min<int>(m, limit);
+    return sign ? -value : value;
+}
+
+// BlockAligner Module
+// Second conversion stage after the adder's extractors: the block exponent is
+// the largest extracted exponent and every significand is aligned to it
+SC_MODULE(BlockAligner) {
+    sc_in<bool> x_sign[MAX_BLOCK];
+    sc_in<sc_uint<8>> x_exp[MAX_BLOCK];
+    sc_in<sc_uint<32>> x_significand[MAX_BLOCK];
+    sc_out<sc_uint<32>> mantissa[MAX_BLOCK];
+    sc_out<sc_uint<8>> block_exp;
+    sc_in<bool> clock;
+    int block;
+    int bits;
+
+    void alignment_process() {
+        while (true) {
+            wait();
+            unsigned int max_exp = 0;
+            for (int k = 0; k < block; k++) {
+                max_exp = std::max<unsigned int>(max_exp, x_exp[k].read());
+            }
+            for (int k = 0; k < block; k++) {
+                int shift = 32 - bits + max_exp - x_exp[k].read();
+                mantissa[k].write(static_cast<uint32_t>(align_mantissa(x_sign[k].read(), x_significand[k].read(), shift, bits)));
+            }
+            block_exp.write(max_exp);
+        }
+    }
+
+    SC_HAS_PROCESS(BlockAligner);
+    BlockAligner(sc_module_name name, int block, int bits)
+        : sc_module(name), block_exp("block_exp"), clock("clock"), block(block), bits(bits) {
+        SC_THREAD(alignment_process);
+        sensitive << clock.pos();
+    }
+};
+
+// BfpEncoder Module: FP32 block in, shared exponent and mantissas out, two stages.
+// Element pairs go through the adder's FloatingPointExtractor. Inputs are finite.
+SC_MODULE(BfpEncoder) {
+    sc_in<sc_uint<32>> x[MAX_BLOCK];
+    sc_out<sc_uint<32>> mantissa[MAX_BLOCK];
+    sc_out<sc_uint<8>> block_exp;
+    sc_in<bool> clock;
+
+    std::vector<addition::FloatingPointExtractor*> extractors;
+    BlockAligner aligner;
+    sc_signal<bool> x_sign[MAX_BLOCK];
+    sc_signal<sc_uint<8>> x_exp[MAX_BLOCK];
+    sc_signal<sc_uint<32>> x_significand[MAX_BLOCK];
+
+    SC_HAS_PROCESS(BfpEncoder);
+    BfpEncoder(sc_module_name name, int block, int bits) : sc_module(name), aligner("Aligner", block, bits) {
+        for (int k = 0; k < block; k += 2) {
+            addition::FloatingPointExtractor* e = new addition::FloatingPointExtractor(("Extractor" + std::to_string(k / 2)).c_str());
+            e->a(x[k]);
+            e->b(x[k + 1]);
+            e->a_sign(x_sign[k]);
+            e->a_exp(x_exp[k]);
+            e->a_significand(x_significand[k]);
+            e->b_sign(x_sign[k + 1]);
+            e->b_exp(x_exp[k + 1]);
+            e->b_significand(x_significand[k + 1]);
+            e->clock(clock);
+            extractors.push_back(e);
+        }
+        for (int k = 0; k < MAX_BLOCK; k++) {
+            aligner.x_sign[k](x_sign[k]);
+            aligner.x_exp[k](x_exp[k]);
+            aligner.x_significand[k](x_significand[k]);
+            aligner.mantissa[k](mantissa[k]);
+        }
+        aligner.block_exp(block_exp);
+        aligner.clock(clock);
+    }
+};
+
+// Integer lane operation on two blocks, producing the normaliser's inputs: a sign,
+// a magnitude whose bit 30 has weight 2^(exp - 127) and one exponent per block.
+// Add aligns the block with the smaller exponent by an arithmetic shift rounding
+// half up; multiply keeps the full 2 * bits - 2 bit product.
+void lane_function(bool multiply, int a_exp, int b_exp, const int* a, const int* b, int block, int bits, bool* sign,
+                   unsigned int* magnitude, unsigned int& exp) {
+    for (int k = 0; k < block; k++) {
+        long long r;
+        if (multiply) {
+            r = static_cast<long long>(a[k]) * b[k];
+            magnitude[k] = static_cast<unsigned int>(llabs(r) << (32 - 2 * bits));
+        } else {
+            int d = abs(a_exp - b_exp);
+            int small = (a_exp >= b_exp) ? b[k] : a[k];
+            int aligned = (d == 0) ? small : (d > bits) ? 0 : ((small + (1 << (d - 1))) >> d);
+            r = static_cast<long long>((a_exp >= b_exp) ? a[k] : b[k]) + aligned;
+            magnitude[k] = static_cast<unsigned int>(llabs(r) << (32 - bits));
+        }
+        sign[k] = r < 0;
+    }
+    // Products of blocks whose exponents leave the 8-bit range are not handled,
+    // as in the multiplier
+    exp = multiply ? a_exp + b_exp - 125 : std::max(a_exp, b_exp);
+}
+
+// BfpLane Module: integer-only add or multiply across the block in one stage
+SC_MODULE(BfpLane) {
+    sc_in<sc_uint<32>> a[MAX_BLOCK];
+    sc_in<sc_uint<32>> b[MAX_BLOCK];
+    sc_in<sc_uint<8>> a_exp;
+    sc_in<sc_uint<8>> b_exp;
+    sc_in<bool> multiply;
+    sc_out<bool> result_sign[MAX_BLOCK];
+    sc_out<sc_uint<32>> result_significand[MAX_BLOCK];
+    sc_out<sc_uint<8>> result_exp;
+    sc_in<bool> clock;
+    int block;
+    int bits;
+
+    void lane_process() {
+        int x[MAX_BLOCK], y[MAX_BLOCK];
+        bool sign[MAX_BLOCK];
+        unsigned int magnitude[MAX_BLOCK], exp;
+        while (true) {
+            wait();
+            for (int k = 0; k < block; k++) {
+                x[k] = static_cast<int>(static_cast<uint32_t>(a[k].read()));
+                y[k] = static_cast<int>(static_cast<uint32_t>(b[k].read()));
+            }
+            lane_function(multiply.read(), a_exp.read(), b_exp.read(), x, y, block, bits, sign, magnitude, exp);
+            for (int k = 0; k < block; k++) {
+                result_sign[k].write(sign[k]);
+                result_significand[k].write(magnitude[k]);
+            }
+            result_exp.write(exp);
+        }
+    }
+
+    SC_HAS_PROCESS(BfpLane);
+    BfpLane(sc_module_name name, int block, int bits)
+        : sc_module(name), a_exp("a_exp"), b_exp("b_exp"), multiply("multiply"), result_exp("result_exp"), clock("clock"),
+          block(block), bits(bits) {
+        SC_THREAD(lane_process);
+        sensitive << clock.pos();
+    }
+};
+
+// Top-level Module
+// BfpEncoder (x2) -> BfpLane -> one adder FloatingPointNormaliser per element,
+// which repacks and rounds each result to FP32. One block per 1 ns cycle,
+// four stages.
+SC_MODULE(Top) {
+    BfpEncoder encoder_a, encoder_b;
+    OpRegister extract_op_register, align_op_register;
+    BfpLane lane;
+    std::vector<addition::FloatingPointNormaliser*> normalisers;
+    sc_signal<sc_uint<32>> a[MAX_BLOCK], b[MAX_BLOCK];
+    sc_signal<bool> multiply[3];
+    sc_signal<sc_uint<32>> a_mantissa[MAX_BLOCK], b_mantissa[MAX_BLOCK];
+    sc_signal<sc_uint<8>> a_exp, b_exp, result_exp;
+    sc_signal<bool> result_sign[MAX_BLOCK];
+    sc_signal<sc_uint<32>> result_significand[MAX_BLOCK];
+    sc_signal<sc_uint<32>> result[MAX_BLOCK];
+    sc_clock clock;
+
+    SC_HAS_PROCESS(Top);
+    Top(sc_module_name name, int block, int bits)
+        : sc_module(name),
+          encoder_a("EncoderA", block, bits),
+          encoder_b("EncoderB", block, bits),
+          extract_op_register("ExtractOpRegister"),
+          align_op_register("AlignOpRegister"),
+          lane("Lane", block, bits),
+          clock("clock", 1, SC_NS) {
+        for (int k = 0; k < MAX_BLOCK; k++) {
+            encoder_a.x[k](a[k]);
+            encoder_a.mantissa[k](a_mantissa[k]);
+            encoder_b.x[k](b[k]);
+            encoder_b.mantissa[k](b_mantissa[k]);
+            lane.a[k](a_mantissa[k]);
+            lane.b[k](b_mantissa[k]);
+            lane.result_sign[k](result_sign[k]);
+            lane.result_significand[k](result_significand[k]);
+        }
+        encoder_a.block_exp(a_exp);
+        encoder_a.clock(clock);
+        encoder_b.block_exp(b_exp);
+        encoder_b.clock(clock);
+
+        extract_op_register.multiply_in(multiply[0]);
+        extract_op_register.multiply_out(multiply[1]);
+        extract_op_register.clock(clock);
+        align_op_register.multiply_in(multiply[1]);
+        align_op_register.multiply_out(multiply[2]);
+        align_op_register.clock(clock);
+
+        lane.a_exp(a_exp);
+        lane.b_exp(b_exp);
+        lane.multiply(multiply[2]);
+        lane.result_exp(result_exp);
+        lane.clock(clock);
+
+        for (int k = 0; k < block; k++) {
+            addition::FloatingPointNormaliser* n = new addition::FloatingPointNormaliser(("Normaliser" + std::to_string(k)).c_str());
+            n->result_sign(result_sign[k]);
+            n->result_exp(result_exp);
+            n->result_significand(result_significand[k]);
+            n->nresult(result[k]);
+            n->clock(clock);
+            normalisers.push_back(n);
+        }
+    }
+};
+
+// Result delay in cycles: stages - 1
+const int bfp_delay = 3;
+
+// Functional model of a whole block: encode both operands, run the lane, repack
+void bfp_function(const uint32_t* a, const uint32_t* b, bool multiply, int block, int bits, uint32_t* result) {
+    int mantissas[2][MAX_BLOCK], exps[2];
+    const uint32_t* operands[2] = {a, b};
+    for (int o = 0; o < 2; o++) {
+        unsigned int max_exp = 0, exp[MAX_BLOCK];
+        for (int k = 0; k < block; k++) {
+            unsigned int exp0 = (operands[o][k] & 0x7F800000) >> 23;
+            exp[k] = (exp0 == 0) ? 1 : exp0;
+            max_exp = std::max(max_exp, exp[k]);
+        }
+        for (int k = 0; k < block; k++) {
+            unsigned int exp0 = (operands[o][k] & 0x7F800000) >> 23, fraction = operands[o][k] & 0x7FFFFF;
+            unsigned int significand = ((exp0 >= 1) ? (fraction | (1 << 23)) : fraction) << 7;
+            mantissas[o][k] = align_mantissa(operands[o][k] >> 31, significand, 32 - bits + max_exp - exp[k], bits);
+        }
+        exps[o] = max_exp;
+    }
+    bool sign[MAX_BLOCK];
+    unsigned int magnitude[MAX_BLOCK], exp;
+    lane_function(multiply, exps[0], exps[1], mantissas[0], mantissas[1], block, bits, sign, magnitude, exp);
+    for (int k = 0; k < block; k++) {
+        result[k] = normaliser_function(sign[k], exp, magnitude[k]);
+    }
+}
+
+float bits_float(uint32_t bits) {
+    float value;
+    memcpy(&value, &bits, 4);
+    return value;
+}
+
+uint32_t float_bits(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, 4);
+    return bits;
+}
+
+// Errors are measured against the largest exact magnitude in the block, the scale
+// block floating point keeps its precision at
+struct ErrorStats {
+    double max_relative;
+    double error_sq;
+    double exact_sq;
+};
+
+void accumulate(ErrorStats& s, uint32_t result, double exact, double block_scale) {
+    double error = bits_float(result) - exact;
+    s.max_relative = std::max(s.max_relative, fabs(error) / block_scale);
+    s.error_sq += error * error;
+    s.exact_sq += exact * exact;
+}
+
+double snr_db(const ErrorStats& s) {
+    return (s.error_sq == 0) ? INFINITY : 10 * log10(s.exact_sq / s.error_sq);
+}
+
+int sc_main(int argc, char* argv[]) {
+    int block, bits;
+    long blocks;
+    cout << "Enter the block size (16 to 32, even): ";
+    cin >> block;
+    cout << "Enter the mantissa bits (8 to 16): ";
+    cin >> bits;
+    cout << "Enter the number of blocks: ";
+    cin >> blocks;
+    if (!cin || block < 16 || block > MAX_BLOCK || block % 2 != 0 || bits < 8 || bits > 16 || blocks <= 0) {
+        cout << "Invalid input" << endl;
+        return 1;
+    }
+    Top top("Top", block, bits);
+
+    // Each block has its own scale and spreads over 2^-4 to 2^4 around it, with
+    // mixed signs; blocks alternate randomly between add and multiply
+    srand(1);
+    std::vector<uint32_t> a(blocks * block), b(blocks * block), result(blocks * block);
+    std::vector<char> multiply(blocks);
+    for (long j = 0; j < blocks; j++) {
+        int scale_a = rand() % 17 - 8, scale_b = rand() % 17 - 8;
+        multiply[j] = rand() % 2;
+        for (int k = 0; k < block; k++) {
+            float x = ldexpf(static_cast<float>(rand()) / RAND_MAX + 0.5f, scale_a + rand() % 9 - 4);
+            float y = ldexpf(static_cast<float>(rand()) / RAND_MAX + 0.5f, scale_b + rand() % 9 - 4);
+            a[j * block + k] = float_bits((rand() & 1) ? -x : x);
+            b[j * block + k] = float_bits((rand() & 1) ? -y : y);
+        }
+    }
+
+    long cycle = 0;
+    for (long done = 0; done < blocks; cycle++) {
+        if (cycle < blocks) {
+            for (int k = 0; k < block; k++) {
+                top.a[k].write(a[cycle * block + k]);
+                top.b[k].write(b[cycle * block + k]);
+            }
+            top.multiply[0].write(multiply[cycle]);
+        }
+        sc_start(1, SC_NS);
+        if (cycle >= bfp_delay) {
+            for (int k = 0; k < block; k++) {
+                result[done * block + k] = top.result[k].read();
+            }
+            done++;
+        }
+    }
+
+    // Same streams: the functional model of the block path, and per-element FP32
+    // through the adder and multiplier models, both against double precision
+    ErrorStats bfp[2] = {}, fp32[2] = {};
+    long mismatches = 0, counts[2] = {0, 0};
+    for (long j = 0; j < blocks; j++) {
+        uint32_t model[MAX_BLOCK];
+        bfp_function(&a[j * block], &b[j * block], multiply[j], block, bits, model);
+        int op = multiply[j];
+        counts[op] += block;
+        double exact[MAX_BLOCK], block_scale = 0;
+        for (int k = 0; k < block; k++) {
+            double x = bits_float(a[j * block + k]), y = bits_float(b[j * block + k]);
+            exact[k] = op ? x * y : x + y;
+            block_scale = std::max(block_scale, fabs(exact[k]));
+        }
+        for (int k = 0; k < block; k++) {
+            long i = j * block + k;
+            mismatches += (result[i] != model[k]);
+            accumulate(bfp[op], result[i], exact[k], block_scale);
+            accumulate(fp32[op], op ? multiplication_function(a[i], b[i]) : addition_function(a[i], b[i]), exact[k], block_scale);
+        }
+    }
+
+    double bfp_bits = bits + 8.0 / block;
+    cout << blocks << " blocks of " << block << " elements, " << bits << "-bit mantissas + 1 exponent byte per block ("
+         << bfp_bits << " bits/element vs 32)" << endl;
+    cout << "Block path: " << cycle << " cycles, " << static_cast<double>(blocks * block) / cycle << " elements/cycle, "
+         << bfp_delay + 1 << " stages (extract, align, integer lane, normalise)" << endl;
+    cout << "Bandwidth-bound operand streams carry " << 32 / bfp_bits << "x the elements per byte of FP32" << endl;
+    const char* names[2] = {"add", "multiply"};
+    for (int op = 0; op < 2; op++) {
+        printf("%-8s %7ld elements: block FP max error 2^%.1f of block max, SNR %.1f dB; per-element FP32 2^%.1f, SNR %.1f dB\n",
+               names[op], counts[op], log2(bfp[op].max_relative), snr_db(bfp[op]), log2(fp32[op].max_relative), snr_db(fp32[op]));
+    }
+    cout << "Pin-level mismatches vs functional model: " << mismatches << endl;
+    return 0;
+}
@@ -0,0 +1,588 @@
+#include <systemc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <chrono>
+#include "fpu_models.h"
+
+// Adder stages from Addition Final, each clocked through its own clock gate
+namespace addition {
+
+// FloatingPointExtractor Module
+SC_MODULE(FloatingPointExtractor) {
+    sc_in<sc_uint<32>> a;
+    sc_in<sc_uint<32>> b;
+    sc_out<bool> a_sign;
+    sc_out<sc_uint<8>> a_exp;
+    sc_out<sc_uint<32>> a_significand;
+    sc_out<bool> b_sign;
+    sc_out<sc_uint<8>> b_exp;
+    sc_out<sc_uint<32>> b_significand;
+    sc_in<bool> clock;
+
+    void extraction_process() {
+        while (true) {
+            wait();
+            //Extraction
+            bool a_sign0 = (a.read() & 0x80000000) >> 31;
+            unsigned int a_exp0 = (a.read() & 0x7f800000) >> 23;
+            unsigned int a_significand0 = (a.read() & 0x7fffff);
+
+            bool b_sign0 = (b.read() & 0x80000000) >> 31;
+            unsigned int b_exp0 = (b.read() & 0x7f800000) >> 23;
+            unsigned int b_significand0 = (b.read() & 0x7fffff);
+
+            unsigned int a_significand1 = (a_exp0 >= 1) ? (a_significand0 | (1 << 23)) : a_significand0;
+            unsigned int b_significand1 = (b_exp0 >= 1) ? (b_significand0 | (1 << 23)) : b_significand0;
+
+            unsigned int a_significand2 = (a_significand1 << 7);
+            unsigned int b_significand2 = (b_significand1 << 7);
+
+            unsigned int a_exp1 = ((a_exp0 == 0) ? 1 : a_exp0);
+            unsigned int b_exp1 = ((b_exp0 == 0) ? 1 : b_exp0);
+            //Special Cases
+            if (a_exp0 == 255 && a_significand0 != 0) {
+                a_sign.write(true);
+                a_exp.write(0x7F);
+                a_significand.write(0x7fffffff);
+                b_sign.write(true);
+                b_exp.write(0x7F);
+                b_significand.write(0x7fffffff);
+            } else if (b_exp0 == 255 && b_significand0 != 0) {
+                a_sign.write(true);
+                a_exp.write(0x7F);
+                a_significand.write(0x7fffffff);
+                b_sign.write(true);
+                b_exp.write(0x7F);
+                b_significand.write(0x7fffffff);
+            } else if (a_exp0 == 255 && a_significand0 == 0 && b_exp0 == 255 && b_significand0 == 0 && a_sign0 != b_sign0) {
+                a_sign.write(true);
+                a_exp.write(0x7F);
+                a_significand.write(0x7fffffff);
+                b_sign.write(true);
+                b_exp.write(0x7F);
+                b_significand.write(0x7fffffff);
+            } else if (a_exp0 == 255 && a_significand0 == 0) {
+                a_sign.write(a_sign0);
+                a_exp.write(a_exp0);
+                a_significand.write(a_significand0);
+                b_sign.write(true);
+                b_exp.write(0x7F);
+                b_significand.write(0x7fffffff);
+            } else if (b_exp0 == 255 && b_significand0 == 0) {
+                a_sign.write(true);
+                a_exp.write(0x7F);
+                a_significand.write(0x7fffffff);
+                b_sign.write(b_sign0);
+                b_exp.write(b_exp0);
+                b_significand.write(b_significand0);
+            } else {
+    
+                a_sign.write(a_sign0);
+                a_exp.write(static_cast<sc_uint<8>>(a_exp1));
+                a_significand.write(a_significand2);
+                b_sign.write(b_sign0);
+                b_exp.write(static_cast<sc_uint<8>>(b_exp1));
+                b_significand.write(b_significand2);
+            }
+        }
+    }
+    //Constructor
+    SC_CTOR(FloatingPointExtractor)
+        : a("a"),
+          b("b"),
+          a_sign("a_sign"),
+          a_exp("a_exp"),
+          a_significand("a_significand"),
+          b_sign("b_sign"),
+          b_exp("b_exp"),
+          b_significand("b_significand"),
+          clock("clock") {
+        SC_THREAD(extraction_process);
+        sensitive << clock.pos();     //Clock signal
+    }
+};
+
+// FloatingPointAdder Module
+SC_MODULE(FloatingPointAdder) {
+    sc_in<bool> a_sign;
+    sc_in<sc_uint<8>> a_exp;
+    sc_in<sc_uint<32>> a_significand;
+    sc_in<bool> b_sign;
+    sc_in<sc_uint<8>> b_exp;
+    sc_in<sc_uint<32>> b_significand;
+    sc_out<bool> result_sign;
+    sc_out<sc_uint<8>> result_exp;
+    sc_out<sc_uint<32>> result_significand;
+    sc_in<bool> clock;
+
+    void addition_process() {
+        while (true) {
+            wait();
+
+            unsigned int ans_exp;
+            unsigned int ans_significand;
+            bool ans_sign;
+            unsigned int a_significand3 = a_significand.read();
+            unsigned int b_significand3 = b_significand.read();
+        //Exponent Shifting
+            if (a_exp.read() >= b_exp.read()) {
+                unsigned int shift = a_exp.read() - b_exp.read();
+                b_significand3 = (b_significand.read() >> ((shift > 31) ? 31 : shift));
+                ans_exp = a_exp.read();
+            } else {
+                unsigned int shift = b_exp.read() - a_exp.read();
+                a_significand3 = (a_significand.read() >> ((shift > 31) ? 31 : shift));
+                ans_exp = b_exp.read();
+            }
+         //Significand shifting and adding
+            if (a_sign.read() == b_sign.read()) {
+                ans_significand = a_significand3 + b_significand3;
+                ans_sign = a_sign.read();
+            } else {
+                if (a_significand3 > b_significand3) {
+                    ans_sign = a_sign.read();
+                    ans_significand = a_significand3 - b_significand3;
+                } else if (a_significand3 < b_significand3) {
+                    ans_sign = b_sign.read();
+                    ans_significand = b_significand3 - a_significand3;
+                } else if (a_significand3 == b_significand3) {
+                    ans_sign = false;
+                    ans_significand = a_significand3 - b_significand3;
+                }
+            }
+
+            result_sign.write(ans_sign);
+            result_exp.write(static_cast<sc_uint<8>>(ans_exp));
+            result_significand.write(ans_significand);
+        }
+    }
+
+    SC_CTOR(FloatingPointAdder)
+        : a_sign("a_sign"),
+          a_exp("a_exp"),
+          a_significand("a_significand"),
+          b_sign("b_sign"),
+          b_exp("b_exp"),
+          b_significand("b_significand"),
+          result_sign("result_sign"),
+          result_exp("result_exp"),
+          result_significand("result_significand"),
+          clock("clock") {
+        SC_THREAD(addition_process);
+        sensitive << clock.pos();
+    }
+};
+
+SC_MODULE(FloatingPointNormaliser) {
+    sc_in<bool> result_sign;
+    sc_in<sc_uint<8>> result_exp;
+    sc_in<sc_uint<32>> result_significand;
+    sc_out<sc_uint<32>> nresult;
+    sc_in<bool> clock;
+    void normal_process() {
+    
+    
+
+        while (true) {
+            wait();
+
+            unsigned int ans_exp = result_exp.read();
+            unsigned int ans_significand = result_significand.read();
+            bool ans_sign = result_sign.read();
+    /* Normalization */
+    int i;
+    for (i=31; i>0 && ((ans_significand>>i) == 0); i-- ){;}
+    
+    if (i>23){
+
+        //Rounding
+        unsigned int twentyfourth = ((ans_significand&(1<<(i-23-1)))>>(i-23-1));
+
+        unsigned int twentyfifth = 0;
+        for(int j=0;j<i-23-1;j++){
+            twentyfifth = twentyfifth | ((ans_significand & (1<<j))>>j);
+        }
+
+        if ((int(ans_exp) + (i-23) - 7) > 0 && (int(ans_exp) + (i-23) - 7) < 255){
+
+            ans_significand = (ans_significand>>(i-23));
+
+            ans_exp = ans_exp + (i-23) - 7;
+
+            if (twentyfourth==1 && twentyfifth == 1){
+        
+                ans_significand += 1;
+
+            }
+            else if ((ans_significand&1)==1 && twentyfourth ==1 && twentyfifth == 0){
+   
+                ans_significand += 1;
+
+            }
+
+            if ((ans_significand>>24)==1){
+                ans_significand = (ans_significand>>1);
+                ans_exp += 1;
+
+            }
+        }
+
+        //Overflow
+        else if (int(ans_exp) + (i-23) - 7 >= 255){
+            ans_significand = (1<<23);
+            ans_exp = 255;
+        }
+}
+    // Cancellation: 23 or fewer significant bits are left, all of them exact;
+    // shift them up to the hidden-bit position
+    else if (i > 0) {
+        int shifted_exp = int(ans_exp) + (i - 23) - 7;
+        ans_significand = ans_significand << (23 - i);
+        if (shifted_exp > 0) {
+            ans_exp = shifted_exp;
+        } else {
+            ans_significand = (1 - shifted_exp > 24) ? 0 : (ans_significand >> (1 - shifted_exp));
+            ans_exp = 0;
+        }
+    }
+
+
+    //When answer is zero
+     if (i==0 && ans_exp < 255){
+        ans_exp = 0;
+    }
+    
+    /* Constructing floating point number from sign, exponent and significand */
+
+    unsigned int ans = (ans_sign<<31) | (ans_exp<<23) | (ans_significand& (0x7FFFFF));
+    nresult.write(ans);
+    }
+}
+
+
+    SC_CTOR(FloatingPointNormaliser) {
+        SC_THREAD(normal_process);
+        sensitive << clock.pos();
+    }
+};
+
+}
+
+enum ClockMode { FREE_RUNNING = 1, IDLE_SKIP = 2, STAGE_GATED = 3 };
+
+// IdleSkipClock Module
+// Replaces the free-running sc_clock of Top. With gating on it stops after the
+// last valid operation leaves the adder stage and waits for the next input, so
+// the kernel jumps straight to that event. Edges stay on the period grid.
+SC_MODULE(IdleSkipClock) {
+    sc_in<bool> in_valid;
+    sc_in<bool> extract_valid;
+    sc_in<bool> add_valid;
+    sc_out<bool> clock;
+    sc_time period;
+    bool gated;
+    long edges;
+
+    void clock_process() {
+        while (true) {
+            if (gated && !(in_valid.read() || extract_valid.read() || add_valid.read())) {
+                wait(in_valid.value_changed_event());
+                long ticks = static_cast<long>(ceil(sc_time_stamp() / period));
+                wait(period * ticks - sc_time_stamp());
+                continue;
+            }
+            clock.write(true);
+            edges++;
+            wait(period / 2);
+            clock.write(false);
+            wait(period / 2);
+        }
+    }
+
+    SC_HAS_PROCESS(IdleSkipClock);
+    IdleSkipClock(sc_module_name name, sc_time period, bool gated)
+        : sc_module(name), in_valid("in_valid"), extract_valid("extract_valid"), add_valid("add_valid"),
+          clock("clock"), period(period), gated(gated), edges(0) {
+        SC_THREAD(clock_process);
+    }
+};
+
+// ClockGate Module
+// Integrated clock gating cell: the enable is latched while the clock is low so
+// the gated clock never glitches. A stage only sees an edge when its input holds
+// valid data, which also isolates its operands. With bypass set every edge passes;
+// edges on invalid data are counted as the evaluations isolation would remove.
+SC_MODULE(ClockGate) {
+    sc_in<bool> clock_in;
+    sc_in<bool> enable;
+    sc_out<bool> clock_out;
+    bool bypass;
+    bool latched;
+    long pulses;
+    long idle_pulses;
+
+    void gate_process() {
+        if (!clock_in.read()) {
+            latched = enable.read();
+        }
+        bool out = clock_in.read() && (latched || bypass);
+        if (out && !clock_out.read()) {
+            pulses++;
+            idle_pulses += !latched;
+        }
+        clock_out.write(out);
+    }
+
+    SC_HAS_PROCESS(ClockGate);
+    ClockGate(sc_module_name name, bool bypass)
+        : sc_module(name), clock_in("clock_in"), enable("enable"), clock_out("clock_out"), bypass(bypass),
+          latched(false), pulses(0), idle_pulses(0) {
+        SC_METHOD(gate_process);
+        sensitive << clock_in << enable;
+    }
+};
+
+// ValidPipeline Module
+// Valid bits travelling alongside the extractor, adder and normaliser stages
+SC_MODULE(ValidPipeline) {
+    sc_in<bool> in_valid;
+    sc_out<bool> extract_valid;
+    sc_out<bool> add_valid;
+    sc_out<bool> result_valid;
+    sc_in<bool> clock;
+
+    void valid_process() {
+        while (true) {
+            wait();
+            result_valid.write(add_valid.read());
+            add_valid.write(extract_valid.read());
+            extract_valid.write(in_valid.read());
+        }
+    }
+
+    SC_CTOR(ValidPipeline) : in_valid("in_valid"), extract_valid("extract_valid"), add_valid("add_valid"),
+                             result_valid("result_valid"), clock("clock") {
+        SC_THREAD(valid_process);
+        sensitive << clock.pos();
+    }
+};
+
+// SparseDriver Module
+// Presents each operand pair half a period before the edge of its arrival cycle
+// and drops in_valid again when the next pair is not due on the following edge
+SC_MODULE(SparseDriver) {
+    sc_out<sc_uint<32>> a;
+    sc_out<sc_uint<32>> b;
+    sc_out<bool> in_valid;
+    std::vector<unsigned int> a_values;
+    std::vector<unsigned int> b_values;
+    std::vector<long> arrival;
+    sc_time period;
+
+    void drive_process() {
+        for (size_t i = 0; i < arrival.size(); i++) {
+            sc_time t = period * arrival[i] - period / 2;
+            if (t > sc_time_stamp()) {
+                wait(t - sc_time_stamp());
+            }
+            a.write(a_values[i]);
+            b.write(b_values[i]);
+            in_valid.write(true);
+            if (i + 1 == arrival.size() || arrival[i + 1] > arrival[i] + 1) {
+                wait(period);
+                in_valid.write(false);
+            }
+        }
+    }
+
+    SC_HAS_PROCESS(SparseDriver);
+    SparseDriver(sc_module_name name, sc_time period)
+        : sc_module(name), a("a"), b("b"), in_valid("in_valid"), period(period) {
+        SC_THREAD(drive_process);
+    }
+};
+
+// ResultMonitor Module
+// Samples the normaliser output on the falling edge after a valid result
+SC_MODULE(ResultMonitor) {
+    sc_in<sc_uint<32>> nresult;
+    sc_in<bool> result_valid;
+    sc_in<bool> clock;
+    std::vector<unsigned int> results;
+
+    void monitor_process() {
+        if (result_valid.read()) {
+            results.push_back(nresult.read());
+        }
+    }
+
+    SC_CTOR(ResultMonitor) : nresult("nresult"), result_valid("result_valid"), clock("clock") {
+        SC_METHOD(monitor_process);
+        sensitive << clock.neg();
+        dont_initialize();
+    }
+};
+
+// Top-level Module
+SC_MODULE(Top) {
+    addition::FloatingPointExtractor extractor;
+    addition::FloatingPointAdder adder;
+    addition::FloatingPointNormaliser normalization;
+    IdleSkipClock root;
+    ClockGate extractor_gate;
+    ClockGate adder_gate;
+    ClockGate normaliser_gate;
+    ValidPipeline valid;
+    SparseDriver driver;
+    ResultMonitor monitor;
+    sc_signal<bool> a_sign;
+    sc_signal<sc_uint<8>> a_exp;
+    sc_signal<sc_uint<32>> a_significands;
+    sc_signal<bool> b_sign;
+    sc_signal<sc_uint<8>> b_exp;
+    sc_signal<sc_uint<32>> b_significands;
+    sc_signal<bool> result_sign;
+    sc_signal<sc_uint<8>> result_exp;
+    sc_signal<sc_uint<32>> result_significand;
+    sc_signal<sc_uint<32>> a;
+    sc_signal<sc_uint<32>> b;
+    sc_signal<sc_uint<32>> normalized_result;
+    sc_signal<bool> in_valid;
+    sc_signal<bool> extract_valid;
+    sc_signal<bool> add_valid;
+    sc_signal<bool> result_valid;
+    sc_signal<bool> clock;
+    sc_signal<bool> extractor_clock;
+    sc_signal<bool> adder_clock;
+    sc_signal<bool> normaliser_clock;
+
+    SC_HAS_PROCESS(Top);
+    Top(sc_module_name name, int mode)
+        : sc_module(name),
+          extractor("Extractor"),
+          adder("Adder"),
+          normalization("Normalization"),
+          root("Clock", sc_time(1, SC_NS), mode != FREE_RUNNING),
+          extractor_gate("ExtractorGate", mode != STAGE_GATED),
+          adder_gate("AdderGate", mode != STAGE_GATED),
+          normaliser_gate("NormaliserGate", mode != STAGE_GATED),
+          valid("Valid"),
+          driver("Driver", sc_time(1, SC_NS)),
+          monitor("Monitor") {
+        root.in_valid(in_valid);
+        root.extract_valid(extract_valid);
+        root.add_valid(add_valid);
+        root.clock(clock);
+
+        extractor_gate.clock_in(clock);
+        extractor_gate.enable(in_valid);
+        extractor_gate.clock_out(extractor_clock);
+        adder_gate.clock_in(clock);
+        adder_gate.enable(extract_valid);
+        adder_gate.clock_out(adder_clock);
+        normaliser_gate.clock_in(clock);
+        normaliser_gate.enable(add_valid);
+        normaliser_gate.clock_out(normaliser_clock);
+
+        valid.in_valid(in_valid);
+        valid.extract_valid(extract_valid);
+        valid.add_valid(add_valid);
+        valid.result_valid(result_valid);
+        valid.clock(clock);
+
+        driver.a(a);
+        driver.b(b);
+        driver.in_valid(in_valid);
+
+        monitor.nresult(normalized_result);
+        monitor.result_valid(result_valid);
+        monitor.clock(clock);
+
+        extractor.a(a);
+        extractor.b(b);
+        extractor.a_sign(a_sign);
+        extractor.a_exp(a_exp);
+        extractor.a_significand(a_significands);
+        extractor.b_sign(b_sign);
+        extractor.b_exp(b_exp);
+        extractor.b_significand(b_significands);
+        extractor.clock(extractor_clock);
+
+        adder.a_sign(a_sign);
+        adder.a_exp(a_exp);
+        adder.a_significand(a_significands);
+        adder.b_sign(b_sign);
+        adder.b_exp(b_exp);
+        adder.b_significand(b_significands);
+        adder.result_sign(result_sign);
+        adder.result_exp(result_exp);
+        adder.result_significand(result_significand);
+        adder.clock(adder_clock);
+
+        normalization.result_sign(result_sign);
+        normalization.result_exp(result_exp);
+        normalization.result_significand(result_significand);
+        normalization.nresult(normalized_result);
+        normalization.clock(normaliser_clock);
+    }
+};
+
+int sc_main(int argc, char* argv[]) {
+    int mode, n, gap;
+    cout << "Enter the clocking mode (1 = free-running, 2 = idle skip, 3 = idle skip + per-stage gating): ";
+    cin >> mode;
+    cout << "Enter the number of operations: ";
+    cin >> n;
+    cout << "Enter the mean gap between operations in cycles: ";
+    cin >> gap;
+    if (mode < FREE_RUNNING || mode > STAGE_GATED || n <= 0 || gap <= 0) {
+        cout << "Invalid input" << endl;
+        return 1;
+    }
+
+    Top top("Top", mode);
+    srand(1);
+    long cycle = 0;
+    for (int i = 0; i < n; i++) {
+        float a_float = ldexpf(static_cast<float>(rand()) / RAND_MAX, rand() % 16 - 8);
+        float b_float = ldexpf(static_cast<float>(rand()) / RAND_MAX, rand() % 16 - 8);
+        unsigned int a_binary, b_binary;
+        memcpy(&a_binary, &a_float, sizeof(a_binary));
+        memcpy(&b_binary, &b_float, sizeof(b_binary));
+        cycle += 1 + rand() % (2 * gap - 1);
+        top.driver.a_values.push_back(a_binary);
+        top.driver.b_values.push_back(b_binary);
+        top.driver.arrival.push_back(cycle);
+    }
+
+    // Three edges drain the last operation; one more lets the monitor sample it
+    long total_cycles = cycle + 4;
+    std::chrono::steady_clock::time_point host_start = std::chrono::steady_clock::now();
+    sc_start(sc_time(total_cycles, SC_NS));
+    double host = std::chrono::duration<double>(std::chrono::steady_clock::now() - host_start).count();
+
+    int mismatches = (static_cast<int>(top.monitor.results.size()) != n);
+    for (size_t i = 0; i < top.monitor.results.size() && static_cast<int>(i) < n; i++) {
+        mismatches += (top.monitor.results[i] != addition_function(top.driver.a_values[i], top.driver.b_values[i]));
+    }
+
+    ClockGate* gates[3] = {&top.extractor_gate, &top.adder_gate, &top.normaliser_gate};
+    const char* stage_names[3] = {"extractor", "adder", "normaliser"};
+    long activations = 0, idle = 0;
+    cout << "Simulated " << sc_time_stamp() << ", " << total_cycles << " cycles, " << top.root.edges << " clock edges, "
+         << sc_delta_count() << " delta cycles, host " << host * 1e3 << " ms" << endl;
+    for (int s = 0; s < 3; s++) {
+        cout << stage_names[s] << ": " << gates[s]->pulses << " activations, " << gates[s]->idle_pulses
+             << " on invalid operands" << endl;
+        activations += gates[s]->pulses;
+        idle += gates[s]->idle_pulses;
+    }
+    long free_running = 3 * total_cycles;
+    cout << "Stage activations: " << activations << " of " << free_running << " free-running ("
+         << free_running - activations << " avoided, " << 100.0 * (free_running - activations) / free_running << "%)" << endl;
+    cout << "Evaluations on invalid operands: " << idle << " (" << 100.0 * idle / free_running
+         << "% of free-running, removed by operand isolation)" << endl;
+    cout << "Results: " << top.monitor.results.size() << ", mismatches vs addition_function: " << mismatches << endl;
+    return 0;
+}
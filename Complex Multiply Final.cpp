@@ -0,0 +1,475 @@
+#include <systemc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <bitset>
+#include <algorithm>
+#include <vector>
+#include "fpu_models.h"
+#include "fpu_pipelines.h"
+
+// MultiplyPipe Module
+// The three multiplier stages on a shared clock. The multiplier has no zero
+// special case, so a zero operand forces the product to +0, as in the
+// systolic array's processing element.
+SC_MODULE(MultiplyPipe) {
+    sc_in<sc_uint<32>> a;
+    sc_in<sc_uint<32>> b;
+    sc_out<sc_uint<32>> result;
+    sc_in<bool> clock;
+
+    multiplication::FloatingPointExtractor extractor;
+    multiplication::FloatingPointMultiplier multiplier;
+    multiplication::FloatingPointNormalizer normalizer;
+    sc_signal<bool> a_sign, b_sign, result_sign;
+    sc_signal<sc_uint<8>> a_exp, b_exp, result_exp;
+    sc_signal<sc_uint<32>> a_significand, b_significand, result_significand, result_significand0;
+    sc_signal<sc_uint<32>> product;
+    sc_signal<bool> zero_flag;
+
+    void zero_process() {
+        bool zero_delay[2] = {false, false};
+        while (true) {
+            wait();
+            zero_flag.write(zero_delay[1]);
+            zero_delay[1] = zero_delay[0];
+            zero_delay[0] = ((a.read() & 0x7FFFFFFF) == 0) || ((b.read() & 0x7FFFFFFF) == 0);
+        }
+    }
+
+    void gate_process() {
+        result.write(zero_flag.read() ? sc_uint<32>(0) : product.read());
+    }
+
+    SC_CTOR(MultiplyPipe)
+        : a("a"), b("b"), result("result"), clock("clock"), extractor("Extractor"), multiplier("Multiplier"),
+          normalizer("Normalizer") {
+        extractor.a(a);
+        extractor.b(b);
+        extractor.a_sign(a_sign);
+        extractor.a_exp(a_exp);
+        extractor.a_significand(a_significand);
+        extractor.b_sign(b_sign);
+        extractor.b_exp(b_exp);
+        extractor.b_significand(b_significand);
+        extractor.clock(clock);
+
+        multiplier.a_sign(a_sign);
+        multiplier.a_exp(a_exp);
+        multiplier.a_significand(a_significand);
+        multiplier.b_sign(b_sign);
+        multiplier.b_exp(b_exp);
+        multiplier.b_significand(b_significand);
+        multiplier.result_sign(result_sign);
+        multiplier.result_exp(result_exp);
+        multiplier.result_significand(result_significand);
+        multiplier.result_significand1(result_significand0);
+        multiplier.clock(clock);
+
+        normalizer.result_sign(result_sign);
+        normalizer.result_exp(result_exp);
+        normalizer.result_significand(result_significand);
+        normalizer.result_significand1(result_significand0);
+        normalizer.normalized_result(product);
+        normalizer.clock(clock);
+
+        SC_THREAD(zero_process);
+        sensitive << clock.pos();
+        SC_METHOD(gate_process);
+        sensitive << product << zero_flag;
+    }
+};
+
+// AddPipe Module: the three adder stages on a shared clock
+SC_MODULE(AddPipe) {
+    sc_in<sc_uint<32>> a;
+    sc_in<sc_uint<32>> b;
+    sc_out<sc_uint<32>> result;
+    sc_in<bool> clock;
+
+    addition::FloatingPointExtractor extractor;
+    addition::FloatingPointAdder adder;
+    addition::FloatingPointNormaliser normaliser;
+    sc_signal<bool> a_sign, b_sign, result_sign;
+    sc_signal<sc_uint<8>> a_exp, b_exp, result_exp;
+    sc_signal<sc_uint<32>> a_significands, b_significands, result_significand;
+
+    SC_CTOR(AddPipe)
+        : a("a"), b("b"), result("result"), clock("clock"), extractor("Extractor"), adder("Adder"), normaliser("Normalization") {
+        extractor.a(a);
+        extractor.b(b);
+        extractor.a_sign(a_sign);
+        extractor.a_exp(a_exp);
+        extractor.a_significand(a_significands);
+        extractor.b_sign(b_sign);
+        extractor.b_exp(b_exp);
+        extractor.b_significand(b_significands);
+        extractor.clock(clock);
+
+        adder.a_sign(a_sign);
+        adder.a_exp(a_exp);
+        adder.a_significand(a_significands);
+        adder.b_sign(b_sign);
+        adder.b_exp(b_exp);
+        adder.b_significand(b_significands);
+        adder.result_sign(result_sign);
+        adder.result_exp(result_exp);
+        adder.result_significand(result_significand);
+        adder.clock(clock);
+
+        normaliser.result_sign(result_sign);
+        normaliser.result_exp(result_exp);
+        normaliser.result_significand(result_significand);
+        normaliser.nresult(result);
+        normaliser.clock(clock);
+    }
+};
+
+// SubPipe Module: the three subtractor stages on a shared clock
+SC_MODULE(SubPipe) {
+    sc_in<sc_uint<32>> a;
+    sc_in<sc_uint<32>> b;
+    sc_out<sc_uint<32>> result;
+    sc_in<bool> clock;
+
+    subtraction::FloatingPointExtractor extractor;
+    subtraction::FloatingPointSubtractor subtractor;
+    subtraction::FloatingPointNormaliser normaliser;
+    sc_signal<bool> a_sign, b_sign, result_sign;
+    sc_signal<sc_uint<8>> a_exp, b_exp, result_exp;
+    sc_signal<sc_uint<32>> a_significands, b_significands, result_significand;
+
+    SC_CTOR(SubPipe)
+        : a("a"), b("b"), result("result"), clock("clock"), extractor("Extractor"), subtractor("Subtractor"),
+          normaliser("Normalization") {
+        extractor.a(a);
+        extractor.b(b);
+        extractor.a_sign(a_sign);
+        extractor.a_exp(a_exp);
+        extractor.a_significand(a_significands);
+        extractor.b_sign(b_sign);
+        extractor.b_exp(b_exp);
+        extractor.b_significand(b_significands);
+        extractor.clock(clock);
+
+        subtractor.a_sign(a_sign);
+        subtractor.a_exp(a_exp);
+        subtractor.a_significand(a_significands);
+        subtractor.b_sign(b_sign);
+        subtractor.b_exp(b_exp);
+        subtractor.b_significand(b_significands);
+        subtractor.result_sign(result_sign);
+        subtractor.result_exp(result_exp);
+        subtractor.result_significand(result_significand);
+        subtractor.clock(clock);
+
+        normaliser.result_sign(result_sign);
+        normaliser.result_exp(result_exp);
+        normaliser.result_significand(result_significand);
+        normaliser.nresult(result);
+        normaliser.clock(clock);
+    }
+};
+
+// DelayLine Module: holds a word for depth clock edges, to keep operands in
+// step with a parallel pipeline. A depth of PIPE_DELAY matches one MultiplyPipe,
+// AddPipe or SubPipe.
+#define PIPE_DELAY 2
+SC_MODULE(DelayLine) {
+    sc_in<sc_uint<32>> data_in;
+    sc_out<sc_uint<32>> data_out;
+    sc_in<bool> clock;
+    int depth;
+
+    void shift_process() {
+        std::vector<unsigned int> data(depth, 0);
+        while (true) {
+            wait();
+            data_out.write(data[depth - 1]);
+            for (int i = depth - 1; i > 0; i--) {
+                data[i] = data[i - 1];
+            }
+            data[0] = data_in.read();
+        }
+    }
+
+    SC_HAS_PROCESS(DelayLine);
+    DelayLine(sc_module_name name, int depth)
+        : sc_module(name), data_in("data_in"), data_out("data_out"), clock("clock"), depth(depth) {
+        SC_THREAD(shift_process);
+        sensitive << clock.pos();
+    }
+};
+
+// ComplexMultiplier4 Module
+// (a + bi)(c + di) = (ac - bd) + (ad + bc)i: four multipliers, then a
+// subtractor and an adder. One complex multiply per cycle, six stages.
+SC_MODULE(ComplexMultiplier4) {
+    sc_in<sc_uint<32>> a, b, c, d;
+    sc_out<sc_uint<32>> re, im;
+    sc_in<bool> clock;
+
+    MultiplyPipe ac_pipe, bd_pipe, ad_pipe, bc_pipe;
+    SubPipe re_pipe;
+    AddPipe im_pipe;
+    sc_signal<sc_uint<32>> ac, bd, ad, bc;
+
+    SC_CTOR(ComplexMultiplier4)
+        : ac_pipe("AC"), bd_pipe("BD"), ad_pipe("AD"), bc_pipe("BC"), re_pipe("Real"), im_pipe("Imaginary") {
+        ac_pipe.a(a);
+        ac_pipe.b(c);
+        ac_pipe.result(ac);
+        ac_pipe.clock(clock);
+        bd_pipe.a(b);
+        bd_pipe.b(d);
+        bd_pipe.result(bd);
+        bd_pipe.clock(clock);
+        ad_pipe.a(a);
+        ad_pipe.b(d);
+        ad_pipe.result(ad);
+        ad_pipe.clock(clock);
+        bc_pipe.a(b);
+        bc_pipe.b(c);
+        bc_pipe.result(bc);
+        bc_pipe.clock(clock);
+
+        re_pipe.a(ac);
+        re_pipe.b(bd);
+        re_pipe.result(re);
+        re_pipe.clock(clock);
+        im_pipe.a(ad);
+        im_pipe.b(bc);
+        im_pipe.result(im);
+        im_pipe.clock(clock);
+    }
+};
+
+// ComplexMultiplierGauss Module
+// Three-multiplier form: k1 = c(a + b), k2 = a(d - c), k3 = b(c + d), then
+// re = k1 - k3 and im = k1 + k2. Pre-adders, multipliers and post-adders
+// are each three stages; a, b and c wait in delay lines while the pre-adders
+// run. One complex multiply per cycle, nine stages.
+SC_MODULE(ComplexMultiplierGauss) {
+    sc_in<sc_uint<32>> a, b, c, d;
+    sc_out<sc_uint<32>> re, im;
+    sc_in<bool> clock;
+
+    AddPipe a_plus_b, c_plus_d;
+    SubPipe d_minus_c;
+    DelayLine a_delay, b_delay, c_delay;
+    MultiplyPipe k1_pipe, k2_pipe, k3_pipe;
+    SubPipe re_pipe;
+    AddPipe im_pipe;
+    sc_signal<sc_uint<32>> sum_ab, sum_cd, diff_dc, a_late, b_late, c_late, k1, k2, k3;
+
+    SC_CTOR(ComplexMultiplierGauss)
+        : a_plus_b("APlusB"), c_plus_d("CPlusD"), d_minus_c("DMinusC"), a_delay("ADelay", PIPE_DELAY),
+          b_delay("BDelay", PIPE_DELAY), c_delay("CDelay", PIPE_DELAY), k1_pipe("K1"), k2_pipe("K2"), k3_pipe("K3"),
+          re_pipe("Real"), im_pipe("Imaginary") {
+        a_plus_b.a(a);
+        a_plus_b.b(b);
+        a_plus_b.result(sum_ab);
+        a_plus_b.clock(clock);
+        c_plus_d.a(c);
+        c_plus_d.b(d);
+        c_plus_d.result(sum_cd);
+        c_plus_d.clock(clock);
+        d_minus_c.a(d);
+        d_minus_c.b(c);
+        d_minus_c.result(diff_dc);
+        d_minus_c.clock(clock);
+        a_delay.data_in(a);
+        a_delay.data_out(a_late);
+        a_delay.clock(clock);
+        b_delay.data_in(b);
+        b_delay.data_out(b_late);
+        b_delay.clock(clock);
+        c_delay.data_in(c);
+        c_delay.data_out(c_late);
+        c_delay.clock(clock);
+
+        k1_pipe.a(c_late);
+        k1_pipe.b(sum_ab);
+        k1_pipe.result(k1);
+        k1_pipe.clock(clock);
+        k2_pipe.a(a_late);
+        k2_pipe.b(diff_dc);
+        k2_pipe.result(k2);
+        k2_pipe.clock(clock);
+        k3_pipe.a(b_late);
+        k3_pipe.b(sum_cd);
+        k3_pipe.result(k3);
+        k3_pipe.clock(clock);
+
+        re_pipe.a(k1);
+        re_pipe.b(k3);
+        re_pipe.result(re);
+        re_pipe.clock(clock);
+        im_pipe.a(k1);
+        im_pipe.b(k2);
+        im_pipe.result(im);
+        im_pipe.clock(clock);
+    }
+};
+
+// Top-level Module: both variants fed from the same operands on a 1 ns clock
+SC_MODULE(Top) {
+    ComplexMultiplier4 four;
+    ComplexMultiplierGauss gauss;
+    sc_signal<sc_uint<32>> a, b, c, d;
+    sc_signal<sc_uint<32>> re4, im4, re3, im3;
+    sc_clock clock;
+
+    SC_CTOR(Top) : four("Four"), gauss("Gauss"), clock("clock", 1, SC_NS) {
+        four.a(a);
+        four.b(b);
+        four.c(c);
+        four.d(d);
+        four.re(re4);
+        four.im(im4);
+        four.clock(clock);
+
+        gauss.a(a);
+        gauss.b(b);
+        gauss.c(c);
+        gauss.d(d);
+        gauss.re(re3);
+        gauss.im(im3);
+        gauss.clock(clock);
+    }
+};
+
+// Result delay of each variant in cycles: stages - 1
+const int four_delay = 2 * PIPE_DELAY + 1;
+const int gauss_delay = 3 * PIPE_DELAY + 2;
+
+uint32_t product_function(uint32_t x, uint32_t y) {
+    return ((x & 0x7FFFFFFF) == 0 || (y & 0x7FFFFFFF) == 0) ? 0 : multiplication_function(x, y);
+}
+
+void complex4_function(uint32_t a, uint32_t b, uint32_t c, uint32_t d, uint32_t& re, uint32_t& im) {
+    re = subtraction_function(product_function(a, c), product_function(b, d));
+    im = addition_function(product_function(a, d), product_function(b, c));
+}
+
+void gauss_function(uint32_t a, uint32_t b, uint32_t c, uint32_t d, uint32_t& re, uint32_t& im) {
+    uint32_t k1 = product_function(c, addition_function(a, b));
+    uint32_t k2 = product_function(a, subtraction_function(d, c));
+    uint32_t k3 = product_function(b, addition_function(c, d));
+    re = subtraction_function(k1, k3);
+    im = addition_function(k1, k2);
+}
+
+float bits_float(uint32_t bits) {
+    float value;
+    memcpy(&value, &bits, 4);
+    return value;
+}
+
+uint32_t float_bits(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, 4);
+    return bits;
+}
+
+long ulp_distance(uint32_t x, uint32_t y) {
+    long a = (x & 0x80000000) ? -static_cast<long>(x & 0x7FFFFFFF) : static_cast<long>(x);
+    long b = (y & 0x80000000) ? -static_cast<long>(y & 0x7FFFFFFF) : static_cast<long>(y);
+    return labs(a - b);
+}
+
+struct ErrorStats {
+    long max_ulp;          // componentwise, against the correctly rounded component
+    double total_ulp;
+    double max_relative;   // normwise: |z - exact| / |exact|, in units of 2^-24
+    long over_4_ulp;
+};
+
+void accumulate(ErrorStats& s, uint32_t re, uint32_t im, double exact_re, double exact_im) {
+    long ulp = std::max(ulp_distance(re, float_bits(static_cast<float>(exact_re))),
+                        ulp_distance(im, float_bits(static_cast<float>(exact_im))));
+    double norm = sqrt(exact_re * exact_re + exact_im * exact_im);
+    double error = sqrt(pow(bits_float(re) - exact_re, 2) + pow(bits_float(im) - exact_im, 2));
+    s.max_ulp = std::max(s.max_ulp, ulp);
+    s.total_ulp += ulp;
+    s.over_4_ulp += ulp > 4;
+    if (norm > 0) {
+        s.max_relative = std::max(s.max_relative, error / norm * 16777216.0);
+    }
+}
+
+// Operands: moderate magnitudes with an occasional zero part, as with twiddle factors
+uint32_t random_part() {
+    if (rand() % 16 == 0) {
+        return 0;
+    }
+    float value = ldexpf(static_cast<float>(rand()) / RAND_MAX + 0.5f, rand() % 16 - 8);
+    return float_bits((rand() % 2) ? -value : value);
+}
+
+int sc_main(int argc, char* argv[]) {
+    long n;
+    cout << "Enter the number of complex multiplies: ";
+    cin >> n;
+    if (n <= 0) {
+        cout << "Invalid input" << endl;
+        return 1;
+    }
+
+    srand(1);
+    std::vector<uint32_t> a(n), b(n), c(n), d(n);
+    for (long i = 0; i < n; i++) {
+        a[i] = random_part();
+        b[i] = random_part();
+        c[i] = random_part();
+        d[i] = random_part();
+    }
+
+    // One complex multiply issued per cycle into both variants
+    Top top("Top");
+    long cycle = 0, done4 = 0, done3 = 0, mismatches = 0;
+    ErrorStats errors[2];
+    memset(errors, 0, sizeof(errors));
+    for (long next = 0; done3 < n; cycle++) {
+        if (next < n) {
+            top.a.write(a[next]);
+            top.b.write(b[next]);
+            top.c.write(c[next]);
+            top.d.write(d[next]);
+            next++;
+        }
+        sc_start(1, SC_NS);
+        double exact_re, exact_im;
+        uint32_t re, im;
+        if (cycle >= four_delay && done4 < n) {
+            long i = done4++;
+            exact_re = static_cast<double>(bits_float(a[i])) * bits_float(c[i]) - static_cast<double>(bits_float(b[i])) * bits_float(d[i]);
+            exact_im = static_cast<double>(bits_float(a[i])) * bits_float(d[i]) + static_cast<double>(bits_float(b[i])) * bits_float(c[i]);
+            complex4_function(a[i], b[i], c[i], d[i], re, im);
+            mismatches += (top.re4.read() != re) + (top.im4.read() != im);
+            accumulate(errors[0], top.re4.read(), top.im4.read(), exact_re, exact_im);
+        }
+        if (cycle >= gauss_delay) {
+            long i = done3++;
+            exact_re = static_cast<double>(bits_float(a[i])) * bits_float(c[i]) - static_cast<double>(bits_float(b[i])) * bits_float(d[i]);
+            exact_im = static_cast<double>(bits_float(a[i])) * bits_float(d[i]) + static_cast<double>(bits_float(b[i])) * bits_float(c[i]);
+            gauss_function(a[i], b[i], c[i], d[i], re, im);
+            mismatches += (top.re3.read() != re) + (top.im3.read() != im);
+            accumulate(errors[1], top.re3.read(), top.im3.read(), exact_re, exact_im);
+        }
+    }
+
+    cout << n << " complex multiplies, one issued per cycle" << endl;
+    cout << "Variant   multipliers  adders  latency  cycles    max ULP  mean ULP  >4 ULP   max normwise error (2^-24)" << endl;
+    const char* names[] = {"4-mult", "3-mult"};
+    const int multipliers[] = {4, 3}, adders[] = {2, 5}, latency[] = {four_delay + 1, gauss_delay + 1};
+    for (int v = 0; v < 2; v++) {
+        printf("%-9s %11d %7d %8d %7ld %10ld %9.3f %7ld %14.2f\n", names[v], multipliers[v], adders[v], latency[v],
+               n + latency[v] - 1, errors[v].max_ulp, errors[v].total_ulp / n, errors[v].over_4_ulp, errors[v].max_relative);
+    }
+    cout << "Separate runs through one multiplier and one adder/subtractor Top: " << 4 * n + 5
+         << " cycles (four multiplier issues per complex multiply)" << endl;
+    cout << "Pin-level mismatches vs functional models: " << mismatches << endl;
+    return 0;
+}
@@ -0,0 +1,383 @@
+#include <systemc.h>
+#include <bitset>
+#include <math.h>
+#include <algorithm>
+#include <vector>
+#include "fpu_models.h"
+SC_MODULE(ExtractModule) {
+    sc_in<sc_uint<32>> a;
+    sc_in<sc_uint<32>> b;
+    sc_out<sc_uint<32>> a_significand;
+    sc_out<sc_uint<32>> b_significand;
+    sc_out<bool> a_sign;
+    sc_out<bool> b_sign;
+    sc_out<sc_uint<8>> a_exp; // Change to 8 bits for exponent
+    sc_out<sc_uint<8>> b_exp; // Change to 8 bits for exponent
+    sc_in_clk clock; // Clock input
+
+    void extract() {
+        while (true) {
+            wait(); // Wait for the rising edge of the clock
+
+            uint32_t a_val = a.read();
+            uint32_t b_val = b.read();
+
+            // Extract biased exponents and sign bits
+            a_exp.write((a_val & 0x7F800000) >> 23);
+            b_exp.write((b_val & 0x7F800000) >> 23);
+            a_sign.write((a_val & 0x80000000) != 0);
+            b_sign.write((b_val & 0x80000000) != 0);
+
+            // Extract significands
+            a_significand.write((a_val & 0x007FFFFF) | 0x00800000);
+            b_significand.write((b_val & 0x007FFFFF) | 0x00800000);
+        }
+    }
+
+    SC_CTOR(ExtractModule) {
+        SC_THREAD(extract);
+        sensitive << clock.pos();
+    }
+};
+
+// OpRegister: carries the operation select alongside the extracted operands
+SC_MODULE(OpRegister) {
+    sc_in<bool> sqrt_in;
+    sc_out<bool> sqrt_out;
+    sc_in_clk clock; // Clock input
+
+    void latch() {
+        while (true) {
+            wait(); // Wait for the rising edge of the clock
+            sqrt_out.write(sqrt_in.read());
+        }
+    }
+
+    SC_CTOR(OpRegister) {
+        SC_THREAD(latch);
+        sensitive << clock.pos();
+    }
+};
+
+// DivSqrtModule: ComputeModule of Division Final extended with square root of a.
+// Both run the same 25-step restoring recurrence: each step shifts one result bit
+// into r and subtracts from the partial remainder when it fits. Division subtracts
+// the divisor; square root brings down two radicand bits per step and subtracts
+// the trial root 4r + 1.
+SC_MODULE(DivSqrtModule) {
+    sc_in<sc_uint<32>> a_significand;
+    sc_in<sc_uint<32>> b_significand;
+    sc_in<bool> a_sign;
+    sc_in<bool> b_sign;
+    sc_in<sc_uint<8>> a_exp; // Change to 8 bits for exponent
+    sc_in<sc_uint<8>> b_exp; // Change to 8 bits for exponent
+    sc_in<bool> sqrt_op;
+    sc_out<sc_uint<32>> result;
+    sc_in_clk clock; // Clock input
+
+    void compute() {
+        while (true) {
+            wait(); // Wait for the rising edge of the clock
+
+            uint32_t r, result_exp;
+            uint8_t i, odd, rnd, sticky;
+            uint64_t x_val, y_val, radicand = 0;
+            bool root = sqrt_op.read();
+            uint32_t a_exp_val = a_exp.read();
+            uint32_t a_fraction = a_significand.read() & 0x007FFFFF;
+
+            // Square root specials: NaN, infinity, zero and negative operands bypass the recurrence
+            if (root && (a_exp_val == 255 || (a_exp_val == 0 && a_fraction == 0) || a_sign.read())) {
+                if (a_exp_val == 0 && a_fraction == 0) {
+                    r = 0;
+                } else if (a_exp_val == 255 && a_fraction == 0 && !a_sign.read()) {
+                    r = 0x7F800000;
+                } else {
+                    r = 0x7FC00000;
+                }
+                result.write(r | (a_sign.read() ? 0x80000000 : 0));
+                continue;
+            }
+
+            if (root) {
+                // Normalize a subnormal radicand, then make the unbiased exponent even
+                int exponent = int(a_exp_val) - 127;
+                uint32_t m = a_significand.read();
+                if (a_exp_val == 0) {
+                    m = a_fraction;
+                    exponent = -126;
+                    while ((m & 0x00800000) == 0) {
+                        m = m << 1;
+                        exponent--;
+                    }
+                }
+                if (exponent & 1) {
+                    m = m << 1;
+                    exponent--;
+                }
+                result_exp = exponent / 2 + 127;
+
+                // 25 root bits of m * 2^25 give the 24-bit significand and a round bit
+                radicand = static_cast<uint64_t>(m) << 25;
+                x_val = 0;
+                y_val = 0;
+            } else {
+                // Compute exponent of result
+                result_exp = a_exp_val - b_exp.read() + 127;
+
+                // Dividend may not be smaller than divisor: normalize
+                x_val = a_significand.read();
+                y_val = b_significand.read();
+
+                if (x_val < y_val) {
+                    x_val = x_val << 1;
+                    result_exp--;
+                }
+            }
+
+            // Generate the result one bit at a time
+            r = 0;
+            for (i = 0; i < 25; i++) {
+                if (root) {
+                    x_val = (x_val << 2) | ((radicand >> (48 - 2 * i)) & 3);
+                    y_val = (static_cast<uint64_t>(r) << 2) | 1;
+                }
+                r = r << 1;
+                if (x_val >= y_val) {
+                    x_val = x_val - y_val;
+                    r = r | 1;
+                }
+                if (!root) {
+                    x_val = x_val << 1;
+                }
+            }
+
+            sticky = (x_val != 0);
+            if ((result_exp >= 1) && (result_exp <= 254)) { // normal, may overflow to infinity
+                // Extract round and lsb bits: the 25 result bits are the 24-bit
+                // significand followed by the round bit
+                rnd = r & 1;
+                odd = (r & 0x2) != 0;
+
+                // Remove round bit from quotient and round to-nearest-even
+                r = (r >> 1) + (rnd & (sticky | odd));
+
+                // Combine exponent and significand
+                r = (result_exp << 23) + (r - 0x00800000);
+            } else if (result_exp > 254) { // overflow: infinity
+                r = 0x7F800000;
+            } else { // underflow: result is zero, subnormal, or smallest normal
+                uint8_t shift = (uint8_t)(1 - result_exp);
+
+                // Clamp shift count
+                if (shift > 25) shift = 25;
+
+                // OR shifted-off bits of significand into sticky bit
+                sticky = sticky | ((r & ((1u << shift) - 1)) != 0);
+
+                // Denormalize significand
+                r = r >> shift;
+
+                // Extract round and lsb bits
+                rnd = r & 1;
+                odd = (r & 0x2) != 0;
+
+                // Remove round bit from quotient and round to-nearest-even
+                r = (r >> 1) + (rnd & (sticky | odd));
+            }
+
+            // Combine sign bit with combo of exponent and significand
+            r = r | (a_sign.read() ? 0x80000000 : 0);
+            result.write(r);
+        }
+    }
+
+    SC_CTOR(DivSqrtModule) {
+        SC_THREAD(compute);
+        sensitive << clock.pos();
+    }
+};
+
+SC_MODULE(NormalizationModule) {
+    sc_in<sc_uint<32>> result;
+    sc_in<sc_uint<8>> a_exp; // Change to 8 bits for exponent
+    sc_out<bool> normalized;
+    sc_in_clk clock; // Clock input
+
+    void normalize() {
+        while (true) {
+            wait(); // Wait for the rising edge of the clock
+
+            uint32_t result_val = result.read();
+            uint8_t a_exp_val = a_exp.read();
+
+            // Perform normalization check
+            if ((result_val & 0x7F800000) == 0x7F800000) {
+                // Exponent is all 1s, indicating infinity or NaN
+                normalized.write(false);
+            } else if ((result_val & 0x7F800000) == 0) {
+                // Exponent is all 0s, indicating a subnormal or zero
+                normalized.write(false);
+            } else {
+                // Normalized result
+                normalized.write(true);
+            }
+        }
+    }
+
+    SC_CTOR(NormalizationModule) {
+        SC_THREAD(normalize);
+        sensitive << clock.pos();
+    }
+};
+
+// Top-level Module: operands and the operation select enter together, one
+// operation per 10 ns clock
+SC_MODULE(Top) {
+    ExtractModule extract_module;
+    OpRegister op_register;
+    DivSqrtModule div_sqrt_module;
+    NormalizationModule normalization_module;
+    sc_signal<sc_uint<32>> a;
+    sc_signal<sc_uint<32>> b;
+    sc_signal<bool> sqrt_op;
+    sc_signal<sc_uint<32>> a_significand;
+    sc_signal<sc_uint<32>> b_significand;
+    sc_signal<sc_uint<32>> result;
+    sc_signal<bool> a_sign;
+    sc_signal<bool> b_sign;
+    sc_signal<bool> extracted_sqrt_op;
+    sc_signal<bool> normalized;
+    sc_signal<sc_uint<8>> a_exp;
+    sc_signal<sc_uint<8>> b_exp;
+    sc_clock clock;
+
+    SC_CTOR(Top)
+        : extract_module("ExtractModule"),
+          op_register("OpRegister"),
+          div_sqrt_module("DivSqrtModule"),
+          normalization_module("NormalizationModule"),
+          clock("clock", 10, SC_NS) {
+        extract_module.a(a);
+        extract_module.b(b);
+        extract_module.a_significand(a_significand);
+        extract_module.b_significand(b_significand);
+        extract_module.a_sign(a_sign);
+        extract_module.b_sign(b_sign);
+        extract_module.a_exp(a_exp);
+        extract_module.b_exp(b_exp);
+        extract_module.clock(clock);
+
+        op_register.sqrt_in(sqrt_op);
+        op_register.sqrt_out(extracted_sqrt_op);
+        op_register.clock(clock);
+
+        div_sqrt_module.a_significand(a_significand);
+        div_sqrt_module.b_significand(b_significand);
+        div_sqrt_module.a_sign(a_sign);
+        div_sqrt_module.b_sign(b_sign);
+        div_sqrt_module.a_exp(a_exp);
+        div_sqrt_module.b_exp(b_exp);
+        div_sqrt_module.sqrt_op(extracted_sqrt_op);
+        div_sqrt_module.result(result);
+        div_sqrt_module.clock(clock);
+
+        normalization_module.result(result);
+        normalization_module.a_exp(a_exp);
+        normalization_module.normalized(normalized);
+        normalization_module.clock(clock);
+    }
+};
+
+bool is_nan(uint32_t x) {
+    return (x & 0x7FFFFFFF) > 0x7F800000;
+}
+
+// Distance in units in the last place between two finite floats of the same sign
+long ulp_distance(uint32_t x, uint32_t y) {
+    return labs(static_cast<long>(x & 0x7FFFFFFF) - static_cast<long>(y & 0x7FFFFFFF));
+}
+
+uint32_t host_sqrt(uint32_t a) {
+    float x, r;
+    memcpy(&x, &a, 4);
+    r = sqrtf(x);
+    uint32_t bits;
+    memcpy(&bits, &r, 4);
+    return bits;
+}
+
+int sc_main(int argc, char* argv[]) {
+    long n;
+    cout << "Enter the number of operations: ";
+    cin >> n;
+    if (n <= 0) {
+        cout << "Invalid input" << endl;
+        return 1;
+    }
+
+    // Functional sweep of the square root over a stride of all bit patterns
+    long swept = 0, sweep_mismatches = 0, max_ulp = 0;
+    for (uint64_t pattern = 0; pattern < 0x100000000ULL; pattern += 4099) {
+        uint32_t a = static_cast<uint32_t>(pattern);
+        uint32_t mine = sqrt_function(a), host = host_sqrt(a);
+        bool same = (is_nan(mine) && is_nan(host)) || mine == host;
+        sweep_mismatches += !same;
+        if (!same && !is_nan(mine) && !is_nan(host)) {
+            max_ulp = std::max(max_ulp, ulp_distance(mine, host));
+        }
+        swept++;
+    }
+
+    // Mixed division / square root stream through the pin-level unit
+    Top top("Top");
+    srand(1);
+    std::vector<uint32_t> a(n), b(n);
+    std::vector<char> sqrt_ops(n);
+    for (long i = 0; i < n; i++) {
+        float a_float = ldexpf(static_cast<float>(rand()) / RAND_MAX + 0.5f, rand() % 64 - 32);
+        float b_float = ldexpf(static_cast<float>(rand()) / RAND_MAX + 0.5f, rand() % 64 - 32);
+        sqrt_ops[i] = rand() % 2;
+        if (sqrt_ops[i] && rand() % 8 == 0) {
+            a_float = ldexpf(a_float, -140);   // subnormal radicand
+        }
+        memcpy(&a[i], &a_float, 4);
+        memcpy(&b[i], &b_float, 4);
+    }
+
+    // The unit takes one operation per 10 ns clock. The loop steps 1 ns at a time
+    // so each result is read just after the edge that produces it; the time is
+    // converted to clock cycles for the report
+    const int clock_ns = 10, result_delay = 10;
+    long ns = 0, done = 0, counts[2] = {0, 0}, model_mismatches = 0, host_mismatches = 0;
+    for (long next = 0; done < n; ns++) {
+        if (next < n && ns % clock_ns == 0) {
+            top.a.write(a[next]);
+            top.b.write(b[next]);
+            top.sqrt_op.write(sqrt_ops[next]);
+            next++;
+        }
+        sc_start(1, SC_NS);
+        if (ns >= result_delay && (ns - result_delay) % clock_ns == 0) {
+            uint32_t r = top.result.read();
+            bool root = sqrt_ops[done];
+            model_mismatches += (r != (root ? sqrt_function(a[done]) : division_function(a[done], b[done])));
+            host_mismatches += root && r != host_sqrt(a[done]);
+            counts[root]++;
+            done++;
+        }
+    }
+
+    cout << "Square root sweep: " << swept << " bit patterns, " << sweep_mismatches << " differ from sqrtf";
+    if (sweep_mismatches) {
+        cout << " (max " << max_ulp << " ulp)";
+    }
+    cout << endl;
+    long cycles = (ns + clock_ns - 1) / clock_ns;
+    cout << counts[0] << " divisions and " << counts[1] << " square roots in " << cycles << " cycles: "
+         << static_cast<double>(cycles) / n << " cycles/op, latency " << result_delay / clock_ns
+         << " cycle for both, 25 recurrence steps each" << endl;
+    cout << "Pin-level mismatches vs functional models: " << model_mismatches << ", square roots differing from sqrtf: "
+         << host_mismatches << endl;
+    return 0;
+}
@@ -85,8 +85,9 @@ SC_MODULE(ComputeModule) {
 check++;
             sticky = (x_val != 0);
             if ((result_exp >= 1) && (result_exp <= 254)) { // normal, may overflow to infinity
-                // Extract round and lsb bits
-                rnd = (r & 0x1000000) >> 24;
+                // Extract round and lsb bits: the 25 quotient bits are the 24-bit
+                // significand followed by the round bit
+                rnd = r & 1;
                 odd = (r & 0x2) != 0;
 
                 // Remove round bit from quotient and round to-nearest-even
@@ -103,13 +104,13 @@ check++;
                 if (shift > 25) shift = 25;
 
                 // OR shifted-off bits of significand into sticky bit
-                sticky = sticky | ((r & ~(~0 << shift)) != 0);
+                sticky = sticky | ((r & ((1u << shift) - 1)) != 0);
 
                 // Denormalize significand
                 r = r >> shift;
 
                 // Extract round and lsb bits
-                rnd = (r & 0x1000000) >> 24;
+                rnd = r & 1;
                 odd = (r & 0x2) != 0;
 
                 // Remove round bit from quotient and round to-nearest-even
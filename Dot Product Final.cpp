@@ -0,0 +1,690 @@
+#include <systemc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <bitset>
+#include "fpu_pipelines.h"
+
+#define LANES 4
+#define TERMS (LANES + 1)
+
+// DotProductExtractor Module
+// Unpacks a0..a3, b0..b3 and the addend c. NaN, infinity and 0*inf cases are
+// resolved for the whole dot product and travel down the pipeline as a special result.
+SC_MODULE(DotProductExtractor) {
+    sc_in<sc_uint<32>> a[LANES];
+    sc_in<sc_uint<32>> b[LANES];
+    sc_in<sc_uint<32>> c;
+    sc_in<bool> in_valid;
+    sc_out<bool> a_sign[LANES];
+    sc_out<sc_uint<8>> a_exp[LANES];
+    sc_out<sc_uint<32>> a_significand[LANES];
+    sc_out<bool> b_sign[LANES];
+    sc_out<sc_uint<8>> b_exp[LANES];
+    sc_out<sc_uint<32>> b_significand[LANES];
+    sc_out<bool> c_sign;
+    sc_out<sc_uint<8>> c_exp;
+    sc_out<sc_uint<32>> c_significand;
+    sc_out<bool> special;
+    sc_out<sc_uint<32>> special_result;
+    sc_out<bool> valid;
+    sc_in<bool> clock;
+
+    void extraction_process() {
+        while (true) {
+            wait();
+            bool nan = false;
+            bool pos_inf = false;
+            bool neg_inf = false;
+            bool all_neg_zero = true;
+            //Extraction
+            for (int k = 0; k < LANES; k++) {
+                bool a_sign0 = (a[k].read() & 0x80000000) >> 31;
+                unsigned int a_exp0 = (a[k].read() & 0x7f800000) >> 23;
+                unsigned int a_significand0 = (a[k].read() & 0x7fffff);
+
+                bool b_sign0 = (b[k].read() & 0x80000000) >> 31;
+                unsigned int b_exp0 = (b[k].read() & 0x7f800000) >> 23;
+                unsigned int b_significand0 = (b[k].read() & 0x7fffff);
+
+                bool a_zero = (a_exp0 == 0 && a_significand0 == 0);
+                bool b_zero = (b_exp0 == 0 && b_significand0 == 0);
+                bool a_inf = (a_exp0 == 255 && a_significand0 == 0);
+                bool b_inf = (b_exp0 == 255 && b_significand0 == 0);
+
+                //Special Cases
+                if ((a_exp0 == 255 && a_significand0 != 0) || (b_exp0 == 255 && b_significand0 != 0)) {
+                    nan = true;
+                } else if ((a_inf && b_zero) || (b_inf && a_zero)) {
+                    nan = true;
+                } else if (a_inf || b_inf) {
+                    pos_inf = pos_inf || (a_sign0 == b_sign0);
+                    neg_inf = neg_inf || (a_sign0 != b_sign0);
+                }
+                all_neg_zero = all_neg_zero && (a_zero || b_zero) && (a_sign0 != b_sign0);
+
+                a_sign[k].write(a_sign0);
+                a_exp[k].write((a_exp0 == 0) ? 1 : a_exp0);
+                a_significand[k].write((a_exp0 >= 1) ? (a_significand0 | (1 << 23)) : a_significand0);
+                b_sign[k].write(b_sign0);
+                b_exp[k].write((b_exp0 == 0) ? 1 : b_exp0);
+                b_significand[k].write((b_exp0 >= 1) ? (b_significand0 | (1 << 23)) : b_significand0);
+            }
+
+            bool c_sign0 = (c.read() & 0x80000000) >> 31;
+            unsigned int c_exp0 = (c.read() & 0x7f800000) >> 23;
+            unsigned int c_significand0 = (c.read() & 0x7fffff);
+            if (c_exp0 == 255 && c_significand0 != 0) {
+                nan = true;
+            } else if (c_exp0 == 255) {
+                pos_inf = pos_inf || !c_sign0;
+                neg_inf = neg_inf || c_sign0;
+            }
+            all_neg_zero = all_neg_zero && c_sign0 && c_exp0 == 0 && c_significand0 == 0;
+
+            c_sign.write(c_sign0);
+            c_exp.write((c_exp0 == 0) ? 1 : c_exp0);
+            c_significand.write((c_exp0 >= 1) ? (c_significand0 | (1 << 23)) : c_significand0);
+
+            if (nan || (pos_inf && neg_inf)) {
+                special.write(true);
+                special_result.write(0x7FC00000);
+            } else if (pos_inf || neg_inf) {
+                special.write(true);
+                special_result.write(neg_inf ? 0xFF800000 : 0x7F800000);
+            } else if (all_neg_zero) {
+                special.write(true);
+                special_result.write(0x80000000);
+            } else {
+                special.write(false);
+                special_result.write(0);
+            }
+            valid.write(in_valid.read());
+        }
+    }
+
+    SC_CTOR(DotProductExtractor)
+        : c("c"),
+          in_valid("in_valid"),
+          c_sign("c_sign"),
+          c_exp("c_exp"),
+          c_significand("c_significand"),
+          special("special"),
+          special_result("special_result"),
+          valid("valid"),
+          clock("clock") {
+        SC_THREAD(extraction_process);
+        sensitive << clock.pos();
+    }
+};
+
+// DotProductMultiplier Module
+// Four significand multipliers as in FloatingPointMultiplier::multiply_process.
+// Products are kept exact (no normalisation or rounding); the addend c is passed
+// through as a fifth term with the same scaling, value = significand * 2^(exp - 188).
+SC_MODULE(DotProductMultiplier) {
+    sc_in<bool> a_sign[LANES];
+    sc_in<sc_uint<8>> a_exp[LANES];
+    sc_in<sc_uint<32>> a_significand[LANES];
+    sc_in<bool> b_sign[LANES];
+    sc_in<sc_uint<8>> b_exp[LANES];
+    sc_in<sc_uint<32>> b_significand[LANES];
+    sc_in<bool> c_sign;
+    sc_in<sc_uint<8>> c_exp;
+    sc_in<sc_uint<32>> c_significand;
+    sc_in<bool> special_in;
+    sc_in<sc_uint<32>> special_result_in;
+    sc_in<bool> in_valid;
+    sc_out<bool> term_sign[TERMS];
+    sc_out<sc_int<16>> term_exp[TERMS];
+    sc_out<sc_uint<64>> term_significand[TERMS];
+    sc_out<bool> special;
+    sc_out<sc_uint<32>> special_result;
+    sc_out<bool> valid;
+    sc_in<bool> clock;
+
+    void multiply_process() {
+        while (true) {
+            wait();
+            for (int k = 0; k < LANES; k++) {
+                // compute sign bit
+                bool resultSign = a_sign[k].read() ^ b_sign[k].read();
+
+                // compute exponent
+                int resultExponent = static_cast<int>(a_exp[k].read() + b_exp[k].read()) - 0x7F;
+
+                // implicit `1' bit was added by the extractor (denormals keep it clear)
+                uint64_t aSignificand = static_cast<uint64_t>(a_significand[k].read()) << 7;
+                uint64_t bSignificand = static_cast<uint64_t>(b_significand[k].read()) << 8;
+
+                uint64_t resultSignificand = aSignificand * bSignificand;
+
+                term_sign[k].write(resultSign);
+                // zero products must not take part in the max-exponent search
+                term_exp[k].write((resultSignificand == 0) ? -1024 : resultExponent);
+                term_significand[k].write(resultSignificand);
+            }
+
+            uint64_t cSignificand = static_cast<uint64_t>(c_significand.read()) << 38;
+            term_sign[LANES].write(c_sign.read());
+            term_exp[LANES].write((cSignificand == 0) ? -1024 : static_cast<int>(c_exp.read()));
+            term_significand[LANES].write(cSignificand);
+
+            special.write(special_in.read());
+            special_result.write(special_result_in.read());
+            valid.write(in_valid.read());
+        }
+    }
+
+    SC_CTOR(DotProductMultiplier)
+        : c_sign("c_sign"),
+          c_exp("c_exp"),
+          c_significand("c_significand"),
+          special_in("special_in"),
+          special_result_in("special_result_in"),
+          in_valid("in_valid"),
+          special("special"),
+          special_result("special_result"),
+          valid("valid"),
+          clock("clock") {
+        SC_THREAD(multiply_process);
+        sensitive << clock.pos();
+    }
+};
+
+// DotProductAligner Module
+// Shared max-exponent alignment of the five terms. Terms are pre-shifted by 4 to
+// leave headroom for the sum, bits shifted off are jammed into the LSB, and
+// negative terms are converted to two's complement for the CSA tree.
+SC_MODULE(DotProductAligner) {
+    sc_in<bool> term_sign[TERMS];
+    sc_in<sc_int<16>> term_exp[TERMS];
+    sc_in<sc_uint<64>> term_significand[TERMS];
+    sc_in<bool> special_in;
+    sc_in<sc_uint<32>> special_result_in;
+    sc_in<bool> in_valid;
+    sc_out<sc_uint<64>> aligned[TERMS];
+    sc_out<sc_int<16>> max_exp;
+    sc_out<bool> special;
+    sc_out<sc_uint<32>> special_result;
+    sc_out<bool> valid;
+    sc_in<bool> clock;
+
+    void alignment_process() {
+        while (true) {
+            wait();
+
+            //Maximum exponent
+            int ans_exp = -1024;
+            for (int k = 0; k < TERMS; k++) {
+                if (term_exp[k].read() > ans_exp) {
+                    ans_exp = term_exp[k].read();
+                }
+            }
+
+            //Exponent Shifting
+            for (int k = 0; k < TERMS; k++) {
+                unsigned int shift = ans_exp - term_exp[k].read();
+                uint64_t wide = term_significand[k].read() >> 4;
+                uint64_t shifted = (shift > 63) ? 0 : (wide >> shift);
+                bool sticky = (shift > 63) ? (wide != 0) : ((wide & ((1ULL << shift) - 1)) != 0);
+                shifted = shifted | sticky;
+                aligned[k].write(term_sign[k].read() ? (~shifted + 1) : shifted);
+            }
+
+            max_exp.write(ans_exp);
+            special.write(special_in.read());
+            special_result.write(special_result_in.read());
+            valid.write(in_valid.read());
+        }
+    }
+
+    SC_CTOR(DotProductAligner)
+        : special_in("special_in"),
+          special_result_in("special_result_in"),
+          in_valid("in_valid"),
+          max_exp("max_exp"),
+          special("special"),
+          special_result("special_result"),
+          valid("valid"),
+          clock("clock") {
+        SC_THREAD(alignment_process);
+        sensitive << clock.pos();
+    }
+};
+
+// CarrySaveTree Module
+// Reduces the aligned terms to a sum and a carry vector with 3:2 compressors.
+SC_MODULE(CarrySaveTree) {
+    sc_in<sc_uint<64>> aligned[TERMS];
+    sc_in<sc_int<16>> max_exp_in;
+    sc_in<bool> special_in;
+    sc_in<sc_uint<32>> special_result_in;
+    sc_in<bool> in_valid;
+    sc_out<sc_uint<64>> sum_vector;
+    sc_out<sc_uint<64>> carry_vector;
+    sc_out<sc_int<16>> max_exp;
+    sc_out<bool> special;
+    sc_out<sc_uint<32>> special_result;
+    sc_out<bool> valid;
+    sc_in<bool> clock;
+
+    void csa_process() {
+        while (true) {
+            wait();
+
+            uint64_t rows[TERMS];
+            int n = TERMS;
+            for (int k = 0; k < TERMS; k++) {
+                rows[k] = aligned[k].read();
+            }
+
+            //3:2 compression until two rows are left
+            while (n > 2) {
+                int m = 0;
+                int k = 0;
+                for (; k + 2 < n; k += 3) {
+                    uint64_t s = rows[k] ^ rows[k + 1] ^ rows[k + 2];
+                    uint64_t c = ((rows[k] & rows[k + 1]) | (rows[k] & rows[k + 2]) | (rows[k + 1] & rows[k + 2])) << 1;
+                    rows[m++] = s;
+                    rows[m++] = c;
+                }
+                for (; k < n; k++) {
+                    rows[m++] = rows[k];
+                }
+                n = m;
+            }
+
+            sum_vector.write(rows[0]);
+            carry_vector.write(rows[1]);
+            max_exp.write(max_exp_in.read());
+            special.write(special_in.read());
+            special_result.write(special_result_in.read());
+            valid.write(in_valid.read());
+        }
+    }
+
+    SC_CTOR(CarrySaveTree)
+        : max_exp_in("max_exp_in"),
+          special_in("special_in"),
+          special_result_in("special_result_in"),
+          in_valid("in_valid"),
+          sum_vector("sum_vector"),
+          carry_vector("carry_vector"),
+          max_exp("max_exp"),
+          special("special"),
+          special_result("special_result"),
+          valid("valid"),
+          clock("clock") {
+        SC_THREAD(csa_process);
+        sensitive << clock.pos();
+    }
+};
+
+// DotProductNormaliser Module
+// Final carry-propagate add, leading-one detection and a single
+// round-to-nearest-even for the whole dot product.
+SC_MODULE(DotProductNormaliser) {
+    sc_in<sc_uint<64>> sum_vector;
+    sc_in<sc_uint<64>> carry_vector;
+    sc_in<sc_int<16>> max_exp;
+    sc_in<bool> special;
+    sc_in<sc_uint<32>> special_result;
+    sc_in<bool> in_valid;
+    sc_out<sc_uint<32>> nresult;
+    sc_out<bool> valid;
+    sc_in<bool> clock;
+
+    void normal_process() {
+        while (true) {
+            wait();
+
+            int64_t total = static_cast<int64_t>(sum_vector.read() + carry_vector.read());
+            bool ans_sign = total < 0;
+            uint64_t magnitude = ans_sign ? (~static_cast<uint64_t>(total) + 1) : static_cast<uint64_t>(total);
+            int exp_max = max_exp.read();
+            unsigned int ans;
+
+            if (special.read()) {
+                ans = special_result.read();
+            } else if (magnitude == 0) {
+                //When answer is zero
+                ans = 0;
+            } else {
+                /* Normalization */
+                int i;
+                for (i = 63; i > 0 && ((magnitude >> i) == 0); i--) {;}
+
+                // Value is magnitude * 2^(max_exp - 184)
+                int ans_exp = exp_max + i - 57;
+                int shift = (ans_exp >= 1) ? (i - 23) : (35 - exp_max);
+                uint64_t ans_significand;
+
+                if (shift > 63) {
+                    // Below half of the smallest subnormal
+                    ans_significand = 0;
+                } else if (shift > 0) {
+                    //Rounding
+                    uint64_t guard = (magnitude >> (shift - 1)) & 1;
+                    bool sticky = (magnitude & ((1ULL << (shift - 1)) - 1)) != 0;
+                    ans_significand = magnitude >> shift;
+                    if (guard == 1 && (sticky || (ans_significand & 1) == 1)) {
+                        ans_significand += 1;
+                    }
+                } else {
+                    ans_significand = magnitude << (-shift);
+                }
+
+                if (ans_exp >= 1) {
+                    if ((ans_significand >> 24) == 1) {
+                        ans_significand = (ans_significand >> 1);
+                        ans_exp += 1;
+                    }
+                    //Overflow
+                    if (ans_exp >= 255) {
+                        ans = (ans_sign << 31) | 0x7F800000;
+                    } else {
+                        ans = (ans_sign << 31) | (ans_exp << 23) | (ans_significand & 0x7FFFFF);
+                    }
+                } else {
+                    //Underflow: subnormal result, rounding into bit 23 gives the smallest normal
+                    ans = (ans_sign << 31) | static_cast<unsigned int>(ans_significand);
+                }
+            }
+
+            nresult.write(ans);
+            valid.write(in_valid.read());
+        }
+    }
+
+    SC_CTOR(DotProductNormaliser)
+        : sum_vector("sum_vector"),
+          carry_vector("carry_vector"),
+          max_exp("max_exp"),
+          special("special"),
+          special_result("special_result"),
+          in_valid("in_valid"),
+          nresult("nresult"),
+          valid("valid"),
+          clock("clock") {
+        SC_THREAD(normal_process);
+        sensitive << clock.pos();
+    }
+};
+
+// Top-level Module: DP4 unit, one a0*b0 + a1*b1 + a2*b2 + a3*b3 + c per cycle
+SC_MODULE(Top) {
+    DotProductExtractor extractor;
+    DotProductMultiplier multiplier;
+    DotProductAligner aligner;
+    CarrySaveTree csa;
+    DotProductNormaliser normalization;
+    sc_signal<sc_uint<32>> a[LANES];
+    sc_signal<sc_uint<32>> b[LANES];
+    sc_signal<sc_uint<32>> c;
+    sc_signal<bool> in_valid;
+    sc_signal<bool> a_sign[LANES];
+    sc_signal<sc_uint<8>> a_exp[LANES];
+    sc_signal<sc_uint<32>> a_significands[LANES];
+    sc_signal<bool> b_sign[LANES];
+    sc_signal<sc_uint<8>> b_exp[LANES];
+    sc_signal<sc_uint<32>> b_significands[LANES];
+    sc_signal<bool> c_sign;
+    sc_signal<sc_uint<8>> c_exp;
+    sc_signal<sc_uint<32>> c_significands;
+    sc_signal<bool> term_sign[TERMS];
+    sc_signal<sc_int<16>> term_exp[TERMS];
+    sc_signal<sc_uint<64>> term_significands[TERMS];
+    sc_signal<sc_uint<64>> aligned[TERMS];
+    sc_signal<sc_int<16>> max_exp[2];
+    sc_signal<bool> special[4];
+    sc_signal<sc_uint<32>> special_result[4];
+    sc_signal<bool> valid[5];
+    sc_signal<sc_uint<64>> sum_vector;
+    sc_signal<sc_uint<64>> carry_vector;
+    sc_signal<sc_uint<32>> normalized_result;
+    sc_clock clock;
+
+    SC_CTOR(Top)
+        : extractor("Extractor"),
+          multiplier("Multiplier"),
+          aligner("Aligner"),
+          csa("CarrySaveTree"),
+          normalization("Normalization"),
+          clock("clock", 1, SC_NS) {
+        for (int k = 0; k < LANES; k++) {
+            extractor.a[k](a[k]);
+            extractor.b[k](b[k]);
+            extractor.a_sign[k](a_sign[k]);
+            extractor.a_exp[k](a_exp[k]);
+            extractor.a_significand[k](a_significands[k]);
+            extractor.b_sign[k](b_sign[k]);
+            extractor.b_exp[k](b_exp[k]);
+            extractor.b_significand[k](b_significands[k]);
+
+            multiplier.a_sign[k](a_sign[k]);
+            multiplier.a_exp[k](a_exp[k]);
+            multiplier.a_significand[k](a_significands[k]);
+            multiplier.b_sign[k](b_sign[k]);
+            multiplier.b_exp[k](b_exp[k]);
+            multiplier.b_significand[k](b_significands[k]);
+        }
+        for (int k = 0; k < TERMS; k++) {
+            multiplier.term_sign[k](term_sign[k]);
+            multiplier.term_exp[k](term_exp[k]);
+            multiplier.term_significand[k](term_significands[k]);
+
+            aligner.term_sign[k](term_sign[k]);
+            aligner.term_exp[k](term_exp[k]);
+            aligner.term_significand[k](term_significands[k]);
+            aligner.aligned[k](aligned[k]);
+
+            csa.aligned[k](aligned[k]);
+        }
+        extractor.c(c);
+        extractor.in_valid(in_valid);
+        extractor.c_sign(c_sign);
+        extractor.c_exp(c_exp);
+        extractor.c_significand(c_significands);
+        extractor.special(special[0]);
+        extractor.special_result(special_result[0]);
+        extractor.valid(valid[0]);
+        extractor.clock(clock);
+
+        multiplier.c_sign(c_sign);
+        multiplier.c_exp(c_exp);
+        multiplier.c_significand(c_significands);
+        multiplier.special_in(special[0]);
+        multiplier.special_result_in(special_result[0]);
+        multiplier.in_valid(valid[0]);
+        multiplier.special(special[1]);
+        multiplier.special_result(special_result[1]);
+        multiplier.valid(valid[1]);
+        multiplier.clock(clock);
+
+        aligner.special_in(special[1]);
+        aligner.special_result_in(special_result[1]);
+        aligner.in_valid(valid[1]);
+        aligner.max_exp(max_exp[0]);
+        aligner.special(special[2]);
+        aligner.special_result(special_result[2]);
+        aligner.valid(valid[2]);
+        aligner.clock(clock);
+
+        csa.max_exp_in(max_exp[0]);
+        csa.special_in(special[2]);
+        csa.special_result_in(special_result[2]);
+        csa.in_valid(valid[2]);
+        csa.sum_vector(sum_vector);
+        csa.carry_vector(carry_vector);
+        csa.max_exp(max_exp[1]);
+        csa.special(special[3]);
+        csa.special_result(special_result[3]);
+        csa.valid(valid[3]);
+        csa.clock(clock);
+
+        normalization.sum_vector(sum_vector);
+        normalization.carry_vector(carry_vector);
+        normalization.max_exp(max_exp[1]);
+        normalization.special(special[3]);
+        normalization.special_result(special_result[3]);
+        normalization.in_valid(valid[3]);
+        normalization.nresult(normalized_result);
+        normalization.valid(valid[4]);
+        normalization.clock(clock);
+    }
+};
+
+// Distance between two floats in units in the last place
+long long ulp_distance(unsigned int x, unsigned int y) {
+    long long ox = (x & 0x80000000) ? -static_cast<long long>(x & 0x7FFFFFFF) : static_cast<long long>(x);
+    long long oy = (y & 0x80000000) ? -static_cast<long long>(y & 0x7FFFFFFF) : static_cast<long long>(y);
+    return (ox > oy) ? (ox - oy) : (oy - ox);
+}
+
+// Issue record for the sequential baseline: operation node of a dot product
+struct Issued {
+    int cycle;
+    int dot;
+    int node;
+};
+
+int sc_main(int argc, char* argv[]) {
+    int dots;
+    cout << "Enter the number of dot products: ";
+    cin >> dots;
+    if (dots <= 0) {
+        cout << "Invalid input" << endl;
+        return 1;
+    }
+
+    Top top("Top");
+    addition::Top add_top("AdderTop");
+    multiplication::Top mul_top("MultiplierTop");
+
+    // Random operands with mixed signs and a spread of exponents
+    srand(1);
+    std::vector<unsigned int> a_in(dots * LANES), b_in(dots * LANES), c_in(dots), reference(dots);
+    for (int d = 0; d < dots; d++) {
+        double sum = 0;
+        for (int k = 0; k < LANES; k++) {
+            float a_float = ldexpf(0.5f + 0.5f * rand() / RAND_MAX, rand() % 8 - 4) * ((rand() & 1) ? -1 : 1);
+            float b_float = ldexpf(0.5f + 0.5f * rand() / RAND_MAX, rand() % 8 - 4) * ((rand() & 1) ? -1 : 1);
+            memcpy(&a_in[d * LANES + k], &a_float, sizeof(a_float));
+            memcpy(&b_in[d * LANES + k], &b_float, sizeof(b_float));
+            sum += static_cast<double>(a_float) * b_float;
+        }
+        float c_float = ldexpf(0.5f + 0.5f * rand() / RAND_MAX, rand() % 8 - 4) * ((rand() & 1) ? -1 : 1);
+        memcpy(&c_in[d], &c_float, sizeof(c_float));
+        float sum_float = static_cast<float>(sum + c_float);
+        memcpy(&reference[d], &sum_float, sizeof(sum_float));
+    }
+
+    // DP4 unit: one dot product issued per cycle
+    std::vector<unsigned int> fused(dots);
+    int fused_count = 0;
+    int fused_latency = 0;
+    int cycle = 0;
+    while (fused_count < dots) {
+        for (int k = 0; k < LANES; k++) {
+            top.a[k].write((cycle < dots) ? a_in[cycle * LANES + k] : 0);
+            top.b[k].write((cycle < dots) ? b_in[cycle * LANES + k] : 0);
+        }
+        top.c.write((cycle < dots) ? c_in[cycle] : 0);
+        top.in_valid.write(cycle < dots);
+        sc_start(1, SC_NS);
+        cycle++;
+        if (top.valid[4].read()) {
+            if (fused_count == 0) {
+                fused_latency = cycle;
+            }
+            fused[fused_count++] = top.normalized_result.read();
+        }
+    }
+    int fused_cycles = cycle;
+
+    // Sequential baseline: one multiplier Top and one adder Top from fpu_pipelines.h,
+    // each accepting one operation per cycle with a 3-cycle latency. Nodes 0-3 are the products,
+    // 4 = p0+p1, 5 = p2+p3, 6 = (4)+(5), 7 = (6)+c.
+    std::vector<unsigned int> value(dots * 8);
+    std::vector<char> issued(dots * 8, 0), ready(dots * 8, 0);
+    std::deque<Issued> mul_flight, add_flight;
+    int mul_next = 0;
+    int add_first = 0;
+    int finished = 0;
+    cycle = 0;
+    while (finished < dots) {
+        if (mul_next < dots * LANES) {
+            int d = mul_next / LANES;
+            int k = mul_next % LANES;
+            mul_top.a.write(a_in[d * LANES + k]);
+            mul_top.b.write(b_in[d * LANES + k]);
+            issued[d * 8 + k] = 1;
+            mul_flight.push_back({cycle, d, k});
+            mul_next++;
+        }
+        for (int d = add_first; d < dots && d <= mul_next / LANES; d++) {
+            int node = -1;
+            unsigned int x = 0, y = 0;
+            if (!issued[d * 8 + 4] && ready[d * 8 + 0] && ready[d * 8 + 1]) {
+                node = 4; x = value[d * 8 + 0]; y = value[d * 8 + 1];
+            } else if (!issued[d * 8 + 5] && ready[d * 8 + 2] && ready[d * 8 + 3]) {
+                node = 5; x = value[d * 8 + 2]; y = value[d * 8 + 3];
+            } else if (!issued[d * 8 + 6] && ready[d * 8 + 4] && ready[d * 8 + 5]) {
+                node = 6; x = value[d * 8 + 4]; y = value[d * 8 + 5];
+            } else if (!issued[d * 8 + 7] && ready[d * 8 + 6]) {
+                node = 7; x = value[d * 8 + 6]; y = c_in[d];
+            }
+            if (node >= 0) {
+                add_top.a.write(x);
+                add_top.b.write(y);
+                issued[d * 8 + node] = 1;
+                add_flight.push_back({cycle, d, node});
+                break;
+            }
+        }
+        while (add_first < dots && issued[add_first * 8 + 7]) {
+            add_first++;
+        }
+        sc_start(1, SC_NS);
+
+        // Results issued two cycles ago are on the normaliser outputs now
+        if (!mul_flight.empty() && mul_flight.front().cycle == cycle - 2) {
+            Issued done = mul_flight.front();
+            mul_flight.pop_front();
+            value[done.dot * 8 + done.node] = mul_top.normalized_result.read();
+            ready[done.dot * 8 + done.node] = 1;
+        }
+        if (!add_flight.empty() && add_flight.front().cycle == cycle - 2) {
+            Issued done = add_flight.front();
+            add_flight.pop_front();
+            value[done.dot * 8 + done.node] = add_top.normalized_result.read();
+            ready[done.dot * 8 + done.node] = 1;
+            finished += (done.node == 7);
+        }
+        cycle++;
+    }
+    int sequential_cycles = cycle;
+
+    long long fused_max = 0, sequential_max = 0;
+    int fused_exact = 0, sequential_exact = 0;
+    for (int d = 0; d < dots; d++) {
+        long long df = ulp_distance(fused[d], reference[d]);
+        long long ds = ulp_distance(value[d * 8 + 7], reference[d]);
+        fused_max = (df > fused_max) ? df : fused_max;
+        sequential_max = (ds > sequential_max) ? ds : sequential_max;
+        fused_exact += (df == 0);
+        sequential_exact += (ds == 0);
+    }
+
+    cout << "Dot products: " << dots << endl;
+    cout << "DP4 unit:" << endl;
+    cout << "  Latency: " << fused_latency << " cycles, 1 rounding" << endl;
+    cout << "  Cycles for stream: " << fused_cycles << " (" << static_cast<double>(fused_cycles) / dots << " per dot product)" << endl;
+    cout << "  Max ULP error: " << fused_max << ", exact: " << fused_exact << "/" << dots << endl;
+    cout << "Sequential multiplier Top + adder Top:" << endl;
+    cout << "  Cycles for stream: " << sequential_cycles << " (" << static_cast<double>(sequential_cycles) / dots << " per dot product), 8 roundings" << endl;
+    cout << "  Max ULP error: " << sequential_max << ", exact: " << sequential_exact << "/" << dots << endl;
+    cout << "Speedup: " << static_cast<double>(sequential_cycles) / fused_cycles << "x" << endl;
+    return 0;
+}
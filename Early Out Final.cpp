@@ -0,0 +1,307 @@
+#include <systemc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <bitset>
+#include <algorithm>
+#include <deque>
+#include <string>
+#include <vector>
+#include "fpu_models.h"
+#include "fpu_pipelines.h"
+#include "traced_float.h"
+
+enum FpuOp { FPU_ADD, FPU_SUB, FPU_MUL, FPU_DIV };
+const char* op_names[] = {"add", "sub", "mul", "div"};
+
+// Issue/result timing of each Top in 1 ns cycles, as in the simulation server
+const int issue_period[4] = {1, 1, 1, 10};
+const int result_delay[4] = {2, 2, 2, 10};
+#define QUEUE_DEPTH 16
+#define ROB_SIZE 64
+#define RETIRE_WIDTH 4
+
+uint32_t functional(int op, uint32_t a, uint32_t b) {
+    return (op == FPU_ADD) ? addition_function(a, b)
+         : (op == FPU_SUB) ? subtraction_function(a, b)
+         : (op == FPU_MUL) ? multiplication_function(a, b)
+         : division_function(a, b);
+}
+
+// Special-operand detector of the extractor stage. Returns true with the exact
+// IEEE result when an operand is trivial: adding or subtracting zero, multiplying
+// by zero or a power of two (including +-1), dividing zero by a normal number or
+// dividing by a power of two. Cases that would overflow or underflow, and
+// subnormal, infinite or NaN operands, take the full datapath.
+bool early_out(int op, uint32_t a, uint32_t b, uint32_t& result) {
+    uint32_t a_exp = (a >> 23) & 0xFF, b_exp = (b >> 23) & 0xFF;
+    bool a_zero = (a & 0x7FFFFFFF) == 0, b_zero = (b & 0x7FFFFFFF) == 0;
+    bool a_normal = a_exp >= 1 && a_exp <= 254, b_normal = b_exp >= 1 && b_exp <= 254;
+    bool a_pow2 = a_normal && (a & 0x7FFFFF) == 0, b_pow2 = b_normal && (b & 0x7FFFFF) == 0;
+    uint32_t sign = (a ^ b) & 0x80000000;
+    if (op == FPU_SUB) {
+        b ^= 0x80000000;
+        op = FPU_ADD;
+    }
+    if (op == FPU_ADD) {
+        if (a_zero && b_zero) {
+            result = a & b & 0x80000000;   // -0 only when both are -0
+        } else if ((a_zero && b_normal) || (b_zero && a_normal)) {
+            result = a_zero ? b : a;
+        } else {
+            return false;
+        }
+        return true;
+    }
+    if (op == FPU_MUL) {
+        if ((a_zero && (b_normal || b_zero)) || (b_zero && a_normal)) {
+            result = sign;
+            return true;
+        }
+        if ((a_pow2 && b_normal) || (b_pow2 && a_normal)) {
+            uint32_t other = a_pow2 ? b : a;
+            int exponent = int(a_exp) + int(b_exp) - 127;
+            if (exponent >= 1 && exponent <= 254) {
+                result = sign | (exponent << 23) | (other & 0x7FFFFF);
+                return true;
+            }
+        }
+        return false;
+    }
+    if (a_zero && b_normal) {
+        result = sign;
+        return true;
+    }
+    if (b_pow2 && a_normal) {
+        int exponent = int(a_exp) - int(b_exp) + 127;
+        if (exponent >= 1 && exponent <= 254) {
+            result = sign | (exponent << 23) | (a & 0x7FFFFF);
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t ieee_result(int op, uint32_t a, uint32_t b) {
+    float x, y, r;
+    memcpy(&x, &a, 4);
+    memcpy(&y, &b, 4);
+    r = (op == FPU_ADD) ? x + y : (op == FPU_SUB) ? x - y : (op == FPU_MUL) ? x * y : x / y;
+    uint32_t bits;
+    memcpy(&bits, &r, 4);
+    return bits;
+}
+
+struct Operation {
+    int op;
+    uint32_t a;
+    uint32_t b;
+};
+
+struct Transaction {
+    long tag;
+    int op;
+    uint32_t a;
+    uint32_t b;
+    long dispatched;
+    long ready;
+    bool fast;
+};
+
+struct ModeStats {
+    long cycles;
+    long count[4];
+    long fast[4];
+    long latency[4];
+    long retire_latency;
+    long fast_ieee_mismatches;
+    long fast_pipeline_differences;
+    long slow_mismatches;
+    long reorders;
+};
+
+// EarlyOutEngine
+// Dispatches one tagged operation per cycle in program order. With early-out on,
+// the extractor-stage detector completes trivial operations after one cycle
+// without entering the datapath; the rest queue for their Top. Each unit has one
+// result port, taken first by the datapath. Completed results wait in a reorder
+// buffer and retire in tag order; dispatch stalls while it is full.
+struct EarlyOutEngine {
+    addition::Top adder;
+    subtraction::Top subtractor;
+    multiplication::Top multiplier;
+    division::Top divider;
+    long cycle;
+
+    EarlyOutEngine() : adder("Adder"), subtractor("Subtractor"), multiplier("Multiplier"), divider("Divider"), cycle(0) {}
+
+    void start_unit(int op, uint32_t a, uint32_t b) {
+        switch (op) {
+        case FPU_ADD: adder.a.write(a); adder.b.write(b); break;
+        case FPU_SUB: subtractor.a.write(a); subtractor.b.write(b); break;
+        case FPU_MUL: multiplier.a.write(a); multiplier.b.write(b); break;
+        default: divider.a.write(a); divider.b.write(b); break;
+        }
+    }
+
+    uint32_t unit_result(int op) {
+        switch (op) {
+        case FPU_ADD: return adder.normalized_result.read();
+        case FPU_SUB: return subtractor.normalized_result.read();
+        case FPU_MUL: return multiplier.normalized_result.read();
+        default: return divider.result.read();
+        }
+    }
+
+    ModeStats run(const std::vector<Operation>& ops, bool enabled) {
+        ModeStats stats;
+        memset(&stats, 0, sizeof(stats));
+        std::deque<Transaction> waiting[4], in_flight[4], fast[4];
+        std::vector<char> completed(ROB_SIZE, 0);
+        std::vector<long> dispatched_at(ROB_SIZE, 0);
+        long next = 0, oldest = 0, newest_completed = -1, n = ops.size();
+        long start = cycle;
+
+        while (oldest < n) {
+            // Dispatch
+            if (next < n && next - oldest < ROB_SIZE) {
+                const Operation& o = ops[next];
+                Transaction t = {next, o.op, o.a, o.b, cycle, 0, false};
+                uint32_t result;
+                t.fast = enabled && early_out(o.op, o.a, o.b, result);
+                if (t.fast) {
+                    t.ready = cycle + 1;
+                    fast[o.op].push_back(t);
+                    stats.fast[o.op]++;
+                    stats.fast_ieee_mismatches += (result != ieee_result(o.op, o.a, o.b));
+                    stats.fast_pipeline_differences += (result != functional(o.op, o.a, o.b));
+                } else if (waiting[o.op].size() < QUEUE_DEPTH) {
+                    waiting[o.op].push_back(t);
+                } else {
+                    t.tag = -1;
+                }
+                if (t.tag >= 0) {
+                    dispatched_at[next % ROB_SIZE] = cycle;
+                    stats.count[o.op]++;
+                    next++;
+                }
+            }
+
+            // Datapath issue
+            for (int u = 0; u < 4; u++) {
+                if (!waiting[u].empty() && cycle % issue_period[u] == 0) {
+                    Transaction t = waiting[u].front();
+                    waiting[u].pop_front();
+                    t.ready = cycle + result_delay[u];
+                    start_unit(u, t.a, t.b);
+                    in_flight[u].push_back(t);
+                }
+            }
+            sc_start(1, SC_NS);
+
+            // Completion on each unit's result port
+            for (int u = 0; u < 4; u++) {
+                Transaction t;
+                if (!in_flight[u].empty() && in_flight[u].front().ready == cycle) {
+                    t = in_flight[u].front();
+                    in_flight[u].pop_front();
+                    stats.slow_mismatches += (unit_result(u) != functional(u, t.a, t.b));
+                } else if (!fast[u].empty() && fast[u].front().ready <= cycle + 1) {
+                    t = fast[u].front();
+                    fast[u].pop_front();
+                } else {
+                    continue;
+                }
+                completed[t.tag % ROB_SIZE] = 1;
+                stats.latency[u] += cycle + 1 - t.dispatched;
+                stats.reorders += (t.tag < newest_completed);
+                newest_completed = std::max(newest_completed, t.tag);
+            }
+            cycle++;
+
+            // In-order retirement
+            for (int r = 0; r < RETIRE_WIDTH && oldest < next && completed[oldest % ROB_SIZE]; r++) {
+                completed[oldest % ROB_SIZE] = 0;
+                stats.retire_latency += cycle - dispatched_at[oldest % ROB_SIZE];
+                oldest++;
+            }
+        }
+        stats.cycles = cycle - start;
+        return stats;
+    }
+};
+
+// Synthetic workload: a quarter of the operations have a trivial operand
+std::vector<Operation> synthetic_workload(long n) {
+    std::vector<Operation> ops;
+    srand(1);
+    for (long i = 0; i < n; i++) {
+        float a_float = ldexpf(static_cast<float>(rand()) / RAND_MAX + 0.5f, rand() % 16 - 8);
+        float b_float = ldexpf(static_cast<float>(rand()) / RAND_MAX + 0.5f, rand() % 16 - 8);
+        Operation o = {rand() % 4, 0, 0};
+        if (rand() % 4 == 0) {
+            const float trivial[] = {0.0f, 1.0f, -1.0f, 2.0f, 0.5f, 0.25f};
+            b_float = (o.op < FPU_MUL) ? 0.0f : trivial[rand() % 6];
+            a_float = (o.op == FPU_DIV && rand() % 3 == 0) ? 0.0f : a_float;
+        }
+        memcpy(&o.a, &a_float, 4);
+        memcpy(&o.b, &b_float, 4);
+        ops.push_back(o);
+    }
+    return ops;
+}
+
+int sc_main(int argc, char* argv[]) {
+    std::string path;
+    cout << "Enter the trace file (or 'synthetic'): ";
+    cin >> path;
+    std::vector<Operation> ops;
+    if (path == "synthetic") {
+        long n;
+        cout << "Enter the number of operations: ";
+        cin >> n;
+        ops = synthetic_workload(n > 0 ? n : 0);
+    } else {
+        fptrace::TraceReader reader;
+        fptrace::Opcode op;
+        Operation o;
+        if (reader.open(path.c_str())) {
+            while (reader.next(op, o.a, o.b)) {
+                o.op = op;
+                ops.push_back(o);
+            }
+        }
+    }
+    if (ops.empty()) {
+        cout << "Invalid input" << endl;
+        return 1;
+    }
+
+    EarlyOutEngine engine;
+    ModeStats modes[2] = {engine.run(ops, false), engine.run(ops, true)};
+
+    cout << ops.size() << " operations" << endl;
+    cout << "       ops    early-out   mean latency (full -> early-out)" << endl;
+    for (int u = 0; u < 4; u++) {
+        long count = std::max(modes[1].count[u], 1L);
+        printf("%s %9ld %10.1f%%   %6.2f -> %6.2f cycles\n", op_names[u], modes[1].count[u], 100.0 * modes[1].fast[u] / count,
+               static_cast<double>(modes[0].latency[u]) / count, static_cast<double>(modes[1].latency[u]) / count);
+    }
+    long n = ops.size();
+    for (int m = 0; m < 2; m++) {
+        long latency = modes[m].latency[0] + modes[m].latency[1] + modes[m].latency[2] + modes[m].latency[3];
+        printf("%-10s %8ld cycles, mean completion latency %.2f, mean in-order retire latency %.2f, %ld results out of tag order\n",
+               m ? "early-out" : "full", modes[m].cycles, static_cast<double>(latency) / n,
+               static_cast<double>(modes[m].retire_latency) / n, modes[m].reorders);
+    }
+    double full = modes[0].latency[0] + modes[0].latency[1] + modes[0].latency[2] + modes[0].latency[3];
+    double early = modes[1].latency[0] + modes[1].latency[1] + modes[1].latency[2] + modes[1].latency[3];
+    printf("Average latency reduction %.1f%%, in-order retire latency reduction %.1f%%, run time %.1f%%\n",
+           100 * (1 - early / full), 100 * (1 - static_cast<double>(modes[1].retire_latency) / modes[0].retire_latency),
+           100.0 * modes[1].cycles / modes[0].cycles - 100);
+    cout << "Early-out results differing from IEEE: " << modes[1].fast_ieee_mismatches
+         << ", from the full datapath: " << modes[1].fast_pipeline_differences << endl;
+    cout << "Datapath mismatches vs functional models: " << modes[0].slow_mismatches + modes[1].slow_mismatches << endl;
+    return 0;
+}
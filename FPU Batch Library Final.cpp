@@ -0,0 +1,258 @@
+#include <systemc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <bitset>
+#include <chrono>
+#include <deque>
+#include <string>
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "fpu_models.h"
+#include "fpu_pipelines.h"
+
+// C ABI batch interface. Build as a shared library against SystemC:
+//
+//   g++ -std=c++17 -O2 -fPIC -shared -I$SYSTEMC_HOME/include "FPU Batch Library Final.cpp" \
+//       -o libfpubatch.so -L$SYSTEMC_HOME/lib -lsystemc -lpthread
+//
+// and call it from C, or through ctypes/cffi with uint32 views of float32 arrays.
+// The demo sc_main at the end is only compiled with -DFPU_BATCH_DEMO, so the
+// library links into a SystemC host that has its own. Building with
+// -DFPU_BATCH_DEMO and without -fPIC -shared gives the self-test executable.
+//
+//   int fpu_run_batch(int op, const uint32_t* a, const uint32_t* b, uint32_t* out, size_t n);
+//   unsigned long long fpu_simulated_ns(void);
+//
+// op is FPU_ADD, FPU_SUB, FPU_MUL or FPU_DIV, optionally OR'ed with
+// FPU_CYCLE_ACCURATE. Operands and results stay in the caller's buffers and are
+// read and written in place. The default fast model is the bit-exact
+// functional model, so any number of threads may run batches at once. With
+// FPU_CYCLE_ACCURATE the batch streams through the elaborated SystemC Tops at one
+// operation per clock period. There is only one SystemC kernel, so it runs on
+// its own worker thread and batches from concurrent callers queue up for it.
+// The worker is stopped and joined when the library is unloaded or the process
+// exits.
+// Returns 0 on success, -1 for a bad op and -2 for a null buffer.
+#define FPU_ADD 0
+#define FPU_SUB 1
+#define FPU_MUL 2
+#define FPU_DIV 3
+#define FPU_CYCLE_ACCURATE 0x100
+
+// Issue/result timing of each Top in 1 ns simulation steps
+const int issue_period[4] = {1, 1, 1, 10};
+const int result_delay[4] = {2, 2, 2, 10};
+
+struct PipelineJob {
+    int op;
+    const uint32_t* a;
+    const uint32_t* b;
+    uint32_t* out;
+    size_t n;
+    bool done;
+};
+
+// PipelineWorker
+// Owns the SystemC kernel: elaborates the four Tops on its own thread and runs
+// queued batches one at a time, always from that thread. step is only written by
+// that thread but read by fpu_simulated_ns from any caller, so it is atomic.
+struct PipelineWorker {
+    addition::Top* adder;
+    subtraction::Top* subtractor;
+    multiplication::Top* multiplier;
+    division::Top* divider;
+    std::atomic<long> step;
+    std::mutex mutex;
+    std::condition_variable job_ready;
+    std::condition_variable job_done;
+    std::deque<PipelineJob*> jobs;
+    bool stopping;
+    std::thread worker;
+
+    PipelineWorker() : step(0), stopping(false) {
+        worker = std::thread(&PipelineWorker::run, this);
+    }
+
+    // Lets the worker finish any queued batches, then stops and joins it
+    ~PipelineWorker() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        job_ready.notify_one();
+        worker.join();
+    }
+
+    void issue(int op, uint32_t a, uint32_t b) {
+        switch (op) {
+        case FPU_ADD: adder->a.write(a); adder->b.write(b); break;
+        case FPU_SUB: subtractor->a.write(a); subtractor->b.write(b); break;
+        case FPU_MUL: multiplier->a.write(a); multiplier->b.write(b); break;
+        default: divider->a.write(a); divider->b.write(b); break;
+        }
+    }
+
+    uint32_t result(int op) {
+        switch (op) {
+        case FPU_ADD: return adder->normalized_result.read();
+        case FPU_SUB: return subtractor->normalized_result.read();
+        case FPU_MUL: return multiplier->normalized_result.read();
+        default: return divider->result.read();
+        }
+    }
+
+    // One operation enters per issue period; each result is read on the step
+    // its last stage fires
+    void stream(PipelineJob& job) {
+        std::deque<long> ready;
+        size_t issued = 0, completed = 0;
+        while (completed < job.n) {
+            if (issued < job.n && step % issue_period[job.op] == 0) {
+                issue(job.op, job.a[issued], job.b[issued]);
+                ready.push_back(step + result_delay[job.op]);
+                issued++;
+            }
+            sc_start(1, SC_NS);
+            if (!ready.empty() && ready.front() == step) {
+                job.out[completed++] = result(job.op);
+                ready.pop_front();
+            }
+            step++;
+        }
+    }
+
+    void run() {
+        adder = new addition::Top("Adder");
+        subtractor = new subtraction::Top("Subtractor");
+        multiplier = new multiplication::Top("Multiplier");
+        divider = new division::Top("Divider");
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            job_ready.wait(lock, [this] { return stopping || !jobs.empty(); });
+            if (jobs.empty()) {
+                return;
+            }
+            PipelineJob* job = jobs.front();
+            jobs.pop_front();
+            lock.unlock();
+            stream(*job);
+            lock.lock();
+            job->done = true;
+            job_done.notify_all();
+        }
+    }
+
+    void submit(PipelineJob& job) {
+        std::unique_lock<std::mutex> lock(mutex);
+        jobs.push_back(&job);
+        job_ready.notify_one();
+        job_done.wait(lock, [&job] { return job.done; });
+    }
+
+    static PipelineWorker& instance() {
+        static PipelineWorker worker;
+        return worker;
+    }
+};
+
+extern "C" int fpu_run_batch(int op, const uint32_t* a, const uint32_t* b, uint32_t* out, size_t n) {
+    int unit = op & ~FPU_CYCLE_ACCURATE;
+    if (unit < FPU_ADD || unit > FPU_DIV) {
+        return -1;
+    }
+    if (n == 0) {
+        return 0;
+    }
+    if (!a || !b || !out) {
+        return -2;
+    }
+    if (op & FPU_CYCLE_ACCURATE) {
+        PipelineJob job = {unit, a, b, out, n, false};
+        PipelineWorker::instance().submit(job);
+        return 0;
+    }
+    unsigned int (*model)(unsigned int, unsigned int) = (unit == FPU_ADD) ? addition_function
+                                                      : (unit == FPU_SUB) ? subtraction_function
+                                                      : (unit == FPU_MUL) ? multiplication_function
+                                                      : division_function;
+    for (size_t i = 0; i < n; i++) {
+        out[i] = model(a[i], b[i]);
+    }
+    return 0;
+}
+
+extern "C" unsigned long long fpu_simulated_ns(void) {
+    return PipelineWorker::instance().step.load();
+}
+
+#ifdef FPU_BATCH_DEMO
+// Self-test and benchmark when built as an executable: concurrent batches on both
+// models, checked against each other
+int sc_main(int argc, char* argv[]) {
+    int n, threads;
+    cout << "Enter the number of operations per unit: ";
+    cin >> n;
+    cout << "Enter the number of calling threads: ";
+    cin >> threads;
+    if (n <= 0 || threads <= 0) {
+        cout << "Invalid input" << endl;
+        return 1;
+    }
+
+    srand(1);
+    std::vector<uint32_t> a(n), b(n);
+    for (int i = 0; i < n; i++) {
+        float a_float = ldexpf(static_cast<float>(rand()) / RAND_MAX, rand() % 16 - 8);
+        float b_float = ldexpf(static_cast<float>(rand()) / RAND_MAX, rand() % 16 - 8);
+        memcpy(&a[i], &a_float, 4);
+        memcpy(&b[i], &b_float, 4);
+    }
+
+    const char* op_names[] = {"add", "sub", "mul", "div"};
+    for (int model = 0; model < 2; model++) {
+        std::vector<std::vector<uint32_t>> out(4, std::vector<uint32_t>(n));
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        std::vector<std::thread> callers;
+        for (int t = 0; t < threads; t++) {
+            callers.push_back(std::thread([&, t] {
+                // Each thread takes a slice of every unit's batch
+                size_t begin = static_cast<size_t>(n) * t / threads, end = static_cast<size_t>(n) * (t + 1) / threads;
+                for (int op = 0; op < 4; op++) {
+                    fpu_run_batch(op | (model ? FPU_CYCLE_ACCURATE : 0), &a[begin], &b[begin], &out[op][begin], end - begin);
+                }
+            }));
+        }
+        for (size_t t = 0; t < callers.size(); t++) {
+            callers[t].join();
+        }
+        double host = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        int mismatches = 0;
+        for (int op = 0; op < 4; op++) {
+            for (int i = 0; i < n; i++) {
+                uint32_t expected;
+                fpu_run_batch(op, &a[i], &b[i], &expected, 1);
+                mismatches += (out[op][i] != expected);
+            }
+        }
+        cout << (model ? "Cycle-accurate" : "Fast") << " model: " << 4 * n << " ops on " << threads << " threads, host "
+             << host * 1e3 << " ms (" << host * 1e9 / (4.0 * n) << " ns/op), mismatches vs fast model " << mismatches;
+        if (model) {
+            cout << ", simulated " << fpu_simulated_ns() << " ns";
+        }
+        cout << endl;
+        float a0, b0, r0;
+        memcpy(&a0, &a[0], 4);
+        memcpy(&b0, &b[0], 4);
+        for (int op = 0; op < 4 && model == 0; op++) {
+            memcpy(&r0, &out[op][0], 4);
+            cout << "  " << op_names[op] << " " << a0 << ", " << b0 << " = " << r0 << endl;
+        }
+    }
+    return 0;
+}
+#endif
@@ -0,0 +1,298 @@
+#include <systemc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <bitset>
+#include <algorithm>
+#include <deque>
+#include <string>
+#include <vector>
+#include "fpu_models.h"
+#include "fpu_pipelines.h"
+#include "traced_float.h"
+
+enum FpuOp { FPU_ADD, FPU_SUB, FPU_MUL, FPU_DIV };
+const char* unit_names[] = {"adder", "subtractor", "multiplier", "divider"};
+
+// Issue/result timing of each Top in 1 ns cycles, as in the simulation server
+const int issue_period[4] = {1, 1, 1, 10};
+const int result_delay[4] = {2, 2, 2, 10};
+#define REQUEST_QUEUE_DEPTH 8
+
+// Synthetic operation mix in percent: add, sub, mul, div
+const int synthetic_mix[4] = {40, 10, 40, 10};
+
+struct Request {
+    int op;
+    uint32_t a;
+    uint32_t b;
+    int requester;
+    long created;
+    long issued;
+    long ready;
+};
+
+struct RequesterStats {
+    long generated;
+    long blocked;
+    long completed;
+    long wait_total;
+    long wait_max;
+    long latency_total;
+};
+
+// FpuCluster
+// M requesters, each with a request queue whose head is presented to the
+// crossbar, and K instances of every Top. Each cycle the arbiter of a unit type
+// hands the instances that can take operands to the requesters whose head request
+// targets that type, round-robin from the last grant or by fixed priority
+// (lowest requester first).
+struct FpuCluster {
+    int requesters;
+    int instances;
+    bool round_robin;
+    std::vector<addition::Top*> adders;
+    std::vector<subtraction::Top*> subtractors;
+    std::vector<multiplication::Top*> multipliers;
+    std::vector<division::Top*> dividers;
+    std::vector<std::deque<Request> > queues;
+    std::vector<std::deque<Request> > in_flight[4];
+    std::vector<long> issued[4];
+    std::vector<RequesterStats> stats;
+    int pointer[4];
+    long cycle;
+    long mismatches;
+
+    FpuCluster(int requesters, int instances, bool round_robin)
+        : requesters(requesters), instances(instances), round_robin(round_robin), queues(requesters),
+          stats(requesters), cycle(0), mismatches(0) {
+        for (int k = 0; k < instances; k++) {
+            std::string suffix = std::to_string(k);
+            adders.push_back(new addition::Top(("Adder" + suffix).c_str()));
+            subtractors.push_back(new subtraction::Top(("Subtractor" + suffix).c_str()));
+            multipliers.push_back(new multiplication::Top(("Multiplier" + suffix).c_str()));
+            dividers.push_back(new division::Top(("Divider" + suffix).c_str()));
+        }
+        for (int u = 0; u < 4; u++) {
+            in_flight[u].resize(instances);
+            issued[u].assign(instances, 0);
+            pointer[u] = 0;
+        }
+        memset(&stats[0], 0, requesters * sizeof(RequesterStats));
+    }
+
+    // Queues a request, or counts it as blocked when the requester's queue is full
+    bool submit(int requester, int op, uint32_t a, uint32_t b) {
+        stats[requester].generated++;
+        if (queues[requester].size() >= REQUEST_QUEUE_DEPTH) {
+            stats[requester].blocked++;
+            return false;
+        }
+        Request r = {op, a, b, requester, cycle, 0, 0};
+        queues[requester].push_back(r);
+        return true;
+    }
+
+    void start_unit(int op, int k, uint32_t a, uint32_t b) {
+        switch (op) {
+        case FPU_ADD: adders[k]->a.write(a); adders[k]->b.write(b); break;
+        case FPU_SUB: subtractors[k]->a.write(a); subtractors[k]->b.write(b); break;
+        case FPU_MUL: multipliers[k]->a.write(a); multipliers[k]->b.write(b); break;
+        default: dividers[k]->a.write(a); dividers[k]->b.write(b); break;
+        }
+    }
+
+    uint32_t unit_result(int op, int k) {
+        switch (op) {
+        case FPU_ADD: return adders[k]->normalized_result.read();
+        case FPU_SUB: return subtractors[k]->normalized_result.read();
+        case FPU_MUL: return multipliers[k]->normalized_result.read();
+        default: return dividers[k]->result.read();
+        }
+    }
+
+    void arbitrate() {
+        for (int u = 0; u < 4; u++) {
+            if (cycle % issue_period[u] != 0) {
+                continue;
+            }
+            int granted = 0;
+            int first = round_robin ? pointer[u] : 0;
+            for (int i = 0; i < requesters && granted < instances; i++) {
+                int r = (first + i) % requesters;
+                if (queues[r].empty() || queues[r].front().op != u) {
+                    continue;
+                }
+                Request req = queues[r].front();
+                queues[r].pop_front();
+                req.issued = cycle;
+                req.ready = cycle + result_delay[u];
+                start_unit(u, granted, req.a, req.b);
+                in_flight[u][granted].push_back(req);
+                issued[u][granted]++;
+                stats[r].wait_total += req.issued - req.created;
+                stats[r].wait_max = std::max(stats[r].wait_max, req.issued - req.created);
+                pointer[u] = (r + 1) % requesters;
+                granted++;
+            }
+        }
+    }
+
+    void retire() {
+        for (int u = 0; u < 4; u++) {
+            for (int k = 0; k < instances; k++) {
+                if (in_flight[u][k].empty() || in_flight[u][k].front().ready != cycle) {
+                    continue;
+                }
+                const Request& req = in_flight[u][k].front();
+                uint32_t model = (u == FPU_ADD) ? addition_function(req.a, req.b)
+                               : (u == FPU_SUB) ? subtraction_function(req.a, req.b)
+                               : (u == FPU_MUL) ? multiplication_function(req.a, req.b)
+                               : division_function(req.a, req.b);
+                mismatches += (unit_result(u, k) != model);
+                stats[req.requester].completed++;
+                stats[req.requester].latency_total += cycle + 1 - req.created;
+                in_flight[u][k].pop_front();
+            }
+        }
+    }
+
+    bool busy() {
+        for (int r = 0; r < requesters; r++) {
+            if (!queues[r].empty()) {
+                return true;
+            }
+        }
+        for (int u = 0; u < 4; u++) {
+            for (int k = 0; k < instances; k++) {
+                if (!in_flight[u][k].empty()) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    void step() {
+        arbitrate();
+        sc_start(1, SC_NS);
+        retire();
+        cycle++;
+    }
+};
+
+uint32_t random_operand() {
+    float value = ldexpf(static_cast<float>(rand()) / RAND_MAX, rand() % 16 - 8);
+    uint32_t bits;
+    memcpy(&bits, &value, 4);
+    return bits;
+}
+
+// Every requester injects with the given probability per cycle for the given
+// number of cycles; the cluster then drains
+void run_synthetic(FpuCluster& cluster, double rate, long cycles) {
+    srand(1);
+    for (long c = 0; c < cycles; c++) {
+        for (int r = 0; r < cluster.requesters; r++) {
+            if (static_cast<double>(rand()) / RAND_MAX >= rate) {
+                continue;
+            }
+            int pick = rand() % 100, op = 0;
+            while (pick >= synthetic_mix[op]) {
+                pick -= synthetic_mix[op++];
+            }
+            uint32_t a = random_operand();
+            cluster.submit(r, op, a, random_operand());
+        }
+        cluster.step();
+    }
+    while (cluster.busy()) {
+        cluster.step();
+    }
+}
+
+// Trace records are dealt to the requesters in turn; each requester keeps its
+// queue full until its share of the trace is exhausted
+void run_trace(FpuCluster& cluster, fptrace::TraceReader& reader) {
+    std::vector<std::deque<Request> > shares(cluster.requesters);
+    fptrace::Opcode op;
+    uint32_t a, b;
+    for (long i = 0; reader.next(op, a, b); i++) {
+        Request r = {op, a, b, static_cast<int>(i % cluster.requesters), 0, 0, 0};
+        shares[r.requester].push_back(r);
+    }
+    bool pending = true;
+    while (pending || cluster.busy()) {
+        pending = false;
+        for (int r = 0; r < cluster.requesters; r++) {
+            while (!shares[r].empty() && cluster.queues[r].size() < REQUEST_QUEUE_DEPTH) {
+                cluster.submit(r, shares[r].front().op, shares[r].front().a, shares[r].front().b);
+                shares[r].pop_front();
+            }
+            pending = pending || !shares[r].empty();
+        }
+        cluster.step();
+    }
+}
+
+int sc_main(int argc, char* argv[]) {
+    int requesters, instances, arbiter, load;
+    cout << "Enter the number of requesters: ";
+    cin >> requesters;
+    cout << "Enter the number of instances of each unit: ";
+    cin >> instances;
+    cout << "Enter the arbiter (1 = round-robin, 2 = fixed priority): ";
+    cin >> arbiter;
+    cout << "Enter the load (1 = synthetic, 2 = trace file): ";
+    cin >> load;
+    if (requesters <= 0 || instances <= 0 || (arbiter != 1 && arbiter != 2) || (load != 1 && load != 2)) {
+        cout << "Invalid input" << endl;
+        return 1;
+    }
+
+    FpuCluster cluster(requesters, instances, arbiter == 1);
+    if (load == 1) {
+        double rate;
+        long cycles;
+        cout << "Enter the injection rate per requester (operations/cycle): ";
+        cin >> rate;
+        cout << "Enter the number of cycles: ";
+        cin >> cycles;
+        if (rate <= 0 || rate > 1 || cycles <= 0) {
+            cout << "Invalid input" << endl;
+            return 1;
+        }
+        run_synthetic(cluster, rate, cycles);
+    } else {
+        std::string path;
+        cout << "Enter the trace file: ";
+        cin >> path;
+        fptrace::TraceReader reader;
+        if (!reader.open(path.c_str())) {
+            cout << "Invalid input" << endl;
+            return 1;
+        }
+        run_trace(cluster, reader);
+    }
+
+    cout << "Ran " << cluster.cycle << " cycles" << endl;
+    cout << "Wait (queued until issued) and latency in cycles" << endl;
+    cout << "Requester  completed  ops/cycle   mean wait   max wait  mean latency  blocked" << endl;
+    for (int r = 0; r < requesters; r++) {
+        const RequesterStats& s = cluster.stats[r];
+        double completed = (s.completed > 0) ? s.completed : 1;
+        printf("%9d %10ld %10.3f %11.2f %10ld %13.2f %8ld\n", r, s.completed, static_cast<double>(s.completed) / cluster.cycle,
+               s.wait_total / completed, s.wait_max, s.latency_total / completed, s.blocked);
+    }
+    cout << "Unit utilisation:" << endl;
+    for (int u = 0; u < 4; u++) {
+        cout << unit_names[u] << ":";
+        for (int k = 0; k < instances; k++) {
+            cout << " " << 100.0 * cluster.issued[u][k] * issue_period[u] / cluster.cycle << "%";
+        }
+        cout << endl;
+    }
+    cout << "Mismatches vs functional models: " << cluster.mismatches << endl;
+    return 0;
+}
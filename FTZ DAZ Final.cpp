@@ -0,0 +1,201 @@
+#include <systemc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+#include <bitset>
+#include <chrono>
+#include "fpu_models.h"
+#include "fpu_pipelines.h"
+
+enum FpuOp { FPU_ADD, FPU_SUB, FPU_MUL, FPU_DIV };
+const char* unit_names[] = {"adder", "subtractor", "multiplier", "divider"};
+
+// Issue/result timing of each Top in 1 ns cycles, the same in both modes; the
+// divider's clock is ten cycles long
+const int issue_period[4] = {1, 1, 1, 10};
+const int result_delay[4] = {2, 2, 2, 10};
+
+uint32_t float_bits(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, 4);
+    return bits;
+}
+
+float bits_float(uint32_t bits) {
+    float value;
+    memcpy(&value, &bits, 4);
+    return value;
+}
+
+uint32_t functional(int op, uint32_t a, uint32_t b) {
+    return (op == FPU_ADD) ? addition_function(a, b)
+         : (op == FPU_SUB) ? subtraction_function(a, b)
+         : (op == FPU_MUL) ? multiplication_function(a, b)
+         : division_function(a, b);
+}
+
+uint32_t daz(uint32_t x) {
+    return ((x & 0x7F800000) == 0) ? (x & 0x80000000) : x;
+}
+
+bool subnormal(uint32_t x) {
+    return (x & 0x7F800000) == 0 && (x & 0x7FFFFF) != 0;
+}
+
+double exact_result(int op, uint32_t a, uint32_t b) {
+    double x = bits_float(a), y = bits_float(b);
+    return (op == FPU_ADD) ? x + y : (op == FPU_SUB) ? x - y : (op == FPU_MUL) ? x * y : x / y;
+}
+
+// Expected FTZ/DAZ result: the IEEE-mode model on the flushed operands, except
+// that zero operands of the divider and results that are zero or below the
+// smallest normal are compared by magnitude
+bool ftz_matches(int op, uint32_t a, uint32_t b, uint32_t r) {
+    uint32_t fa = daz(a), fb = daz(b);
+    bool a_zero = (fa & 0x7FFFFFFF) == 0, b_zero = (fb & 0x7FFFFFFF) == 0;
+    if (op == FPU_DIV && b_zero) {
+        return (r & 0x7FFFFFFF) == (a_zero ? 0x7FC00000u : 0x7F800000u);
+    }
+    double exact = exact_result(op, fa, fb);
+    if (fabs(exact) < FLT_MIN) {
+        return (r & 0x7FFFFFFF) == 0;
+    }
+    return r == functional(op, fa, fb);
+}
+
+// Operands: mostly moderate normals, with subnormals, zeros and normals just
+// above the underflow threshold so that sums, products and quotients underflow
+uint32_t random_operand() {
+    int kind = rand() % 100;
+    float value = static_cast<float>(rand()) / RAND_MAX + 0.5f;
+    if (kind < 15) {
+        value = ldexpf(value, -127 - rand() % 20);
+    } else if (kind < 30) {
+        value = ldexpf(value, -126 + rand() % 4);
+    } else if (kind < 33) {
+        value = 0.0f;
+    } else {
+        value = ldexpf(value, rand() % 16 - 8);
+    }
+    return float_bits((rand() % 2) ? -value : value);
+}
+
+// FtzUnits
+// One IEEE-mode and one FTZ/DAZ-mode instance of every Top, all stepped in 1 ns
+// cycles; the dividers keep the 10 ns clock of Division Final.
+struct FtzUnits {
+    addition::Top* adders[2];
+    subtraction::Top* subtractors[2];
+    multiplication::Top* multipliers[2];
+    division::Top* dividers[2];
+    sc_time step;
+
+    FtzUnits() : step(1, SC_NS) {
+        for (int mode = 0; mode < 2; mode++) {
+            std::string suffix = mode ? "Ftz" : "Ieee";
+            adders[mode] = new addition::Top(("Adder" + suffix).c_str(), mode, step);
+            subtractors[mode] = new subtraction::Top(("Subtractor" + suffix).c_str(), mode, step);
+            multipliers[mode] = new multiplication::Top(("Multiplier" + suffix).c_str(), mode, step);
+            dividers[mode] = new division::Top(("Divider" + suffix).c_str(), mode, step * 10);
+        }
+    }
+
+    void start_unit(int op, int mode, uint32_t a, uint32_t b) {
+        switch (op) {
+        case FPU_ADD: adders[mode]->a.write(a); adders[mode]->b.write(b); break;
+        case FPU_SUB: subtractors[mode]->a.write(a); subtractors[mode]->b.write(b); break;
+        case FPU_MUL: multipliers[mode]->a.write(a); multipliers[mode]->b.write(b); break;
+        default: dividers[mode]->a.write(a); dividers[mode]->b.write(b); break;
+        }
+    }
+
+    uint32_t unit_result(int op, int mode) {
+        switch (op) {
+        case FPU_ADD: return adders[mode]->normalized_result.read();
+        case FPU_SUB: return subtractors[mode]->normalized_result.read();
+        case FPU_MUL: return multipliers[mode]->normalized_result.read();
+        default: return dividers[mode]->result.read();
+        }
+    }
+
+    // Streams the operand pairs through one instance at its full issue rate
+    // and returns the number of 1 ns cycles taken
+    long stream(int op, int mode, const std::vector<uint32_t>& a, const std::vector<uint32_t>& b, std::vector<uint32_t>& out) {
+        // Start on a clock edge of this instance
+        long period = issue_period[op];
+        long offset = llround(sc_time_stamp() / step) % period;
+        if (offset != 0) {
+            sc_start(step * static_cast<double>(period - offset));
+        }
+        long n = a.size(), cycle = 0;
+        for (long next = 0, done = 0; done < n; cycle++) {
+            if (next < n && cycle % issue_period[op] == 0) {
+                start_unit(op, mode, a[next], b[next]);
+                next++;
+            }
+            sc_start(step);
+            if (cycle >= result_delay[op] && (cycle - result_delay[op]) % issue_period[op] == 0) {
+                out[done++] = unit_result(op, mode);
+            }
+        }
+        return cycle;
+    }
+};
+
+int sc_main(int argc, char* argv[]) {
+    long n;
+    cout << "Enter the number of operations per unit: ";
+    cin >> n;
+    if (n <= 0) {
+        cout << "Invalid input" << endl;
+        return 1;
+    }
+
+    FtzUnits units;
+    srand(1);
+    cout << "Unit        subnormal in  underflows  IEEE subnormal out  FTZ subnormal out  FTZ mismatches  normal-range differences" << endl;
+    long cycles[4][2];
+    double host[4][2];
+    for (int op = 0; op < 4; op++) {
+        std::vector<uint32_t> a(n), b(n), out[2] = {std::vector<uint32_t>(n), std::vector<uint32_t>(n)};
+        for (long i = 0; i < n; i++) {
+            a[i] = random_operand();
+            b[i] = random_operand();
+        }
+        for (int mode = 0; mode < 2; mode++) {
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            cycles[op][mode] = units.stream(op, mode, a, b, out[mode]);
+            host[op][mode] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        long subnormal_in = 0, underflows = 0, ieee_subnormal = 0, ftz_subnormal = 0, mismatches = 0, differences = 0;
+        for (long i = 0; i < n; i++) {
+            double exact = exact_result(op, a[i], b[i]);
+            bool in_range = !subnormal(a[i]) && !subnormal(b[i]) && (a[i] & 0x7FFFFFFF) && (b[i] & 0x7FFFFFFF) &&
+                            fabs(exact_result(op, daz(a[i]), daz(b[i]))) >= FLT_MIN;
+            subnormal_in += subnormal(a[i]) || subnormal(b[i]);
+            underflows += exact != 0 && fabs(exact) < FLT_MIN;
+            ieee_subnormal += subnormal(out[0][i]);
+            ftz_subnormal += subnormal(out[1][i]);
+            mismatches += !ftz_matches(op, a[i], b[i], out[1][i]);
+            differences += in_range && out[0][i] != out[1][i];
+        }
+        printf("%-11s %13ld %11ld %19ld %18ld %15ld %25ld\n", unit_names[op], subnormal_in, underflows, ieee_subnormal,
+               ftz_subnormal, mismatches, differences);
+    }
+
+    // FTZ/DAZ only changes what the stages compute, not how many there are, so
+    // the simulated cycle counts are the measured throughput of both modes. A
+    // shorter clock from the removed denormal logic is not modelled.
+    cout << endl << "Unit        simulated cycles      Mops/s at 1 ns         host Mops/s" << endl;
+    cout << "                IEEE      FTZ       IEEE      FTZ       IEEE      FTZ" << endl;
+    for (int op = 0; op < 4; op++) {
+        printf("%-11s %8ld %8ld %10.1f %8.1f %10.3f %8.3f\n", unit_names[op], cycles[op][0], cycles[op][1],
+               n * 1e3 / cycles[op][0], n * 1e3 / cycles[op][1], n / host[op][0] / 1e6, n / host[op][1] / 1e6);
+    }
+    cout << "(FTZ/DAZ removes no pipeline stage, so simulated throughput is the same in both modes; a faster" << endl
+         << " clock from the shorter denormal-free paths is not modelled)" << endl;
+    return 0;
+}
@@ -0,0 +1,430 @@
+#include <systemc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <bitset>
+#include <deque>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include "fpu_models.h"
+#include "fpu_pipelines.h"
+
+enum FpuOp { FPU_ADD, FPU_SUB, FPU_MUL, FPU_DIV };
+const char* op_names[] = {"add", "sub", "mul", "div"};
+
+// DagNode
+// One FP operation of the dataflow graph. A source is either an earlier node
+// (src >= 0) or a literal operand (src == -1).
+struct DagNode {
+    std::string name;
+    int op;
+    int src[2];
+    uint32_t literal[2];
+    uint32_t value;
+    long ready;
+    long issue_cycle;
+    bool issued;
+    long depth;
+    int critical_source;
+};
+
+// Unit timing in cycles. latency is issue to first dependent issue, interval the
+// initiation interval and align the issue grid of the unit's clock.
+struct UnitTiming {
+    int latency;
+    int interval;
+    int align;
+};
+
+// Stall reasons of a cycle in which nothing issued
+enum StallReason { STALL_RAW_ADD, STALL_RAW_SUB, STALL_RAW_MUL, STALL_RAW_DIV, STALL_BUSY_ADD, STALL_BUSY_SUB,
+                   STALL_BUSY_MUL, STALL_BUSY_DIV, STALL_DRAIN, STALL_COUNT };
+const char* stall_names[] = {"waiting on add", "waiting on sub", "waiting on mul", "waiting on div", "add busy",
+                             "sub busy", "mul busy", "div busy", "drain"};
+
+uint32_t float_bits(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+float random_float() {
+    return ldexpf(static_cast<float>(rand()) / RAND_MAX + 0.5f, rand() % 4 - 2);
+}
+
+// DataflowGraph
+// Nodes in program order; built by the kernels below or read from a text file
+struct DataflowGraph {
+    std::vector<DagNode> nodes;
+    std::map<std::string, int> names;
+
+    int add(const std::string& name, int op, int src0, int src1, float literal0 = 0, float literal1 = 0) {
+        DagNode node;
+        node.name = name;
+        node.op = op;
+        node.src[0] = src0;
+        node.src[1] = src1;
+        node.literal[0] = float_bits(literal0);
+        node.literal[1] = float_bits(literal1);
+        node.value = 0;
+        node.ready = 0;
+        node.issue_cycle = -1;
+        node.issued = false;
+        node.depth = 0;
+        node.critical_source = -1;
+        names[name] = static_cast<int>(nodes.size());
+        nodes.push_back(node);
+        return static_cast<int>(nodes.size()) - 1;
+    }
+
+    // One operation per line: <name> <add|sub|mul|div> <source> <source>, where a
+    // source is an earlier name or a float literal; '#' starts a comment
+    bool load(const char* path) {
+        std::ifstream file(path);
+        std::string line;
+        if (!file) {
+            return false;
+        }
+        while (std::getline(file, line)) {
+            line = line.substr(0, line.find('#'));
+            std::istringstream fields(line);
+            std::string name, op_name, source[2];
+            if (!(fields >> name)) {
+                continue;
+            }
+            if (!(fields >> op_name >> source[0] >> source[1])) {
+                return false;
+            }
+            int op = -1, src[2];
+            float literal[2] = {0, 0};
+            for (int k = 0; k < 4; k++) {
+                op = (op_name == op_names[k]) ? k : op;
+            }
+            if (op < 0) {
+                return false;
+            }
+            for (int s = 0; s < 2; s++) {
+                std::map<std::string, int>::iterator found = names.find(source[s]);
+                src[s] = (found == names.end()) ? -1 : found->second;
+                if (src[s] < 0) {
+                    char* end;
+                    literal[s] = strtof(source[s].c_str(), &end);
+                    if (*end != 0) {
+                        return false;
+                    }
+                }
+            }
+            add(name, op, src[0], src[1], literal[0], literal[1]);
+        }
+        return !nodes.empty();
+    }
+
+    // Longest latency-weighted path: the cycle count with unlimited issue
+    long critical_path(const UnitTiming* timing) {
+        long longest = 0;
+        for (size_t i = 0; i < nodes.size(); i++) {
+            DagNode& node = nodes[i];
+            node.depth = timing[node.op].latency;
+            for (int s = 0; s < 2; s++) {
+                if (node.src[s] >= 0 && nodes[node.src[s]].depth + timing[node.op].latency > node.depth) {
+                    node.depth = nodes[node.src[s]].depth + timing[node.op].latency;
+                    node.critical_source = node.src[s];
+                }
+            }
+            longest = (node.depth > longest) ? node.depth : longest;
+        }
+        return longest;
+    }
+};
+
+// Kernels
+void dot_chain(DataflowGraph& g, int n) {
+    int sum = -1;
+    for (int i = 0; i < n; i++) {
+        int p = g.add("p" + std::to_string(i), FPU_MUL, -1, -1, random_float(), random_float());
+        sum = (sum < 0) ? p : g.add("s" + std::to_string(i), FPU_ADD, sum, p);
+    }
+}
+
+void dot_tree(DataflowGraph& g, int n) {
+    std::vector<int> level;
+    for (int i = 0; i < n; i++) {
+        level.push_back(g.add("p" + std::to_string(i), FPU_MUL, -1, -1, random_float(), random_float()));
+    }
+    for (int depth = 0; level.size() > 1; depth++) {
+        std::vector<int> next;
+        for (size_t i = 0; i + 1 < level.size(); i += 2) {
+            next.push_back(g.add("t" + std::to_string(depth) + "_" + std::to_string(i / 2), FPU_ADD, level[i], level[i + 1]));
+        }
+        if (level.size() % 2) {
+            next.push_back(level.back());
+        }
+        level = next;
+    }
+}
+
+// n independent points, each a degree-8 Horner chain written one after another
+void horner(DataflowGraph& g, int n) {
+    const float coefficients[] = {1.0f / 40320, 1.0f / 5040, 1.0f / 720, 1.0f / 120, 1.0f / 24, 1.0f / 6, 0.5f, 1.0f, 1.0f};
+    for (int i = 0; i < n; i++) {
+        float x = random_float();
+        int p = -1;
+        for (int k = 1; k < 9; k++) {
+            std::string suffix = std::to_string(i) + "_" + std::to_string(k);
+            int t = (p < 0) ? g.add("t" + suffix, FPU_MUL, -1, -1, coefficients[0], x) : g.add("t" + suffix, FPU_MUL, p, -1, 0, x);
+            p = g.add("h" + suffix, FPU_ADD, t, -1, 0, coefficients[k]);
+        }
+    }
+}
+
+void axpy(DataflowGraph& g, int n) {
+    for (int i = 0; i < n; i++) {
+        int t = g.add("ax" + std::to_string(i), FPU_MUL, -1, -1, 1.5f, random_float());
+        g.add("y" + std::to_string(i), FPU_ADD, t, -1, 0, random_float());
+    }
+}
+
+// n Newton steps refining 1/d and then dividing: long dependent chain with the divider
+void newton(DataflowGraph& g, int n) {
+    float d = random_float();
+    int x = g.add("x0", FPU_DIV, -1, -1, 1.0f, d);
+    for (int i = 1; i <= n; i++) {
+        std::string suffix = std::to_string(i);
+        int dx = g.add("dx" + suffix, FPU_MUL, x, -1, 0, d);
+        int e = g.add("e" + suffix, FPU_SUB, -1, dx, 2.0f, 0);
+        x = g.add("x" + suffix, FPU_MUL, x, e);
+        g.add("q" + suffix, FPU_DIV, -1, -1, random_float(), d);
+    }
+}
+
+// Scoreboard
+// Issues graph nodes into the units. Each cycle it scans the oldest `window`
+// unissued nodes in program order and issues every node whose sources are ready
+// and whose unit can accept, at most one per unit; window 1 is strict in-order
+// issue. With pin-level timing the operands go through the four Tops and results
+// are written back when they leave the last stage.
+struct Scoreboard {
+    DataflowGraph& graph;
+    const UnitTiming* timing;
+    int window;
+    bool pin_level;
+    addition::Top* adder;
+    subtraction::Top* subtractor;
+    multiplication::Top* multiplier;
+    division::Top* divider;
+    long unit_free[4];
+    std::deque<int> in_flight[4];
+    long cycle;
+    long issued_ops[4];
+    long stalls[STALL_COUNT];
+
+    Scoreboard(DataflowGraph& graph, const UnitTiming* timing, int window, bool pin_level)
+        : graph(graph), timing(timing), window(window), pin_level(pin_level), cycle(0) {
+        memset(unit_free, 0, sizeof(unit_free));
+        memset(issued_ops, 0, sizeof(issued_ops));
+        memset(stalls, 0, sizeof(stalls));
+        if (pin_level) {
+            adder = new addition::Top("Adder");
+            subtractor = new subtraction::Top("Subtractor");
+            multiplier = new multiplication::Top("Multiplier");
+            divider = new division::Top("Divider");
+        }
+    }
+
+    uint32_t operand(const DagNode& node, int s) {
+        return (node.src[s] >= 0) ? graph.nodes[node.src[s]].value : node.literal[s];
+    }
+
+    bool unit_ready(int op) {
+        return cycle >= unit_free[op] && cycle % timing[op].align == 0;
+    }
+
+    void issue(int index) {
+        DagNode& node = graph.nodes[index];
+        uint32_t a = operand(node, 0), b = operand(node, 1);
+        node.issued = true;
+        node.issue_cycle = cycle;
+        node.ready = cycle + timing[node.op].latency;
+        unit_free[node.op] = cycle + timing[node.op].interval;
+        issued_ops[node.op]++;
+        if (!pin_level) {
+            node.value = (node.op == FPU_ADD) ? addition_function(a, b)
+                       : (node.op == FPU_SUB) ? subtraction_function(a, b)
+                       : (node.op == FPU_MUL) ? multiplication_function(a, b)
+                       : division_function(a, b);
+            return;
+        }
+        switch (node.op) {
+        case FPU_ADD: adder->a.write(a); adder->b.write(b); break;
+        case FPU_SUB: subtractor->a.write(a); subtractor->b.write(b); break;
+        case FPU_MUL: multiplier->a.write(a); multiplier->b.write(b); break;
+        default: divider->a.write(a); divider->b.write(b); break;
+        }
+        in_flight[node.op].push_back(index);
+    }
+
+    // Results leave the last stage one cycle before dependents may issue
+    void write_back() {
+        for (int op = 0; op < 4; op++) {
+            if (!in_flight[op].empty() && graph.nodes[in_flight[op].front()].ready == cycle + 1) {
+                DagNode& node = graph.nodes[in_flight[op].front()];
+                node.value = (op == FPU_ADD) ? static_cast<uint32_t>(adder->normalized_result.read())
+                           : (op == FPU_SUB) ? static_cast<uint32_t>(subtractor->normalized_result.read())
+                           : (op == FPU_MUL) ? static_cast<uint32_t>(multiplier->normalized_result.read())
+                           : static_cast<uint32_t>(divider->result.read());
+                in_flight[op].pop_front();
+            }
+        }
+    }
+
+    long run() {
+        size_t head = 0;
+        long finish = 0;
+        std::vector<DagNode>& nodes = graph.nodes;
+        while (head < nodes.size() || cycle < finish) {
+            bool unit_taken[4] = {false, false, false, false};
+            int issued = 0, blocking = -1;
+            int scanned = 0;
+            for (size_t i = head; i < nodes.size() && scanned < window; i++) {
+                DagNode& node = nodes[i];
+                if (node.issued) {
+                    continue;
+                }
+                scanned++;
+                int raw = -1;
+                for (int s = 0; s < 2; s++) {
+                    if (node.src[s] >= 0 && (!nodes[node.src[s]].issued || nodes[node.src[s]].ready > cycle)) {
+                        raw = nodes[node.src[s]].op;
+                    }
+                }
+                if (raw < 0 && !unit_taken[node.op] && unit_ready(node.op)) {
+                    unit_taken[node.op] = true;
+                    issue(static_cast<int>(i));
+                    finish = (node.ready > finish) ? node.ready : finish;
+                    issued++;
+                } else if (blocking < 0) {
+                    blocking = (raw >= 0) ? STALL_RAW_ADD + raw : STALL_BUSY_ADD + node.op;
+                }
+            }
+            while (head < nodes.size() && nodes[head].issued) {
+                head++;
+            }
+            if (issued == 0) {
+                stalls[(blocking < 0) ? STALL_DRAIN : blocking]++;
+            }
+            if (pin_level) {
+                sc_start(1, SC_NS);
+                write_back();
+            }
+            cycle++;
+        }
+        return cycle;
+    }
+};
+
+int sc_main(int argc, char* argv[]) {
+    int kernel, n = 0, mode, window;
+    std::string path;
+    cout << "Enter the kernel (1 = dot product chain, 2 = dot product tree, 3 = Horner, 4 = AXPY, 5 = Newton reciprocal, 6 = DAG file): ";
+    cin >> kernel;
+    if (kernel == 6) {
+        cout << "Enter the DAG file: ";
+        cin >> path;
+    } else {
+        cout << "Enter the kernel size: ";
+        cin >> n;
+    }
+    cout << "Enter the timing (1 = pin-level Tops, 2 = what-if latencies): ";
+    cin >> mode;
+
+    // Pin-level: a result leaves the normaliser two steps after issue and is
+    // usable on the next; the divider runs on a 10 ns clock
+    UnitTiming timing[4] = {{3, 1, 1}, {3, 1, 1}, {3, 1, 1}, {11, 10, 10}};
+    if (mode == 2) {
+        cout << "Enter latency and initiation interval for add/sub, mul and div: ";
+        cin >> timing[FPU_ADD].latency >> timing[FPU_ADD].interval >> timing[FPU_MUL].latency >> timing[FPU_MUL].interval
+            >> timing[FPU_DIV].latency >> timing[FPU_DIV].interval;
+        timing[FPU_SUB] = timing[FPU_ADD];
+        timing[FPU_DIV].align = 1;
+    }
+    cout << "Enter the issue window (1 = in-order): ";
+    cin >> window;
+    if (kernel < 1 || kernel > 6 || (kernel != 6 && n <= 0) || (mode != 1 && mode != 2) || window <= 0) {
+        cout << "Invalid input" << endl;
+        return 1;
+    }
+    for (int op = 0; op < 4; op++) {
+        if (timing[op].latency < 1 || timing[op].interval < 1) {
+            cout << "Invalid input" << endl;
+            return 1;
+        }
+    }
+
+    DataflowGraph graph;
+    srand(1);
+    switch (kernel) {
+    case 1: dot_chain(graph, n); break;
+    case 2: dot_tree(graph, n); break;
+    case 3: horner(graph, n); break;
+    case 4: axpy(graph, n); break;
+    case 5: newton(graph, n); break;
+    default:
+        if (!graph.load(path.c_str())) {
+            cout << "Invalid DAG file" << endl;
+            return 1;
+        }
+    }
+
+    long critical = graph.critical_path(timing);
+    Scoreboard scoreboard(graph, timing, window, mode == 1);
+    long cycles = scoreboard.run();
+
+    // Functional evaluation in program order as the reference for the values
+    int mismatches = 0;
+    std::vector<uint32_t> reference(graph.nodes.size());
+    for (size_t i = 0; i < graph.nodes.size(); i++) {
+        DagNode& node = graph.nodes[i];
+        uint32_t a = (node.src[0] >= 0) ? reference[node.src[0]] : node.literal[0];
+        uint32_t b = (node.src[1] >= 0) ? reference[node.src[1]] : node.literal[1];
+        reference[i] = (node.op == FPU_ADD) ? addition_function(a, b)
+                     : (node.op == FPU_SUB) ? subtraction_function(a, b)
+                     : (node.op == FPU_MUL) ? multiplication_function(a, b)
+                     : division_function(a, b);
+        mismatches += (reference[i] != node.value);
+    }
+
+    long ops = graph.nodes.size();
+    cout << ops << " ops in " << cycles << " cycles: " << static_cast<double>(ops) / cycles << " ops/cycle" << endl;
+    cout << "Critical path " << critical << " cycles (" << 100.0 * critical / cycles << "% of achieved)";
+    int node = -1;
+    for (size_t i = 0; i < graph.nodes.size(); i++) {
+        node = (node < 0 || graph.nodes[i].depth > graph.nodes[node].depth) ? static_cast<int>(i) : node;
+    }
+    std::vector<std::string> path_names;
+    for (; node >= 0; node = graph.nodes[node].critical_source) {
+        path_names.push_back(graph.nodes[node].name + "(" + op_names[graph.nodes[node].op] + ")");
+    }
+    cout << ", " << path_names.size() << " ops:";
+    for (size_t i = path_names.size(); i-- > 0;) {
+        if (path_names.size() > 12 && i < path_names.size() - 6 && i >= 6) {
+            if (i == 6) {
+                cout << " ...";
+            }
+            continue;
+        }
+        cout << " " << path_names[i];
+    }
+    cout << endl;
+    cout << "Issued: add " << scoreboard.issued_ops[FPU_ADD] << ", sub " << scoreboard.issued_ops[FPU_SUB] << ", mul "
+         << scoreboard.issued_ops[FPU_MUL] << ", div " << scoreboard.issued_ops[FPU_DIV] << endl;
+    cout << "Stall cycles:";
+    for (int s = 0; s < STALL_COUNT; s++) {
+        if (scoreboard.stalls[s]) {
+            cout << " " << stall_names[s] << " " << scoreboard.stalls[s] << ";";
+        }
+    }
+    cout << endl << "Mismatches vs functional evaluation: " << mismatches << endl;
+    return 0;
+}
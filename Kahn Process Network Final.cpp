@@ -0,0 +1,670 @@
+#include <systemc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <bitset>
+#include <chrono>
+#include "fpu_models.h"
+#include "fpu_pipelines.h"
+
+// Kahn process network wiring of the adder. The stages keep the processing of
+// Addition Final but talk over sc_fifo channels: every read blocks until a token
+// arrives, so a process runs once per operation and no clock is needed.
+namespace addition_kpn {
+
+// FloatingPointExtractor Module
+SC_MODULE(FloatingPointExtractor) {
+    sc_fifo_in<sc_uint<32>> a;
+    sc_fifo_in<sc_uint<32>> b;
+    sc_fifo_out<bool> a_sign;
+    sc_fifo_out<sc_uint<8>> a_exp;
+    sc_fifo_out<sc_uint<32>> a_significand;
+    sc_fifo_out<bool> b_sign;
+    sc_fifo_out<sc_uint<8>> b_exp;
+    sc_fifo_out<sc_uint<32>> b_significand;
+    int activations;
+
+    void extraction_process() {
+        while (true) {
+            unsigned int a_in = a.read();
+            unsigned int b_in = b.read();
+            activations++;
+            //Extraction
+            bool a_sign0 = (a_in & 0x80000000) >> 31;
+            unsigned int a_exp0 = (a_in & 0x7f800000) >> 23;
+            unsigned int a_significand0 = (a_in & 0x7fffff);
+
+            bool b_sign0 = (b_in & 0x80000000) >> 31;
+            unsigned int b_exp0 = (b_in & 0x7f800000) >> 23;
+            unsigned int b_significand0 = (b_in & 0x7fffff);
+
+            unsigned int a_significand1 = (a_exp0 >= 1) ? (a_significand0 | (1 << 23)) : a_significand0;
+            unsigned int b_significand1 = (b_exp0 >= 1) ? (b_significand0 | (1 << 23)) : b_significand0;
+
+            unsigned int a_significand2 = (a_significand1 << 7);
+            unsigned int b_significand2 = (b_significand1 << 7);
+
+            unsigned int a_exp1 = ((a_exp0 == 0) ? 1 : a_exp0);
+            unsigned int b_exp1 = ((b_exp0 == 0) ? 1 : b_exp0);
+            //Special Cases
+            if ((a_exp0 == 255 && a_significand0 != 0) || (b_exp0 == 255 && b_significand0 != 0) ||
+                (a_exp0 == 255 && a_significand0 == 0 && b_exp0 == 255 && b_significand0 == 0 && a_sign0 != b_sign0)) {
+                a_sign.write(true);
+                a_exp.write(0x7F);
+                a_significand.write(0x7fffffff);
+                b_sign.write(true);
+                b_exp.write(0x7F);
+                b_significand.write(0x7fffffff);
+            } else if (a_exp0 == 255 && a_significand0 == 0) {
+                a_sign.write(a_sign0);
+                a_exp.write(a_exp0);
+                a_significand.write(a_significand0);
+                b_sign.write(true);
+                b_exp.write(0x7F);
+                b_significand.write(0x7fffffff);
+            } else if (b_exp0 == 255 && b_significand0 == 0) {
+                a_sign.write(true);
+                a_exp.write(0x7F);
+                a_significand.write(0x7fffffff);
+                b_sign.write(b_sign0);
+                b_exp.write(b_exp0);
+                b_significand.write(b_significand0);
+            } else {
+                a_sign.write(a_sign0);
+                a_exp.write(static_cast<sc_uint<8>>(a_exp1));
+                a_significand.write(a_significand2);
+                b_sign.write(b_sign0);
+                b_exp.write(static_cast<sc_uint<8>>(b_exp1));
+                b_significand.write(b_significand2);
+            }
+        }
+    }
+
+    SC_CTOR(FloatingPointExtractor)
+        : a("a"),
+          b("b"),
+          a_sign("a_sign"),
+          a_exp("a_exp"),
+          a_significand("a_significand"),
+          b_sign("b_sign"),
+          b_exp("b_exp"),
+          b_significand("b_significand"),
+          activations(0) {
+        SC_THREAD(extraction_process);
+    }
+};
+
+// FloatingPointAdder Module
+SC_MODULE(FloatingPointAdder) {
+    sc_fifo_in<bool> a_sign;
+    sc_fifo_in<sc_uint<8>> a_exp;
+    sc_fifo_in<sc_uint<32>> a_significand;
+    sc_fifo_in<bool> b_sign;
+    sc_fifo_in<sc_uint<8>> b_exp;
+    sc_fifo_in<sc_uint<32>> b_significand;
+    sc_fifo_out<bool> result_sign;
+    sc_fifo_out<sc_uint<8>> result_exp;
+    sc_fifo_out<sc_uint<32>> result_significand;
+    int activations;
+
+    void addition_process() {
+        while (true) {
+            bool a_sign0 = a_sign.read();
+            unsigned int a_exp0 = a_exp.read();
+            unsigned int a_significand0 = a_significand.read();
+            bool b_sign0 = b_sign.read();
+            unsigned int b_exp0 = b_exp.read();
+            unsigned int b_significand0 = b_significand.read();
+            activations++;
+
+            unsigned int ans_exp;
+            unsigned int ans_significand;
+            bool ans_sign;
+            unsigned int a_significand3 = a_significand0;
+            unsigned int b_significand3 = b_significand0;
+        //Exponent Shifting
+            if (a_exp0 >= b_exp0) {
+                unsigned int shift = a_exp0 - b_exp0;
+                b_significand3 = (b_significand0 >> ((shift > 31) ? 31 : shift));
+                ans_exp = a_exp0;
+            } else {
+                unsigned int shift = b_exp0 - a_exp0;
+                a_significand3 = (a_significand0 >> ((shift > 31) ? 31 : shift));
+                ans_exp = b_exp0;
+            }
+         //Significand shifting and adding
+            if (a_sign0 == b_sign0) {
+                ans_significand = a_significand3 + b_significand3;
+                ans_sign = a_sign0;
+            } else if (a_significand3 > b_significand3) {
+                ans_sign = a_sign0;
+                ans_significand = a_significand3 - b_significand3;
+            } else if (a_significand3 < b_significand3) {
+                ans_sign = b_sign0;
+                ans_significand = b_significand3 - a_significand3;
+            } else {
+                ans_sign = false;
+                ans_significand = 0;
+            }
+
+            result_sign.write(ans_sign);
+            result_exp.write(static_cast<sc_uint<8>>(ans_exp));
+            result_significand.write(ans_significand);
+        }
+    }
+
+    SC_CTOR(FloatingPointAdder)
+        : a_sign("a_sign"),
+          a_exp("a_exp"),
+          a_significand("a_significand"),
+          b_sign("b_sign"),
+          b_exp("b_exp"),
+          b_significand("b_significand"),
+          result_sign("result_sign"),
+          result_exp("result_exp"),
+          result_significand("result_significand"),
+          activations(0) {
+        SC_THREAD(addition_process);
+    }
+};
+
+// FloatingPointNormaliser Module
+SC_MODULE(FloatingPointNormaliser) {
+    sc_fifo_in<bool> result_sign;
+    sc_fifo_in<sc_uint<8>> result_exp;
+    sc_fifo_in<sc_uint<32>> result_significand;
+    sc_fifo_out<sc_uint<32>> nresult;
+    int activations;
+
+    void normal_process() {
+        while (true) {
+            bool ans_sign = result_sign.read();
+            unsigned int ans_exp = result_exp.read();
+            unsigned int ans_significand = result_significand.read();
+            activations++;
+            /* Normalization */
+            int i;
+            for (i = 31; i > 0 && ((ans_significand >> i) == 0); i--) {;}
+
+            if (i > 23) {
+                //Rounding
+                unsigned int twentyfourth = ((ans_significand & (1 << (i - 23 - 1))) >> (i - 23 - 1));
+
+                unsigned int twentyfifth = 0;
+                for (int j = 0; j < i - 23 - 1; j++) {
+                    twentyfifth = twentyfifth | ((ans_significand & (1 << j)) >> j);
+                }
+
+                if ((int(ans_exp) + (i - 23) - 7) > 0 && (int(ans_exp) + (i - 23) - 7) < 255) {
+                    ans_significand = (ans_significand >> (i - 23));
+                    ans_exp = ans_exp + (i - 23) - 7;
+
+                    if (twentyfourth == 1 && twentyfifth == 1) {
+                        ans_significand += 1;
+                    } else if ((ans_significand & 1) == 1 && twentyfourth == 1 && twentyfifth == 0) {
+                        ans_significand += 1;
+                    }
+
+                    if ((ans_significand >> 24) == 1) {
+                        ans_significand = (ans_significand >> 1);
+                        ans_exp += 1;
+                    }
+                }
+                //Overflow
+                else if (int(ans_exp) + (i - 23) - 7 >= 255) {
+                    ans_significand = (1 << 23);
+                    ans_exp = 255;
+                }
+            }
+            // Cancellation: 23 or fewer significant bits are left, all of them exact;
+            // shift them up to the hidden-bit position
+            else if (i > 0) {
+                int shifted_exp = int(ans_exp) + (i - 23) - 7;
+                ans_significand = ans_significand << (23 - i);
+                if (shifted_exp > 0) {
+                    ans_exp = shifted_exp;
+                } else {
+                    ans_significand = (1 - shifted_exp > 24) ? 0 : (ans_significand >> (1 - shifted_exp));
+                    ans_exp = 0;
+                }
+            }
+
+            //When answer is zero
+            if (i == 0 && ans_exp < 255) {
+                ans_exp = 0;
+            }
+
+            unsigned int ans = (ans_sign << 31) | (ans_exp << 23) | (ans_significand & (0x7FFFFF));
+            nresult.write(ans);
+        }
+    }
+
+    SC_CTOR(FloatingPointNormaliser)
+        : result_sign("result_sign"),
+          result_exp("result_exp"),
+          result_significand("result_significand"),
+          nresult("nresult"),
+          activations(0) {
+        SC_THREAD(normal_process);
+    }
+};
+
+// Top-level Module
+SC_MODULE(Top) {
+    FloatingPointExtractor extractor;
+    FloatingPointAdder adder;
+    FloatingPointNormaliser normalization;
+    sc_fifo<sc_uint<32>> a;
+    sc_fifo<sc_uint<32>> b;
+    sc_fifo<bool> a_sign;
+    sc_fifo<sc_uint<8>> a_exp;
+    sc_fifo<sc_uint<32>> a_significands;
+    sc_fifo<bool> b_sign;
+    sc_fifo<sc_uint<8>> b_exp;
+    sc_fifo<sc_uint<32>> b_significands;
+    sc_fifo<bool> result_sign;
+    sc_fifo<sc_uint<8>> result_exp;
+    sc_fifo<sc_uint<32>> result_significand;
+    sc_fifo<sc_uint<32>> normalized_result;
+
+    SC_HAS_PROCESS(Top);
+    Top(sc_module_name name, int depth)
+        : sc_module(name),
+          extractor("Extractor"),
+          adder("Adder"),
+          normalization("Normalization"),
+          a("a", depth),
+          b("b", depth),
+          a_sign("a_sign", depth),
+          a_exp("a_exp", depth),
+          a_significands("a_significands", depth),
+          b_sign("b_sign", depth),
+          b_exp("b_exp", depth),
+          b_significands("b_significands", depth),
+          result_sign("result_sign", depth),
+          result_exp("result_exp", depth),
+          result_significand("result_significand", depth),
+          normalized_result("normalized_result", depth) {
+        extractor.a(a);
+        extractor.b(b);
+        extractor.a_sign(a_sign);
+        extractor.a_exp(a_exp);
+        extractor.a_significand(a_significands);
+        extractor.b_sign(b_sign);
+        extractor.b_exp(b_exp);
+        extractor.b_significand(b_significands);
+
+        adder.a_sign(a_sign);
+        adder.a_exp(a_exp);
+        adder.a_significand(a_significands);
+        adder.b_sign(b_sign);
+        adder.b_exp(b_exp);
+        adder.b_significand(b_significands);
+        adder.result_sign(result_sign);
+        adder.result_exp(result_exp);
+        adder.result_significand(result_significand);
+
+        normalization.result_sign(result_sign);
+        normalization.result_exp(result_exp);
+        normalization.result_significand(result_significand);
+        normalization.nresult(normalized_result);
+    }
+};
+}
+
+// Kahn process network wiring of the multiplier from Multiplication Final
+namespace multiplication_kpn {
+
+// FloatingPointExtractor Module
+SC_MODULE(FloatingPointExtractor) {
+    sc_fifo_in<sc_uint<32>> a;
+    sc_fifo_in<sc_uint<32>> b;
+    sc_fifo_out<bool> a_sign;
+    sc_fifo_out<sc_uint<8>> a_exp;
+    sc_fifo_out<sc_uint<32>> a_significand;
+    sc_fifo_out<bool> b_sign;
+    sc_fifo_out<sc_uint<8>> b_exp;
+    sc_fifo_out<sc_uint<32>> b_significand;
+    int activations;
+
+    void extraction_process() {
+        while (true) {
+            unsigned int a_in = a.read();
+            unsigned int b_in = b.read();
+            activations++;
+     //Extraction
+            bool a_sign0 = (a_in & 0x80000000) >> 31;
+            unsigned int a_exp0 = (a_in & 0x7f800000) >> 23;
+            unsigned int a_significand0 = (a_in & 0x7fffff);
+
+            bool b_sign0 = (b_in & 0x80000000) >> 31;
+            unsigned int b_exp0 = (b_in & 0x7f800000) >> 23;
+            unsigned int b_significand0 = (b_in & 0x7fffff);
+
+            // Special cases
+            if ((a_exp0 == 255 && a_significand0 != 0) || (b_exp0 == 255 && b_significand0 != 0) ||
+                (a_exp0 == 255 && a_significand0 == 0 && b_exp0 == 255 && b_significand0 == 0 && a_sign0 != b_sign0)) {
+                // NaN operand or Infinity - Infinity
+                a_sign.write(true);
+                a_exp.write(255);
+                a_significand.write(0x7fffffff);
+                b_sign.write(true);
+                b_exp.write(255);
+                b_significand.write(0x7fffffff);
+            } else if (a_exp0 == 255 && a_significand0 == 0) {
+                // Case when a is Infinity
+                a_sign.write(a_sign0);
+                a_exp.write(255);
+                a_significand.write(0x7fffffff);
+                b_sign.write(true);
+                b_exp.write(255);
+                b_significand.write(0x7fffffff);
+            } else if (b_exp0 == 255 && b_significand0 == 0) {
+                // Case when b is Infinity
+                a_sign.write(true);
+                a_exp.write(255);
+                a_significand.write(0x7fffffff);
+                b_sign.write(b_sign0);
+                b_exp.write(255);
+                b_significand.write(0x7fffffff);
+            } else {
+                // Normal case
+                a_sign.write(a_sign0);
+                a_exp.write(a_exp0);
+                a_significand.write(a_significand0);
+                b_sign.write(b_sign0);
+                b_exp.write(b_exp0);
+                b_significand.write(b_significand0);
+            }
+        }
+    }
+
+    SC_CTOR(FloatingPointExtractor) : a("a"), b("b"), a_sign("a_sign"), a_exp("a_exp"), a_significand("a_significand"),
+                                     b_sign("b_sign"), b_exp("b_exp"), b_significand("b_significand"), activations(0) {
+        SC_THREAD(extraction_process);
+    }
+};
+
+// FloatingPointMultiplier Module
+SC_MODULE(FloatingPointMultiplier) {
+    sc_fifo_in<bool> a_sign;
+    sc_fifo_in<sc_uint<8>> a_exp;
+    sc_fifo_in<sc_uint<32>> a_significand;
+    sc_fifo_in<bool> b_sign;
+    sc_fifo_in<sc_uint<8>> b_exp;
+    sc_fifo_in<sc_uint<32>> b_significand;
+    sc_fifo_out<bool> result_sign;
+    sc_fifo_out<sc_uint<8>> result_exp;
+    sc_fifo_out<sc_uint<32>> result_significand;
+    sc_fifo_out<sc_uint<32>> result_significand1;
+    int activations;
+
+    void multiply_process() {
+        while (true) {
+            bool aSign = a_sign.read();
+            unsigned int aExponent = a_exp.read();
+            unsigned int aSignificand = a_significand.read();
+
+            bool bSign = b_sign.read();
+            unsigned int bExponent = b_exp.read();
+            unsigned int bSignificand = b_significand.read();
+            activations++;
+
+            // compute sign bit
+            bool resultSign = aSign ^ bSign;
+
+            // compute exponent
+            unsigned int resultExponent = aExponent + bExponent - 0x7F;
+
+            // add implicit `1' bit
+            aSignificand = (aSignificand | 0x00800000) << 7;
+            bSignificand = (bSignificand | 0x00800000) << 8;
+
+            uint64_t resultSignificand = static_cast<uint64_t>(aSignificand) * static_cast<uint64_t>(bSignificand);
+
+            uint32_t resultSignificand0 = static_cast<uint32_t>(resultSignificand >> 32);
+            uint32_t resultSignificand1 = static_cast<uint32_t>(resultSignificand & 0xFFFFFFFF);
+
+            result_sign.write(resultSign);
+            result_exp.write(resultExponent);
+            result_significand.write(resultSignificand0);
+            result_significand1.write(resultSignificand1);
+        }
+    }
+
+    SC_CTOR(FloatingPointMultiplier) : a_sign("a_sign"), a_exp("a_exp"), a_significand("a_significand"),
+                                       b_sign("b_sign"), b_exp("b_exp"), b_significand("b_significand"),
+                                       result_sign("result_sign"), result_exp("result_exp"),
+                                       result_significand("result_significand"),
+                                       result_significand1("result_significand1"), activations(0) {
+        SC_THREAD(multiply_process);
+    }
+};
+
+// FloatingPointNormalizer Module
+// The clocked normaliser never sets its rounding bits, so the 23 fraction bits
+// are taken as they are; this stage does the same without the bit arrays.
+SC_MODULE(FloatingPointNormalizer) {
+    sc_fifo_in<bool> result_sign;
+    sc_fifo_in<sc_uint<8>> result_exp;
+    sc_fifo_in<sc_uint<32>> result_significand;
+    sc_fifo_in<sc_uint<32>> result_significand1;
+    sc_fifo_out<sc_uint<32>> normalized_result;
+    int activations;
+
+    void normalize_process() {
+        while (true) {
+            bool resultSign = result_sign.read();
+            unsigned int resultExponent = result_exp.read();
+            unsigned int resultSignificand0 = result_significand.read();
+            unsigned int resultSignificand1 = result_significand1.read();
+            activations++;
+            // check if we overflowed into more than 23-bits and handle accordingly
+            resultSignificand0 |= (resultSignificand1 != 0);
+            if (0 <= static_cast<int32_t>(resultSignificand0 << 1)) {
+                resultSignificand0 <<= 1;
+                resultExponent--;
+            }
+
+            uint32_t result_value = (resultSign << 31) | ((resultExponent << 23) + (resultSignificand0 >> 7));
+            normalized_result.write(result_value);
+        }
+    }
+
+    SC_CTOR(FloatingPointNormalizer) : result_sign("result_sign"), result_exp("result_exp"),
+                                       result_significand("result_significand"),
+                                       result_significand1("result_significand1"),
+                                       normalized_result("normalized_result"), activations(0) {
+        SC_THREAD(normalize_process);
+    }
+};
+
+SC_MODULE(Top) {
+    FloatingPointExtractor extractor;
+    FloatingPointMultiplier multiplier;
+    FloatingPointNormalizer normalizer;
+    sc_fifo<sc_uint<32>> a;
+    sc_fifo<sc_uint<32>> b;
+    sc_fifo<bool> a_sign;
+    sc_fifo<sc_uint<8>> a_exp;
+    sc_fifo<sc_uint<32>> a_significand;
+    sc_fifo<bool> b_sign;
+    sc_fifo<sc_uint<8>> b_exp;
+    sc_fifo<sc_uint<32>> b_significand;
+    sc_fifo<bool> result_sign;
+    sc_fifo<sc_uint<8>> result_exp;
+    sc_fifo<sc_uint<32>> result_significand;
+    sc_fifo<sc_uint<32>> result_significand0;
+    sc_fifo<sc_uint<32>> normalized_result;
+
+    SC_HAS_PROCESS(Top);
+    Top(sc_module_name name, int depth)
+        : sc_module(name),
+          extractor("Extractor"),
+          multiplier("Multiplier"),
+          normalizer("Normalizer"),
+          a("a", depth),
+          b("b", depth),
+          a_sign("a_sign", depth),
+          a_exp("a_exp", depth),
+          a_significand("a_significand", depth),
+          b_sign("b_sign", depth),
+          b_exp("b_exp", depth),
+          b_significand("b_significand", depth),
+          result_sign("result_sign", depth),
+          result_exp("result_exp", depth),
+          result_significand("result_significand", depth),
+          result_significand0("result_significand0", depth),
+          normalized_result("normalized_result", depth) {
+        extractor.a(a);
+        extractor.b(b);
+        extractor.a_sign(a_sign);
+        extractor.a_exp(a_exp);
+        extractor.a_significand(a_significand);
+        extractor.b_sign(b_sign);
+        extractor.b_exp(b_exp);
+        extractor.b_significand(b_significand);
+
+        multiplier.a_sign(a_sign);
+        multiplier.a_exp(a_exp);
+        multiplier.a_significand(a_significand);
+        multiplier.b_sign(b_sign);
+        multiplier.b_exp(b_exp);
+        multiplier.b_significand(b_significand);
+        multiplier.result_sign(result_sign);
+        multiplier.result_exp(result_exp);
+        multiplier.result_significand(result_significand);
+        multiplier.result_significand1(result_significand0);
+
+        normalizer.result_sign(result_sign);
+        normalizer.result_exp(result_exp);
+        normalizer.result_significand(result_significand);
+        normalizer.result_significand1(result_significand0);
+        normalizer.normalized_result(normalized_result);
+    }
+};
+}
+
+// TokenSource Module
+// Pushes the operand pairs into a network; blocks whenever the input FIFOs are full
+SC_MODULE(TokenSource) {
+    sc_fifo_out<sc_uint<32>> a;
+    sc_fifo_out<sc_uint<32>> b;
+    std::vector<unsigned int> a_values;
+    std::vector<unsigned int> b_values;
+
+    void source_process() {
+        for (size_t i = 0; i < a_values.size(); i++) {
+            a.write(a_values[i]);
+            b.write(b_values[i]);
+        }
+    }
+
+    SC_CTOR(TokenSource) : a("a"), b("b") {
+        SC_THREAD(source_process);
+    }
+};
+
+// TokenSink Module
+// Collects the results in order; the network goes quiet once it has all of them
+SC_MODULE(TokenSink) {
+    sc_fifo_in<sc_uint<32>> result;
+    std::vector<unsigned int> results;
+    size_t expected;
+
+    void sink_process() {
+        while (results.size() < expected) {
+            results.push_back(result.read());
+        }
+    }
+
+    SC_CTOR(TokenSink) : result("result"), expected(0) {
+        SC_THREAD(sink_process);
+    }
+};
+
+int sc_main(int argc, char* argv[]) {
+    int model, n, depth = 0;
+    cout << "Enter the model (1 = clockless KPN, 2 = clocked Tops): ";
+    cin >> model;
+    cout << "Enter the number of operations: ";
+    cin >> n;
+    if (model == 1) {
+        cout << "Enter the FIFO depth: ";
+        cin >> depth;
+    }
+    if ((model != 1 && model != 2) || n <= 0 || (model == 1 && depth <= 0)) {
+        cout << "Invalid input" << endl;
+        return 1;
+    }
+
+    srand(1);
+    std::vector<unsigned int> a(n), b(n);
+    for (int i = 0; i < n; i++) {
+        float a_float = ldexpf(static_cast<float>(rand()) / RAND_MAX, rand() % 16 - 8);
+        float b_float = ldexpf(static_cast<float>(rand()) / RAND_MAX, rand() % 16 - 8);
+        memcpy(&a[i], &a_float, sizeof(a_float));
+        memcpy(&b[i], &b_float, sizeof(b_float));
+    }
+
+    int add_mismatches = 0, mul_mismatches = 0;
+    std::chrono::steady_clock::time_point host_start = std::chrono::steady_clock::now();
+    if (model == 1) {
+        addition_kpn::Top adder("Adder", depth);
+        multiplication_kpn::Top multiplier("Multiplier", depth);
+        TokenSource add_source("AddSource"), mul_source("MulSource");
+        TokenSink add_sink("AddSink"), mul_sink("MulSink");
+        add_source.a(adder.a);
+        add_source.b(adder.b);
+        add_sink.result(adder.normalized_result);
+        mul_source.a(multiplier.a);
+        mul_source.b(multiplier.b);
+        mul_sink.result(multiplier.normalized_result);
+        add_source.a_values = a;
+        add_source.b_values = b;
+        mul_source.a_values = a;
+        mul_source.b_values = b;
+        add_sink.expected = n;
+        mul_sink.expected = n;
+
+        // Runs until every process is blocked on an empty FIFO
+        sc_start();
+        double host = std::chrono::duration<double>(std::chrono::steady_clock::now() - host_start).count();
+
+        for (int i = 0; i < n; i++) {
+            add_mismatches += (add_sink.results[i] != addition_function(a[i], b[i]));
+            mul_mismatches += (mul_sink.results[i] != multiplication_function(a[i], b[i]));
+        }
+        cout << "KPN: " << n << " ops per pipeline, simulated " << sc_time_stamp() << ", delta cycles " << sc_delta_count()
+             << ", host " << host * 1e3 << " ms (" << host * 1e9 / (2 * n) << " ns/op)" << endl;
+        cout << "Adder activations: extractor " << adder.extractor.activations << ", adder " << adder.adder.activations
+             << ", normaliser " << adder.normalization.activations << endl;
+        cout << "Multiplier activations: extractor " << multiplier.extractor.activations << ", multiplier "
+             << multiplier.multiplier.activations << ", normaliser " << multiplier.normalizer.activations << endl;
+    } else {
+        // Clocked reference from fpu_pipelines.h: every stage thread wakes on every 1 ns edge
+        addition::Top adder("Adder");
+        multiplication::Top multiplier("Multiplier");
+        int cycles = 0;
+        for (int cycle = 0; cycle < n + 2; cycle++) {
+            if (cycle < n) {
+                adder.a.write(a[cycle]);
+                adder.b.write(b[cycle]);
+                multiplier.a.write(a[cycle]);
+                multiplier.b.write(b[cycle]);
+            }
+            sc_start(1, SC_NS);
+            cycles++;
+            if (cycle >= 2) {
+                add_mismatches += (adder.normalized_result.read() != addition_function(a[cycle - 2], b[cycle - 2]));
+                mul_mismatches += (multiplier.normalized_result.read() != multiplication_function(a[cycle - 2], b[cycle - 2]));
+            }
+        }
+        double host = std::chrono::duration<double>(std::chrono::steady_clock::now() - host_start).count();
+        cout << "Clocked: " << n << " ops per pipeline, simulated " << sc_time_stamp() << ", delta cycles " << sc_delta_count()
+             << ", host " << host * 1e3 << " ms (" << host * 1e9 / (2 * n) << " ns/op)" << endl;
+        cout << "Stage activations: " << cycles << " per stage, " << 6 * cycles << " in total" << endl;
+    }
+    cout << "Mismatches vs functional models: add " << add_mismatches << ", mul " << mul_mismatches << endl;
+    return 0;
+}
@@ -0,0 +1,495 @@
+#include <systemc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <bitset>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include "fpu_models.h"
+#include "fpu_pipelines.h"
+
+enum FpuOp { FPU_ADD, FPU_SUB, FPU_MUL, FPU_DIV };
+
+// Assembly format, one instruction per line, '#' comments and 'label:' prefixes.
+// x0-x15 are integer registers (x0 reads as zero), f0-f31 float registers and
+// scratchpad addresses count 32-bit words. Immediates are integers or symbols
+// defined by the host (N, X, Y, OUT, A).
+//   li   xd, imm            addi xd, xs, imm        bnez xs, label
+//   flw  fd, imm(xs)        fsw  fs, imm(xs)        fmv  fd, fs
+//   fadd fd, fa, fb         fsub fd, fa, fb         fmul fd, fa, fb
+//   fdiv fd, fa, fb         halt
+enum Opcode { OP_LI, OP_ADDI, OP_BNEZ, OP_FLW, OP_FSW, OP_FMV, OP_FADD, OP_FSUB, OP_FMUL, OP_FDIV, OP_HALT };
+const char* mnemonics[] = {"li", "addi", "bnez", "flw", "fsw", "fmv", "fadd", "fsub", "fmul", "fdiv", "halt"};
+
+#define INT_REGISTERS 16
+#define FLOAT_REGISTERS 32
+#define SCRATCHPAD_WORDS 65536
+#define LOAD_LATENCY 2
+
+struct Instruction {
+    int opcode;
+    int rd;
+    int rs1;
+    int rs2;
+    long imm;
+    int line;
+};
+
+// Assembler
+// Two passes: labels first, then operands. Errors name the source line.
+struct Assembler {
+    std::map<std::string, long> symbols;
+    std::string error;
+
+    static std::vector<std::string> tokens(const std::string& line) {
+        std::string text = line.substr(0, line.find('#'));
+        for (size_t i = 0; i < text.size(); i++) {
+            text[i] = (text[i] == ',' || text[i] == '(' || text[i] == ')') ? ' ' : text[i];
+        }
+        std::istringstream fields(text);
+        std::vector<std::string> result;
+        std::string field;
+        while (fields >> field) {
+            result.push_back(field);
+        }
+        return result;
+    }
+
+    bool reg(const std::string& text, char kind, int& index) {
+        int limit = (kind == 'x') ? INT_REGISTERS : FLOAT_REGISTERS;
+        char* end;
+        if (text.size() < 2 || text[0] != kind) {
+            return false;
+        }
+        index = static_cast<int>(strtol(text.c_str() + 1, &end, 10));
+        return *end == 0 && index >= 0 && index < limit;
+    }
+
+    bool immediate(const std::string& text, long& value) {
+        std::map<std::string, long>::iterator found = symbols.find(text);
+        if (found != symbols.end()) {
+            value = found->second;
+            return true;
+        }
+        char* end;
+        value = strtol(text.c_str(), &end, 0);
+        return !text.empty() && *end == 0;
+    }
+
+    bool assemble(const std::string& source, std::vector<Instruction>& program) {
+        std::vector<std::string> lines;
+        std::istringstream stream(source);
+        std::string line;
+        while (std::getline(stream, line)) {
+            lines.push_back(line);
+        }
+        std::map<std::string, long> labels;
+        long count = 0;
+        for (size_t l = 0; l < lines.size(); l++) {
+            std::vector<std::string> t = tokens(lines[l]);
+            while (!t.empty() && t[0][t[0].size() - 1] == ':') {
+                labels[t[0].substr(0, t[0].size() - 1)] = count;
+                t.erase(t.begin());
+            }
+            count += !t.empty();
+        }
+        for (size_t l = 0; l < lines.size(); l++) {
+            std::vector<std::string> t = tokens(lines[l]);
+            while (!t.empty() && t[0][t[0].size() - 1] == ':') {
+                t.erase(t.begin());
+            }
+            if (t.empty()) {
+                continue;
+            }
+            Instruction in = {-1, 0, 0, 0, 0, static_cast<int>(l + 1)};
+            for (int op = OP_LI; op <= OP_HALT; op++) {
+                in.opcode = (t[0] == mnemonics[op]) ? op : in.opcode;
+            }
+            bool ok = false;
+            switch (in.opcode) {
+            case OP_LI: ok = t.size() == 3 && reg(t[1], 'x', in.rd) && immediate(t[2], in.imm); break;
+            case OP_ADDI: ok = t.size() == 4 && reg(t[1], 'x', in.rd) && reg(t[2], 'x', in.rs1) && immediate(t[3], in.imm); break;
+            case OP_BNEZ:
+                ok = t.size() == 3 && reg(t[1], 'x', in.rs1) && labels.count(t[2]);
+                in.imm = ok ? labels[t[2]] : 0;
+                break;
+            case OP_FLW:
+            case OP_FSW: ok = t.size() == 4 && reg(t[1], 'f', in.rd) && immediate(t[2], in.imm) && reg(t[3], 'x', in.rs1); break;
+            case OP_FMV: ok = t.size() == 3 && reg(t[1], 'f', in.rd) && reg(t[2], 'f', in.rs1); break;
+            case OP_FADD:
+            case OP_FSUB:
+            case OP_FMUL:
+            case OP_FDIV: ok = t.size() == 4 && reg(t[1], 'f', in.rd) && reg(t[2], 'f', in.rs1) && reg(t[3], 'f', in.rs2); break;
+            case OP_HALT: ok = t.size() == 1; break;
+            }
+            if (!ok) {
+                error = "line " + std::to_string(l + 1) + ": cannot assemble '" + lines[l] + "'";
+                return false;
+            }
+            program.push_back(in);
+        }
+        return true;
+    }
+};
+
+// Stall reasons of a cycle in which the sequencer issued nothing
+enum StallReason { STALL_RAW, STALL_WAW, STALL_UNIT_BUSY, STALL_DRAIN, STALL_COUNT };
+const char* stall_names[] = {"operand not ready", "destination pending", "unit busy", "drain after halt"};
+
+struct PendingWrite {
+    int reg;
+    long ready;
+    int unit;
+    uint32_t value;
+};
+
+// MicroCore
+// In-order, single-issue sequencer around the four Tops. A float register stays
+// busy from issue until its result is written back; the divider only takes
+// operands on its own 10 ns clock edges.
+struct MicroCore {
+    addition::Top adder;
+    subtraction::Top subtractor;
+    multiplication::Top multiplier;
+    division::Top divider;
+    std::vector<Instruction> program;
+    std::vector<uint32_t> scratchpad;
+    long x[INT_REGISTERS];
+    uint32_t f[FLOAT_REGISTERS];
+    int f_pending[FLOAT_REGISTERS];
+    std::vector<PendingWrite> pending;
+    long unit_free[4];
+    long cycle;
+    long instructions;
+    long flops;
+    long stalls[STALL_COUNT];
+
+    MicroCore() : adder("Adder"), subtractor("Subtractor"), multiplier("Multiplier"), divider("Divider"),
+                  scratchpad(SCRATCHPAD_WORDS, 0) {
+        reset();
+    }
+
+    void reset() {
+        memset(x, 0, sizeof(x));
+        memset(f, 0, sizeof(f));
+        memset(f_pending, 0, sizeof(f_pending));
+        memset(unit_free, 0, sizeof(unit_free));
+        memset(stalls, 0, sizeof(stalls));
+        pending.clear();
+        cycle = 0;
+        instructions = 0;
+        flops = 0;
+    }
+
+    // Issue to first dependent issue: extractor, operation and normaliser edges
+    // plus write back; the divider extracts and computes on its 10 ns edges
+    static int unit_latency(int unit) { return (unit == FPU_DIV) ? 11 : 3; }
+    static int unit_interval(int unit) { return (unit == FPU_DIV) ? 10 : 1; }
+
+    void start_unit(int unit, uint32_t a, uint32_t b) {
+        switch (unit) {
+        case FPU_ADD: adder.a.write(a); adder.b.write(b); break;
+        case FPU_SUB: subtractor.a.write(a); subtractor.b.write(b); break;
+        case FPU_MUL: multiplier.a.write(a); multiplier.b.write(b); break;
+        default: divider.a.write(a); divider.b.write(b); break;
+        }
+    }
+
+    uint32_t unit_result(int unit) {
+        switch (unit) {
+        case FPU_ADD: return adder.normalized_result.read();
+        case FPU_SUB: return subtractor.normalized_result.read();
+        case FPU_MUL: return multiplier.normalized_result.read();
+        default: return divider.result.read();
+        }
+    }
+
+    int try_issue(long& pc, bool& halted) {
+        const Instruction& in = program[pc];
+        bool reads_f1 = in.opcode >= OP_FMV && in.opcode <= OP_FDIV;
+        bool reads_f2 = in.opcode >= OP_FADD && in.opcode <= OP_FDIV;
+        bool writes_f = in.opcode == OP_FLW || reads_f1;
+        if ((in.opcode == OP_FSW && f_pending[in.rd]) || (reads_f1 && f_pending[in.rs1]) || (reads_f2 && f_pending[in.rs2])) {
+            return STALL_RAW;
+        }
+        if (writes_f && f_pending[in.rd]) {
+            return STALL_WAW;
+        }
+        int unit = in.opcode - OP_FADD;
+        if (reads_f2 && (cycle < unit_free[unit] || cycle % unit_interval(unit) != 0)) {
+            return STALL_UNIT_BUSY;
+        }
+
+        long next = pc + 1;
+        switch (in.opcode) {
+        case OP_LI: x[in.rd] = in.imm; break;
+        case OP_ADDI: x[in.rd] = x[in.rs1] + in.imm; break;
+        case OP_BNEZ: next = x[in.rs1] ? in.imm : next; break;
+        case OP_FLW: {
+            PendingWrite w = {in.rd, cycle + LOAD_LATENCY, -1, scratchpad[(x[in.rs1] + in.imm) & (SCRATCHPAD_WORDS - 1)]};
+            pending.push_back(w);
+            f_pending[in.rd]++;
+            break;
+        }
+        case OP_FSW: scratchpad[(x[in.rs1] + in.imm) & (SCRATCHPAD_WORDS - 1)] = f[in.rd]; break;
+        case OP_FMV: f[in.rd] = f[in.rs1]; break;
+        case OP_HALT: halted = true; break;
+        default: {
+            start_unit(unit, f[in.rs1], f[in.rs2]);
+            unit_free[unit] = cycle + unit_interval(unit);
+            PendingWrite w = {in.rd, cycle + unit_latency(unit), unit, 0};
+            pending.push_back(w);
+            f_pending[in.rd]++;
+            flops++;
+        }
+        }
+        x[0] = 0;
+        pc = next;
+        instructions++;
+        return -1;
+    }
+
+    // Results are written back at the end of the cycle before they are usable
+    void write_back() {
+        for (size_t i = 0; i < pending.size();) {
+            if (pending[i].ready == cycle + 1) {
+                f[pending[i].reg] = (pending[i].unit < 0) ? pending[i].value : unit_result(pending[i].unit);
+                f_pending[pending[i].reg]--;
+                pending.erase(pending.begin() + i);
+            } else {
+                i++;
+            }
+        }
+    }
+
+    bool run(long max_cycles) {
+        long pc = 0;
+        bool halted = false;
+        reset();
+        while ((!halted || !pending.empty()) && cycle < max_cycles) {
+            if (halted) {
+                stalls[STALL_DRAIN]++;
+            } else if (pc < 0 || pc >= static_cast<long>(program.size())) {
+                return false;
+            } else {
+                int stall = try_issue(pc, halted);
+                if (stall >= 0) {
+                    stalls[stall]++;
+                }
+            }
+            sc_start(1, SC_NS);
+            write_back();
+            cycle++;
+        }
+        return halted;
+    }
+};
+
+// Built-in kernels
+const char* axpy_source =
+    "# y[i] = a * x[i] + y[i]\n"
+    "        li   x1, X\n"
+    "        li   x2, Y\n"
+    "        li   x3, N\n"
+    "        li   x4, A\n"
+    "        flw  f1, 0(x4)\n"
+    "loop:   flw  f2, 0(x1)\n"
+    "        flw  f3, 0(x2)\n"
+    "        fmul f4, f1, f2\n"
+    "        fadd f5, f4, f3\n"
+    "        fsw  f5, 0(x2)\n"
+    "        addi x1, x1, 1\n"
+    "        addi x2, x2, 1\n"
+    "        addi x3, x3, -1\n"
+    "        bnez x3, loop\n"
+    "        halt\n";
+
+const char* dot_source =
+    "# OUT[0] = sum x[i] * y[i], one accumulator\n"
+    "        li   x1, X\n"
+    "        li   x2, Y\n"
+    "        li   x3, N\n"
+    "        flw  f0, 0(x0)\n"
+    "        fsub f0, f0, f0\n"
+    "loop:   flw  f1, 0(x1)\n"
+    "        flw  f2, 0(x2)\n"
+    "        fmul f3, f1, f2\n"
+    "        fadd f0, f0, f3\n"
+    "        addi x1, x1, 1\n"
+    "        addi x2, x2, 1\n"
+    "        addi x3, x3, -1\n"
+    "        bnez x3, loop\n"
+    "        li   x4, OUT\n"
+    "        fsw  f0, 0(x4)\n"
+    "        halt\n";
+
+const char* dot4_source =
+    "# OUT[0] = sum x[i] * y[i], four interleaved accumulators (N multiple of 4)\n"
+    "        li   x1, X\n"
+    "        li   x2, Y\n"
+    "        li   x3, N\n"
+    "        flw  f0, 0(x0)\n"
+    "        fsub f0, f0, f0\n"
+    "        fmv  f1, f0\n"
+    "        fmv  f2, f0\n"
+    "        fmv  f3, f0\n"
+    "loop:   flw  f4, 0(x1)\n"
+    "        flw  f5, 0(x2)\n"
+    "        flw  f6, 1(x1)\n"
+    "        flw  f7, 1(x2)\n"
+    "        flw  f8, 2(x1)\n"
+    "        flw  f9, 2(x2)\n"
+    "        flw  f10, 3(x1)\n"
+    "        flw  f11, 3(x2)\n"
+    "        fmul f12, f4, f5\n"
+    "        fmul f13, f6, f7\n"
+    "        fmul f14, f8, f9\n"
+    "        fmul f15, f10, f11\n"
+    "        fadd f0, f0, f12\n"
+    "        fadd f1, f1, f13\n"
+    "        fadd f2, f2, f14\n"
+    "        fadd f3, f3, f15\n"
+    "        addi x1, x1, 4\n"
+    "        addi x2, x2, 4\n"
+    "        addi x3, x3, -4\n"
+    "        bnez x3, loop\n"
+    "        fadd f0, f0, f1\n"
+    "        fadd f2, f2, f3\n"
+    "        fadd f0, f0, f2\n"
+    "        li   x4, OUT\n"
+    "        fsw  f0, 0(x4)\n"
+    "        halt\n";
+
+const char* stencil_source =
+    "# OUT[i] = c0 * x[i-1] + c1 * x[i] + c2 * x[i+1] for i = 1 .. N-2, x[i+1] loaded once\n"
+    "        li   x1, X\n"
+    "        li   x2, OUT\n"
+    "        li   x3, N\n"
+    "        addi x3, x3, -2\n"
+    "        li   x4, A\n"
+    "        flw  f1, 1(x4)\n"
+    "        flw  f2, 2(x4)\n"
+    "        flw  f3, 3(x4)\n"
+    "        flw  f4, 0(x1)\n"
+    "        flw  f5, 1(x1)\n"
+    "loop:   flw  f6, 2(x1)\n"
+    "        fmul f7, f1, f4\n"
+    "        fmul f8, f2, f5\n"
+    "        fmul f9, f3, f6\n"
+    "        fadd f10, f7, f8\n"
+    "        fadd f11, f10, f9\n"
+    "        fsw  f11, 1(x2)\n"
+    "        fmv  f4, f5\n"
+    "        fmv  f5, f6\n"
+    "        addi x1, x1, 1\n"
+    "        addi x2, x2, 1\n"
+    "        addi x3, x3, -1\n"
+    "        bnez x3, loop\n"
+    "        halt\n";
+
+#define X_BASE 0
+#define Y_BASE 16384
+#define OUT_BASE 32768
+#define A_BASE 49152
+#define MAX_LENGTH 16384
+
+int sc_main(int argc, char* argv[]) {
+    int kernel, n;
+    std::string source;
+    cout << "Enter the kernel (1 = AXPY, 2 = dot product, 3 = dot product with 4 accumulators, 4 = 3-point stencil, 5 = assembly file): ";
+    cin >> kernel;
+    if (kernel == 5) {
+        std::string path;
+        cout << "Enter the assembly file: ";
+        cin >> path;
+        std::ifstream file(path.c_str());
+        std::stringstream text;
+        text << file.rdbuf();
+        source = text.str();
+    } else if (kernel >= 1 && kernel <= 4) {
+        const char* sources[] = {axpy_source, dot_source, dot4_source, stencil_source};
+        source = sources[kernel - 1];
+    }
+    cout << "Enter the vector length: ";
+    cin >> n;
+    if (source.empty() || n < 4 || n > MAX_LENGTH || (kernel == 3 && n % 4 != 0)) {
+        cout << "Invalid input" << endl;
+        return 1;
+    }
+
+    MicroCore core;
+    Assembler assembler;
+    assembler.symbols["N"] = n;
+    assembler.symbols["X"] = X_BASE;
+    assembler.symbols["Y"] = Y_BASE;
+    assembler.symbols["OUT"] = OUT_BASE;
+    assembler.symbols["A"] = A_BASE;
+    if (!assembler.assemble(source, core.program)) {
+        cout << assembler.error << endl;
+        return 1;
+    }
+
+    // Scratchpad: x and y vectors, scalars a, c0, c1, c2 at A
+    srand(1);
+    for (int i = 0; i < n; i++) {
+        float x_float = ldexpf(static_cast<float>(rand()) / RAND_MAX + 0.5f, rand() % 4 - 2);
+        float y_float = ldexpf(static_cast<float>(rand()) / RAND_MAX + 0.5f, rand() % 4 - 2);
+        memcpy(&core.scratchpad[X_BASE + i], &x_float, 4);
+        memcpy(&core.scratchpad[Y_BASE + i], &y_float, 4);
+    }
+    const float scalars[] = {1.5f, 0.25f, 0.5f, 0.25f};
+    for (int k = 0; k < 4; k++) {
+        memcpy(&core.scratchpad[A_BASE + k], &scalars[k], 4);
+    }
+    std::vector<uint32_t> initial = core.scratchpad;
+
+    if (!core.run(100L * n + 1000)) {
+        cout << "Program did not halt" << endl;
+        return 1;
+    }
+
+    // Same operation order on the functional models
+    int mismatches = -1;
+    std::vector<uint32_t> expected = initial;
+    const uint32_t* s = &initial[A_BASE];
+    if (kernel == 1) {
+        for (int i = 0; i < n; i++) {
+            expected[Y_BASE + i] = addition_function(multiplication_function(s[0], initial[X_BASE + i]), initial[Y_BASE + i]);
+        }
+    } else if (kernel == 2 || kernel == 3) {
+        int lanes = (kernel == 2) ? 1 : 4;
+        uint32_t acc[4] = {0, 0, 0, 0};
+        for (int i = 0; i < n; i++) {
+            acc[i % lanes] = addition_function(acc[i % lanes], multiplication_function(initial[X_BASE + i], initial[Y_BASE + i]));
+        }
+        expected[OUT_BASE] = (lanes == 1) ? acc[0]
+                           : addition_function(addition_function(acc[0], acc[1]), addition_function(acc[2], acc[3]));
+    } else if (kernel == 4) {
+        for (int i = 1; i < n - 1; i++) {
+            uint32_t sum = addition_function(multiplication_function(s[1], initial[X_BASE + i - 1]),
+                                             multiplication_function(s[2], initial[X_BASE + i]));
+            expected[OUT_BASE + i] = addition_function(sum, multiplication_function(s[3], initial[X_BASE + i + 1]));
+        }
+    }
+    if (kernel != 5) {
+        mismatches = 0;
+        for (int i = 0; i < SCRATCHPAD_WORDS; i++) {
+            mismatches += (expected[i] != core.scratchpad[i]);
+        }
+    }
+
+    cout << core.program.size() << " instructions assembled, " << core.instructions << " executed in " << core.cycle
+         << " cycles (IPC " << static_cast<double>(core.instructions) / core.cycle << ")" << endl;
+    cout << core.flops << " FLOPs: " << static_cast<double>(core.flops) / core.cycle << " FLOPs/cycle" << endl;
+    cout << "Stall cycles:";
+    for (int k = 0; k < STALL_COUNT; k++) {
+        cout << " " << stall_names[k] << " " << core.stalls[k] << ";";
+    }
+    cout << endl;
+    if (mismatches >= 0) {
+        cout << "Scratchpad mismatches vs functional models: " << mismatches << endl;
+    }
+    return 0;
+}
@@ -0,0 +1,572 @@
+#include <systemc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "fpu_pipelines.h"
+
+#define MAX_OPERANDS 8
+
+// ChainedAdderTree Module
+// Reference reduction: a binary tree of the two-input Extractor -> Adder -> Normaliser
+// pipeline of Addition Final, so every level pays a full alignment, normalisation
+// and rounding.
+SC_MODULE(ChainedAdderTree) {
+    sc_in<sc_uint<32>> x[MAX_OPERANDS];
+    sc_out<sc_uint<32>> result;
+    sc_in<bool> clock;
+
+    addition::FloatingPointExtractor* extractor[MAX_OPERANDS - 1];
+    addition::FloatingPointAdder* adder[MAX_OPERANDS - 1];
+    addition::FloatingPointNormaliser* normalization[MAX_OPERANDS - 1];
+    sc_signal<bool> a_sign[MAX_OPERANDS - 1];
+    sc_signal<sc_uint<8>> a_exp[MAX_OPERANDS - 1];
+    sc_signal<sc_uint<32>> a_significands[MAX_OPERANDS - 1];
+    sc_signal<bool> b_sign[MAX_OPERANDS - 1];
+    sc_signal<sc_uint<8>> b_exp[MAX_OPERANDS - 1];
+    sc_signal<sc_uint<32>> b_significands[MAX_OPERANDS - 1];
+    sc_signal<bool> result_sign[MAX_OPERANDS - 1];
+    sc_signal<sc_uint<8>> result_exp[MAX_OPERANDS - 1];
+    sc_signal<sc_uint<32>> result_significand[MAX_OPERANDS - 1];
+    sc_signal<sc_uint<32>> normalized_result[MAX_OPERANDS - 1];
+    int levels;
+
+    SC_HAS_PROCESS(ChainedAdderTree);
+    ChainedAdderTree(sc_module_name name, int operands)
+        : sc_module(name),
+          result("result"),
+          clock("clock") {
+        // Nodes 0..operands/2-1 add input pairs, every later node adds the
+        // results of two earlier nodes; node operands-2 is the root.
+        int nodes = operands - 1;
+        levels = 0;
+        for (int n = operands; n > 1; n /= 2) {
+            levels++;
+        }
+        for (int k = 0; k < nodes; k++) {
+            std::string id = std::to_string(k);
+            extractor[k] = new addition::FloatingPointExtractor(("Extractor" + id).c_str());
+            adder[k] = new addition::FloatingPointAdder(("Adder" + id).c_str());
+            normalization[k] = new addition::FloatingPointNormaliser(("Normalization" + id).c_str());
+
+            if (k < operands / 2) {
+                extractor[k]->a(x[2 * k]);
+                extractor[k]->b(x[2 * k + 1]);
+            } else {
+                int child = 2 * (k - operands / 2);
+                extractor[k]->a(normalized_result[child]);
+                extractor[k]->b(normalized_result[child + 1]);
+            }
+            extractor[k]->a_sign(a_sign[k]);
+            extractor[k]->a_exp(a_exp[k]);
+            extractor[k]->a_significand(a_significands[k]);
+            extractor[k]->b_sign(b_sign[k]);
+            extractor[k]->b_exp(b_exp[k]);
+            extractor[k]->b_significand(b_significands[k]);
+            extractor[k]->clock(clock);
+
+            adder[k]->a_sign(a_sign[k]);
+            adder[k]->a_exp(a_exp[k]);
+            adder[k]->a_significand(a_significands[k]);
+            adder[k]->b_sign(b_sign[k]);
+            adder[k]->b_exp(b_exp[k]);
+            adder[k]->b_significand(b_significands[k]);
+            adder[k]->result_sign(result_sign[k]);
+            adder[k]->result_exp(result_exp[k]);
+            adder[k]->result_significand(result_significand[k]);
+            adder[k]->clock(clock);
+
+            normalization[k]->result_sign(result_sign[k]);
+            normalization[k]->result_exp(result_exp[k]);
+            normalization[k]->result_significand(result_significand[k]);
+            if (k == nodes - 1) {
+                normalization[k]->nresult(result);
+            } else {
+                normalization[k]->nresult(normalized_result[k]);
+            }
+            normalization[k]->clock(clock);
+        }
+    }
+};
+
+// MultiOperandExtractor Module
+// Unpacks every operand in parallel. NaN and infinity operands are resolved here
+// for the whole reduction and travel down the pipeline as a special result.
+SC_MODULE(MultiOperandExtractor) {
+    sc_in<sc_uint<32>> x[MAX_OPERANDS];
+    sc_in<bool> in_valid;
+    sc_out<bool> x_sign[MAX_OPERANDS];
+    sc_out<sc_uint<8>> x_exp[MAX_OPERANDS];
+    sc_out<sc_uint<32>> x_significand[MAX_OPERANDS];
+    sc_out<bool> special;
+    sc_out<sc_uint<32>> special_result;
+    sc_out<bool> valid;
+    sc_in<bool> clock;
+    int operands;
+
+    void extraction_process() {
+        while (true) {
+            wait();
+            bool nan = false;
+            bool pos_inf = false;
+            bool neg_inf = false;
+            bool all_neg_zero = true;
+            //Extraction
+            for (int k = 0; k < MAX_OPERANDS; k++) {
+                if (k >= operands) {
+                    // Unused lanes contribute +0
+                    x_sign[k].write(false);
+                    x_exp[k].write(1);
+                    x_significand[k].write(0);
+                    continue;
+                }
+                bool sign0 = (x[k].read() & 0x80000000) >> 31;
+                unsigned int exp0 = (x[k].read() & 0x7f800000) >> 23;
+                unsigned int significand0 = (x[k].read() & 0x7fffff);
+
+                unsigned int significand1 = (exp0 >= 1) ? (significand0 | (1 << 23)) : significand0;
+                unsigned int exp1 = ((exp0 == 0) ? 1 : exp0);
+
+                //Special Cases
+                if (exp0 == 255 && significand0 != 0) {
+                    nan = true;
+                } else if (exp0 == 255) {
+                    pos_inf = pos_inf || !sign0;
+                    neg_inf = neg_inf || sign0;
+                }
+                all_neg_zero = all_neg_zero && sign0 && exp0 == 0 && significand0 == 0;
+
+                x_sign[k].write(sign0);
+                x_exp[k].write(static_cast<sc_uint<8>>(exp1));
+                x_significand[k].write(significand1);
+            }
+
+            if (nan || (pos_inf && neg_inf)) {
+                special.write(true);
+                special_result.write(0x7FC00000);
+            } else if (pos_inf || neg_inf) {
+                special.write(true);
+                special_result.write(neg_inf ? 0xFF800000 : 0x7F800000);
+            } else if (all_neg_zero) {
+                special.write(true);
+                special_result.write(0x80000000);
+            } else {
+                special.write(false);
+                special_result.write(0);
+            }
+            valid.write(in_valid.read());
+        }
+    }
+
+    SC_HAS_PROCESS(MultiOperandExtractor);
+    MultiOperandExtractor(sc_module_name name, int operands)
+        : sc_module(name),
+          in_valid("in_valid"),
+          special("special"),
+          special_result("special_result"),
+          valid("valid"),
+          clock("clock"),
+          operands(operands) {
+        SC_THREAD(extraction_process);
+        sensitive << clock.pos();
+    }
+};
+
+// MultiOperandAligner Module
+// Aligns all significands to the largest exponent in one step. Significands are
+// widened by 30 guard bits, bits shifted off the bottom are jammed into the LSB
+// and negative operands are converted to two's complement for the CSA tree.
+SC_MODULE(MultiOperandAligner) {
+    sc_in<bool> x_sign[MAX_OPERANDS];
+    sc_in<sc_uint<8>> x_exp[MAX_OPERANDS];
+    sc_in<sc_uint<32>> x_significand[MAX_OPERANDS];
+    sc_in<bool> special_in;
+    sc_in<sc_uint<32>> special_result_in;
+    sc_in<bool> in_valid;
+    sc_out<sc_uint<64>> aligned[MAX_OPERANDS];
+    sc_out<sc_uint<8>> max_exp;
+    sc_out<bool> special;
+    sc_out<sc_uint<32>> special_result;
+    sc_out<bool> valid;
+    sc_in<bool> clock;
+
+    void alignment_process() {
+        while (true) {
+            wait();
+
+            //Maximum exponent
+            unsigned int ans_exp = 0;
+            for (int k = 0; k < MAX_OPERANDS; k++) {
+                if (x_exp[k].read() > ans_exp) {
+                    ans_exp = x_exp[k].read();
+                }
+            }
+
+            //Exponent Shifting
+            for (int k = 0; k < MAX_OPERANDS; k++) {
+                unsigned int shift = ans_exp - x_exp[k].read();
+                uint64_t wide = static_cast<uint64_t>(x_significand[k].read()) << 30;
+                uint64_t shifted = (shift > 63) ? 0 : (wide >> shift);
+                bool sticky = (shift > 63) ? (wide != 0) : ((wide & ((1ULL << shift) - 1)) != 0);
+                shifted = shifted | sticky;
+                aligned[k].write(x_sign[k].read() ? (~shifted + 1) : shifted);
+            }
+
+            max_exp.write(static_cast<sc_uint<8>>(ans_exp));
+            special.write(special_in.read());
+            special_result.write(special_result_in.read());
+            valid.write(in_valid.read());
+        }
+    }
+
+    SC_CTOR(MultiOperandAligner)
+        : special_in("special_in"),
+          special_result_in("special_result_in"),
+          in_valid("in_valid"),
+          max_exp("max_exp"),
+          special("special"),
+          special_result("special_result"),
+          valid("valid"),
+          clock("clock") {
+        SC_THREAD(alignment_process);
+        sensitive << clock.pos();
+    }
+};
+
+// CarrySaveTree Module
+// Reduces the aligned operands to a sum and a carry vector with 3:2 compressors,
+// so no carry propagates until the single adder in the normaliser.
+SC_MODULE(CarrySaveTree) {
+    sc_in<sc_uint<64>> aligned[MAX_OPERANDS];
+    sc_in<sc_uint<8>> max_exp_in;
+    sc_in<bool> special_in;
+    sc_in<sc_uint<32>> special_result_in;
+    sc_in<bool> in_valid;
+    sc_out<sc_uint<64>> sum_vector;
+    sc_out<sc_uint<64>> carry_vector;
+    sc_out<sc_uint<8>> max_exp;
+    sc_out<bool> special;
+    sc_out<sc_uint<32>> special_result;
+    sc_out<bool> valid;
+    sc_in<bool> clock;
+
+    void csa_process() {
+        while (true) {
+            wait();
+
+            uint64_t rows[MAX_OPERANDS];
+            int n = MAX_OPERANDS;
+            for (int k = 0; k < MAX_OPERANDS; k++) {
+                rows[k] = aligned[k].read();
+            }
+
+            //3:2 compression until two rows are left
+            while (n > 2) {
+                int m = 0;
+                int k = 0;
+                for (; k + 2 < n; k += 3) {
+                    uint64_t s = rows[k] ^ rows[k + 1] ^ rows[k + 2];
+                    uint64_t c = ((rows[k] & rows[k + 1]) | (rows[k] & rows[k + 2]) | (rows[k + 1] & rows[k + 2])) << 1;
+                    rows[m++] = s;
+                    rows[m++] = c;
+                }
+                for (; k < n; k++) {
+                    rows[m++] = rows[k];
+                }
+                n = m;
+            }
+
+            sum_vector.write(rows[0]);
+            carry_vector.write(rows[1]);
+            max_exp.write(max_exp_in.read());
+            special.write(special_in.read());
+            special_result.write(special_result_in.read());
+            valid.write(in_valid.read());
+        }
+    }
+
+    SC_CTOR(CarrySaveTree)
+        : max_exp_in("max_exp_in"),
+          special_in("special_in"),
+          special_result_in("special_result_in"),
+          in_valid("in_valid"),
+          sum_vector("sum_vector"),
+          carry_vector("carry_vector"),
+          max_exp("max_exp"),
+          special("special"),
+          special_result("special_result"),
+          valid("valid"),
+          clock("clock") {
+        SC_THREAD(csa_process);
+        sensitive << clock.pos();
+    }
+};
+
+// MultiOperandNormaliser Module
+// Final carry-propagate add, leading-one detection and a single
+// round-to-nearest-even for the whole reduction.
+SC_MODULE(MultiOperandNormaliser) {
+    sc_in<sc_uint<64>> sum_vector;
+    sc_in<sc_uint<64>> carry_vector;
+    sc_in<sc_uint<8>> max_exp;
+    sc_in<bool> special;
+    sc_in<sc_uint<32>> special_result;
+    sc_in<bool> in_valid;
+    sc_out<sc_uint<32>> nresult;
+    sc_out<bool> valid;
+    sc_in<bool> clock;
+
+    void normal_process() {
+        while (true) {
+            wait();
+
+            int64_t total = static_cast<int64_t>(sum_vector.read() + carry_vector.read());
+            bool ans_sign = total < 0;
+            uint64_t magnitude = ans_sign ? (~static_cast<uint64_t>(total) + 1) : static_cast<uint64_t>(total);
+            int exp_max = max_exp.read();
+            unsigned int ans;
+
+            if (special.read()) {
+                ans = special_result.read();
+            } else if (magnitude == 0) {
+                //When answer is zero
+                ans = 0;
+            } else {
+                /* Normalization */
+                int i;
+                for (i = 63; i > 0 && ((magnitude >> i) == 0); i--) {;}
+
+                // Value is magnitude * 2^(max_exp - 127 - 23 - 30)
+                int ans_exp = exp_max + i - 53;
+                int shift = (ans_exp >= 1) ? (i - 23) : (31 - exp_max);
+                uint64_t ans_significand;
+
+                if (shift > 0) {
+                    //Rounding
+                    int s = (shift > 63) ? 63 : shift;
+                    uint64_t guard = (magnitude >> (s - 1)) & 1;
+                    bool sticky = (magnitude & ((1ULL << (s - 1)) - 1)) != 0;
+                    ans_significand = (shift > 63) ? 0 : (magnitude >> s);
+                    if (guard == 1 && (sticky || (ans_significand & 1) == 1)) {
+                        ans_significand += 1;
+                    }
+                } else {
+                    ans_significand = magnitude << (-shift);
+                }
+
+                if (ans_exp >= 1) {
+                    if ((ans_significand >> 24) == 1) {
+                        ans_significand = (ans_significand >> 1);
+                        ans_exp += 1;
+                    }
+                    //Overflow
+                    if (ans_exp >= 255) {
+                        ans = (ans_sign << 31) | 0x7F800000;
+                    } else {
+                        ans = (ans_sign << 31) | (ans_exp << 23) | (ans_significand & 0x7FFFFF);
+                    }
+                } else {
+                    //Underflow: subnormal result, rounding into bit 23 gives the smallest normal
+                    ans = (ans_sign << 31) | static_cast<unsigned int>(ans_significand);
+                }
+            }
+
+            nresult.write(ans);
+            valid.write(in_valid.read());
+        }
+    }
+
+    SC_CTOR(MultiOperandNormaliser)
+        : sum_vector("sum_vector"),
+          carry_vector("carry_vector"),
+          max_exp("max_exp"),
+          special("special"),
+          special_result("special_result"),
+          in_valid("in_valid"),
+          nresult("nresult"),
+          valid("valid"),
+          clock("clock") {
+        SC_THREAD(normal_process);
+        sensitive << clock.pos();
+    }
+};
+
+// Top-level Module: fused multi-operand adder next to the chained two-input tree
+SC_MODULE(Top) {
+    MultiOperandExtractor extractor;
+    MultiOperandAligner aligner;
+    CarrySaveTree csa;
+    MultiOperandNormaliser normalization;
+    ChainedAdderTree chained;
+    sc_signal<sc_uint<32>> x[MAX_OPERANDS];
+    sc_signal<bool> in_valid;
+    sc_signal<bool> x_sign[MAX_OPERANDS];
+    sc_signal<sc_uint<8>> x_exp[MAX_OPERANDS];
+    sc_signal<sc_uint<32>> x_significands[MAX_OPERANDS];
+    sc_signal<sc_uint<64>> aligned[MAX_OPERANDS];
+    sc_signal<sc_uint<8>> max_exp[2];
+    sc_signal<bool> special[3];
+    sc_signal<sc_uint<32>> special_result[3];
+    sc_signal<bool> valid[4];
+    sc_signal<sc_uint<64>> sum_vector;
+    sc_signal<sc_uint<64>> carry_vector;
+    sc_signal<sc_uint<32>> normalized_result;
+    sc_signal<sc_uint<32>> chained_result;
+    sc_clock clock;
+
+    SC_HAS_PROCESS(Top);
+    Top(sc_module_name name, int operands)
+        : sc_module(name),
+          extractor("Extractor", operands),
+          aligner("Aligner"),
+          csa("CarrySaveTree"),
+          normalization("Normalization"),
+          chained("ChainedAdderTree", operands),
+          clock("clock", 1, SC_NS) {
+        for (int k = 0; k < MAX_OPERANDS; k++) {
+            extractor.x[k](x[k]);
+            extractor.x_sign[k](x_sign[k]);
+            extractor.x_exp[k](x_exp[k]);
+            extractor.x_significand[k](x_significands[k]);
+
+            aligner.x_sign[k](x_sign[k]);
+            aligner.x_exp[k](x_exp[k]);
+            aligner.x_significand[k](x_significands[k]);
+            aligner.aligned[k](aligned[k]);
+
+            csa.aligned[k](aligned[k]);
+
+            chained.x[k](x[k]);
+        }
+        extractor.in_valid(in_valid);
+        extractor.special(special[0]);
+        extractor.special_result(special_result[0]);
+        extractor.valid(valid[0]);
+        extractor.clock(clock);
+
+        aligner.special_in(special[0]);
+        aligner.special_result_in(special_result[0]);
+        aligner.in_valid(valid[0]);
+        aligner.max_exp(max_exp[0]);
+        aligner.special(special[1]);
+        aligner.special_result(special_result[1]);
+        aligner.valid(valid[1]);
+        aligner.clock(clock);
+
+        csa.max_exp_in(max_exp[0]);
+        csa.special_in(special[1]);
+        csa.special_result_in(special_result[1]);
+        csa.in_valid(valid[1]);
+        csa.sum_vector(sum_vector);
+        csa.carry_vector(carry_vector);
+        csa.max_exp(max_exp[1]);
+        csa.special(special[2]);
+        csa.special_result(special_result[2]);
+        csa.valid(valid[2]);
+        csa.clock(clock);
+
+        normalization.sum_vector(sum_vector);
+        normalization.carry_vector(carry_vector);
+        normalization.max_exp(max_exp[1]);
+        normalization.special(special[2]);
+        normalization.special_result(special_result[2]);
+        normalization.in_valid(valid[2]);
+        normalization.nresult(normalized_result);
+        normalization.valid(valid[3]);
+        normalization.clock(clock);
+
+        chained.result(chained_result);
+        chained.clock(clock);
+    }
+};
+
+// Distance between two floats in units in the last place
+long long ulp_distance(unsigned int x, unsigned int y) {
+    long long ox = (x & 0x80000000) ? -static_cast<long long>(x & 0x7FFFFFFF) : static_cast<long long>(x);
+    long long oy = (y & 0x80000000) ? -static_cast<long long>(y & 0x7FFFFFFF) : static_cast<long long>(y);
+    return (ox > oy) ? (ox - oy) : (oy - ox);
+}
+
+int sc_main(int argc, char* argv[]) {
+    int operands, reductions;
+    cout << "Enter the number of operands (4 or 8): ";
+    cin >> operands;
+    cout << "Enter the number of reductions: ";
+    cin >> reductions;
+    if ((operands != 4 && operands != 8) || reductions <= 0) {
+        cout << "Invalid input" << endl;
+        return 1;
+    }
+
+    Top top("Top", operands);
+    int chained_latency = 3 * top.chained.levels;
+
+    // Random operands with mixed signs and a spread of exponents
+    srand(1);
+    std::vector<unsigned int> inputs(reductions * operands);
+    std::vector<unsigned int> reference(reductions);
+    for (int r = 0; r < reductions; r++) {
+        double sum = 0;
+        for (int k = 0; k < operands; k++) {
+            float value = ldexpf(static_cast<float>(rand()) / RAND_MAX, rand() % 24 - 12);
+            if (rand() & 1) {
+                value = -value;
+            }
+            memcpy(&inputs[r * operands + k], &value, sizeof(value));
+            sum += value;
+        }
+        float sum_float = static_cast<float>(sum);
+        memcpy(&reference[r], &sum_float, sizeof(sum_float));
+    }
+
+    std::vector<unsigned int> fused(reductions);
+    std::vector<unsigned int> chained(reductions);
+    int fused_count = 0;
+    int fused_latency = 0;
+    int cycle = 0;
+    while (fused_count < reductions || cycle - chained_latency < reductions) {
+        for (int k = 0; k < MAX_OPERANDS; k++) {
+            top.x[k].write((cycle < reductions && k < operands) ? inputs[cycle * operands + k] : 0);
+        }
+        top.in_valid.write(cycle < reductions);
+        sc_start(1, SC_NS);
+        cycle++;
+
+        if (top.valid[3].read() && fused_count < reductions) {
+            if (fused_count == 0) {
+                fused_latency = cycle;
+            }
+            fused[fused_count++] = top.normalized_result.read();
+        }
+        int done = cycle - chained_latency;
+        if (done >= 0 && done < reductions) {
+            chained[done] = top.chained_result.read();
+        }
+    }
+
+    long long fused_max = 0, chained_max = 0;
+    double fused_sum = 0, chained_sum = 0;
+    int fused_exact = 0, chained_exact = 0;
+    for (int r = 0; r < reductions; r++) {
+        long long df = ulp_distance(fused[r], reference[r]);
+        long long dc = ulp_distance(chained[r], reference[r]);
+        fused_max = (df > fused_max) ? df : fused_max;
+        chained_max = (dc > chained_max) ? dc : chained_max;
+        fused_sum += df;
+        chained_sum += dc;
+        fused_exact += (df == 0);
+        chained_exact += (dc == 0);
+    }
+
+    cout << "Operands per reduction: " << operands << ", reductions: " << reductions << endl;
+    cout << "Fused multi-operand adder:" << endl;
+    cout << "  Latency per reduction: " << fused_latency << " cycles, 1 rounding" << endl;
+    cout << "  Cycles for stream: " << reductions + fused_latency - 1 << endl;
+    cout << "  Max ULP error: " << fused_max << ", mean ULP error: " << fused_sum / reductions
+         << ", exact: " << fused_exact << "/" << reductions << endl;
+    cout << "Chained two-input adder tree:" << endl;
+    cout << "  Latency per reduction: " << chained_latency << " cycles, " << operands - 1 << " roundings" << endl;
+    cout << "  Cycles for stream: " << reductions + chained_latency - 1 << endl;
+    cout << "  Max ULP error: " << chained_max << ", mean ULP error: " << chained_sum / reductions
+         << ", exact: " << chained_exact << "/" << reductions << endl;
+    return 0;
+}
@@ -0,0 +1,340 @@
+#include <systemc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <bitset>
+#include <algorithm>
+#include <vector>
+#include "fpu_models.h"
+#include "fpu_pipelines.h"
+
+// Seed tables, generated at compile time. The reciprocal table holds 2/c and the
+// reciprocal square root table 2/sqrt(c), each as a 23-bit fraction with the
+// hidden bit implied, for c the midpoint of each of the 2^BITS intervals of the
+// significand in [1, 2). The second half of the square-root table covers odd
+// exponents, where the significand is doubled to [2, 4).
+constexpr uint64_t isqrt64(uint64_t value) {
+    uint64_t root = 0;
+    for (int bit = 31; bit >= 0; bit--) {
+        uint64_t trial = root | (static_cast<uint64_t>(1) << bit);
+        if (trial * trial <= value) {
+            root = trial;
+        }
+    }
+    return root;
+}
+
+template <int BITS>
+struct SeedTables {
+    uint32_t reciprocal[1 << BITS];
+    uint32_t rsqrt[2 << BITS];
+
+    constexpr SeedTables() : reciprocal(), rsqrt() {
+        for (int i = 0; i < (1 << BITS); i++) {
+            // c = midpoint / 2^(BITS+1)
+            uint64_t midpoint = (static_cast<uint64_t>(1) << (BITS + 1)) + 2 * i + 1;
+            uint64_t quotient = ((static_cast<uint64_t>(1) << (BITS + 25)) + midpoint / 2) / midpoint;
+            reciprocal[i] = static_cast<uint32_t>(quotient) & 0x7FFFFF;
+            for (int odd = 0; odd < 2; odd++) {
+                uint64_t square = (static_cast<uint64_t>(1) << (BITS + 49)) / (midpoint << odd);
+                uint64_t root = isqrt64(square);
+                root += (square - root * root > root);   // round to nearest
+                rsqrt[(odd << BITS) | i] = static_cast<uint32_t>(root >= (1u << 24) ? 0xFFFFFF : root) & 0x7FFFFF;
+            }
+        }
+    }
+};
+
+// Estimate from the fields the extractor isolates. Zero and subnormal operands
+// read as zero, results below the smallest normal flush to zero.
+template <int BITS>
+uint32_t estimate_bits(bool rsqrt, bool sign, uint32_t exponent, uint32_t fraction) {
+    static constexpr SeedTables<BITS> tables;
+    uint32_t signbit = sign ? 0x80000000 : 0;
+    uint32_t index = fraction >> (23 - BITS);
+    if (exponent == 255) {
+        // NaN stays NaN; 1/inf is zero, 1/sqrt(+inf) is zero and 1/sqrt(-inf) NaN
+        return (fraction != 0 || (rsqrt && sign)) ? 0x7FC00000 : signbit;
+    }
+    if (exponent == 0) {
+        return signbit | 0x7F800000;
+    }
+    if (!rsqrt) {
+        int result_exp = 253 - int(exponent);
+        return (result_exp < 1) ? signbit : (signbit | (result_exp << 23) | tables.reciprocal[index]);
+    }
+    if (sign) {
+        return 0x7FC00000;
+    }
+    int unbiased = int(exponent) - 127;
+    int odd = unbiased & 1;
+    int result_exp = 126 - (unbiased - odd) / 2;
+    return (result_exp << 23) | tables.rsqrt[(odd << BITS) | index];
+}
+
+// EstimateExtractor Module: isolates sign, exponent and fraction like the
+// multiplier's FloatingPointExtractor, without its special-case encodings, and
+// carries the operation select alongside
+SC_MODULE(EstimateExtractor) {
+    sc_in<sc_uint<32>> a;
+    sc_in<bool> rsqrt;
+    sc_out<bool> a_sign;
+    sc_out<sc_uint<8>> a_exp;
+    sc_out<sc_uint<32>> a_significand;
+    sc_out<bool> rsqrt_out;
+    sc_in<bool> clock;
+
+    void extraction_process() {
+        while (true) {
+            wait();
+            a_sign.write((a.read() & 0x80000000) != 0);
+            a_exp.write((a.read() & 0x7F800000) >> 23);
+            a_significand.write(a.read() & 0x7FFFFF);
+            rsqrt_out.write(rsqrt.read());
+        }
+    }
+
+    SC_CTOR(EstimateExtractor) : a("a"), rsqrt("rsqrt"), a_sign("a_sign"), a_exp("a_exp"), a_significand("a_significand"),
+                                 rsqrt_out("rsqrt_out"), clock("clock") {
+        SC_THREAD(extraction_process);
+        sensitive << clock.pos();
+    }
+};
+
+// EstimateLookup Module: one table read and an exponent subtract
+template <int BITS>
+struct EstimateLookup : public sc_module {
+    sc_in<bool> a_sign;
+    sc_in<sc_uint<8>> a_exp;
+    sc_in<sc_uint<32>> a_significand;
+    sc_in<bool> rsqrt;
+    sc_out<sc_uint<32>> estimate;
+    sc_in<bool> clock;
+
+    void lookup_process() {
+        while (true) {
+            wait();
+            estimate.write(estimate_bits<BITS>(rsqrt.read(), a_sign.read(), a_exp.read(), a_significand.read()));
+        }
+    }
+
+    SC_HAS_PROCESS(EstimateLookup);
+    EstimateLookup(sc_module_name name) : sc_module(name) {
+        SC_THREAD(lookup_process);
+        sensitive << clock.pos();
+    }
+};
+
+// Estimate unit interface, so that units with different table sizes share a driver
+struct EstimatePort {
+    virtual void start(uint32_t x, bool rsqrt) = 0;
+    virtual uint32_t estimate() = 0;
+    virtual uint32_t model(uint32_t x, bool rsqrt) = 0;
+    virtual ~EstimatePort() {}
+};
+
+template <int BITS>
+struct EstimateTop : public sc_module, public EstimatePort {
+    EstimateExtractor extractor;
+    EstimateLookup<BITS> lookup;
+    sc_signal<sc_uint<32>> a;
+    sc_signal<bool> rsqrt;
+    sc_signal<bool> a_sign;
+    sc_signal<sc_uint<8>> a_exp;
+    sc_signal<sc_uint<32>> a_significand;
+    sc_signal<bool> rsqrt_extracted;
+    sc_signal<sc_uint<32>> result;
+    sc_clock clock;
+
+    EstimateTop(sc_module_name name) : sc_module(name), extractor("Extractor"), lookup("Lookup"), clock("clock", 1, SC_NS) {
+        extractor.a(a);
+        extractor.rsqrt(rsqrt);
+        extractor.a_sign(a_sign);
+        extractor.a_exp(a_exp);
+        extractor.a_significand(a_significand);
+        extractor.rsqrt_out(rsqrt_extracted);
+        extractor.clock(clock);
+
+        lookup.a_sign(a_sign);
+        lookup.a_exp(a_exp);
+        lookup.a_significand(a_significand);
+        lookup.rsqrt(rsqrt_extracted);
+        lookup.estimate(result);
+        lookup.clock(clock);
+    }
+
+    void start(uint32_t x, bool op) {
+        a.write(x);
+        rsqrt.write(op);
+    }
+
+    uint32_t estimate() {
+        return result.read();
+    }
+
+    uint32_t model(uint32_t x, bool op) {
+        return estimate_bits<BITS>(op, (x & 0x80000000) != 0, (x & 0x7F800000) >> 23, x & 0x7FFFFF);
+    }
+};
+
+// Newton steps on the functional models:
+//   1/x:       y1 = y0 * (2 - x * y0)
+//   1/sqrt(x): y1 = y0 * (1.5 - (0.5 * x) * (y0 * y0))
+const uint32_t TWO = 0x40000000, ONE_AND_HALF = 0x3FC00000, HALF = 0x3F000000;
+
+uint32_t refine_function(bool rsqrt, uint32_t x, uint32_t y0) {
+    if (!rsqrt) {
+        return multiplication_function(y0, subtraction_function(TWO, multiplication_function(x, y0)));
+    }
+    uint32_t u = multiplication_function(multiplication_function(x, HALF), multiplication_function(y0, y0));
+    return multiplication_function(y0, subtraction_function(ONE_AND_HALF, u));
+}
+
+// Cycle-stepped chain: the estimate unit, then the Newton step on the
+// multiplier and subtractor Tops, each operation issued as soon as its operands
+// are back
+struct EstimateChain {
+    multiplication::Top multiplier;
+    subtraction::Top subtractor;
+    long cycle;
+
+    EstimateChain() : multiplier("Multiplier"), subtractor("Subtractor"), cycle(0) {}
+
+    void step() {
+        sc_start(1, SC_NS);
+        cycle++;
+    }
+
+    // Issue, then step until the result has left the last stage
+    uint32_t estimate(EstimatePort& unit, uint32_t x, bool rsqrt) {
+        unit.start(x, rsqrt);
+        step();
+        step();
+        return unit.estimate();
+    }
+
+    uint32_t multiply(uint32_t a, uint32_t b) {
+        multiplier.a.write(a);
+        multiplier.b.write(b);
+        step();
+        step();
+        step();
+        return multiplier.normalized_result.read();
+    }
+
+    uint32_t subtract(uint32_t a, uint32_t b) {
+        subtractor.a.write(a);
+        subtractor.b.write(b);
+        step();
+        step();
+        step();
+        return subtractor.normalized_result.read();
+    }
+
+    uint32_t refine(bool rsqrt, uint32_t x, uint32_t y0) {
+        if (!rsqrt) {
+            return multiply(y0, subtract(TWO, multiply(x, y0)));
+        }
+        // 0.5 * x and y0 * y0 are independent and issue on consecutive cycles
+        multiplier.a.write(x);
+        multiplier.b.write(HALF);
+        step();
+        multiplier.a.write(y0);
+        multiplier.b.write(y0);
+        step();
+        step();
+        uint32_t half_x = multiplier.normalized_result.read();
+        step();
+        uint32_t square = multiplier.normalized_result.read();
+        return multiply(y0, subtract(ONE_AND_HALF, multiply(half_x, square)));
+    }
+};
+
+uint32_t float_bits(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, 4);
+    return bits;
+}
+
+uint32_t reference(bool rsqrt, uint32_t x) {
+    float value;
+    memcpy(&value, &x, 4);
+    return float_bits(static_cast<float>(rsqrt ? 1.0 / sqrt(static_cast<double>(value)) : 1.0 / value));
+}
+
+long ulp_distance(uint32_t x, uint32_t y) {
+    return labs(static_cast<long>(x & 0x7FFFFFFF) - static_cast<long>(y & 0x7FFFFFFF));
+}
+
+struct Accuracy {
+    long estimate_ulp[2];
+    long refined_ulp[2];
+};
+
+// Max ULP over every 61st significand at two exponents and random normal operands
+template <int BITS>
+Accuracy sweep() {
+    Accuracy acc = {{0, 0}, {0, 0}};
+    srand(1);
+    std::vector<uint32_t> inputs;
+    for (uint32_t fraction = 0; fraction < 0x800000; fraction += 61) {
+        inputs.push_back((127u << 23) | fraction);
+        inputs.push_back((128u << 23) | fraction);
+    }
+    for (int i = 0; i < 20000; i++) {
+        inputs.push_back(((2u + rand() % 248) << 23) | ((static_cast<uint32_t>(rand()) << 8) & 0x7FFFFF));
+    }
+    for (size_t i = 0; i < inputs.size(); i++) {
+        uint32_t x = inputs[i];
+        for (int rsqrt = 0; rsqrt < 2; rsqrt++) {
+            uint32_t y0 = estimate_bits<BITS>(rsqrt, false, x >> 23, x & 0x7FFFFF);
+            uint32_t expected = reference(rsqrt, x);
+            acc.estimate_ulp[rsqrt] = std::max(acc.estimate_ulp[rsqrt], ulp_distance(y0, expected));
+            acc.refined_ulp[rsqrt] = std::max(acc.refined_ulp[rsqrt], ulp_distance(refine_function(rsqrt, x, y0), expected));
+        }
+    }
+    return acc;
+}
+
+int sc_main(int argc, char* argv[]) {
+    long n;
+    cout << "Enter the number of pin-level operations per table size: ";
+    cin >> n;
+    if (n <= 0) {
+        cout << "Invalid input" << endl;
+        return 1;
+    }
+
+    const int table_bits[] = {6, 8, 10, 12};
+    EstimatePort* units[] = {new EstimateTop<6>("Estimate6"), new EstimateTop<8>("Estimate8"),
+                             new EstimateTop<10>("Estimate10"), new EstimateTop<12>("Estimate12")};
+    Accuracy accuracy[] = {sweep<6>(), sweep<8>(), sweep<10>(), sweep<12>()};
+    EstimateChain chain;
+
+    cout << "Table bits  entries  table bytes   max ULP 1/x        max ULP 1/sqrt(x)" << endl;
+    cout << "                                  estimate  refined  estimate  refined" << endl;
+    long mismatches = 0, latency[2][2] = {{0, 0}, {0, 0}};
+    for (int t = 0; t < 4; t++) {
+        srand(2);
+        for (long i = 0; i < n; i++) {
+            uint32_t x = ((100u + rand() % 56) << 23) | ((static_cast<uint32_t>(rand()) << 8) & 0x7FFFFF);
+            bool rsqrt = i % 2;
+            long start = chain.cycle;
+            uint32_t y0 = chain.estimate(*units[t], x, rsqrt);
+            latency[rsqrt][0] = chain.cycle - start;
+            uint32_t y1 = chain.refine(rsqrt, x, y0);
+            latency[rsqrt][1] = chain.cycle - start;
+            uint32_t expected = units[t]->model(x, rsqrt);
+            mismatches += (y0 != expected) + (y1 != refine_function(rsqrt, x, expected));
+        }
+        int entries = 3 << table_bits[t];
+        printf("%10d %8d %12d %9ld %8ld %9ld %8ld\n", table_bits[t], entries, entries * 3, accuracy[t].estimate_ulp[0],
+               accuracy[t].refined_ulp[0], accuracy[t].estimate_ulp[1], accuracy[t].refined_ulp[1]);
+    }
+    cout << "Latency: estimate " << latency[0][0] << " cycles, refined 1/x " << latency[0][1] << " cycles, refined 1/sqrt(x) "
+         << latency[1][1] << " cycles; the estimate unit issues one operation per cycle, a refined 1/x takes the multiplier"
+         << " twice and a refined 1/sqrt(x) four times" << endl;
+    cout << "Pin-level mismatches vs functional models: " << mismatches << endl;
+    return 0;
+}
@@ -0,0 +1,348 @@
+#include <systemc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <bitset>
+#include <algorithm>
+#include <deque>
+#include <string>
+#include <vector>
+#include "fpu_models.h"
+#include "fpu_pipelines.h"
+
+enum FpuOp { FPU_ADD, FPU_SUB, FPU_MUL, FPU_DIV };
+const char* unit_names[] = {"adder", "subtractor", "multiplier", "divider"};
+
+// Issue/result timing of each Top in 1 ns cycles, as in the simulation server
+const int issue_period[4] = {1, 1, 1, 10};
+const int result_delay[4] = {2, 2, 2, 10};
+
+// Operand sources of a kernel step: loaded words are 0, 1, ..., the previous
+// step's result is SRC_PREV and kernel constant k is SRC_CONST(k)
+#define SRC_PREV -1
+#define SRC_CONST(k) (-2 - (k))
+#define ELEMENT_WINDOW 64
+#define WORD_BYTES 4
+
+struct Step {
+    int op;
+    int a;
+    int b;
+};
+
+// A streaming kernel: every element loads some words, runs a chain of steps and
+// stores the last result
+struct Kernel {
+    std::string name;
+    int loads;
+    std::vector<Step> steps;
+    std::vector<float> constants;
+};
+
+std::vector<Kernel> make_kernels() {
+    std::vector<Kernel> kernels;
+    Kernel scale = {"scale  y = a*x", 1, {{FPU_MUL, SRC_CONST(0), 0}}, {1.5f}};
+    Kernel axpy = {"axpy   y = a*x + y", 2, {{FPU_MUL, SRC_CONST(0), 0}, {FPU_ADD, SRC_PREV, 1}}, {1.5f}};
+    Kernel divide = {"divide z = x / y", 2, {{FPU_DIV, 0, 1}}, {}};
+    kernels.push_back(scale);
+    kernels.push_back(axpy);
+    kernels.push_back(divide);
+    // Horner evaluation of degree 4 and degree 16 polynomials in x
+    const int degrees[] = {4, 16};
+    for (int d = 0; d < 2; d++) {
+        Kernel horner = {"horner" + std::to_string(degrees[d]) + " p(x)", 1, {}, {}};
+        for (int k = 0; k <= degrees[d]; k++) {
+            horner.constants.push_back(1.0f / (k + 1));
+        }
+        for (int k = 1; k <= degrees[d]; k++) {
+            Step multiply = {FPU_MUL, (k == 1) ? SRC_CONST(0) : SRC_PREV, 0};
+            Step add = {FPU_ADD, SRC_PREV, SRC_CONST(k)};
+            horner.steps.push_back(multiply);
+            horner.steps.push_back(add);
+        }
+        kernels.push_back(horner);
+    }
+    return kernels;
+}
+
+uint32_t float_bits(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, 4);
+    return bits;
+}
+
+uint32_t functional(int op, uint32_t a, uint32_t b) {
+    return (op == FPU_ADD) ? addition_function(a, b)
+         : (op == FPU_SUB) ? subtraction_function(a, b)
+         : (op == FPU_MUL) ? multiplication_function(a, b)
+         : division_function(a, b);
+}
+
+// Memory configuration: total bandwidth, load-to-use latency and word-interleaved
+// banks, each serving one 4-byte word per cycle. Input stream s and the output
+// stream are offset by one bank from each other so that element i of every
+// stream maps to a different bank.
+struct MemoryConfig {
+    double bytes_per_cycle;
+    int latency;
+    int banks;
+};
+
+struct Element {
+    long index;
+    int requested;
+    int arrived;
+    uint32_t words[2];
+    size_t step;
+    int unit;
+    long result_at;
+    long value_ready;
+    uint32_t value;
+    bool stored;
+};
+
+struct LoadResponse {
+    long ready;
+    Element* element;
+    int word;
+};
+
+struct RunStats {
+    long cycles;
+    long flops;
+    long bytes;
+    long bank_conflicts;
+    long mismatches;
+};
+
+// StreamEngine
+// Streams a kernel through the Tops. The memory side fetches element words in
+// order while the bandwidth budget and banks allow, up to ELEMENT_WINDOW elements
+// ahead; stores of finished elements go first. The compute side issues one step
+// per unit per issue period to the oldest element whose operands are ready.
+struct StreamEngine {
+    addition::Top adder;
+    subtraction::Top subtractor;
+    multiplication::Top multiplier;
+    division::Top divider;
+    long cycle;
+
+    StreamEngine() : adder("Adder"), subtractor("Subtractor"), multiplier("Multiplier"), divider("Divider"), cycle(0) {}
+
+    void start_unit(int unit, uint32_t a, uint32_t b) {
+        switch (unit) {
+        case FPU_ADD: adder.a.write(a); adder.b.write(b); break;
+        case FPU_SUB: subtractor.a.write(a); subtractor.b.write(b); break;
+        case FPU_MUL: multiplier.a.write(a); multiplier.b.write(b); break;
+        default: divider.a.write(a); divider.b.write(b); break;
+        }
+    }
+
+    uint32_t unit_result(int unit) {
+        switch (unit) {
+        case FPU_ADD: return adder.normalized_result.read();
+        case FPU_SUB: return subtractor.normalized_result.read();
+        case FPU_MUL: return multiplier.normalized_result.read();
+        default: return divider.result.read();
+        }
+    }
+
+    uint32_t operand(const Kernel& kernel, const Element& e, int source) {
+        return (source == SRC_PREV) ? e.value : (source >= 0) ? e.words[source] : float_bits(kernel.constants[-2 - source]);
+    }
+
+    RunStats run(const Kernel& kernel, const MemoryConfig& memory, const std::vector<uint32_t> inputs[2], std::vector<uint32_t>& output) {
+        RunStats stats = {0, 0, 0, 0, 0};
+        long n = output.size();
+        long next_element = 0, retired = 0;
+        double credit = 0;
+        std::deque<Element> window;
+        std::deque<LoadResponse> responses;
+        Element* busy_unit[4] = {NULL, NULL, NULL, NULL};
+        long start = cycle;
+        std::vector<char> bank_used(memory.banks);
+
+        while (retired < n) {
+            // Memory side: the budget accrues every cycle and carries at most one word over
+            credit = std::min(credit + memory.bytes_per_cycle, memory.bytes_per_cycle + WORD_BYTES);
+            std::fill(bank_used.begin(), bank_used.end(), 0);
+            bool blocked = false;
+            for (size_t i = 0; i < window.size() && !blocked; i++) {
+                Element& e = window[i];
+                if (e.stored || e.step < kernel.steps.size() || e.value_ready > cycle) {
+                    continue;
+                }
+                int bank = (e.index + kernel.loads) % memory.banks;
+                blocked = credit < WORD_BYTES || bank_used[bank];
+                if (!blocked) {
+                    credit -= WORD_BYTES;
+                    bank_used[bank] = 1;
+                    output[e.index] = e.value;
+                    e.stored = true;
+                    stats.bytes += WORD_BYTES;
+                }
+            }
+            while (!blocked && credit >= WORD_BYTES) {
+                if (window.empty() || window.back().requested == kernel.loads) {
+                    if (next_element == n || static_cast<long>(window.size()) == ELEMENT_WINDOW) {
+                        break;
+                    }
+                    Element e = {next_element++, 0, 0, {0, 0}, 0, -1, 0, 0, 0, false};
+                    window.push_back(e);
+                }
+                Element& e = window.back();
+                int bank = (e.index + e.requested) % memory.banks;
+                if (bank_used[bank]) {
+                    stats.bank_conflicts++;
+                    break;
+                }
+                bank_used[bank] = 1;
+                credit -= WORD_BYTES;
+                LoadResponse response = {cycle + memory.latency, &e, e.requested};
+                e.words[e.requested] = inputs[e.requested][e.index];
+                e.requested++;
+                responses.push_back(response);
+                stats.bytes += WORD_BYTES;
+            }
+            while (!responses.empty() && responses.front().ready <= cycle) {
+                responses.front().element->arrived++;
+                responses.pop_front();
+            }
+
+            // Compute side
+            for (size_t i = 0; i < window.size(); i++) {
+                Element& e = window[i];
+                if (e.arrived < kernel.loads || e.step == kernel.steps.size() || e.unit >= 0 || e.value_ready > cycle) {
+                    continue;
+                }
+                const Step& s = kernel.steps[e.step];
+                if (busy_unit[s.op] || cycle % issue_period[s.op] != 0) {
+                    continue;
+                }
+                start_unit(s.op, operand(kernel, e, s.a), operand(kernel, e, s.b));
+                busy_unit[s.op] = &e;
+                e.unit = s.op;
+                e.result_at = cycle + result_delay[s.op];
+                stats.flops++;
+            }
+            for (int u = 0; u < 4; u++) {
+                busy_unit[u] = NULL;
+            }
+
+            sc_start(1, SC_NS);
+            for (size_t i = 0; i < window.size(); i++) {
+                Element& e = window[i];
+                if (e.unit >= 0 && e.result_at == cycle) {
+                    e.value = unit_result(e.unit);
+                    e.value_ready = cycle + 1;
+                    e.unit = -1;
+                    e.step++;
+                }
+            }
+            while (!window.empty() && window.front().stored) {
+                window.pop_front();
+                retired++;
+            }
+            cycle++;
+        }
+        stats.cycles = cycle - start;
+
+        for (long i = 0; i < n; i++) {
+            uint32_t value = 0;
+            for (size_t k = 0; k < kernel.steps.size(); k++) {
+                const Step& s = kernel.steps[k];
+                uint32_t a = (s.a == SRC_PREV) ? value : (s.a >= 0) ? inputs[s.a][i] : float_bits(kernel.constants[-2 - s.a]);
+                uint32_t b = (s.b == SRC_PREV) ? value : (s.b >= 0) ? inputs[s.b][i] : float_bits(kernel.constants[-2 - s.b]);
+                value = functional(s.op, a, b);
+            }
+            stats.mismatches += (output[i] != value);
+        }
+        return stats;
+    }
+};
+
+// Peak FLOPs/cycle of a kernel's step mix with the given unit issue periods
+double compute_peak(const Kernel& kernel, const double periods[4]) {
+    int uses[4] = {0, 0, 0, 0};
+    for (size_t k = 0; k < kernel.steps.size(); k++) {
+        uses[kernel.steps[k].op]++;
+    }
+    double elements_per_cycle = 1e30;
+    for (int u = 0; u < 4; u++) {
+        if (uses[u]) {
+            elements_per_cycle = std::min(elements_per_cycle, 1.0 / (periods[u] * uses[u]));
+        }
+    }
+    return elements_per_cycle * kernel.steps.size();
+}
+
+int sc_main(int argc, char* argv[]) {
+    MemoryConfig memory;
+    long n;
+    cout << "Enter the memory bandwidth (bytes/cycle): ";
+    cin >> memory.bytes_per_cycle;
+    cout << "Enter the memory latency (cycles): ";
+    cin >> memory.latency;
+    cout << "Enter the number of banks: ";
+    cin >> memory.banks;
+    cout << "Enter the number of elements: ";
+    cin >> n;
+    if (memory.bytes_per_cycle <= 0 || memory.latency < 0 || memory.banks <= 0 || n <= 0) {
+        cout << "Invalid input" << endl;
+        return 1;
+    }
+
+    std::vector<uint32_t> inputs[2];
+    srand(1);
+    for (long i = 0; i < n; i++) {
+        inputs[0].push_back(float_bits(ldexpf(static_cast<float>(rand()) / RAND_MAX + 0.5f, rand() % 4 - 2)));
+        inputs[1].push_back(float_bits(ldexpf(static_cast<float>(rand()) / RAND_MAX + 0.5f, rand() % 4 - 2)));
+    }
+
+    StreamEngine engine;
+    std::vector<Kernel> kernels = make_kernels();
+    cout << "Roofline: " << memory.bytes_per_cycle << " bytes/cycle, latency " << memory.latency << ", " << memory.banks
+         << " banks, window " << ELEMENT_WINDOW << " elements" << endl;
+    cout << "Kernel                 FLOPs/byte  achieved  memory roof  compute roof  bound    of roof  2x faster unit" << endl;
+    for (size_t k = 0; k < kernels.size(); k++) {
+        const Kernel& kernel = kernels[k];
+        std::vector<uint32_t> output(n);
+        RunStats stats = engine.run(kernel, memory, inputs, output);
+
+        double intensity = static_cast<double>(kernel.steps.size()) / ((kernel.loads + 1) * WORD_BYTES);
+        double achieved = static_cast<double>(stats.flops) / stats.cycles;
+        double memory_roof = intensity * memory.bytes_per_cycle;
+        double periods[4] = {static_cast<double>(issue_period[0]), static_cast<double>(issue_period[1]),
+                             static_cast<double>(issue_period[2]), static_cast<double>(issue_period[3])};
+        double compute_roof = compute_peak(kernel, periods);
+        double roof = std::min(memory_roof, compute_roof);
+
+        // Roof if the unit limiting the compute peak were twice as fast
+        int limiting = 0;
+        double best = compute_roof;
+        for (int u = 0; u < 4; u++) {
+            double faster[4] = {periods[0], periods[1], periods[2], periods[3]};
+            faster[u] /= 2;
+            double peak = compute_peak(kernel, faster);
+            if (peak > best) {
+                best = peak;
+                limiting = u;
+            }
+        }
+        double gain = std::min(memory_roof, best) / roof - 1;
+
+        printf("%-22s %10.3f %9.3f %12.3f %13.3f  %-7s %7.1f%%  ", kernel.name.c_str(), intensity, achieved, memory_roof,
+               compute_roof, (memory_roof < compute_roof) ? "memory" : "compute", 100 * achieved / roof);
+        if (gain > 0.005) {
+            printf("%s +%.0f%%\n", unit_names[limiting], 100 * gain);
+        } else {
+            printf("no gain\n");
+        }
+        if (stats.mismatches || stats.bank_conflicts) {
+            printf("%22s %ld mismatches vs functional models, %ld bank conflicts\n", "", stats.mismatches, stats.bank_conflicts);
+        }
+    }
+    cout << "(a 2x faster unit is modelled as twice its issue rate)" << endl;
+    return 0;
+}
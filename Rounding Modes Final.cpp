@@ -0,0 +1,694 @@
+#include <systemc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <bitset>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "fpu_pipelines.h"
+
+// Rounding modes and target formats, selectable per operation. The adder,
+// subtractor and multiplier stop rounding in their normalisers: those only find
+// the leading one, and a single RoundingStage after each of them rounds.
+namespace rounding {
+
+enum Mode { ROUND_NEAREST_EVEN, ROUND_TOWARD_ZERO, ROUND_UP, ROUND_DOWN, ROUND_STOCHASTIC, MODES };
+enum Format { FORMAT_FP32, FORMAT_BF16, FORMAT_FP16, FORMATS };
+enum Operation { OP_ADD, OP_SUB, OP_MUL, OPERATIONS };
+
+// Results stay in FP32 containers; a narrower format only limits the fraction
+// bits and the exponent range the value can take
+struct FormatSpec {
+    int fraction;
+    int emin;
+    int emax;
+};
+const FormatSpec FORMAT_SPECS[FORMATS] = {{23, -126, 127}, {7, -126, 127}, {10, -14, 15}};
+
+// Control word travelling with each operation: mode, format and a valid bit
+inline unsigned int control_word(int mode, int format) {
+    return mode | (format << 3) | 0x20;
+}
+
+// Discarded bits compared against the LFSR for stochastic rounding
+#define SR_BITS 16
+
+// 32-bit Galois LFSR, x^32 + x^22 + x^2 + x + 1, stepped SR_BITS times per
+// operation so every operation sees fresh bits
+inline uint32_t lfsr_next(uint32_t state) {
+    for (int i = 0; i < SR_BITS; i++) {
+        state = (state >> 1) ^ ((state & 1) ? 0x80200003u : 0u);
+    }
+    return state;
+}
+
+// Unrounded result: value = significand * 2^(exponent - 63) with the leading one
+// at bit 63, or a zero significand. cancelled marks an exact zero from x - x.
+struct Unrounded {
+    bool sign;
+    int exponent;
+    uint64_t significand;
+    bool cancelled;
+};
+
+uint32_t encode(bool sign, uint64_t kept, int exponent_low) {
+    // kept * 2^exponent_low, always representable in FP32
+    if (kept == 0) {
+        return sign << 31;
+    }
+    int l;
+    for (l = 63; l > 0 && (kept >> l) == 0; l--) {;}
+    int e = exponent_low + l;
+    if (e >= -126) {
+        return (sign << 31) | ((e + 127) << 23) | ((static_cast<uint32_t>(kept) << (23 - l)) & 0x7FFFFF);
+    }
+    return (sign << 31) | static_cast<uint32_t>(kept << (exponent_low + 149));
+}
+
+// The shared rounding logic: keep fraction + 1 bits (fewer below emin) and
+// decide the increment from the discarded bits by mode
+uint32_t round_function(const Unrounded& u, int mode, int format, uint32_t random) {
+    const FormatSpec& f = FORMAT_SPECS[format];
+    if (u.significand == 0) {
+        // An exact zero from cancellation is -0 only when rounding down
+        return (u.cancelled ? (mode == ROUND_DOWN) : u.sign) << 31;
+    }
+    int base = std::max(u.exponent, f.emin);
+    int shift = 63 - f.fraction + (base - u.exponent);
+    uint64_t sig = u.significand;
+
+    uint64_t kept = (shift >= 64) ? 0 : (sig >> shift);
+    bool guard = (shift > 64) ? false : (shift == 64) ? (sig >> 63) : ((sig >> (shift - 1)) & 1);
+    bool sticky = (shift > 64) ? true : (shift == 64) ? ((sig << 1) != 0) : ((sig & ((1ULL << (shift - 1)) - 1)) != 0);
+    bool inexact = guard || sticky;
+
+    bool increment = false;
+    switch (mode) {
+        case ROUND_NEAREST_EVEN:
+            increment = guard && (sticky || (kept & 1));
+            break;
+        case ROUND_TOWARD_ZERO:
+            break;
+        case ROUND_UP:
+            increment = inexact && !u.sign;
+            break;
+        case ROUND_DOWN:
+            increment = inexact && u.sign;
+            break;
+        case ROUND_STOCHASTIC: {
+            // Round up with probability (discarded bits) / ulp, to SR_BITS bits
+            int k = std::min(shift, SR_BITS);
+            uint64_t top = (shift - k >= 64) ? 0 : (sig >> (shift - k)) & ((1ULL << k) - 1);
+            increment = (random & ((1u << k) - 1)) < top;
+            break;
+        }
+    }
+    kept += increment;
+    if (kept >> (f.fraction + 1)) {
+        kept >>= 1;
+        base++;
+    }
+
+    //Overflow: infinity, or the largest finite value when rounding towards zero
+    if (base > f.emax) {
+        bool to_infinity = mode == ROUND_NEAREST_EVEN || mode == ROUND_STOCHASTIC || (mode == ROUND_UP && !u.sign) ||
+                           (mode == ROUND_DOWN && u.sign);
+        if (to_infinity) {
+            return (u.sign << 31) | 0x7F800000;
+        }
+        return encode(u.sign, (2ULL << f.fraction) - 1, f.emax - f.fraction);
+    }
+    return encode(u.sign, kept, base - f.fraction);
+}
+
+// SignificandAdder Module
+// The adder's significand stage for both operations (subtract flips b's sign),
+// with one change: bits shifted out during alignment are jammed into the LSB so
+// directed and stochastic rounding see that the result is inexact. Operands are
+// finite.
+SC_MODULE(SignificandAdder) {
+    sc_in<bool> a_sign;
+    sc_in<sc_uint<8>> a_exp;
+    sc_in<sc_uint<32>> a_significand;
+    sc_in<bool> b_sign;
+    sc_in<sc_uint<8>> b_exp;
+    sc_in<sc_uint<32>> b_significand;
+    sc_out<bool> result_sign;
+    sc_out<sc_uint<8>> result_exp;
+    sc_out<sc_uint<32>> result_significand;
+    sc_out<bool> cancelled;
+    sc_in<bool> clock;
+    bool subtract;
+
+    void addition_process() {
+        while (true) {
+            wait();
+            bool sa = a_sign.read(), sb = b_sign.read() != subtract;
+            unsigned int ea = a_exp.read(), eb = b_exp.read();
+            unsigned int ma = a_significand.read(), mb = b_significand.read();
+
+            //Exponent shifting with a sticky bit
+            unsigned int shift = (ea >= eb) ? ea - eb : eb - ea;
+            unsigned int& small = (ea >= eb) ? mb : ma;
+            unsigned int lost = (shift > 31) ? small : (small & ((1u << shift) - 1));
+            small = ((shift > 31) ? 0 : (small >> shift)) | (lost != 0);
+
+            bool ans_sign = sa;
+            unsigned int ans_significand;
+            if (sa == sb) {
+                ans_significand = ma + mb;
+            } else if (ma >= mb) {
+                ans_significand = ma - mb;
+            } else {
+                ans_sign = sb;
+                ans_significand = mb - ma;
+            }
+            result_sign.write(ans_significand == 0 && sa != sb ? false : ans_sign);
+            result_exp.write(std::max(ea, eb));
+            result_significand.write(ans_significand);
+            cancelled.write(ans_significand == 0 && sa != sb);
+        }
+    }
+
+    SC_HAS_PROCESS(SignificandAdder);
+    SignificandAdder(sc_module_name name, bool subtract)
+        : sc_module(name), result_sign("result_sign"), result_exp("result_exp"), result_significand("result_significand"),
+          cancelled("cancelled"), clock("clock"), subtract(subtract) {
+        SC_THREAD(addition_process);
+        sensitive << clock.pos();
+    }
+};
+
+// FloatingPointNormaliser Module
+// normal_process of the adder and subtractor without its rounding: leading-one
+// detection and the shift to bit 63. The significand's bit 30 has weight
+// 2^(exp - 127).
+SC_MODULE(FloatingPointNormaliser) {
+    sc_in<bool> result_sign;
+    sc_in<sc_uint<8>> result_exp;
+    sc_in<sc_uint<32>> result_significand;
+    sc_in<bool> cancelled_in;
+    sc_out<bool> sign;
+    sc_out<sc_int<16>> exponent;
+    sc_out<sc_uint<64>> significand;
+    sc_out<bool> cancelled;
+    sc_in<bool> clock;
+
+    void normal_process() {
+        while (true) {
+            wait();
+            unsigned int ans_significand = result_significand.read();
+            int i;
+            for (i = 31; i > 0 && ((ans_significand >> i) == 0); i--) {;}
+            sign.write(result_sign.read());
+            exponent.write(int(result_exp.read()) - 157 + i);
+            significand.write(static_cast<uint64_t>(ans_significand) << (63 - i));
+            cancelled.write(cancelled_in.read());
+        }
+    }
+
+    SC_CTOR(FloatingPointNormaliser)
+        : result_sign("result_sign"), result_exp("result_exp"), result_significand("result_significand"),
+          cancelled_in("cancelled_in"), sign("sign"), exponent("exponent"), significand("significand"),
+          cancelled("cancelled"), clock("clock") {
+        SC_THREAD(normal_process);
+        sensitive << clock.pos();
+    }
+};
+
+// FloatingPointNormalizer Module
+// The multiplier's normaliser without its truncation: the exact 64-bit product
+// of the two significands (hidden bits at 30 and 31) shifted to bit 63. Operands
+// are nonzero normals whose product exponent fits the multiplier's 8 bits.
+SC_MODULE(FloatingPointNormalizer) {
+    sc_in<bool> result_sign;
+    sc_in<sc_uint<8>> result_exp;
+    sc_in<sc_uint<32>> result_significand;
+    sc_in<sc_uint<32>> result_significand1;
+    sc_out<bool> sign;
+    sc_out<sc_int<16>> exponent;
+    sc_out<sc_uint<64>> significand;
+    sc_out<bool> cancelled;
+    sc_in<bool> clock;
+
+    void normalize_process() {
+        while (true) {
+            wait();
+            uint64_t product = (static_cast<uint64_t>(result_significand.read()) << 32) | result_significand1.read();
+            int l;
+            for (l = 63; l > 0 && (product >> l) == 0; l--) {;}
+            sign.write(result_sign.read());
+            exponent.write(int(result_exp.read()) - 188 + l);
+            significand.write(product << (63 - l));
+            cancelled.write(false);
+        }
+    }
+
+    SC_CTOR(FloatingPointNormalizer)
+        : result_sign("result_sign"), result_exp("result_exp"), result_significand("result_significand"),
+          result_significand1("result_significand1"), sign("sign"), exponent("exponent"), significand("significand"),
+          cancelled("cancelled"), clock("clock") {
+        SC_THREAD(normalize_process);
+        sensitive << clock.pos();
+    }
+};
+
+// ModeRegister: carries the control word alongside the operation
+SC_MODULE(ModeRegister) {
+    sc_in<sc_uint<8>> control_in;
+    sc_out<sc_uint<8>> control_out;
+    sc_in<bool> clock;
+
+    void latch() {
+        while (true) {
+            wait();
+            control_out.write(control_in.read());
+        }
+    }
+
+    SC_CTOR(ModeRegister) {
+        SC_THREAD(latch);
+        sensitive << clock.pos();
+    }
+};
+
+// RoundingStage Module
+// The one rounding stage shared by every pipeline. Each instance is a lane with
+// its own LFSR, stepped once per valid operation.
+SC_MODULE(RoundingStage) {
+    sc_in<bool> sign;
+    sc_in<sc_int<16>> exponent;
+    sc_in<sc_uint<64>> significand;
+    sc_in<bool> cancelled;
+    sc_in<sc_uint<8>> control;
+    sc_out<sc_uint<32>> result;
+    sc_in<bool> clock;
+    uint32_t seed;
+
+    void rounding_process() {
+        uint32_t lfsr = seed;
+        while (true) {
+            wait();
+            unsigned int word = control.read();
+            if (word & 0x20) {
+                lfsr = lfsr_next(lfsr);
+            }
+            Unrounded u = {sign.read(), static_cast<int>(exponent.read()), significand.read(), cancelled.read()};
+            result.write(round_function(u, word & 7, (word >> 3) & 3, lfsr));
+        }
+    }
+
+    SC_HAS_PROCESS(RoundingStage);
+    RoundingStage(sc_module_name name, uint32_t seed)
+        : sc_module(name), sign("sign"), exponent("exponent"), significand("significand"), cancelled("cancelled"),
+          control("control"), result("result"), clock("clock"), seed(seed) {
+        SC_THREAD(rounding_process);
+        sensitive << clock.pos();
+    }
+};
+
+// RoundedPipe Module
+// Extractor -> operation -> normaliser -> RoundingStage, with the control word in
+// ModeRegisters beside the first three stages. One operation per cycle.
+SC_MODULE(RoundedPipe) {
+    sc_in<sc_uint<32>> a;
+    sc_in<sc_uint<32>> b;
+    sc_in<sc_uint<8>> control;
+    sc_out<sc_uint<32>> result;
+    sc_in<bool> clock;
+
+    addition::FloatingPointExtractor* add_extractor;
+    SignificandAdder* adder;
+    FloatingPointNormaliser* normaliser;
+    multiplication::FloatingPointExtractor* mul_extractor;
+    multiplication::FloatingPointMultiplier* multiplier;
+    FloatingPointNormalizer* normalizer;
+    ModeRegister extract_register, operation_register, normalise_register;
+    RoundingStage rounder;
+    sc_signal<bool> a_sign, b_sign, result_sign, sign, op_cancelled, cancelled;
+    sc_signal<sc_uint<8>> a_exp, b_exp, result_exp;
+    sc_signal<sc_uint<32>> a_significand, b_significand, result_significand, result_significand1;
+    sc_signal<sc_int<16>> exponent;
+    sc_signal<sc_uint<64>> significand;
+    sc_signal<sc_uint<8>> control_word[3];
+
+    SC_HAS_PROCESS(RoundedPipe);
+    RoundedPipe(sc_module_name name, int operation, uint32_t seed)
+        : sc_module(name),
+          add_extractor(0),
+          adder(0),
+          normaliser(0),
+          mul_extractor(0),
+          multiplier(0),
+          normalizer(0),
+          extract_register("ExtractRegister"),
+          operation_register("OperationRegister"),
+          normalise_register("NormaliseRegister"),
+          rounder("Rounder", seed) {
+        if (operation == OP_MUL) {
+            mul_extractor = new multiplication::FloatingPointExtractor("Extractor");
+            mul_extractor->a(a);
+            mul_extractor->b(b);
+            mul_extractor->a_sign(a_sign);
+            mul_extractor->a_exp(a_exp);
+            mul_extractor->a_significand(a_significand);
+            mul_extractor->b_sign(b_sign);
+            mul_extractor->b_exp(b_exp);
+            mul_extractor->b_significand(b_significand);
+            mul_extractor->clock(clock);
+
+            multiplier = new multiplication::FloatingPointMultiplier("Multiplier");
+            multiplier->a_sign(a_sign);
+            multiplier->a_exp(a_exp);
+            multiplier->a_significand(a_significand);
+            multiplier->b_sign(b_sign);
+            multiplier->b_exp(b_exp);
+            multiplier->b_significand(b_significand);
+            multiplier->result_sign(result_sign);
+            multiplier->result_exp(result_exp);
+            multiplier->result_significand(result_significand);
+            multiplier->result_significand1(result_significand1);
+            multiplier->clock(clock);
+
+            normalizer = new FloatingPointNormalizer("Normalizer");
+            normalizer->result_sign(result_sign);
+            normalizer->result_exp(result_exp);
+            normalizer->result_significand(result_significand);
+            normalizer->result_significand1(result_significand1);
+            normalizer->sign(sign);
+            normalizer->exponent(exponent);
+            normalizer->significand(significand);
+            normalizer->cancelled(cancelled);
+            normalizer->clock(clock);
+        } else {
+            add_extractor = new addition::FloatingPointExtractor("Extractor");
+            add_extractor->a(a);
+            add_extractor->b(b);
+            add_extractor->a_sign(a_sign);
+            add_extractor->a_exp(a_exp);
+            add_extractor->a_significand(a_significand);
+            add_extractor->b_sign(b_sign);
+            add_extractor->b_exp(b_exp);
+            add_extractor->b_significand(b_significand);
+            add_extractor->clock(clock);
+
+            adder = new SignificandAdder("Adder", operation == OP_SUB);
+            adder->a_sign(a_sign);
+            adder->a_exp(a_exp);
+            adder->a_significand(a_significand);
+            adder->b_sign(b_sign);
+            adder->b_exp(b_exp);
+            adder->b_significand(b_significand);
+            adder->result_sign(result_sign);
+            adder->result_exp(result_exp);
+            adder->result_significand(result_significand);
+            adder->cancelled(op_cancelled);
+            adder->clock(clock);
+
+            normaliser = new FloatingPointNormaliser("Normalization");
+            normaliser->result_sign(result_sign);
+            normaliser->result_exp(result_exp);
+            normaliser->result_significand(result_significand);
+            normaliser->cancelled_in(op_cancelled);
+            normaliser->sign(sign);
+            normaliser->exponent(exponent);
+            normaliser->significand(significand);
+            normaliser->cancelled(cancelled);
+            normaliser->clock(clock);
+        }
+
+        extract_register.control_in(control);
+        extract_register.control_out(control_word[0]);
+        extract_register.clock(clock);
+        operation_register.control_in(control_word[0]);
+        operation_register.control_out(control_word[1]);
+        operation_register.clock(clock);
+        normalise_register.control_in(control_word[1]);
+        normalise_register.control_out(control_word[2]);
+        normalise_register.clock(clock);
+
+        rounder.sign(sign);
+        rounder.exponent(exponent);
+        rounder.significand(significand);
+        rounder.cancelled(cancelled);
+        rounder.control(control_word[2]);
+        rounder.result(result);
+        rounder.clock(clock);
+    }
+};
+
+// Top-level Module: an add, a subtract and a multiply lane on a 1 ns clock
+SC_MODULE(Top) {
+    RoundedPipe* lanes[OPERATIONS];
+    sc_signal<sc_uint<32>> a[OPERATIONS], b[OPERATIONS], result[OPERATIONS];
+    sc_signal<sc_uint<8>> control[OPERATIONS];
+    sc_clock clock;
+
+    SC_CTOR(Top) : clock("clock", 1, SC_NS) {
+        const char* names[OPERATIONS] = {"AddLane", "SubLane", "MulLane"};
+        for (int op = 0; op < OPERATIONS; op++) {
+            lanes[op] = new RoundedPipe(names[op], op, 0xACE1u + 0x9E3779B9u * op);
+            lanes[op]->a(a[op]);
+            lanes[op]->b(b[op]);
+            lanes[op]->control(control[op]);
+            lanes[op]->result(result[op]);
+            lanes[op]->clock(clock);
+        }
+    }
+};
+
+// Result delay in cycles: stages - 1
+const int rounded_delay = 3;
+
+// Functional model of the stages before the RoundingStage
+Unrounded unrounded_function(int operation, uint32_t a, uint32_t b) {
+    bool sa = a >> 31, sb = b >> 31;
+    unsigned int ea = (a >> 23) & 0xFF, eb = (b >> 23) & 0xFF;
+    unsigned int fa = a & 0x7FFFFF, fb = b & 0x7FFFFF;
+    Unrounded u = {false, 0, 0, false};
+    if (operation == OP_MUL) {
+        uint64_t product = static_cast<uint64_t>((fa | 0x00800000) << 7) * static_cast<uint64_t>((fb | 0x00800000) << 8);
+        unsigned int result_exp = (ea + eb - 0x7F) & 0xFF;
+        int l;
+        for (l = 63; l > 0 && (product >> l) == 0; l--) {;}
+        u.sign = sa ^ sb;
+        u.exponent = int(result_exp) - 188 + l;
+        u.significand = product << (63 - l);
+        return u;
+    }
+    sb = sb != (operation == OP_SUB);
+    unsigned int ma = ((ea >= 1) ? (fa | (1 << 23)) : fa) << 7, mb = ((eb >= 1) ? (fb | (1 << 23)) : fb) << 7;
+    ea = (ea == 0) ? 1 : ea;
+    eb = (eb == 0) ? 1 : eb;
+    unsigned int shift = (ea >= eb) ? ea - eb : eb - ea;
+    unsigned int& small = (ea >= eb) ? mb : ma;
+    unsigned int lost = (shift > 31) ? small : (small & ((1u << shift) - 1));
+    small = ((shift > 31) ? 0 : (small >> shift)) | (lost != 0);
+    bool sign = sa;
+    unsigned int sum;
+    if (sa == sb) {
+        sum = ma + mb;
+    } else if (ma >= mb) {
+        sum = ma - mb;
+    } else {
+        sign = sb;
+        sum = mb - ma;
+    }
+    int i;
+    for (i = 31; i > 0 && ((sum >> i) == 0); i--) {;}
+    u.cancelled = sum == 0 && sa != sb;
+    u.sign = u.cancelled ? false : sign;
+    u.exponent = int(std::max(ea, eb)) - 157 + i;
+    u.significand = static_cast<uint64_t>(sum) << (63 - i);
+    return u;
+}
+
+}
+
+float bits_float(uint32_t bits) {
+    float value;
+    memcpy(&value, &bits, 4);
+    return value;
+}
+
+uint32_t float_bits(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, 4);
+    return bits;
+}
+
+// Reference: round an exact double to a format in an IEEE mode
+uint32_t reference_round(double x, int mode, int format) {
+    const rounding::FormatSpec& f = rounding::FORMAT_SPECS[format];
+    bool sign = x < 0;
+    double ax = fabs(x);
+    int e;
+    frexp(ax, &e);
+    double ulp = ldexp(1.0, std::max(e - 1, f.emin) - f.fraction);
+    double q = ax / ulp, fl = floor(q), frac = q - fl;
+    bool increment = false;
+    if (mode == rounding::ROUND_NEAREST_EVEN) {
+        increment = frac > 0.5 || (frac == 0.5 && fmod(fl, 2) == 1);
+    } else if (mode == rounding::ROUND_UP) {
+        increment = frac > 0 && !sign;
+    } else if (mode == rounding::ROUND_DOWN) {
+        increment = frac > 0 && sign;
+    }
+    double r = (fl + increment) * ulp, max_finite = ldexp(2.0 - ldexp(1.0, -f.fraction), f.emax);
+    if (r > max_finite) {
+        bool to_infinity = mode == rounding::ROUND_NEAREST_EVEN || (mode == rounding::ROUND_UP && !sign) ||
+                           (mode == rounding::ROUND_DOWN && sign);
+        r = to_infinity ? INFINITY : max_finite;
+    }
+    return float_bits(static_cast<float>(sign ? -r : r));
+}
+
+double exact_result(int operation, uint32_t a, uint32_t b) {
+    double x = bits_float(a), y = bits_float(b);
+    return (operation == rounding::OP_ADD) ? x + y : (operation == rounding::OP_SUB) ? x - y : x * y;
+}
+
+// Operands: nonzero normals of either sign spread over 2^-8 to 2^8
+uint32_t random_operand() {
+    float value = ldexpf(static_cast<float>(rand()) / RAND_MAX + 0.5f, rand() % 17 - 8);
+    return float_bits((rand() & 1) ? -value : value);
+}
+
+int sc_main(int argc, char* argv[]) {
+    long n;
+    cout << "Enter the number of operations per lane: ";
+    cin >> n;
+    if (!cin || n <= 0) {
+        cout << "Invalid input" << endl;
+        return 1;
+    }
+    using namespace rounding;
+    rounding::Top top("RoundingTop");
+    addition::Top add_top("AdderTop");
+    subtraction::Top sub_top("SubtractorTop");
+    multiplication::Top mul_top("MultiplierTop");
+
+    // Random operands, modes and formats on every lane
+    srand(1);
+    std::vector<uint32_t> a[OPERATIONS], b[OPERATIONS], result[OPERATIONS], baseline[OPERATIONS];
+    std::vector<char> modes[OPERATIONS], formats[OPERATIONS];
+    for (int op = 0; op < OPERATIONS; op++) {
+        for (long i = 0; i < n; i++) {
+            a[op].push_back(random_operand());
+            b[op].push_back(random_operand());
+            modes[op].push_back(rand() % MODES);
+            formats[op].push_back(rand() % FORMATS);
+        }
+        result[op].resize(n);
+        baseline[op].resize(n);
+    }
+
+    // Rounding-stage lanes, one operation per lane per cycle
+    long rounded_cycles = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (long done = 0; done < n; rounded_cycles++) {
+        for (int op = 0; op < OPERATIONS; op++) {
+            bool issue = rounded_cycles < n;
+            top.a[op].write(issue ? a[op][rounded_cycles] : 0);
+            top.b[op].write(issue ? b[op][rounded_cycles] : 0);
+            top.control[op].write(issue ? control_word(modes[op][rounded_cycles], formats[op][rounded_cycles]) : 0);
+        }
+        sc_start(1, SC_NS);
+        if (rounded_cycles >= rounded_delay) {
+            for (int op = 0; op < OPERATIONS; op++) {
+                result[op][done] = top.result[op].read();
+            }
+            done++;
+        }
+    }
+    double rounded_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Baseline: the original pipelines with round-to-nearest-even in their normalisers
+    const int baseline_delay = 2;
+    long baseline_cycles = 0;
+    start = std::chrono::steady_clock::now();
+    for (long done = 0; done < n; baseline_cycles++) {
+        bool issue = baseline_cycles < n;
+        add_top.a.write(issue ? a[OP_ADD][baseline_cycles] : 0);
+        add_top.b.write(issue ? b[OP_ADD][baseline_cycles] : 0);
+        sub_top.a.write(issue ? a[OP_SUB][baseline_cycles] : 0);
+        sub_top.b.write(issue ? b[OP_SUB][baseline_cycles] : 0);
+        mul_top.a.write(issue ? a[OP_MUL][baseline_cycles] : 0);
+        mul_top.b.write(issue ? b[OP_MUL][baseline_cycles] : 0);
+        sc_start(1, SC_NS);
+        if (baseline_cycles >= baseline_delay) {
+            baseline[OP_ADD][done] = add_top.normalized_result.read();
+            baseline[OP_SUB][done] = sub_top.normalized_result.read();
+            baseline[OP_MUL][done] = mul_top.normalized_result.read();
+            done++;
+        }
+    }
+    double baseline_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Checks: every result against the functional model with the lane's LFSR
+    // sequence; IEEE modes against the exact result rounded once, stochastic
+    // results against the two neighbours of the exact result
+    long counts[MODES] = {}, model_mismatches[MODES] = {}, reference_mismatches[MODES] = {}, rounded_up = 0;
+    double signed_ulps[MODES] = {}, magnitude_ulps[MODES] = {};
+    for (int op = 0; op < OPERATIONS; op++) {
+        uint32_t lfsr = 0xACE1u + 0x9E3779B9u * op;
+        for (long i = 0; i < n; i++) {
+            int mode = modes[op][i], format = formats[op][i];
+            lfsr = lfsr_next(lfsr);
+            uint32_t model = round_function(unrounded_function(op, a[op][i], b[op][i]), mode, format, lfsr);
+            double exact = exact_result(op, a[op][i], b[op][i]);
+            uint32_t down = reference_round(exact, ROUND_DOWN, format), up = reference_round(exact, ROUND_UP, format);
+            bool correct = (mode == ROUND_STOCHASTIC) ? (result[op][i] == down || result[op][i] == up)
+                                                      : result[op][i] == reference_round(exact, mode, format);
+            counts[mode]++;
+            model_mismatches[mode] += result[op][i] != model;
+            reference_mismatches[mode] += !correct;
+            rounded_up += mode == ROUND_STOCHASTIC && down != up && result[op][i] == up;
+            if (down != up && !isinf(bits_float(up)) && !isinf(bits_float(down))) {
+                double ulp = bits_float(up) - bits_float(down);
+                signed_ulps[mode] += (bits_float(result[op][i]) - exact) / ulp;
+                magnitude_ulps[mode] += (fabs(bits_float(result[op][i])) - fabs(exact)) / ulp;
+            }
+        }
+    }
+
+    // Stagnation: 1.0 + 4096 increments of 2^-10 in BF16 (ulp 2^-7 at 1.0) on the
+    // add lane's functional model, one accumulator per mode
+    uint32_t accumulators[MODES], increment = float_bits(ldexpf(1.0f, -10));
+    uint32_t lfsr = 0xACE1u;
+    for (int mode = 0; mode < MODES; mode++) {
+        accumulators[mode] = float_bits(1.0f);
+    }
+    for (int step = 0; step < 4096; step++) {
+        for (int mode = 0; mode < MODES; mode++) {
+            lfsr = lfsr_next(lfsr);
+            accumulators[mode] = round_function(unrounded_function(OP_ADD, accumulators[mode], increment), mode, FORMAT_BF16, lfsr);
+        }
+    }
+
+    const char* mode_names[MODES] = {"nearest-even", "toward zero", "up", "down", "stochastic"};
+    cout << n << " operations per lane on add, subtract and multiply lanes; modes and formats (FP32, BF16, FP16) random per operation"
+         << endl;
+    cout << "Mode          operations  model mismatches  reference mismatches  mean error, magnitude error (ulp)" << endl;
+    for (int mode = 0; mode < MODES; mode++) {
+        printf("%-13s %10ld %17ld %21ld %11.3f, %6.3f\n", mode_names[mode], counts[mode], model_mismatches[mode],
+               reference_mismatches[mode], signed_ulps[mode] / counts[mode], magnitude_ulps[mode] / counts[mode]);
+    }
+    cout << "(stochastic results checked against the two neighbours of the exact result; " << rounded_up
+         << " rounded away from zero)" << endl;
+    cout << "BF16 accumulation of 4096 x 2^-10 onto 1.0 (exact 5.0):";
+    for (int mode = 0; mode < MODES; mode++) {
+        cout << " " << mode_names[mode] << " " << bits_float(accumulators[mode]) << (mode + 1 < MODES ? "," : "");
+    }
+    cout << endl;
+    cout << "Throughput: rounding stage " << rounded_cycles << " cycles for " << n << " operations per lane ("
+         << static_cast<double>(n) / rounded_cycles << " ops/cycle/lane, latency " << rounded_delay + 1 << " cycles)" << endl;
+    cout << "            nearest-even normalisers " << baseline_cycles << " cycles ("
+         << static_cast<double>(n) / baseline_cycles << " ops/cycle/lane, latency " << baseline_delay + 1 << " cycles)" << endl;
+    cout << "Simulation: " << 3 * n / rounded_seconds / 1e6 << " M ops/s with the rounding stage, "
+         << 3 * n / baseline_seconds / 1e6 << " M ops/s without" << endl;
+    return 0;
+}
@@ -0,0 +1,304 @@
+#include <systemc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include "fpu_models.h"
+#include "fpu_pipelines.h"
+
+// Shared-memory layout: one ring of operand pairs (a in the low word, b in the
+// high word) from the producer process and one ring of results back to it.
+// Each ring has a single writer and a single reader, so the indices only need
+// acquire/release ordering. Each side keeps a cached copy of the other side's
+// index and only re-reads it when the ring looks full or empty.
+#define RING_CAPACITY 65536
+#define CACHE_LINE 64
+
+struct alignas(CACHE_LINE) RingIndex {
+    std::atomic<uint64_t> value;
+    char pad[CACHE_LINE - sizeof(std::atomic<uint64_t>)];
+};
+
+template <typename T>
+struct SpscRing {
+    RingIndex head;     // next slot the writer fills
+    RingIndex tail;     // next slot the reader takes
+    RingIndex closed;   // set by the writer after its last push
+    T slots[RING_CAPACITY];
+};
+
+// ready is published by the creator once the region is sized and zeroed; the
+// producer does not touch the rings before it sees it
+struct SharedRegion {
+    RingIndex ready;
+    SpscRing<uint64_t> operands;
+    SpscRing<uint32_t> results;
+};
+
+// RingWriter / RingReader
+// Process-local ends of a ring holding the cached index of the other side
+template <typename T>
+struct RingWriter {
+    SpscRing<T>* ring;
+    uint64_t head;
+    uint64_t tail_cache;
+
+    explicit RingWriter(SpscRing<T>* ring) : ring(ring), head(ring->head.value.load()), tail_cache(ring->tail.value.load()) {}
+
+    bool try_push(T value) {
+        if (head - tail_cache == RING_CAPACITY) {
+            tail_cache = ring->tail.value.load(std::memory_order_acquire);
+            if (head - tail_cache == RING_CAPACITY) {
+                return false;
+            }
+        }
+        ring->slots[head & (RING_CAPACITY - 1)] = value;
+        ring->head.value.store(++head, std::memory_order_release);
+        return true;
+    }
+
+    void close() {
+        ring->closed.value.store(1, std::memory_order_release);
+    }
+};
+
+template <typename T>
+struct RingReader {
+    SpscRing<T>* ring;
+    uint64_t tail;
+    uint64_t head_cache;
+
+    explicit RingReader(SpscRing<T>* ring) : ring(ring), tail(ring->tail.value.load()), head_cache(ring->head.value.load()) {}
+
+    bool try_pop(T& value) {
+        if (tail == head_cache) {
+            head_cache = ring->head.value.load(std::memory_order_acquire);
+            if (tail == head_cache) {
+                return false;
+            }
+        }
+        value = ring->slots[tail & (RING_CAPACITY - 1)];
+        ring->tail.value.store(++tail, std::memory_order_release);
+        return true;
+    }
+
+    // True once the writer has closed the ring and every value has been taken
+    bool finished() {
+        return ring->closed.value.load(std::memory_order_acquire) && tail == ring->head.value.load(std::memory_order_acquire);
+    }
+};
+
+// The creator replaces any stale segment left by an earlier run with a fresh one,
+// which ftruncate zero-fills, and only then sets ready. An opener returns NULL
+// until the segment has its full size, so it never maps a short region.
+SharedRegion* map_region(const char* name, bool create) {
+    if (create) {
+        shm_unlink(name);
+    }
+    int fd = shm_open(name, create ? (O_CREAT | O_EXCL | O_RDWR) : O_RDWR, 0600);
+    if (fd < 0) {
+        return NULL;
+    }
+    struct stat info;
+    if (create ? ftruncate(fd, sizeof(SharedRegion)) < 0
+               : (fstat(fd, &info) < 0 || info.st_size != static_cast<off_t>(sizeof(SharedRegion)))) {
+        close(fd);
+        return NULL;
+    }
+    void* memory = mmap(NULL, sizeof(SharedRegion), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED) {
+        return NULL;
+    }
+    SharedRegion* region = static_cast<SharedRegion*>(memory);
+    if (create) {
+        region->ready.value.store(1, std::memory_order_release);
+    }
+    return region;
+}
+
+// Opens the region, waiting up to about 10 s for it to be created and published
+SharedRegion* wait_region(const char* name) {
+    SharedRegion* region = NULL;
+    for (int attempt = 0; attempt < 1000; attempt++) {
+        if (!region) {
+            region = map_region(name, false);
+        }
+        if (region && region->ready.value.load(std::memory_order_acquire)) {
+            return region;
+        }
+        usleep(10000);
+    }
+    if (region) {
+        munmap(region, sizeof(SharedRegion));
+    }
+    return NULL;
+}
+
+// Workload generator side: pushes n operand pairs while draining results, so
+// neither ring can fill up and stall the other process. The operand ring is
+// closed once every result is back, also when n is 0.
+int run_producer(SharedRegion* region, long n, bool check) {
+    RingWriter<uint64_t> operands(&region->operands);
+    RingReader<uint32_t> results(&region->results);
+    std::vector<uint64_t> sent(n);
+    srand(1);
+    for (long i = 0; i < n; i++) {
+        float a_float = ldexpf(static_cast<float>(rand()) / RAND_MAX, rand() % 16 - 8);
+        float b_float = ldexpf(static_cast<float>(rand()) / RAND_MAX, rand() % 16 - 8);
+        uint32_t a, b;
+        memcpy(&a, &a_float, 4);
+        memcpy(&b, &b_float, 4);
+        sent[i] = static_cast<uint64_t>(b) << 32 | a;
+    }
+
+    long pushed = 0, received = 0, mismatches = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    while (received < n) {
+        for (int burst = 0; burst < 256 && pushed < n && operands.try_push(sent[pushed]); burst++) {
+            pushed++;
+        }
+        uint32_t result;
+        while (results.try_pop(result)) {
+            if (check) {
+                mismatches += (result != addition_function(static_cast<uint32_t>(sent[received]),
+                                                           static_cast<uint32_t>(sent[received] >> 32)));
+            }
+            received++;
+        }
+    }
+    operands.close();
+    double host = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("producer: %ld pairs in %.2f ms (%.2f Mpairs/s)", n, host * 1e3, n / host / 1e6);
+    if (check) {
+        printf(", mismatches vs addition_function %ld", mismatches);
+    }
+    printf("\n");
+    fflush(stdout);
+    return 0;
+}
+
+// Transport only: echoes every pair's low word back without simulating
+void run_echo(SharedRegion* region) {
+    RingReader<uint64_t> operands(&region->operands);
+    RingWriter<uint32_t> results(&region->results);
+    uint64_t pair;
+    while (!operands.finished()) {
+        if (operands.try_pop(pair)) {
+            while (!results.try_push(static_cast<uint32_t>(pair))) {}
+        }
+    }
+    results.close();
+}
+
+// Pipeline: the adder Top takes at most one pair per 1 ns cycle from the ring and
+// each result is pushed back on the cycle it leaves the normaliser. The clock only
+// runs while a pair is issued or still in flight; time spent with an empty ring and
+// a drained pipeline is host time waiting for the producer, not pipeline cycles.
+struct PipelineStats {
+    long pairs;
+    long cycles;
+    double wait_seconds;
+};
+
+PipelineStats run_pipeline(addition::Top& top, SharedRegion* region) {
+    RingReader<uint64_t> operands(&region->operands);
+    RingWriter<uint32_t> results(&region->results);
+    PipelineStats stats = {0, 0, 0.0};
+    bool valid[3] = {false, false, false};
+    uint64_t pair;
+    while (true) {
+        bool issued = operands.try_pop(pair);
+        if (!issued && !valid[0] && !valid[1]) {
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            while (!(issued = operands.try_pop(pair)) && !operands.finished()) {}
+            stats.wait_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if (!issued) {
+                break;
+            }
+        }
+        valid[2] = valid[1];
+        valid[1] = valid[0];
+        valid[0] = issued;
+        if (issued) {
+            top.a.write(static_cast<uint32_t>(pair));
+            top.b.write(static_cast<uint32_t>(pair >> 32));
+            stats.pairs++;
+        }
+        sc_start(1, SC_NS);
+        stats.cycles++;
+        if (valid[2]) {
+            while (!results.try_push(top.normalized_result.read())) {}
+        }
+    }
+    results.close();
+    return stats;
+}
+
+int sc_main(int argc, char* argv[]) {
+    std::string mode = (argc > 1) ? argv[1] : "";
+    if (mode == "--producer" && argc > 3 && atol(argv[3]) >= 0) {
+        SharedRegion* region = wait_region(argv[2]);
+        return region ? run_producer(region, atol(argv[3]), true) : 1;
+    }
+    if (mode == "--sim" && argc > 2) {
+        SharedRegion* region = map_region(argv[2], true);
+        if (!region) {
+            perror("shm_open");
+            return 1;
+        }
+        addition::Top top("Top");
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        PipelineStats stats = run_pipeline(top, region);
+        double host = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        printf("simulation: %ld pairs in %ld cycles (%.3f cycles/pair), host %.2f ms of which %.2f ms waiting for the producer\n",
+               stats.pairs, stats.cycles, stats.pairs ? static_cast<double>(stats.cycles) / stats.pairs : 0.0,
+               host * 1e3, stats.wait_seconds * 1e3);
+        region->ready.value.store(0, std::memory_order_release);
+        shm_unlink(argv[2]);
+        return 0;
+    }
+    if (mode == "--bench" && argc > 2 && atol(argv[2]) > 0) {
+        long n = atol(argv[2]);
+        const char* name = "/fpu_ring_bench";
+        double host[2];
+        addition::Top top("Top");
+        for (int pass = 0; pass < 2; pass++) {
+            SharedRegion* region = map_region(name, true);
+            if (!region) {
+                perror("shm_open");
+                return 1;
+            }
+            fflush(stdout);
+            pid_t child = fork();
+            if (child == 0) {
+                _exit(run_producer(region, n, pass == 1));
+            }
+            // Start timing at the first pair so operand generation is not counted
+            while (region->operands.head.value.load(std::memory_order_acquire) == 0) {}
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            if (pass == 0) {
+                run_echo(region);
+            } else {
+                run_pipeline(top, region);
+            }
+            host[pass] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            waitpid(child, NULL, 0);
+            munmap(region, sizeof(SharedRegion));
+            shm_unlink(name);
+        }
+        printf("transport alone: %.2f Mpairs/s, through the adder Top: %.2f Mpairs/s (transport is %.0fx faster)\n",
+               n / host[0] / 1e6, n / host[1] / 1e6, host[1] / host[0]);
+        return 0;
+    }
+    fprintf(stderr, "Usage: %s --sim <shm name> | --producer <shm name> <pairs> | --bench <pairs>\n", argv[0]);
+    return 1;
+}
@@ -0,0 +1,394 @@
+#include <systemc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <bitset>
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <string>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "fpu_models.h"
+#include "fpu_pipelines.h"
+
+// Binary framing, little-endian, no padding. A client may pipeline any number of
+// requests but has to keep reading while it writes: the server stops reading once
+// OUTPUT_LIMIT bytes of responses are waiting for the client. Responses come back
+// per unit in issue order and carry the request tag, so different units may
+// complete out of order.
+//   request  : op (1 byte) | tag (4) | a (4) | b (4)
+//   response : tag (4) | status (1) | result (4)
+#define REQUEST_BYTES 13
+#define RESPONSE_BYTES 9
+#define OP_SHUTDOWN 0xFF
+#define STATUS_OK 0
+#define STATUS_BAD_OP 1
+#define OUTPUT_LIMIT (1 << 20)
+
+enum FpuOp { FPU_ADD, FPU_SUB, FPU_MUL, FPU_DIV };
+const char* op_names[] = {"add", "sub", "mul", "div"};
+
+typedef std::chrono::steady_clock host_clock;
+
+struct Request {
+    unsigned int tag;
+    unsigned int a;
+    unsigned int b;
+    long ready_step;
+    host_clock::time_point received;
+};
+
+// Issue/result timing of each elaborated Top in 1 ns simulation steps. Operands
+// are sampled on the first edge after they are written and the result can be read
+// after the step holding the last stage's edge.
+const int issue_period[4] = {1, 1, 1, 10};
+const int result_delay[4] = {2, 2, 2, 10};
+
+// FpuServer
+// Owns the elaborated add/sub/mul/div pipelines for the whole process lifetime and
+// steps simulated time only while requests are queued or in flight.
+struct FpuServer {
+    addition::Top adder;
+    subtraction::Top subtractor;
+    multiplication::Top multiplier;
+    division::Top divider;
+    std::deque<Request> waiting[4];
+    std::deque<Request> in_flight[4];
+    long step;
+    std::vector<double> latency_us;
+
+    FpuServer() : adder("Adder"), subtractor("Subtractor"), multiplier("Multiplier"), divider("Divider"), step(0) {}
+
+    void issue(int op, const Request& r) {
+        switch (op) {
+        case FPU_ADD: adder.a.write(r.a); adder.b.write(r.b); break;
+        case FPU_SUB: subtractor.a.write(r.a); subtractor.b.write(r.b); break;
+        case FPU_MUL: multiplier.a.write(r.a); multiplier.b.write(r.b); break;
+        default: divider.a.write(r.a); divider.b.write(r.b); break;
+        }
+    }
+
+    unsigned int result(int op) {
+        switch (op) {
+        case FPU_ADD: return adder.normalized_result.read();
+        case FPU_SUB: return subtractor.normalized_result.read();
+        case FPU_MUL: return multiplier.normalized_result.read();
+        default: return divider.result.read();
+        }
+    }
+
+    bool busy() {
+        for (int op = 0; op < 4; op++) {
+            if (!waiting[op].empty() || !in_flight[op].empty()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static void put_response(std::string& out, unsigned int tag, unsigned char status, unsigned int value) {
+        char frame[RESPONSE_BYTES];
+        memcpy(frame, &tag, 4);
+        frame[4] = status;
+        memcpy(frame + 5, &value, 4);
+        out.append(frame, RESPONSE_BYTES);
+    }
+
+    // Parses every complete frame in the input buffer; returns false on a shutdown frame
+    bool parse(std::string& in, std::string& out) {
+        size_t pos = 0;
+        bool running = true;
+        host_clock::time_point now = host_clock::now();
+        while (in.size() - pos >= REQUEST_BYTES) {
+            unsigned char op = in[pos];
+            Request r;
+            memcpy(&r.tag, in.data() + pos + 1, 4);
+            memcpy(&r.a, in.data() + pos + 5, 4);
+            memcpy(&r.b, in.data() + pos + 9, 4);
+            r.received = now;
+            pos += REQUEST_BYTES;
+            if (op == OP_SHUTDOWN) {
+                running = false;
+            } else if (op > FPU_DIV) {
+                put_response(out, r.tag, STATUS_BAD_OP, 0);
+            } else {
+                waiting[op].push_back(r);
+            }
+        }
+        in.erase(0, pos);
+        return running;
+    }
+
+    // One 1 ns step of all four pipelines
+    void cycle(std::string& out) {
+        for (int op = 0; op < 4; op++) {
+            if (!waiting[op].empty() && step % issue_period[op] == 0) {
+                Request r = waiting[op].front();
+                waiting[op].pop_front();
+                r.ready_step = step + result_delay[op];
+                issue(op, r);
+                in_flight[op].push_back(r);
+            }
+        }
+        sc_start(1, SC_NS);
+        host_clock::time_point now = host_clock::now();
+        for (int op = 0; op < 4; op++) {
+            if (!in_flight[op].empty() && in_flight[op].front().ready_step == step) {
+                Request& r = in_flight[op].front();
+                put_response(out, r.tag, STATUS_OK, result(op));
+                latency_us.push_back(std::chrono::duration<double, std::micro>(now - r.received).count());
+                in_flight[op].pop_front();
+            }
+        }
+        step++;
+    }
+
+    // Serves one stream until end of input or a shutdown frame. The output is
+    // non-blocking and only written when poll() reports room for it, so a client
+    // that is itself blocked writing its window never stalls the server.
+    bool serve(int in_fd, int out_fd) {
+        std::string in, out;
+        bool running = true, open = true, input = false;
+        char buffer[65536];
+        int out_flags = fcntl(out_fd, F_GETFL);
+        fcntl(out_fd, F_SETFL, out_flags | O_NONBLOCK);
+        latency_us.clear();
+        while ((running && open) || busy() || !out.empty()) {
+            bool reading = running && open && out.size() < OUTPUT_LIMIT;
+            // Batch responses while requests keep arriving, flush as soon as the input goes quiet
+            bool flushing = !out.empty() && (!input || !busy() || out.size() >= 4096);
+            struct pollfd p[2] = {{in_fd, static_cast<short>(reading ? POLLIN : 0), 0},
+                                  {out_fd, static_cast<short>(flushing ? POLLOUT : 0), 0}};
+            input = false;
+            if (poll(p, 2, busy() ? 0 : -1) > 0) {
+                if (reading && p[0].revents) {
+                    ssize_t got = read(in_fd, buffer, sizeof(buffer));
+                    if (got > 0) {
+                        in.append(buffer, got);
+                        running = parse(in, out);
+                        input = true;
+                    } else if (got == 0 || (errno != EAGAIN && errno != EINTR)) {
+                        open = false;
+                    }
+                }
+                if (flushing && p[1].revents) {
+                    ssize_t put = write(out_fd, out.data(), out.size());
+                    if (put > 0) {
+                        out.erase(0, put);
+                    } else if (errno != EAGAIN && errno != EINTR) {
+                        open = false;
+                        out.clear();
+                    }
+                }
+            }
+            if (busy()) {
+                cycle(out);
+            }
+        }
+        fcntl(out_fd, F_SETFL, out_flags);
+        report();
+        return running;
+    }
+
+    void report() {
+        if (latency_us.empty()) {
+            return;
+        }
+        std::sort(latency_us.begin(), latency_us.end());
+        size_t n = latency_us.size();
+        fprintf(stderr, "served %zu requests, simulated %ld ns, latency us: p50 %.2f p90 %.2f p99 %.2f p99.9 %.2f max %.2f\n",
+                n, step, latency_us[n / 2], latency_us[n * 9 / 10], latency_us[n * 99 / 100], latency_us[n * 999 / 1000],
+                latency_us[n - 1]);
+    }
+
+    static bool write_all(int fd, const char* data, size_t size) {
+        while (size > 0) {
+            ssize_t put = write(fd, data, size);
+            if (put <= 0) {
+                return false;
+            }
+            data += put;
+            size -= put;
+        }
+        return true;
+    }
+};
+
+int listen_unix(const char* path) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+    unlink(path);
+    if (fd < 0 || bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0 || listen(fd, 4) < 0) {
+        perror("socket");
+        return -1;
+    }
+    return fd;
+}
+
+int connect_unix(const char* path) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+    if (fd < 0 || connect(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0) {
+        perror("connect");
+        return -1;
+    }
+    return fd;
+}
+
+// Benchmark client: keeps up to window requests outstanding, checks every result
+// against the functional models and reports round-trip latency percentiles
+int run_client(const char* path, int n, int window, bool shutdown) {
+    int fd = connect_unix(path);
+    if (fd < 0) {
+        return 1;
+    }
+    srand(1);
+    std::vector<unsigned int> a(n), b(n);
+    std::vector<int> ops(n);
+    std::vector<host_clock::time_point> sent_at(n);
+    std::vector<double> round_trip;
+    for (int i = 0; i < n; i++) {
+        float a_float = ldexpf(static_cast<float>(rand()) / RAND_MAX, rand() % 16 - 8);
+        float b_float = ldexpf(static_cast<float>(rand()) / RAND_MAX, rand() % 16 - 8);
+        memcpy(&a[i], &a_float, 4);
+        memcpy(&b[i], &b_float, 4);
+        ops[i] = rand() % 4;
+    }
+
+    // Requests and responses are interleaved on a non-blocking socket: the window
+    // is topped up into out, which drains whenever the socket has room, and
+    // responses are read as soon as they arrive
+    int sent = 0, received = 0, mismatches = 0;
+    bool failed = false;
+    std::vector<bool> answered(n, false);
+    std::string in, out;
+    char buffer[65536];
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    host_clock::time_point start = host_clock::now();
+    while (received < n && !failed) {
+        while (sent < n && sent - received < window) {
+            char frame[REQUEST_BYTES];
+            unsigned int tag = sent;
+            frame[0] = static_cast<char>(ops[sent]);
+            memcpy(frame + 1, &tag, 4);
+            memcpy(frame + 5, &a[sent], 4);
+            memcpy(frame + 9, &b[sent], 4);
+            out.append(frame, REQUEST_BYTES);
+            sent_at[sent] = host_clock::now();
+            sent++;
+        }
+        struct pollfd p = {fd, static_cast<short>(POLLIN | (out.empty() ? 0 : POLLOUT)), 0};
+        if (poll(&p, 1, -1) <= 0) {
+            continue;
+        }
+        if (p.revents & POLLOUT) {
+            ssize_t put = write(fd, out.data(), out.size());
+            if (put > 0) {
+                out.erase(0, put);
+            } else if (errno != EAGAIN && errno != EINTR) {
+                break;
+            }
+        }
+        if (!(p.revents & (POLLIN | POLLHUP | POLLERR))) {
+            continue;
+        }
+        ssize_t got = read(fd, buffer, sizeof(buffer));
+        if (got == 0 || (got < 0 && errno != EAGAIN && errno != EINTR)) {
+            break;
+        }
+        if (got < 0) {
+            continue;
+        }
+        in.append(buffer, got);
+        host_clock::time_point now = host_clock::now();
+        size_t pos = 0;
+        for (; in.size() - pos >= RESPONSE_BYTES; pos += RESPONSE_BYTES) {
+            unsigned int tag, value;
+            memcpy(&tag, in.data() + pos, 4);
+            memcpy(&value, in.data() + pos + 5, 4);
+            if (tag >= static_cast<unsigned int>(sent) || answered[tag]) {
+                cerr << "Unexpected response tag " << tag << endl;
+                failed = true;
+                break;
+            }
+            answered[tag] = true;
+            unsigned int expected = (ops[tag] == FPU_ADD) ? addition_function(a[tag], b[tag])
+                                  : (ops[tag] == FPU_SUB) ? subtraction_function(a[tag], b[tag])
+                                  : (ops[tag] == FPU_MUL) ? multiplication_function(a[tag], b[tag])
+                                  : division_function(a[tag], b[tag]);
+            mismatches += (in[pos + 4] != STATUS_OK || value != expected);
+            round_trip.push_back(std::chrono::duration<double, std::micro>(now - sent_at[tag]).count());
+            received++;
+        }
+        in.erase(0, pos);
+    }
+    double host = std::chrono::duration<double>(host_clock::now() - start).count();
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_NONBLOCK);
+    if (shutdown) {
+        char frame[REQUEST_BYTES] = {static_cast<char>(OP_SHUTDOWN)};
+        FpuServer::write_all(fd, frame, REQUEST_BYTES);
+    }
+    close(fd);
+
+    std::sort(round_trip.begin(), round_trip.end());
+    size_t m = round_trip.size();
+    if (m == 0) {
+        cout << "No responses" << endl;
+        return 1;
+    }
+    if (received < n) {
+        cout << "Only " << received << " of " << n << " responses received" << endl;
+    }
+    cout << received << " requests, window " << window << ", " << host * 1e3 << " ms (" << host * 1e9 / received
+         << " ns/request), mismatches " << mismatches << endl;
+    cout << "Round trip us: p50 " << round_trip[m / 2] << " p90 " << round_trip[m * 9 / 10] << " p99 "
+         << round_trip[m * 99 / 100] << " max " << round_trip[m - 1] << endl;
+    return (failed || received < n) ? 1 : 0;
+}
+
+int sc_main(int argc, char* argv[]) {
+    std::string mode = (argc > 1) ? argv[1] : "";
+    if (mode == "--client" && argc > 4) {
+        return run_client(argv[2], atoi(argv[3]), atoi(argv[4]), argc > 5 && std::string(argv[5]) == "--shutdown");
+    }
+    if (mode != "--stdin" && !(mode == "--socket" && argc > 2)) {
+        cerr << "Usage: " << argv[0] << " --stdin | --socket <path> | --client <path> <requests> <window> [--shutdown]" << endl;
+        return 1;
+    }
+
+    // Elaborated once; every request after this only pays for its own cycles
+    FpuServer server;
+    signal(SIGPIPE, SIG_IGN);
+    if (mode == "--stdin") {
+        server.serve(STDIN_FILENO, STDOUT_FILENO);
+        return 0;
+    }
+    int listener = listen_unix(argv[2]);
+    if (listener < 0) {
+        return 1;
+    }
+    bool running = true;
+    while (running) {
+        int fd = accept(listener, NULL, NULL);
+        if (fd < 0) {
+            continue;
+        }
+        running = server.serve(fd, fd);
+        close(fd);
+    }
+    close(listener);
+    unlink(argv[2]);
+    return 0;
+}
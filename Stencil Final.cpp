@@ -0,0 +1,931 @@
+#include <systemc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <bitset>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "fpu_models.h"
+#include "fpu_pipelines.h"
+
+// MultiplyPipe Module
+// The three multiplier stages on a shared clock. The multiplier has no zero
+// special case, so a zero operand forces the product to +0, as in the
+// systolic array's processing element.
+SC_MODULE(MultiplyPipe) {
+    sc_in<sc_uint<32>> a;
+    sc_in<sc_uint<32>> b;
+    sc_out<sc_uint<32>> result;
+    sc_in<bool> clock;
+
+    multiplication::FloatingPointExtractor extractor;
+    multiplication::FloatingPointMultiplier multiplier;
+    multiplication::FloatingPointNormalizer normalizer;
+    sc_signal<bool> a_sign, b_sign, result_sign;
+    sc_signal<sc_uint<8>> a_exp, b_exp, result_exp;
+    sc_signal<sc_uint<32>> a_significand, b_significand, result_significand, result_significand0;
+    sc_signal<sc_uint<32>> product;
+    sc_signal<bool> zero_flag;
+
+    void zero_process() {
+        bool zero_delay[2] = {false, false};
+        while (true) {
+            wait();
+            zero_flag.write(zero_delay[1]);
+            zero_delay[1] = zero_delay[0];
+            zero_delay[0] = ((a.read() & 0x7FFFFFFF) == 0) || ((b.read() & 0x7FFFFFFF) == 0);
+        }
+    }
+
+    void gate_process() {
+        result.write(zero_flag.read() ? sc_uint<32>(0) : product.read());
+    }
+
+    SC_CTOR(MultiplyPipe)
+        : a("a"), b("b"), result("result"), clock("clock"), extractor("Extractor"), multiplier("Multiplier"),
+          normalizer("Normalizer") {
+        extractor.a(a);
+        extractor.b(b);
+        extractor.a_sign(a_sign);
+        extractor.a_exp(a_exp);
+        extractor.a_significand(a_significand);
+        extractor.b_sign(b_sign);
+        extractor.b_exp(b_exp);
+        extractor.b_significand(b_significand);
+        extractor.clock(clock);
+
+        multiplier.a_sign(a_sign);
+        multiplier.a_exp(a_exp);
+        multiplier.a_significand(a_significand);
+        multiplier.b_sign(b_sign);
+        multiplier.b_exp(b_exp);
+        multiplier.b_significand(b_significand);
+        multiplier.result_sign(result_sign);
+        multiplier.result_exp(result_exp);
+        multiplier.result_significand(result_significand);
+        multiplier.result_significand1(result_significand0);
+        multiplier.clock(clock);
+
+        normalizer.result_sign(result_sign);
+        normalizer.result_exp(result_exp);
+        normalizer.result_significand(result_significand);
+        normalizer.result_significand1(result_significand0);
+        normalizer.normalized_result(product);
+        normalizer.clock(clock);
+
+        SC_THREAD(zero_process);
+        sensitive << clock.pos();
+        SC_METHOD(gate_process);
+        sensitive << product << zero_flag;
+    }
+};
+
+// AddPipe Module: the three adder stages on a shared clock
+SC_MODULE(AddPipe) {
+    sc_in<sc_uint<32>> a;
+    sc_in<sc_uint<32>> b;
+    sc_out<sc_uint<32>> result;
+    sc_in<bool> clock;
+
+    addition::FloatingPointExtractor extractor;
+    addition::FloatingPointAdder adder;
+    addition::FloatingPointNormaliser normaliser;
+    sc_signal<bool> a_sign, b_sign, result_sign;
+    sc_signal<sc_uint<8>> a_exp, b_exp, result_exp;
+    sc_signal<sc_uint<32>> a_significands, b_significands, result_significand;
+
+    SC_CTOR(AddPipe)
+        : a("a"), b("b"), result("result"), clock("clock"), extractor("Extractor"), adder("Adder"), normaliser("Normalization") {
+        extractor.a(a);
+        extractor.b(b);
+        extractor.a_sign(a_sign);
+        extractor.a_exp(a_exp);
+        extractor.a_significand(a_significands);
+        extractor.b_sign(b_sign);
+        extractor.b_exp(b_exp);
+        extractor.b_significand(b_significands);
+        extractor.clock(clock);
+
+        adder.a_sign(a_sign);
+        adder.a_exp(a_exp);
+        adder.a_significand(a_significands);
+        adder.b_sign(b_sign);
+        adder.b_exp(b_exp);
+        adder.b_significand(b_significands);
+        adder.result_sign(result_sign);
+        adder.result_exp(result_exp);
+        adder.result_significand(result_significand);
+        adder.clock(clock);
+
+        normaliser.result_sign(result_sign);
+        normaliser.result_exp(result_exp);
+        normaliser.result_significand(result_significand);
+        normaliser.nresult(result);
+        normaliser.clock(clock);
+    }
+};
+
+// DelayLine Module: holds a word for depth clock edges, to keep operands in
+// step with a parallel pipeline. A depth of PIPE_DELAY matches one MultiplyPipe,
+// AddPipe or SubPipe.
+#define PIPE_DELAY 2
+SC_MODULE(DelayLine) {
+    sc_in<sc_uint<32>> data_in;
+    sc_out<sc_uint<32>> data_out;
+    sc_in<bool> clock;
+    int depth;
+
+    void shift_process() {
+        std::vector<unsigned int> data(depth, 0);
+        while (true) {
+            wait();
+            data_out.write(data[depth - 1]);
+            for (int i = depth - 1; i > 0; i--) {
+                data[i] = data[i - 1];
+            }
+            data[0] = data_in.read();
+        }
+    }
+
+    SC_HAS_PROCESS(DelayLine);
+    DelayLine(sc_module_name name, int depth)
+        : sc_module(name), data_in("data_in"), data_out("data_out"), clock("clock"), depth(depth) {
+        SC_THREAD(shift_process);
+        sensitive << clock.pos();
+    }
+};
+
+
+// Fused multi-operand adder stages from Multi Operand Addition Final
+#define MAX_OPERANDS 8
+
+// MultiOperandExtractor Module
+// Unpacks every operand in parallel. NaN and infinity operands are resolved here
+// for the whole reduction and travel down the pipeline as a special result.
+SC_MODULE(MultiOperandExtractor) {
+    sc_in<sc_uint<32>> x[MAX_OPERANDS];
+    sc_in<bool> in_valid;
+    sc_out<bool> x_sign[MAX_OPERANDS];
+    sc_out<sc_uint<8>> x_exp[MAX_OPERANDS];
+    sc_out<sc_uint<32>> x_significand[MAX_OPERANDS];
+    sc_out<bool> special;
+    sc_out<sc_uint<32>> special_result;
+    sc_out<bool> valid;
+    sc_in<bool> clock;
+    int operands;
+
+    void extraction_process() {
+        while (true) {
+            wait();
+            bool nan = false;
+            bool pos_inf = false;
+            bool neg_inf = false;
+            bool all_neg_zero = true;
+            //Extraction
+            for (int k = 0; k < MAX_OPERANDS; k++) {
+                if (k >= operands) {
+                    // Unused lanes contribute +0
+                    x_sign[k].write(false);
+                    x_exp[k].write(1);
+                    x_significand[k].write(0);
+                    continue;
+                }
+                bool sign0 = (x[k].read() & 0x80000000) >> 31;
+                unsigned int exp0 = (x[k].read() & 0x7f800000) >> 23;
+                unsigned int significand0 = (x[k].read() & 0x7fffff);
+
+                unsigned int significand1 = (exp0 >= 1) ? (significand0 | (1 << 23)) : significand0;
+                unsigned int exp1 = ((exp0 == 0) ? 1 : exp0);
+
+                //Special Cases
+                if (exp0 == 255 && significand0 != 0) {
+                    nan = true;
+                } else if (exp0 == 255) {
+                    pos_inf = pos_inf || !sign0;
+                    neg_inf = neg_inf || sign0;
+                }
+                all_neg_zero = all_neg_zero && sign0 && exp0 == 0 && significand0 == 0;
+
+                x_sign[k].write(sign0);
+                x_exp[k].write(static_cast<sc_uint<8>>(exp1));
+                x_significand[k].write(significand1);
+            }
+
+            if (nan || (pos_inf && neg_inf)) {
+                special.write(true);
+                special_result.write(0x7FC00000);
+            } else if (pos_inf || neg_inf) {
+                special.write(true);
+                special_result.write(neg_inf ? 0xFF800000 : 0x7F800000);
+            } else if (all_neg_zero) {
+                special.write(true);
+                special_result.write(0x80000000);
+            } else {
+                special.write(false);
+                special_result.write(0);
+            }
+            valid.write(in_valid.read());
+        }
+    }
+
+    SC_HAS_PROCESS(MultiOperandExtractor);
+    MultiOperandExtractor(sc_module_name name, int operands)
+        : sc_module(name),
+          in_valid("in_valid"),
+          special("special"),
+          special_result("special_result"),
+          valid("valid"),
+          clock("clock"),
+          operands(operands) {
+        SC_THREAD(extraction_process);
+        sensitive << clock.pos();
+    }
+};
+
+// MultiOperandAligner Module
+// Aligns all significands to the largest exponent in one step. Significands are
+// widened by 30 guard bits, bits shifted off the bottom are jammed into the LSB
+// and negative operands are converted to two's complement for the CSA tree.
+SC_MODULE(MultiOperandAligner) {
+    sc_in<bool> x_sign[MAX_OPERANDS];
+    sc_in<sc_uint<8>> x_exp[MAX_OPERANDS];
+    sc_in<sc_uint<32>> x_significand[MAX_OPERANDS];
+    sc_in<bool> special_in;
+    sc_in<sc_uint<32>> special_result_in;
+    sc_in<bool> in_valid;
+    sc_out<sc_uint<64>> aligned[MAX_OPERANDS];
+    sc_out<sc_uint<8>> max_exp;
+    sc_out<bool> special;
+    sc_out<sc_uint<32>> special_result;
+    sc_out<bool> valid;
+    sc_in<bool> clock;
+
+    void alignment_process() {
+        while (true) {
+            wait();
+
+            //Maximum exponent
+            unsigned int ans_exp = 0;
+            for (int k = 0; k < MAX_OPERANDS; k++) {
+                if (x_exp[k].read() > ans_exp) {
+                    ans_exp = x_exp[k].read();
+                }
+            }
+
+            //Exponent Shifting
+            for (int k = 0; k < MAX_OPERANDS; k++) {
+                unsigned int shift = ans_exp - x_exp[k].read();
+                uint64_t wide = static_cast<uint64_t>(x_significand[k].read()) << 30;
+                uint64_t shifted = (shift > 63) ? 0 : (wide >> shift);
+                bool sticky = (shift > 63) ? (wide != 0) : ((wide & ((1ULL << shift) - 1)) != 0);
+                shifted = shifted | sticky;
+                aligned[k].write(x_sign[k].read() ? (~shifted + 1) : shifted);
+            }
+
+            max_exp.write(static_cast<sc_uint<8>>(ans_exp));
+            special.write(special_in.read());
+            special_result.write(special_result_in.read());
+            valid.write(in_valid.read());
+        }
+    }
+
+    SC_CTOR(MultiOperandAligner)
+        : special_in("special_in"),
+          special_result_in("special_result_in"),
+          in_valid("in_valid"),
+          max_exp("max_exp"),
+          special("special"),
+          special_result("special_result"),
+          valid("valid"),
+          clock("clock") {
+        SC_THREAD(alignment_process);
+        sensitive << clock.pos();
+    }
+};
+
+// CarrySaveTree Module
+// Reduces the aligned operands to a sum and a carry vector with 3:2 compressors,
+// so no carry propagates until the single adder in the normaliser.
+SC_MODULE(CarrySaveTree) {
+    sc_in<sc_uint<64>> aligned[MAX_OPERANDS];
+    sc_in<sc_uint<8>> max_exp_in;
+    sc_in<bool> special_in;
+    sc_in<sc_uint<32>> special_result_in;
+    sc_in<bool> in_valid;
+    sc_out<sc_uint<64>> sum_vector;
+    sc_out<sc_uint<64>> carry_vector;
+    sc_out<sc_uint<8>> max_exp;
+    sc_out<bool> special;
+    sc_out<sc_uint<32>> special_result;
+    sc_out<bool> valid;
+    sc_in<bool> clock;
+
+    void csa_process() {
+        while (true) {
+            wait();
+
+            uint64_t rows[MAX_OPERANDS];
+            int n = MAX_OPERANDS;
+            for (int k = 0; k < MAX_OPERANDS; k++) {
+                rows[k] = aligned[k].read();
+            }
+
+            //3:2 compression until two rows are left
+            while (n > 2) {
+                int m = 0;
+                int k = 0;
+                for (; k + 2 < n; k += 3) {
+                    uint64_t s = rows[k] ^ rows[k + 1] ^ rows[k + 2];
+                    uint64_t c = ((rows[k] & rows[k + 1]) | (rows[k] & rows[k + 2]) | (rows[k + 1] & rows[k + 2])) << 1;
+                    rows[m++] = s;
+                    rows[m++] = c;
+                }
+                for (; k < n; k++) {
+                    rows[m++] = rows[k];
+                }
+                n = m;
+            }
+
+            sum_vector.write(rows[0]);
+            carry_vector.write(rows[1]);
+            max_exp.write(max_exp_in.read());
+            special.write(special_in.read());
+            special_result.write(special_result_in.read());
+            valid.write(in_valid.read());
+        }
+    }
+
+    SC_CTOR(CarrySaveTree)
+        : max_exp_in("max_exp_in"),
+          special_in("special_in"),
+          special_result_in("special_result_in"),
+          in_valid("in_valid"),
+          sum_vector("sum_vector"),
+          carry_vector("carry_vector"),
+          max_exp("max_exp"),
+          special("special"),
+          special_result("special_result"),
+          valid("valid"),
+          clock("clock") {
+        SC_THREAD(csa_process);
+        sensitive << clock.pos();
+    }
+};
+
+// MultiOperandNormaliser Module
+// Final carry-propagate add, leading-one detection and a single
+// round-to-nearest-even for the whole reduction.
+SC_MODULE(MultiOperandNormaliser) {
+    sc_in<sc_uint<64>> sum_vector;
+    sc_in<sc_uint<64>> carry_vector;
+    sc_in<sc_uint<8>> max_exp;
+    sc_in<bool> special;
+    sc_in<sc_uint<32>> special_result;
+    sc_in<bool> in_valid;
+    sc_out<sc_uint<32>> nresult;
+    sc_out<bool> valid;
+    sc_in<bool> clock;
+
+    void normal_process() {
+        while (true) {
+            wait();
+
+            int64_t total = static_cast<int64_t>(sum_vector.read() + carry_vector.read());
+            bool ans_sign = total < 0;
+            uint64_t magnitude = ans_sign ? (~static_cast<uint64_t>(total) + 1) : static_cast<uint64_t>(total);
+            int exp_max = max_exp.read();
+            unsigned int ans;
+
+            if (special.read()) {
+                ans = special_result.read();
+            } else if (magnitude == 0) {
+                //When answer is zero
+                ans = 0;
+            } else {
+                /* Normalization */
+                int i;
+                for (i = 63; i > 0 && ((magnitude >> i) == 0); i--) {;}
+
+                // Value is magnitude * 2^(max_exp - 127 - 23 - 30)
+                int ans_exp = exp_max + i - 53;
+                int shift = (ans_exp >= 1) ? (i - 23) : (31 - exp_max);
+                uint64_t ans_significand;
+
+                if (shift > 0) {
+                    //Rounding
+                    int s = (shift > 63) ? 63 : shift;
+                    uint64_t guard = (magnitude >> (s - 1)) & 1;
+                    bool sticky = (magnitude & ((1ULL << (s - 1)) - 1)) != 0;
+                    ans_significand = (shift > 63) ? 0 : (magnitude >> s);
+                    if (guard == 1 && (sticky || (ans_significand & 1) == 1)) {
+                        ans_significand += 1;
+                    }
+                } else {
+                    ans_significand = magnitude << (-shift);
+                }
+
+                if (ans_exp >= 1) {
+                    if ((ans_significand >> 24) == 1) {
+                        ans_significand = (ans_significand >> 1);
+                        ans_exp += 1;
+                    }
+                    //Overflow
+                    if (ans_exp >= 255) {
+                        ans = (ans_sign << 31) | 0x7F800000;
+                    } else {
+                        ans = (ans_sign << 31) | (ans_exp << 23) | (ans_significand & 0x7FFFFF);
+                    }
+                } else {
+                    //Underflow: subnormal result, rounding into bit 23 gives the smallest normal
+                    ans = (ans_sign << 31) | static_cast<unsigned int>(ans_significand);
+                }
+            }
+
+            nresult.write(ans);
+            valid.write(in_valid.read());
+        }
+    }
+
+    SC_CTOR(MultiOperandNormaliser)
+        : sum_vector("sum_vector"),
+          carry_vector("carry_vector"),
+          max_exp("max_exp"),
+          special("special"),
+          special_result("special_result"),
+          in_valid("in_valid"),
+          nresult("nresult"),
+          valid("valid"),
+          clock("clock") {
+        SC_THREAD(normal_process);
+        sensitive << clock.pos();
+    }
+};
+
+uint32_t product_function(uint32_t x, uint32_t y) {
+    return ((x & 0x7FFFFFFF) == 0 || (y & 0x7FFFFFFF) == 0) ? 0 : multiplication_function(x, y);
+}
+
+long ulp_distance(uint32_t x, uint32_t y) {
+    long a = (x & 0x80000000) ? -static_cast<long>(x & 0x7FFFFFFF) : static_cast<long>(x);
+    long b = (y & 0x80000000) ? -static_cast<long>(y & 0x7FFFFFFF) : static_cast<long>(y);
+    return labs(a - b);
+}
+
+
+// MultiOperandAdder Module: the four fused stages on a shared clock. Lanes at
+// or beyond operands contribute +0.
+SC_MODULE(MultiOperandAdder) {
+    sc_in<sc_uint<32>> x[MAX_OPERANDS];
+    sc_out<sc_uint<32>> result;
+    sc_in<bool> clock;
+
+    MultiOperandExtractor extractor;
+    MultiOperandAligner aligner;
+    CarrySaveTree csa;
+    MultiOperandNormaliser normalization;
+    sc_signal<bool> in_valid;
+    sc_signal<bool> x_sign[MAX_OPERANDS];
+    sc_signal<sc_uint<8>> x_exp[MAX_OPERANDS];
+    sc_signal<sc_uint<32>> x_significands[MAX_OPERANDS];
+    sc_signal<sc_uint<64>> aligned[MAX_OPERANDS];
+    sc_signal<sc_uint<8>> max_exp[2];
+    sc_signal<bool> special[3];
+    sc_signal<sc_uint<32>> special_result[3];
+    sc_signal<bool> valid[4];
+    sc_signal<sc_uint<64>> sum_vector;
+    sc_signal<sc_uint<64>> carry_vector;
+
+    SC_HAS_PROCESS(MultiOperandAdder);
+    MultiOperandAdder(sc_module_name name, int operands)
+        : sc_module(name),
+          result("result"),
+          clock("clock"),
+          extractor("Extractor", operands),
+          aligner("Aligner"),
+          csa("CarrySaveTree"),
+          normalization("Normalization") {
+        for (int k = 0; k < MAX_OPERANDS; k++) {
+            extractor.x[k](x[k]);
+            extractor.x_sign[k](x_sign[k]);
+            extractor.x_exp[k](x_exp[k]);
+            extractor.x_significand[k](x_significands[k]);
+
+            aligner.x_sign[k](x_sign[k]);
+            aligner.x_exp[k](x_exp[k]);
+            aligner.x_significand[k](x_significands[k]);
+            aligner.aligned[k](aligned[k]);
+
+            csa.aligned[k](aligned[k]);
+        }
+        extractor.in_valid(in_valid);
+        extractor.special(special[0]);
+        extractor.special_result(special_result[0]);
+        extractor.valid(valid[0]);
+        extractor.clock(clock);
+
+        aligner.special_in(special[0]);
+        aligner.special_result_in(special_result[0]);
+        aligner.in_valid(valid[0]);
+        aligner.max_exp(max_exp[0]);
+        aligner.special(special[1]);
+        aligner.special_result(special_result[1]);
+        aligner.valid(valid[1]);
+        aligner.clock(clock);
+
+        csa.max_exp_in(max_exp[0]);
+        csa.special_in(special[1]);
+        csa.special_result_in(special_result[1]);
+        csa.in_valid(valid[1]);
+        csa.sum_vector(sum_vector);
+        csa.carry_vector(carry_vector);
+        csa.max_exp(max_exp[1]);
+        csa.special(special[2]);
+        csa.special_result(special_result[2]);
+        csa.valid(valid[2]);
+        csa.clock(clock);
+
+        normalization.sum_vector(sum_vector);
+        normalization.carry_vector(carry_vector);
+        normalization.max_exp(max_exp[1]);
+        normalization.special(special[2]);
+        normalization.special_result(special_result[2]);
+        normalization.in_valid(valid[2]);
+        normalization.nresult(result);
+        normalization.valid(valid[3]);
+        normalization.clock(clock);
+    }
+};
+
+#define MAX_TAPS 27
+
+struct Grid {
+    long nx, ny, nz;
+};
+
+struct Tap {
+    long offset;             // from the centre, in raster order
+    uint32_t coefficient;
+};
+
+// Taps in raster order. The 7-point stencil has the centre and its six face
+// neighbours; the 27-point stencil adds the 12 edge and 8 corner neighbours.
+// Weights fall off with the distance class, as in a smoothed Laplacian update.
+std::vector<Tap> stencil_taps(const Grid& g, int points) {
+    const float weights[2][4] = {{0.4f, 0.1f, 0.0f, 0.0f}, {0.3f, 0.05f, 0.02f, 0.01f}};
+    std::vector<Tap> taps;
+    for (int dz = -1; dz <= 1; dz++) {
+        for (int dy = -1; dy <= 1; dy++) {
+            for (int dx = -1; dx <= 1; dx++) {
+                int distance = abs(dx) + abs(dy) + abs(dz);
+                if (points == 7 && distance > 1) {
+                    continue;
+                }
+                float w = weights[points == 27][distance];
+                uint32_t bits;
+                memcpy(&bits, &w, 4);
+                taps.push_back(Tap{(dz * g.ny + dy) * g.nx + dx, bits});
+            }
+        }
+    }
+    return taps;
+}
+
+// Reach of the window either side of its centre: the buffer holds 2 * reach + 1
+// points, so every point is loaded once and read by all the windows that use it
+long stencil_reach(const Grid& g, int points) {
+    return (points == 7) ? g.nx * g.ny : g.nx * g.ny + g.nx + 1;
+}
+
+long buffer_words(const Grid& g, int points) {
+    return 2 * stencil_reach(g, points) + 1;
+}
+
+// WindowBuffer Module
+// Line and plane buffer: a circular buffer of 2 * reach + 1 points. Each arriving
+// point completes the window centred reach points earlier; interior centres
+// drive all taps at once together with their raster index + 1 as a tag, and
+// boundary centres drive a tag of 0.
+struct WindowBuffer : public sc_module {
+    sc_in<sc_uint<32>> x;
+    sc_in<bool> in_valid;
+    sc_out<sc_uint<32>> tap[MAX_TAPS];
+    sc_out<sc_uint<32>> tag;
+    sc_in<bool> clock;
+
+    Grid grid;
+    std::vector<Tap> taps;
+    long reach;
+
+    void window_process() {
+        long words = 2 * reach + 1, count = 0;
+        std::vector<uint32_t> buffer(words, 0);
+        while (true) {
+            wait();
+            bool arrived = in_valid.read();
+            if (arrived) {
+                buffer[count % words] = x.read();
+                count++;
+            }
+            long centre = count - 1 - reach;
+            long cx = centre % grid.nx, cy = (centre / grid.nx) % grid.ny, cz = centre / (grid.nx * grid.ny);
+            bool interior = arrived && centre >= 0 && cx >= 1 && cx < grid.nx - 1 && cy >= 1 && cy < grid.ny - 1 && cz >= 1 &&
+                            cz < grid.nz - 1;
+            for (size_t t = 0; t < taps.size(); t++) {
+                tap[t].write(interior ? buffer[(centre + taps[t].offset) % words] : 0);
+            }
+            tag.write(interior ? centre + 1 : 0);
+        }
+    }
+
+    SC_HAS_PROCESS(WindowBuffer);
+    WindowBuffer(sc_module_name name, const Grid& grid, const std::vector<Tap>& taps, long reach)
+        : sc_module(name), x("x"), in_valid("in_valid"), tag("tag"), clock("clock"), grid(grid), taps(taps), reach(reach) {
+        SC_THREAD(window_process);
+        sensitive << clock.pos();
+    }
+};
+
+// Top-level Module
+// WindowBuffer -> one MultiplyPipe per tap against its coefficient -> reduction,
+// either a tree of two-input AddPipes (an odd operand waits in a DelayLine) or
+// levels of fused MultiOperandAdders of up to MAX_OPERANDS products. The tag
+// travels beside the datapath in a DelayLine. One point in per 1 ns cycle.
+struct Top : public sc_module {
+    WindowBuffer* window;
+    std::vector<MultiplyPipe*> multipliers;
+    std::vector<AddPipe*> adders;
+    std::vector<MultiOperandAdder*> fused_adders;
+    std::vector<DelayLine*> delays;
+    DelayLine* tag_delay;
+    std::vector<sc_signal<sc_uint<32>>*> wires;
+    sc_signal<sc_uint<32>> x, tag, zero;
+    sc_signal<bool> in_valid;
+    sc_signal<sc_uint<32>>* result;
+    sc_signal<sc_uint<32>> result_tag;
+    sc_clock clock;
+    int levels;
+    int stages;
+
+    sc_signal<sc_uint<32>>* wire() {
+        wires.push_back(new sc_signal<sc_uint<32>>());
+        return wires.back();
+    }
+
+    Top(sc_module_name name, const Grid& grid, const std::vector<Tap>& taps, long reach, bool fused)
+        : sc_module(name), clock("clock", 1, SC_NS), levels(0), stages(3) {
+        window = new WindowBuffer("Window", grid, taps, reach);
+        window->x(x);
+        window->in_valid(in_valid);
+        window->tag(tag);
+        window->clock(clock);
+
+        std::vector<sc_signal<sc_uint<32>>*> level;
+        for (int t = 0; t < MAX_TAPS; t++) {
+            sc_signal<sc_uint<32>>* operand = wire();
+            window->tap[t](*operand);
+            if (t >= static_cast<int>(taps.size())) {
+                continue;
+            }
+            sc_signal<sc_uint<32>>* coefficient = wire();
+            coefficient->write(taps[t].coefficient);
+            MultiplyPipe* m = new MultiplyPipe(("Multiply" + std::to_string(t)).c_str());
+            m->a(*operand);
+            m->b(*coefficient);
+            level.push_back(wire());
+            m->result(*level.back());
+            m->clock(clock);
+            multipliers.push_back(m);
+        }
+
+        while (level.size() > 1) {
+            std::vector<sc_signal<sc_uint<32>>*> next;
+            if (fused) {
+                for (size_t k = 0; k < level.size(); k += MAX_OPERANDS) {
+                    int operands = std::min<int>(MAX_OPERANDS, level.size() - k);
+                    MultiOperandAdder* f = new MultiOperandAdder(("Fused" + std::to_string(fused_adders.size())).c_str(), operands);
+                    for (int i = 0; i < MAX_OPERANDS; i++) {
+                        f->x[i]((i < operands) ? *level[k + i] : zero);
+                    }
+                    next.push_back(wire());
+                    f->result(*next.back());
+                    f->clock(clock);
+                    fused_adders.push_back(f);
+                }
+                stages += 4;
+            } else {
+                for (size_t k = 0; k < level.size(); k += 2) {
+                    next.push_back(wire());
+                    if (k + 1 < level.size()) {
+                        AddPipe* a = new AddPipe(("Add" + std::to_string(adders.size())).c_str());
+                        a->a(*level[k]);
+                        a->b(*level[k + 1]);
+                        a->result(*next.back());
+                        a->clock(clock);
+                        adders.push_back(a);
+                    } else {
+                        DelayLine* d = new DelayLine(("Delay" + std::to_string(delays.size())).c_str(), PIPE_DELAY);
+                        d->data_in(*level[k]);
+                        d->data_out(*next.back());
+                        d->clock(clock);
+                        delays.push_back(d);
+                    }
+                }
+                stages += 3;
+            }
+            level = next;
+            levels++;
+        }
+        result = level[0];
+
+        tag_delay = new DelayLine("TagDelay", stages - 1);
+        tag_delay->data_in(tag);
+        tag_delay->data_out(result_tag);
+        tag_delay->clock(clock);
+    }
+};
+
+// Fused multi-operand adder: extraction, alignment to the largest exponent with
+// 30 guard bits and a jammed sticky bit, an exact sum, then the normaliser
+uint32_t multi_operand_function(const std::vector<uint32_t>& x) {
+    bool nan = false, pos_inf = false, neg_inf = false, all_neg_zero = true;
+    unsigned int max_exp = 0;
+    std::vector<unsigned int> exps(x.size()), significands(x.size());
+    for (size_t k = 0; k < x.size(); k++) {
+        bool sign0 = (x[k] & 0x80000000) != 0;
+        unsigned int exp0 = (x[k] & 0x7F800000) >> 23, significand0 = x[k] & 0x7FFFFF;
+        significands[k] = (exp0 >= 1) ? (significand0 | (1 << 23)) : significand0;
+        exps[k] = (exp0 == 0) ? 1 : exp0;
+        if (exp0 == 255 && significand0 != 0) {
+            nan = true;
+        } else if (exp0 == 255) {
+            pos_inf = pos_inf || !sign0;
+            neg_inf = neg_inf || sign0;
+        }
+        all_neg_zero = all_neg_zero && sign0 && exp0 == 0 && significand0 == 0;
+        max_exp = std::max(max_exp, exps[k]);
+    }
+    if (nan || (pos_inf && neg_inf)) {
+        return 0x7FC00000;
+    } else if (pos_inf || neg_inf) {
+        return neg_inf ? 0xFF800000 : 0x7F800000;
+    } else if (all_neg_zero) {
+        return 0x80000000;
+    }
+
+    uint64_t sum = 0;
+    for (size_t k = 0; k < x.size(); k++) {
+        unsigned int shift = max_exp - exps[k];
+        uint64_t wide = static_cast<uint64_t>(significands[k]) << 30;
+        uint64_t shifted = (shift > 63) ? 0 : (wide >> shift);
+        bool sticky = (shift > 63) ? (wide != 0) : ((wide & ((1ULL << shift) - 1)) != 0);
+        shifted = shifted | sticky;
+        sum += (x[k] & 0x80000000) ? (~shifted + 1) : shifted;
+    }
+
+    int64_t total = static_cast<int64_t>(sum);
+    bool ans_sign = total < 0;
+    uint64_t magnitude = ans_sign ? (~static_cast<uint64_t>(total) + 1) : static_cast<uint64_t>(total);
+    if (magnitude == 0) {
+        return 0;
+    }
+    int i;
+    for (i = 63; i > 0 && ((magnitude >> i) == 0); i--) {;}
+    int ans_exp = max_exp + i - 53;
+    int shift = (ans_exp >= 1) ? (i - 23) : (31 - static_cast<int>(max_exp));
+    uint64_t ans_significand;
+    if (shift > 0) {
+        int s = (shift > 63) ? 63 : shift;
+        uint64_t guard = (magnitude >> (s - 1)) & 1;
+        bool sticky = (magnitude & ((1ULL << (s - 1)) - 1)) != 0;
+        ans_significand = (shift > 63) ? 0 : (magnitude >> s);
+        if (guard == 1 && (sticky || (ans_significand & 1) == 1)) {
+            ans_significand += 1;
+        }
+    } else {
+        ans_significand = magnitude << (-shift);
+    }
+    if (ans_exp >= 1) {
+        if ((ans_significand >> 24) == 1) {
+            ans_significand = ans_significand >> 1;
+            ans_exp += 1;
+        }
+        if (ans_exp >= 255) {
+            return (ans_sign << 31) | 0x7F800000;
+        }
+        return (ans_sign << 31) | (ans_exp << 23) | (ans_significand & 0x7FFFFF);
+    }
+    return (ans_sign << 31) | static_cast<unsigned int>(ans_significand);
+}
+
+// Functional model of one stencil update, with the reduction grouped as in Top
+uint32_t stencil_function(const std::vector<uint32_t>& u, long centre, const std::vector<Tap>& taps, bool fused) {
+    std::vector<uint32_t> level;
+    for (size_t t = 0; t < taps.size(); t++) {
+        level.push_back(product_function(u[centre + taps[t].offset], taps[t].coefficient));
+    }
+    while (level.size() > 1) {
+        std::vector<uint32_t> next;
+        size_t group = fused ? MAX_OPERANDS : 2;
+        for (size_t k = 0; k < level.size(); k += group) {
+            std::vector<uint32_t> operands(level.begin() + k, level.begin() + std::min(k + group, level.size()));
+            if (fused) {
+                next.push_back(multi_operand_function(operands));
+            } else {
+                next.push_back((operands.size() == 2) ? addition_function(operands[0], operands[1]) : operands[0]);
+            }
+        }
+        level = next;
+    }
+    return level[0];
+}
+
+int sc_main(int argc, char* argv[]) {
+    Grid grid;
+    int points, reduction;
+    cout << "Enter the grid size (nx ny nz, each at least 3): ";
+    cin >> grid.nx >> grid.ny >> grid.nz;
+    cout << "Enter the stencil (7 or 27 points): ";
+    cin >> points;
+    cout << "Enter the reduction (0 for an adder tree, 1 for fused multi-operand adders): ";
+    cin >> reduction;
+    if (!cin || grid.nx < 3 || grid.ny < 3 || grid.nz < 3 || (points != 7 && points != 27) || (reduction != 0 && reduction != 1)) {
+        cout << "Invalid input" << endl;
+        return 1;
+    }
+    bool fused = reduction == 1;
+    std::vector<Tap> taps = stencil_taps(grid, points);
+    long reach = stencil_reach(grid, points);
+    Top top("Top", grid, taps, reach, fused);
+
+    // Random field of mixed signs and moderate exponents
+    long n = grid.nx * grid.ny * grid.nz;
+    srand(1);
+    std::vector<uint32_t> u(n);
+    for (long i = 0; i < n; i++) {
+        float value = ldexpf(static_cast<float>(rand()) / RAND_MAX + 0.5f, rand() % 8 - 4);
+        if (rand() & 1) {
+            value = -value;
+        }
+        memcpy(&u[i], &value, 4);
+    }
+
+    long interior = (grid.nx - 2) * (grid.ny - 2) * (grid.nz - 2);
+    long cycle = 0, updates = 0, first = -1, mismatches = 0, max_ulp = 0, ordered = 1;
+    double ulp_sum = 0;
+    // Runs until every point has been fed and the last update has drained: the
+    // last interior window completes before the final boundary points arrive
+    for (long last = -1; updates < interior || cycle < n; cycle++) {
+        top.x.write(cycle < n ? u[cycle] : 0);
+        top.in_valid.write(cycle < n);
+        sc_start(1, SC_NS);
+        long tag = top.result_tag.read();
+        if (tag == 0) {
+            continue;
+        }
+        long centre = tag - 1;
+        uint32_t r = top.result->read();
+        mismatches += (r != stencil_function(u, centre, taps, fused));
+        double exact = 0;
+        for (size_t t = 0; t < taps.size(); t++) {
+            float value, coefficient;
+            memcpy(&value, &u[centre + taps[t].offset], 4);
+            memcpy(&coefficient, &taps[t].coefficient, 4);
+            exact += static_cast<double>(value) * coefficient;
+        }
+        float exact_float = static_cast<float>(exact);
+        uint32_t exact_bits;
+        memcpy(&exact_bits, &exact_float, 4);
+        long ulp = ulp_distance(r, exact_bits);
+        max_ulp = std::max(max_ulp, ulp);
+        ulp_sum += ulp;
+        ordered = ordered && centre > last;
+        last = centre;
+        first = (first < 0) ? cycle : first;
+        updates++;
+    }
+
+    long words[2] = {buffer_words(grid, 7), buffer_words(grid, 27)};
+    cout << grid.nx << " x " << grid.ny << " x " << grid.nz << " grid, " << points << "-point stencil, "
+         << (fused ? "fused multi-operand" : "adder tree") << " reduction" << endl;
+    cout << "Datapath: " << top.multipliers.size() << " multipliers, ";
+    if (fused) {
+        cout << top.fused_adders.size() << " multi-operand adders";
+    } else {
+        cout << top.adders.size() << " two-input adders";
+    }
+    cout << " in " << top.levels << " levels, " << top.stages << " stages, " << top.levels + 1 << " roundings per update" << endl;
+    cout << n << " points in, " << interior << " interior updates out in " << cycle << " cycles: " << static_cast<double>(n) / cycle
+         << " points/cycle in, " << static_cast<double>(interior) / cycle << " updates/cycle out" << endl;
+    long window_complete = grid.nx * grid.ny + grid.nx + 1 + reach + 1;
+    cout << "Latency: " << first + 1 << " cycles from the first point in to the first update out (its window is complete after "
+         << window_complete << " points, then " << first + 1 - window_complete << " cycles through the datapath)" << endl;
+    cout << "Buffer: " << words[points == 27] << " words (" << words[points == 27] * 4 / 1024.0 << " KiB); 7-point needs "
+         << words[0] << " words (2 planes + 1 point), 27-point " << words[1] << " (2 planes + 2 lines + 3 points)" << endl;
+    cout << "Each point is loaded once and read " << taps.size() << " times from the buffer" << endl;
+    cout << "Error vs double-precision stencil rounded once: max " << max_ulp << " ulp, mean " << ulp_sum / updates << " ulp"
+         << endl;
+    cout << "Pin-level mismatches vs functional model: " << mismatches << (ordered ? "" : " (updates out of order)") << endl;
+    return 0;
+}
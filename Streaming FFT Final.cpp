@@ -0,0 +1,780 @@
+#include <systemc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <bitset>
+#include <algorithm>
+#include <complex>
+#include <deque>
+#include <string>
+#include <vector>
+#include "fpu_models.h"
+#include "fpu_pipelines.h"
+
+// MultiplyPipe Module
+// The three multiplier stages on a shared clock. The multiplier has no zero
+// special case, so a zero operand forces the product to +0, as in the
+// systolic array's processing element.
+SC_MODULE(MultiplyPipe) {
+    sc_in<sc_uint<32>> a;
+    sc_in<sc_uint<32>> b;
+    sc_out<sc_uint<32>> result;
+    sc_in<bool> clock;
+
+    multiplication::FloatingPointExtractor extractor;
+    multiplication::FloatingPointMultiplier multiplier;
+    multiplication::FloatingPointNormalizer normalizer;
+    sc_signal<bool> a_sign, b_sign, result_sign;
+    sc_signal<sc_uint<8>> a_exp, b_exp, result_exp;
+    sc_signal<sc_uint<32>> a_significand, b_significand, result_significand, result_significand0;
+    sc_signal<sc_uint<32>> product;
+    sc_signal<bool> zero_flag;
+
+    void zero_process() {
+        bool zero_delay[2] = {false, false};
+        while (true) {
+            wait();
+            zero_flag.write(zero_delay[1]);
+            zero_delay[1] = zero_delay[0];
+            zero_delay[0] = ((a.read() & 0x7FFFFFFF) == 0) || ((b.read() & 0x7FFFFFFF) == 0);
+        }
+    }
+
+    void gate_process() {
+        result.write(zero_flag.read() ? sc_uint<32>(0) : product.read());
+    }
+
+    SC_CTOR(MultiplyPipe)
+        : a("a"), b("b"), result("result"), clock("clock"), extractor("Extractor"), multiplier("Multiplier"),
+          normalizer("Normalizer") {
+        extractor.a(a);
+        extractor.b(b);
+        extractor.a_sign(a_sign);
+        extractor.a_exp(a_exp);
+        extractor.a_significand(a_significand);
+        extractor.b_sign(b_sign);
+        extractor.b_exp(b_exp);
+        extractor.b_significand(b_significand);
+        extractor.clock(clock);
+
+        multiplier.a_sign(a_sign);
+        multiplier.a_exp(a_exp);
+        multiplier.a_significand(a_significand);
+        multiplier.b_sign(b_sign);
+        multiplier.b_exp(b_exp);
+        multiplier.b_significand(b_significand);
+        multiplier.result_sign(result_sign);
+        multiplier.result_exp(result_exp);
+        multiplier.result_significand(result_significand);
+        multiplier.result_significand1(result_significand0);
+        multiplier.clock(clock);
+
+        normalizer.result_sign(result_sign);
+        normalizer.result_exp(result_exp);
+        normalizer.result_significand(result_significand);
+        normalizer.result_significand1(result_significand0);
+        normalizer.normalized_result(product);
+        normalizer.clock(clock);
+
+        SC_THREAD(zero_process);
+        sensitive << clock.pos();
+        SC_METHOD(gate_process);
+        sensitive << product << zero_flag;
+    }
+};
+
+// AddPipe Module: the three adder stages on a shared clock
+SC_MODULE(AddPipe) {
+    sc_in<sc_uint<32>> a;
+    sc_in<sc_uint<32>> b;
+    sc_out<sc_uint<32>> result;
+    sc_in<bool> clock;
+
+    addition::FloatingPointExtractor extractor;
+    addition::FloatingPointAdder adder;
+    addition::FloatingPointNormaliser normaliser;
+    sc_signal<bool> a_sign, b_sign, result_sign;
+    sc_signal<sc_uint<8>> a_exp, b_exp, result_exp;
+    sc_signal<sc_uint<32>> a_significands, b_significands, result_significand;
+
+    SC_CTOR(AddPipe)
+        : a("a"), b("b"), result("result"), clock("clock"), extractor("Extractor"), adder("Adder"), normaliser("Normalization") {
+        extractor.a(a);
+        extractor.b(b);
+        extractor.a_sign(a_sign);
+        extractor.a_exp(a_exp);
+        extractor.a_significand(a_significands);
+        extractor.b_sign(b_sign);
+        extractor.b_exp(b_exp);
+        extractor.b_significand(b_significands);
+        extractor.clock(clock);
+
+        adder.a_sign(a_sign);
+        adder.a_exp(a_exp);
+        adder.a_significand(a_significands);
+        adder.b_sign(b_sign);
+        adder.b_exp(b_exp);
+        adder.b_significand(b_significands);
+        adder.result_sign(result_sign);
+        adder.result_exp(result_exp);
+        adder.result_significand(result_significand);
+        adder.clock(clock);
+
+        normaliser.result_sign(result_sign);
+        normaliser.result_exp(result_exp);
+        normaliser.result_significand(result_significand);
+        normaliser.nresult(result);
+        normaliser.clock(clock);
+    }
+};
+
+// SubPipe Module: the three subtractor stages on a shared clock
+SC_MODULE(SubPipe) {
+    sc_in<sc_uint<32>> a;
+    sc_in<sc_uint<32>> b;
+    sc_out<sc_uint<32>> result;
+    sc_in<bool> clock;
+
+    subtraction::FloatingPointExtractor extractor;
+    subtraction::FloatingPointSubtractor subtractor;
+    subtraction::FloatingPointNormaliser normaliser;
+    sc_signal<bool> a_sign, b_sign, result_sign;
+    sc_signal<sc_uint<8>> a_exp, b_exp, result_exp;
+    sc_signal<sc_uint<32>> a_significands, b_significands, result_significand;
+
+    SC_CTOR(SubPipe)
+        : a("a"), b("b"), result("result"), clock("clock"), extractor("Extractor"), subtractor("Subtractor"),
+          normaliser("Normalization") {
+        extractor.a(a);
+        extractor.b(b);
+        extractor.a_sign(a_sign);
+        extractor.a_exp(a_exp);
+        extractor.a_significand(a_significands);
+        extractor.b_sign(b_sign);
+        extractor.b_exp(b_exp);
+        extractor.b_significand(b_significands);
+        extractor.clock(clock);
+
+        subtractor.a_sign(a_sign);
+        subtractor.a_exp(a_exp);
+        subtractor.a_significand(a_significands);
+        subtractor.b_sign(b_sign);
+        subtractor.b_exp(b_exp);
+        subtractor.b_significand(b_significands);
+        subtractor.result_sign(result_sign);
+        subtractor.result_exp(result_exp);
+        subtractor.result_significand(result_significand);
+        subtractor.clock(clock);
+
+        normaliser.result_sign(result_sign);
+        normaliser.result_exp(result_exp);
+        normaliser.result_significand(result_significand);
+        normaliser.nresult(result);
+        normaliser.clock(clock);
+    }
+};
+
+// DelayLine Module: holds a word for depth clock edges, to keep operands in
+// step with a parallel pipeline. A depth of PIPE_DELAY matches one MultiplyPipe,
+// AddPipe or SubPipe.
+#define PIPE_DELAY 2
+SC_MODULE(DelayLine) {
+    sc_in<sc_uint<32>> data_in;
+    sc_out<sc_uint<32>> data_out;
+    sc_in<bool> clock;
+    int depth;
+
+    void shift_process() {
+        std::vector<unsigned int> data(depth, 0);
+        while (true) {
+            wait();
+            data_out.write(data[depth - 1]);
+            for (int i = depth - 1; i > 0; i--) {
+                data[i] = data[i - 1];
+            }
+            data[0] = data_in.read();
+        }
+    }
+
+    SC_HAS_PROCESS(DelayLine);
+    DelayLine(sc_module_name name, int depth)
+        : sc_module(name), data_in("data_in"), data_out("data_out"), clock("clock"), depth(depth) {
+        SC_THREAD(shift_process);
+        sensitive << clock.pos();
+    }
+};
+
+// ComplexMultiplier4 Module
+// (a + bi)(c + di) = (ac - bd) + (ad + bc)i: four multipliers, then a
+// subtractor and an adder. One complex multiply per cycle, six stages.
+SC_MODULE(ComplexMultiplier4) {
+    sc_in<sc_uint<32>> a, b, c, d;
+    sc_out<sc_uint<32>> re, im;
+    sc_in<bool> clock;
+
+    MultiplyPipe ac_pipe, bd_pipe, ad_pipe, bc_pipe;
+    SubPipe re_pipe;
+    AddPipe im_pipe;
+    sc_signal<sc_uint<32>> ac, bd, ad, bc;
+
+    SC_CTOR(ComplexMultiplier4)
+        : ac_pipe("AC"), bd_pipe("BD"), ad_pipe("AD"), bc_pipe("BC"), re_pipe("Real"), im_pipe("Imaginary") {
+        ac_pipe.a(a);
+        ac_pipe.b(c);
+        ac_pipe.result(ac);
+        ac_pipe.clock(clock);
+        bd_pipe.a(b);
+        bd_pipe.b(d);
+        bd_pipe.result(bd);
+        bd_pipe.clock(clock);
+        ad_pipe.a(a);
+        ad_pipe.b(d);
+        ad_pipe.result(ad);
+        ad_pipe.clock(clock);
+        bc_pipe.a(b);
+        bc_pipe.b(c);
+        bc_pipe.result(bc);
+        bc_pipe.clock(clock);
+
+        re_pipe.a(ac);
+        re_pipe.b(bd);
+        re_pipe.result(re);
+        re_pipe.clock(clock);
+        im_pipe.a(ad);
+        im_pipe.b(bc);
+        im_pipe.result(im);
+        im_pipe.clock(clock);
+    }
+};
+
+// ComplexMultiplierGauss Module
+// Three-multiplier form: k1 = c(a + b), k2 = a(d - c), k3 = b(c + d), then
+// re = k1 - k3 and im = k1 + k2. Pre-adders, multipliers and post-adders
+// are each three stages; a, b and c wait in delay lines while the pre-adders
+// run. One complex multiply per cycle, nine stages.
+SC_MODULE(ComplexMultiplierGauss) {
+    sc_in<sc_uint<32>> a, b, c, d;
+    sc_out<sc_uint<32>> re, im;
+    sc_in<bool> clock;
+
+    AddPipe a_plus_b, c_plus_d;
+    SubPipe d_minus_c;
+    DelayLine a_delay, b_delay, c_delay;
+    MultiplyPipe k1_pipe, k2_pipe, k3_pipe;
+    SubPipe re_pipe;
+    AddPipe im_pipe;
+    sc_signal<sc_uint<32>> sum_ab, sum_cd, diff_dc, a_late, b_late, c_late, k1, k2, k3;
+
+    SC_CTOR(ComplexMultiplierGauss)
+        : a_plus_b("APlusB"), c_plus_d("CPlusD"), d_minus_c("DMinusC"), a_delay("ADelay", PIPE_DELAY),
+          b_delay("BDelay", PIPE_DELAY), c_delay("CDelay", PIPE_DELAY), k1_pipe("K1"), k2_pipe("K2"), k3_pipe("K3"),
+          re_pipe("Real"), im_pipe("Imaginary") {
+        a_plus_b.a(a);
+        a_plus_b.b(b);
+        a_plus_b.result(sum_ab);
+        a_plus_b.clock(clock);
+        c_plus_d.a(c);
+        c_plus_d.b(d);
+        c_plus_d.result(sum_cd);
+        c_plus_d.clock(clock);
+        d_minus_c.a(d);
+        d_minus_c.b(c);
+        d_minus_c.result(diff_dc);
+        d_minus_c.clock(clock);
+        a_delay.data_in(a);
+        a_delay.data_out(a_late);
+        a_delay.clock(clock);
+        b_delay.data_in(b);
+        b_delay.data_out(b_late);
+        b_delay.clock(clock);
+        c_delay.data_in(c);
+        c_delay.data_out(c_late);
+        c_delay.clock(clock);
+
+        k1_pipe.a(c_late);
+        k1_pipe.b(sum_ab);
+        k1_pipe.result(k1);
+        k1_pipe.clock(clock);
+        k2_pipe.a(a_late);
+        k2_pipe.b(diff_dc);
+        k2_pipe.result(k2);
+        k2_pipe.clock(clock);
+        k3_pipe.a(b_late);
+        k3_pipe.b(sum_cd);
+        k3_pipe.result(k3);
+        k3_pipe.clock(clock);
+
+        re_pipe.a(k1);
+        re_pipe.b(k3);
+        re_pipe.result(re);
+        re_pipe.clock(clock);
+        im_pipe.a(k1);
+        im_pipe.b(k2);
+        im_pipe.result(im);
+        im_pipe.clock(clock);
+    }
+};
+
+uint32_t product_function(uint32_t x, uint32_t y) {
+    return ((x & 0x7FFFFFFF) == 0 || (y & 0x7FFFFFFF) == 0) ? 0 : multiplication_function(x, y);
+}
+
+void complex4_function(uint32_t a, uint32_t b, uint32_t c, uint32_t d, uint32_t& re, uint32_t& im) {
+    re = subtraction_function(product_function(a, c), product_function(b, d));
+    im = addition_function(product_function(a, d), product_function(b, c));
+}
+
+void gauss_function(uint32_t a, uint32_t b, uint32_t c, uint32_t d, uint32_t& re, uint32_t& im) {
+    uint32_t k1 = product_function(c, addition_function(a, b));
+    uint32_t k2 = product_function(a, subtraction_function(d, c));
+    uint32_t k3 = product_function(b, addition_function(c, d));
+    re = subtraction_function(k1, k3);
+    im = addition_function(k1, k2);
+}
+
+float bits_float(uint32_t bits) {
+    float value;
+    memcpy(&value, &bits, 4);
+    return value;
+}
+
+uint32_t float_bits(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, 4);
+    return bits;
+}
+
+
+// Round trip, in clock edges, from a control thread writing a pipe's operands
+// to reading its result: the pipe's result delay plus the two registers at
+// either end
+const int BUTTERFLY_ROUND_TRIP = PIPE_DELAY + 2;
+const int MULTIPLY_ROUND_TRIP[2] = {2 * PIPE_DELAY + 3, 3 * PIPE_DELAY + 4};   // 4-mult, 3-mult
+
+struct Twiddle {
+    uint32_t re;
+    uint32_t im;
+};
+
+bool unity(const Twiddle& w) {
+    return w.re == 0x3F800000 && w.im == 0;
+}
+
+Twiddle twiddle(long exponent, long size) {
+    double angle = -2 * M_PI * exponent / size;
+    Twiddle w = {float_bits(static_cast<float>(cos(angle))), float_bits(static_cast<float>(sin(angle)))};
+    return (exponent % size == 0) ? Twiddle{0x3F800000, 0} : w;
+}
+
+// Stage plan of an N-point decimation-in-frequency FFT. Stage s butterflies
+// samples L = N / 2^(s+1) apart. Radix-2 multiplies each difference by
+// W_2L^k after every stage. Radix-2^2 (the radix-4 SDF) multiplies by -j on
+// the second half of the differences of even stages, a swap and a sign flip,
+// and applies the remaining twiddles after odd stages in the 0, 2, 1, 3
+// pattern of a radix-4 butterfly, so only every other stage has a multiplier.
+struct StagePlan {
+    long length;
+    bool rotate;
+    std::vector<Twiddle> twiddles;   // by output position modulo its size; empty when all are 1
+};
+
+std::vector<StagePlan> plan_fft(long n, int radix) {
+    std::vector<StagePlan> plan;
+    for (long length = n / 2, s = 0; length >= 1; length /= 2, s++) {
+        StagePlan stage = {length, false, std::vector<Twiddle>()};
+        if (radix == 2) {
+            for (long p = 0; p < 2 * length; p++) {
+                stage.twiddles.push_back(twiddle((p < length) ? 0 : p - length, 2 * length));
+            }
+        } else if (s % 2 == 0) {
+            stage.rotate = length >= 2;
+        } else {
+            long q = length;
+            const int pattern[4] = {0, 2, 1, 3};
+            for (long p = 0; p < 4 * q; p++) {
+                stage.twiddles.push_back(twiddle(pattern[p / q] * (p % q), 4 * q));
+            }
+        }
+        bool trivial = true;
+        for (size_t p = 0; p < stage.twiddles.size(); p++) {
+            trivial = trivial && unity(stage.twiddles[p]);
+        }
+        if (trivial) {
+            stage.twiddles.clear();
+        }
+        plan.push_back(stage);
+    }
+    return plan;
+}
+
+// Difference storage: a stage with L at least the butterfly round trip feeds
+// differences back into its L-word delay line; shorter stages keep them in a
+// second L-word store
+bool feedback(long length) {
+    return length >= BUTTERFLY_ROUND_TRIP;
+}
+
+struct StageItem {
+    long due;
+    bool butterfly;   // sum of a butterfly issued now, else a stored difference
+    bool valid;
+    long slot;        // butterfly index k within the block
+    long position;    // output position, for the twiddle ROM and the rotation
+    uint32_t re;
+    uint32_t im;
+};
+
+// SdfStage Module
+// One single-path delay-feedback stage. The first L samples of each 2L block
+// go into the delay line while the differences of the previous block come out
+// of it; the next L samples meet their partners from the delay line in the
+// butterfly, whose sums leave directly and whose differences go back into the
+// delay line. Everything leaves BUTTERFLY_ROUND_TRIP edges after it arrived,
+// through the optional -j rotation and twiddle multiplier.
+struct SdfStage : public sc_module {
+    sc_in<sc_uint<32>> in_re, in_im;
+    sc_in<bool> in_valid;
+    sc_out<sc_uint<32>> out_re, out_im;
+    sc_out<bool> out_valid;
+    sc_in<bool> clock;
+
+    StagePlan plan;
+    int variant;
+    AddPipe sum_re, sum_im;
+    SubPipe diff_re, diff_im;
+    ComplexMultiplier4* multiplier4;
+    ComplexMultiplierGauss* multiplier3;
+    sc_signal<sc_uint<32>> a_re, a_im, b_re, b_im, s_re, s_im, d_re, d_im;
+    sc_signal<sc_uint<32>> m_re, m_im, w_re, w_im, p_re, p_im;
+
+    void control_process() {
+        long length = plan.length, edge = 0, count = 0;
+        bool started = false;
+        std::vector<uint32_t> line_re(length), line_im(length), store_re(length), store_im(length);
+        std::vector<char> line_valid(length, 0), store_valid(length, 0);
+        std::deque<StageItem> butterflies, products;
+        while (true) {
+            wait();
+            edge++;
+
+            // Butterfly results and stored differences, in arrival order
+            StageItem out = {0, false, false, 0, 0, 0, 0};
+            bool have = !butterflies.empty() && butterflies.front().due == edge;
+            if (have) {
+                out = butterflies.front();
+                butterflies.pop_front();
+                if (out.butterfly) {
+                    std::vector<uint32_t>& target_re = feedback(length) ? line_re : store_re;
+                    std::vector<uint32_t>& target_im = feedback(length) ? line_im : store_im;
+                    std::vector<char>& target_valid = feedback(length) ? line_valid : store_valid;
+                    target_re[out.slot] = d_re.read();
+                    target_im[out.slot] = d_im.read();
+                    target_valid[out.slot] = out.valid;
+                    out.re = s_re.read();
+                    out.im = s_im.read();
+                } else if (!feedback(length)) {
+                    out.re = store_re[out.slot];
+                    out.im = store_im[out.slot];
+                    out.valid = store_valid[out.slot];
+                }
+                // (x + iy)(-j) = y - ix on the second half of the differences
+                long p = out.position % (2 * length);
+                if (plan.rotate && p >= length + length / 2) {
+                    uint32_t re = out.re;
+                    out.re = out.im;
+                    out.im = re ^ 0x80000000;
+                }
+            }
+
+            // Twiddle multiplier
+            if (plan.twiddles.empty()) {
+                out_re.write(out.re);
+                out_im.write(out.im);
+                out_valid.write(have && out.valid);
+            } else {
+                if (have) {
+                    const Twiddle& w = plan.twiddles[out.position % plan.twiddles.size()];
+                    m_re.write(out.re);
+                    m_im.write(out.im);
+                    w_re.write(w.re);
+                    w_im.write(w.im);
+                    out.due = edge + MULTIPLY_ROUND_TRIP[variant];
+                    products.push_back(out);
+                }
+                bool ready = !products.empty() && products.front().due == edge;
+                out_re.write(p_re.read());
+                out_im.write(p_im.read());
+                out_valid.write(ready && products.front().valid);
+                if (ready) {
+                    products.pop_front();
+                }
+            }
+
+            // New sample
+            started = started || in_valid.read();
+            if (!started) {
+                continue;
+            }
+            long c = count % (2 * length), block = count / (2 * length);
+            StageItem item = {edge + BUTTERFLY_ROUND_TRIP, false, false, c, 0, 0, 0};
+            if (c < length) {
+                // Differences of the previous block leave in order
+                item.position = (block - 1) * 2 * length + length + c;
+                if (feedback(length)) {
+                    item.re = line_re[c];
+                    item.im = line_im[c];
+                    item.valid = line_valid[c];
+                }
+                line_re[c] = in_re.read();
+                line_im[c] = in_im.read();
+                line_valid[c] = in_valid.read();
+                butterflies.push_back(item);
+            } else {
+                long k = c - length;
+                a_re.write(line_re[k]);
+                a_im.write(line_im[k]);
+                b_re.write(in_re.read());
+                b_im.write(in_im.read());
+                item.butterfly = true;
+                item.slot = k;
+                item.position = block * 2 * length + k;
+                item.valid = in_valid.read() && line_valid[k];
+                butterflies.push_back(item);
+            }
+            count++;
+        }
+    }
+
+    SC_HAS_PROCESS(SdfStage);
+    SdfStage(sc_module_name name, const StagePlan& plan, int variant)
+        : sc_module(name), plan(plan), variant(variant), sum_re("SumRe"), sum_im("SumIm"), diff_re("DiffRe"), diff_im("DiffIm"),
+          multiplier4(0), multiplier3(0) {
+        sum_re.a(a_re);
+        sum_re.b(b_re);
+        sum_re.result(s_re);
+        sum_re.clock(clock);
+        sum_im.a(a_im);
+        sum_im.b(b_im);
+        sum_im.result(s_im);
+        sum_im.clock(clock);
+        diff_re.a(a_re);
+        diff_re.b(b_re);
+        diff_re.result(d_re);
+        diff_re.clock(clock);
+        diff_im.a(a_im);
+        diff_im.b(b_im);
+        diff_im.result(d_im);
+        diff_im.clock(clock);
+        if (!plan.twiddles.empty() && variant == 0) {
+            multiplier4 = new ComplexMultiplier4("Twiddle");
+            multiplier4->a(m_re);
+            multiplier4->b(m_im);
+            multiplier4->c(w_re);
+            multiplier4->d(w_im);
+            multiplier4->re(p_re);
+            multiplier4->im(p_im);
+            multiplier4->clock(clock);
+        } else if (!plan.twiddles.empty()) {
+            multiplier3 = new ComplexMultiplierGauss("Twiddle");
+            multiplier3->a(m_re);
+            multiplier3->b(m_im);
+            multiplier3->c(w_re);
+            multiplier3->d(w_im);
+            multiplier3->re(p_re);
+            multiplier3->im(p_im);
+            multiplier3->clock(clock);
+        }
+        SC_THREAD(control_process);
+        sensitive << clock.pos();
+    }
+};
+
+// Top-level Module: the stages of one N-point FFT in a chain on a 1 ns clock.
+// Samples enter in natural order, one per cycle, and leave in bit-reversed order.
+struct Top : public sc_module {
+    std::vector<SdfStage*> stages;
+    std::vector<sc_signal<sc_uint<32>>*> link_re, link_im;
+    std::vector<sc_signal<bool>*> link_valid;
+    sc_clock clock;
+
+    Top(sc_module_name name, const std::vector<StagePlan>& plan, int variant) : sc_module(name), clock("clock", 1, SC_NS) {
+        for (size_t s = 0; s <= plan.size(); s++) {
+            link_re.push_back(new sc_signal<sc_uint<32>>());
+            link_im.push_back(new sc_signal<sc_uint<32>>());
+            link_valid.push_back(new sc_signal<bool>());
+        }
+        for (size_t s = 0; s < plan.size(); s++) {
+            SdfStage* stage = new SdfStage(("Stage" + std::to_string(s)).c_str(), plan[s], variant);
+            stage->in_re(*link_re[s]);
+            stage->in_im(*link_im[s]);
+            stage->in_valid(*link_valid[s]);
+            stage->out_re(*link_re[s + 1]);
+            stage->out_im(*link_im[s + 1]);
+            stage->out_valid(*link_valid[s + 1]);
+            stage->clock(clock);
+            stages.push_back(stage);
+        }
+    }
+};
+
+// Functional model: the same stages on blocks, in stream order
+void fft_function(std::vector<uint32_t>& re, std::vector<uint32_t>& im, const std::vector<StagePlan>& plan, int variant) {
+    long n = re.size();
+    for (size_t s = 0; s < plan.size(); s++) {
+        const StagePlan& stage = plan[s];
+        long length = stage.length;
+        for (long b = 0; b < n; b += 2 * length) {
+            for (long k = 0; k < length; k++) {
+                uint32_t a_re = re[b + k], a_im = im[b + k], c_re = re[b + k + length], c_im = im[b + k + length];
+                re[b + k] = addition_function(a_re, c_re);
+                im[b + k] = addition_function(a_im, c_im);
+                re[b + k + length] = subtraction_function(a_re, c_re);
+                im[b + k + length] = subtraction_function(a_im, c_im);
+            }
+        }
+        for (long p = 0; p < n; p++) {
+            if (stage.rotate && p % (2 * length) >= length + length / 2) {
+                uint32_t r = re[p];
+                re[p] = im[p];
+                im[p] = r ^ 0x80000000;
+            }
+            if (!stage.twiddles.empty()) {
+                const Twiddle& w = stage.twiddles[p % stage.twiddles.size()];
+                uint32_t x = re[p], y = im[p];
+                (variant == 0 ? complex4_function : gauss_function)(x, y, w.re, w.im, re[p], im[p]);
+            }
+        }
+    }
+}
+
+long bit_reverse(long value, int bits) {
+    long r = 0;
+    for (int i = 0; i < bits; i++) {
+        r = (r << 1) | ((value >> i) & 1);
+    }
+    return r;
+}
+
+// Double-precision reference
+void reference_fft(std::vector<std::complex<double>>& x) {
+    long n = x.size();
+    int bits = 0;
+    while ((1L << bits) < n) {
+        bits++;
+    }
+    for (long i = 0; i < n; i++) {
+        long j = bit_reverse(i, bits);
+        if (j > i) {
+            std::swap(x[i], x[j]);
+        }
+    }
+    for (long size = 2; size <= n; size *= 2) {
+        for (long b = 0; b < n; b += size) {
+            for (long k = 0; k < size / 2; k++) {
+                std::complex<double> w = std::polar(1.0, -2 * M_PI * k / size);
+                std::complex<double> u = x[b + k], v = x[b + k + size / 2] * w;
+                x[b + k] = u + v;
+                x[b + k + size / 2] = u - v;
+            }
+        }
+    }
+}
+
+struct RunResult {
+    long first_out;      // cycle of the first output sample
+    long last_out;       // cycle of the last output sample
+    long mismatches;
+    double rms_error;    // ||X - X_ref|| / ||X_ref||
+    double max_error;    // max |X - X_ref| / max |X_ref|
+};
+
+RunResult run_fft(Top& top, const std::vector<StagePlan>& plan, int variant, long n, long frames) {
+    int bits = plan.size();
+    srand(1);
+    std::vector<uint32_t> in_re(n * frames), in_im(n * frames), out_re, out_im;
+    for (long i = 0; i < n * frames; i++) {
+        in_re[i] = float_bits(2.0f * rand() / RAND_MAX - 1);
+        in_im[i] = float_bits(2.0f * rand() / RAND_MAX - 1);
+    }
+    RunResult result = {-1, 0, 0, 0, 0};
+    for (long cycle = 0; static_cast<long>(out_re.size()) < n * frames; cycle++) {
+        bool feeding = cycle < n * frames;
+        top.link_re[0]->write(feeding ? in_re[cycle] : 0);
+        top.link_im[0]->write(feeding ? in_im[cycle] : 0);
+        top.link_valid[0]->write(feeding);
+        sc_start(1, SC_NS);
+        if (top.link_valid[bits]->read()) {
+            out_re.push_back(top.link_re[bits]->read());
+            out_im.push_back(top.link_im[bits]->read());
+            result.first_out = (result.first_out < 0) ? cycle : result.first_out;
+            result.last_out = cycle;
+        }
+    }
+
+    double error_sq = 0, norm_sq = 0, max_error = 0, max_norm = 0;
+    for (long f = 0; f < frames; f++) {
+        std::vector<uint32_t> re(in_re.begin() + f * n, in_re.begin() + (f + 1) * n);
+        std::vector<uint32_t> im(in_im.begin() + f * n, in_im.begin() + (f + 1) * n);
+        std::vector<std::complex<double>> x(n);
+        for (long i = 0; i < n; i++) {
+            x[i] = std::complex<double>(bits_float(re[i]), bits_float(im[i]));
+        }
+        fft_function(re, im, plan, variant);
+        reference_fft(x);
+        for (long p = 0; p < n; p++) {
+            result.mismatches += (out_re[f * n + p] != re[p]) + (out_im[f * n + p] != im[p]);
+            std::complex<double> e = std::complex<double>(bits_float(out_re[f * n + p]), bits_float(out_im[f * n + p])) -
+                                     x[bit_reverse(p, bits)];
+            error_sq += std::norm(e);
+            norm_sq += std::norm(x[bit_reverse(p, bits)]);
+            max_error = std::max(max_error, std::abs(e));
+            max_norm = std::max(max_norm, std::abs(x[bit_reverse(p, bits)]));
+        }
+    }
+    result.rms_error = sqrt(error_sq / norm_sq);
+    result.max_error = max_error / max_norm;
+    return result;
+}
+
+int sc_main(int argc, char* argv[]) {
+    long n, frames;
+    int variant;
+    cout << "Enter the FFT size (power of two, 64 to 65536): ";
+    cin >> n;
+    cout << "Enter the number of frames: ";
+    cin >> frames;
+    cout << "Enter the twiddle multiplier (4 for 4-mult, 3 for 3-mult): ";
+    cin >> variant;
+    if (n < 64 || n > 65536 || (n & (n - 1)) != 0 || frames <= 0 || (variant != 3 && variant != 4)) {
+        cout << "Invalid input" << endl;
+        return 1;
+    }
+    variant = (variant == 4) ? 0 : 1;
+
+    const int radices[2] = {2, 4};
+    std::vector<StagePlan> plans[2] = {plan_fft(n, 2), plan_fft(n, 4)};
+    Top* tops[2] = {new Top("Radix2", plans[0], variant), new Top("Radix4", plans[1], variant)};
+
+    cout << n << "-point FFT, " << frames << " frame(s) streamed back to back, one sample per cycle in" << endl;
+    cout << "Radix  stages  multipliers  delay words  ROM words  latency  cycles  samples/cycle  rms error  max error  mismatches"
+         << endl;
+    for (int r = 0; r < 2; r++) {
+        long multipliers = 0, words = 0, rom = 0;
+        for (size_t s = 0; s < plans[r].size(); s++) {
+            multipliers += !plans[r][s].twiddles.empty();
+            words += feedback(plans[r][s].length) ? plans[r][s].length : 2 * plans[r][s].length;
+            for (size_t p = 0; p < plans[r][s].twiddles.size(); p++) {
+                rom += !unity(plans[r][s].twiddles[p]);
+            }
+        }
+        RunResult result = run_fft(*tops[r], plans[r], variant, n, frames);
+        long cycles = result.last_out + 1;
+        printf("%5d %7zu %12ld %12ld %10ld %8ld %7ld %14.3f %10.2e %10.2e %11ld\n", radices[r], plans[r].size(), multipliers, words,
+               rom, result.first_out + 1, cycles, static_cast<double>(n * frames) / (result.last_out - result.first_out + 1), result.rms_error, result.max_error,
+               result.mismatches);
+    }
+    cout << "(latency: cycles from the first sample in to the first sample out; samples/cycle: output rate once" << endl;
+    cout << " the first sample is out; outputs in bit-reversed order)" << endl;
+    return 0;
+}
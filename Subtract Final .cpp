@@ -206,6 +206,18 @@ SC_MODULE(FloatingPointNormaliser) {
             ans_exp = 255;
         }
 }
+    // Cancellation: 23 or fewer significant bits are left, all of them exact;
+    // shift them up to the hidden-bit position
+    else if (i > 0) {
+        int shifted_exp = int(ans_exp) + (i - 23) - 7;
+        ans_significand = ans_significand << (23 - i);
+        if (shifted_exp > 0) {
+            ans_exp = shifted_exp;
+        } else {
+            ans_significand = (1 - shifted_exp > 24) ? 0 : (ans_significand >> (1 - shifted_exp));
+            ans_exp = 0;
+        }
+    }
 
 
     //When answer is zero
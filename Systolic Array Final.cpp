@@ -0,0 +1,909 @@
+#include <systemc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <bitset>
+
+// Two-input adder stages from Addition Final, used for the PE accumulate path
+namespace addition {
+
+// FloatingPointExtractor Module
+SC_MODULE(FloatingPointExtractor) {
+    sc_in<sc_uint<32>> a;
+    sc_in<sc_uint<32>> b;
+    sc_out<bool> a_sign;
+    sc_out<sc_uint<8>> a_exp;
+    sc_out<sc_uint<32>> a_significand;
+    sc_out<bool> b_sign;
+    sc_out<sc_uint<8>> b_exp;
+    sc_out<sc_uint<32>> b_significand;
+    sc_in<bool> clock;
+
+    void extraction_process() {
+        while (true) {
+            wait();
+            //Extraction
+            bool a_sign0 = (a.read() & 0x80000000) >> 31;
+            unsigned int a_exp0 = (a.read() & 0x7f800000) >> 23;
+            unsigned int a_significand0 = (a.read() & 0x7fffff);
+
+            bool b_sign0 = (b.read() & 0x80000000) >> 31;
+            unsigned int b_exp0 = (b.read() & 0x7f800000) >> 23;
+            unsigned int b_significand0 = (b.read() & 0x7fffff);
+
+            unsigned int a_significand1 = (a_exp0 >= 1) ? (a_significand0 | (1 << 23)) : a_significand0;
+            unsigned int b_significand1 = (b_exp0 >= 1) ? (b_significand0 | (1 << 23)) : b_significand0;
+
+            unsigned int a_significand2 = (a_significand1 << 7);
+            unsigned int b_significand2 = (b_significand1 << 7);
+
+            unsigned int a_exp1 = ((a_exp0 == 0) ? 1 : a_exp0);
+            unsigned int b_exp1 = ((b_exp0 == 0) ? 1 : b_exp0);
+            //Special Cases
+            if (a_exp0 == 255 && a_significand0 != 0) {
+                a_sign.write(true);
+                a_exp.write(0x7F);
+                a_significand.write(0x7fffffff);
+                b_sign.write(true);
+                b_exp.write(0x7F);
+                b_significand.write(0x7fffffff);
+            } else if (b_exp0 == 255 && b_significand0 != 0) {
+                a_sign.write(true);
+                a_exp.write(0x7F);
+                a_significand.write(0x7fffffff);
+                b_sign.write(true);
+                b_exp.write(0x7F);
+                b_significand.write(0x7fffffff);
+            } else if (a_exp0 == 255 && a_significand0 == 0 && b_exp0 == 255 && b_significand0 == 0 && a_sign0 != b_sign0) {
+                a_sign.write(true);
+                a_exp.write(0x7F);
+                a_significand.write(0x7fffffff);
+                b_sign.write(true);
+                b_exp.write(0x7F);
+                b_significand.write(0x7fffffff);
+            } else if (a_exp0 == 255 && a_significand0 == 0) {
+                a_sign.write(a_sign0);
+                a_exp.write(a_exp0);
+                a_significand.write(a_significand0);
+                b_sign.write(true);
+                b_exp.write(0x7F);
+                b_significand.write(0x7fffffff);
+            } else if (b_exp0 == 255 && b_significand0 == 0) {
+                a_sign.write(true);
+                a_exp.write(0x7F);
+                a_significand.write(0x7fffffff);
+                b_sign.write(b_sign0);
+                b_exp.write(b_exp0);
+                b_significand.write(b_significand0);
+            } else {
+    
+                a_sign.write(a_sign0);
+                a_exp.write(static_cast<sc_uint<8>>(a_exp1));
+                a_significand.write(a_significand2);
+                b_sign.write(b_sign0);
+                b_exp.write(static_cast<sc_uint<8>>(b_exp1));
+                b_significand.write(b_significand2);
+            }
+        }
+    }
+    //Constructor
+    SC_CTOR(FloatingPointExtractor)
+        : a("a"),
+          b("b"),
+          a_sign("a_sign"),
+          a_exp("a_exp"),
+          a_significand("a_significand"),
+          b_sign("b_sign"),
+          b_exp("b_exp"),
+          b_significand("b_significand"),
+          clock("clock") {
+        SC_THREAD(extraction_process);
+        sensitive << clock.pos();     //Clock signal
+    }
+};
+
+// FloatingPointAdder Module
+SC_MODULE(FloatingPointAdder) {
+    sc_in<bool> a_sign;
+    sc_in<sc_uint<8>> a_exp;
+    sc_in<sc_uint<32>> a_significand;
+    sc_in<bool> b_sign;
+    sc_in<sc_uint<8>> b_exp;
+    sc_in<sc_uint<32>> b_significand;
+    sc_out<bool> result_sign;
+    sc_out<sc_uint<8>> result_exp;
+    sc_out<sc_uint<32>> result_significand;
+    sc_in<bool> clock;
+
+    void addition_process() {
+        while (true) {
+            wait();
+
+            unsigned int ans_exp;
+            unsigned int ans_significand;
+            bool ans_sign;
+            unsigned int a_significand3 = a_significand.read();
+            unsigned int b_significand3 = b_significand.read();
+        //Exponent Shifting
+            if (a_exp.read() >= b_exp.read()) {
+                unsigned int shift = a_exp.read() - b_exp.read();
+                b_significand3 = (b_significand.read() >> ((shift > 31) ? 31 : shift));
+                ans_exp = a_exp.read();
+            } else {
+                unsigned int shift = b_exp.read() - a_exp.read();
+                a_significand3 = (a_significand.read() >> ((shift > 31) ? 31 : shift));
+                ans_exp = b_exp.read();
+            }
+         //Significand shifting and adding
+            if (a_sign.read() == b_sign.read()) {
+                ans_significand = a_significand3 + b_significand3;
+                ans_sign = a_sign.read();
+            } else {
+                if (a_significand3 > b_significand3) {
+                    ans_sign = a_sign.read();
+                    ans_significand = a_significand3 - b_significand3;
+                } else if (a_significand3 < b_significand3) {
+                    ans_sign = b_sign.read();
+                    ans_significand = b_significand3 - a_significand3;
+                } else if (a_significand3 == b_significand3) {
+                    ans_sign = false;
+                    ans_significand = a_significand3 - b_significand3;
+                }
+            }
+
+            result_sign.write(ans_sign);
+            result_exp.write(static_cast<sc_uint<8>>(ans_exp));
+            result_significand.write(ans_significand);
+        }
+    }
+
+    SC_CTOR(FloatingPointAdder)
+        : a_sign("a_sign"),
+          a_exp("a_exp"),
+          a_significand("a_significand"),
+          b_sign("b_sign"),
+          b_exp("b_exp"),
+          b_significand("b_significand"),
+          result_sign("result_sign"),
+          result_exp("result_exp"),
+          result_significand("result_significand"),
+          clock("clock") {
+        SC_THREAD(addition_process);
+        sensitive << clock.pos();
+    }
+};
+
+SC_MODULE(FloatingPointNormaliser) {
+    sc_in<bool> result_sign;
+    sc_in<sc_uint<8>> result_exp;
+    sc_in<sc_uint<32>> result_significand;
+    sc_out<sc_uint<32>> nresult;
+    sc_in<bool> clock;
+    void normal_process() {
+    
+    
+
+        while (true) {
+            wait();
+
+            unsigned int ans_exp = result_exp.read();
+            unsigned int ans_significand = result_significand.read();
+            bool ans_sign = result_sign.read();
+    /* Normalization */
+    int i;
+    for (i=31; i>0 && ((ans_significand>>i) == 0); i-- ){;}
+    
+    if (i>23){
+
+        //Rounding
+        unsigned int twentyfourth = ((ans_significand&(1<<(i-23-1)))>>(i-23-1));
+
+        unsigned int twentyfifth = 0;
+        for(int j=0;j<i-23-1;j++){
+            twentyfifth = twentyfifth | ((ans_significand & (1<<j))>>j);
+        }
+
+        if ((int(ans_exp) + (i-23) - 7) > 0 && (int(ans_exp) + (i-23) - 7) < 255){
+
+            ans_significand = (ans_significand>>(i-23));
+
+            ans_exp = ans_exp + (i-23) - 7;
+
+            if (twentyfourth==1 && twentyfifth == 1){
+        
+                ans_significand += 1;
+
+            }
+            else if ((ans_significand&1)==1 && twentyfourth ==1 && twentyfifth == 0){
+   
+                ans_significand += 1;
+
+            }
+
+            if ((ans_significand>>24)==1){
+                ans_significand = (ans_significand>>1);
+                ans_exp += 1;
+
+            }
+        }
+
+        //Overflow
+        else if (int(ans_exp) + (i-23) - 7 >= 255){
+            ans_significand = (1<<23);
+            ans_exp = 255;
+        }
+}
+    // Cancellation: 23 or fewer significant bits are left, all of them exact;
+    // shift them up to the hidden-bit position
+    else if (i > 0) {
+        int shifted_exp = int(ans_exp) + (i - 23) - 7;
+        ans_significand = ans_significand << (23 - i);
+        if (shifted_exp > 0) {
+            ans_exp = shifted_exp;
+        } else {
+            ans_significand = (1 - shifted_exp > 24) ? 0 : (ans_significand >> (1 - shifted_exp));
+            ans_exp = 0;
+        }
+    }
+
+
+    //When answer is zero
+     if (i==0 && ans_exp < 255){
+        ans_exp = 0;
+    }
+    
+    /* Constructing floating point number from sign, exponent and significand */
+
+    unsigned int ans = (ans_sign<<31) | (ans_exp<<23) | (ans_significand& (0x7FFFFF));
+    nresult.write(ans);
+    }
+}
+
+
+    SC_CTOR(FloatingPointNormaliser) {
+        SC_THREAD(normal_process);
+        sensitive << clock.pos();
+    }
+};
+
+}
+
+// Multiplier stages from Multiplication Final, used for the PE multiply path
+namespace multiplication {
+
+// FloatingPointExtractor Module
+SC_MODULE(FloatingPointExtractor) {
+    sc_in<sc_uint<32>> a;
+    sc_in<sc_uint<32>> b;
+    sc_out<bool> a_sign;
+    sc_out<sc_uint<8>> a_exp;
+    sc_out<sc_uint<32>> a_significand;
+    sc_out<bool> b_sign;
+    sc_out<sc_uint<8>> b_exp;
+    sc_out<sc_uint<32>> b_significand;
+    sc_in<bool> clock;
+
+    void extraction_process() {
+        while (true) {
+            wait();
+     //Extraction
+            bool a_sign0 = (a.read() & 0x80000000) >> 31;
+            unsigned int a_exp0 = (a.read() & 0x7f800000) >> 23;
+            unsigned int a_significand0 = (a.read() & 0x7fffff);
+
+            bool b_sign0 = (b.read() & 0x80000000) >> 31;
+            unsigned int b_exp0 = (b.read() & 0x7f800000) >> 23;
+            unsigned int b_significand0 = (b.read() & 0x7fffff);
+
+            // Special cases
+            if (a_exp0 == 255 && a_significand0 != 0) {
+                // Case when a is NaN
+                a_sign.write(true);
+                a_exp.write(255);
+                a_significand.write(0x7fffffff);
+                b_sign.write(true);
+                b_exp.write(255);
+                b_significand.write(0x7fffffff);
+            } else if (b_exp0 == 255 && b_significand0 != 0) {
+                // Case when b is NaN
+                a_sign.write(true);
+                a_exp.write(255);
+                a_significand.write(0x7fffffff);
+                b_sign.write(true);
+                b_exp.write(255);
+                b_significand.write(0x7fffffff);
+            } else if (a_exp0 == 255 && a_significand0 == 0 && b_exp0 == 255 && b_significand0 == 0 && a_sign0 != b_sign0) {
+                // Case when Infinity - Infinity
+                a_sign.write(true);
+                a_exp.write(255);
+                a_significand.write(0x7fffffff);
+                b_sign.write(true);
+                b_exp.write(255);
+                b_significand.write(0x7fffffff);
+            } else if (a_exp0 == 255 && a_significand0 == 0) {
+                // Case when a is Infinity
+                a_sign.write(a_sign0);
+                a_exp.write(255);
+                a_significand.write(0x7fffffff);
+                b_sign.write(true);
+                b_exp.write(255);
+                b_significand.write(0x7fffffff);
+            } else if (b_exp0 == 255 && b_significand0 == 0) {
+                // Case when b is Infinity
+                a_sign.write(true);
+                a_exp.write(255);
+                a_significand.write(0x7fffffff);
+                b_sign.write(b_sign0);
+                b_exp.write(255);
+                b_significand.write(0x7fffffff);
+            } else {
+                // Normal case
+                a_sign.write(a_sign0);
+                a_exp.write(a_exp0);
+                a_significand.write(a_significand0);
+                b_sign.write(b_sign0);
+                b_exp.write(b_exp0);
+                b_significand.write(b_significand0);
+            }
+        }
+    }
+
+    SC_CTOR(FloatingPointExtractor) : a("a"), b("b"), a_sign("a_sign"), a_exp("a_exp"), a_significand("a_significand"),
+                                     b_sign("b_sign"), b_exp("b_exp"), b_significand("b_significand"), clock("clock") {
+        SC_THREAD(extraction_process);
+        sensitive << clock.pos();
+    }
+};
+
+// FloatingPointMultiplier Module
+SC_MODULE(FloatingPointMultiplier) {
+    sc_in<bool> a_sign;
+    sc_in<sc_uint<8>> a_exp;
+    sc_in<sc_uint<32>> a_significand;
+    sc_in<bool> b_sign;
+    sc_in<sc_uint<8>> b_exp;
+    sc_in<sc_uint<32>> b_significand;
+    sc_out<bool> result_sign;
+    sc_out<sc_uint<8>> result_exp;
+    sc_out<sc_uint<32>> result_significand;
+    sc_out<sc_uint<32>> result_significand1;
+    sc_in<bool> clock;
+
+    void multiply_process() {
+        while (true) {
+            wait();
+            bool aSign = a_sign.read();
+            unsigned int aExponent = a_exp.read();
+            unsigned int aSignificand = a_significand.read();
+
+            bool bSign = b_sign.read();
+            unsigned int bExponent = b_exp.read();
+            unsigned int bSignificand = b_significand.read();
+
+            // compute sign bit
+            bool resultSign = aSign ^ bSign;
+
+            // compute exponent
+            unsigned int resultExponent = aExponent + bExponent - 0x7F;
+
+            // add implicit `1' bit
+            aSignificand = (aSignificand | 0x00800000) << 7;
+            bSignificand = (bSignificand | 0x00800000) << 8;
+
+            uint64_t resultSignificand = static_cast<uint64_t>(aSignificand) * static_cast<uint64_t>(bSignificand);
+
+            uint32_t resultSignificand0 = static_cast<uint32_t>(resultSignificand >> 32);
+            uint32_t resultSignificand1 = static_cast<uint32_t>(resultSignificand & 0xFFFFFFFF);
+
+            result_sign.write(resultSign);
+            result_exp.write(resultExponent);
+            result_significand.write(resultSignificand0);
+            result_significand1.write(resultSignificand1);
+        }
+    }
+
+    SC_CTOR(FloatingPointMultiplier) : a_sign("a_sign"), a_exp("a_exp"), a_significand("a_significand"),
+                                       b_sign("b_sign"), b_exp("b_exp"), b_significand("b_significand"),
+                                       result_sign("result_sign"), result_exp("result_exp"),
+                                       result_significand("result_significand"), clock("clock") {
+        SC_THREAD(multiply_process);
+        sensitive << clock.pos();
+    }
+};
+
+// FloatingPointNormalizer Module
+SC_MODULE(FloatingPointNormalizer) {
+    sc_in<bool> result_sign;
+    sc_in<sc_uint<8>> result_exp;
+    sc_in<sc_uint<32>> result_significand;
+    sc_in<sc_uint<32>> result_significand1;
+    sc_out<sc_uint<32>> normalized_result;
+    sc_in<bool> clock;
+    
+void normalize_process() { int check=0,check1=0;
+    while (true) {
+        wait();
+
+        bool resultSign = result_sign.read();
+        unsigned int resultExponent = result_exp.read();
+        unsigned int resultSignificand0 = result_significand.read();
+        unsigned int resultSignificand1 = result_significand1.read();
+        // check if we overflowed into more than 23-bits and handle accordingly
+        resultSignificand0 |= (resultSignificand1 != 0);
+        if (0 <= static_cast<int32_t>(resultSignificand0 << 1)) {
+            resultSignificand0 <<= 1;
+            resultExponent--;
+        }
+
+        
+        
+        int bit_value;
+           int arr[23];
+        int j=22,k=0;
+    for (int i = 29; i >= 7; --i) {
+   int bit_value = (resultSignificand0 >> i) & 1;
+ k++;
+   arr[j]=bit_value;
+   j--;
+       }
+       
+unsigned int temp1;
+        for (int i = 22; i >=0; --i) {
+        temp1 = (temp1 << 1) | arr[i];
+    }
+    
+
+
+bool bit24,bit25;
+
+  
+  
+    
+if(bit24 ==1 & bit25==1 || bit24==1 && bit25==0)
+  temp1+=1;
+
+
+
+int arr1[23];
+for(int k=22;k>=0;--k)
+{
+   arr1[k]=(temp1>>k)&1;
+  }
+
+
+int f=22;
+for (int l = 29; l >= 7; l--)
+{
+   // Check if f is within bounds
+  if (f >= 0)
+  {
+      // Shift and copy arr1[f] to the l-th position
+       resultSignificand0 |= (arr1[f]) << l;
+
+      // Update f
+      f--;
+  }
+}
+        
+ uint32_t result_value = (resultSign << 31) | ((resultExponent << 23) + (resultSignificand0>>7));
+check++;
+        normalized_result.write(result_value);
+    }
+}
+
+    
+    SC_CTOR(FloatingPointNormalizer) : result_sign("result_sign"), result_exp("result_exp"),
+    result_significand("result_significand"), normalized_result("normalized_result"),
+    clock("clock") {
+        SC_THREAD(normalize_process);
+        sensitive << clock.pos();
+    }
+};
+
+}
+
+// SkewBuffer Module
+// Shift register of a fixed depth for one data word and its valid bit. Used for the
+// input skew of each array row, the partial-sum skew of each column and the
+// output de-skew (drain) of each column.
+SC_MODULE(SkewBuffer) {
+    sc_in<sc_uint<32>> data_in;
+    sc_in<bool> valid_in;
+    sc_out<sc_uint<32>> data_out;
+    sc_out<bool> valid_out;
+    sc_in<bool> clock;
+    int depth;
+
+    void shift_process() {
+        std::vector<unsigned int> data(depth, 0);
+        std::vector<bool> valid(depth, false);
+        while (true) {
+            wait();
+            data_out.write(data[depth - 1]);
+            valid_out.write(valid[depth - 1]);
+            for (int i = depth - 1; i > 0; i--) {
+                data[i] = data[i - 1];
+                valid[i] = valid[i - 1];
+            }
+            data[0] = data_in.read();
+            valid[0] = valid_in.read();
+        }
+    }
+
+    SC_HAS_PROCESS(SkewBuffer);
+    SkewBuffer(sc_module_name name, int depth)
+        : sc_module(name),
+          data_in("data_in"),
+          valid_in("valid_in"),
+          data_out("data_out"),
+          valid_out("valid_out"),
+          clock("clock"),
+          depth(depth) {
+        SC_THREAD(shift_process);
+        sensitive << clock.pos();
+    }
+};
+
+// ProcessingElement Module
+// Weight-stationary PE: psum_out = psum_in + act_in * weight, built from the
+// three-stage multiplier pipeline followed by the three-stage adder pipeline.
+// The activation is forwarded to the right after one cycle, the weight is
+// shifted down while load is high, and the partial sum leaves 6 cycles after
+// its activation arrived.
+SC_MODULE(ProcessingElement) {
+    sc_in<sc_uint<32>> act_in;
+    sc_in<bool> act_valid_in;
+    sc_in<sc_uint<32>> psum_in;
+    sc_in<sc_uint<32>> weight_in;
+    sc_in<bool> load;
+    sc_out<sc_uint<32>> act_out;
+    sc_out<bool> act_valid_out;
+    sc_out<sc_uint<32>> psum_out;
+    sc_out<bool> psum_valid;
+    sc_out<sc_uint<32>> weight_out;
+    sc_in<bool> clock;
+
+    multiplication::FloatingPointExtractor mul_extractor;
+    multiplication::FloatingPointMultiplier multiplier;
+    multiplication::FloatingPointNormalizer mul_normalizer;
+    addition::FloatingPointExtractor add_extractor;
+    addition::FloatingPointAdder adder;
+    addition::FloatingPointNormaliser add_normaliser;
+    sc_signal<sc_uint<32>> weight;
+    sc_signal<bool> m_a_sign, m_b_sign, m_result_sign;
+    sc_signal<sc_uint<8>> m_a_exp, m_b_exp, m_result_exp;
+    sc_signal<sc_uint<32>> m_a_significand, m_b_significand, m_result_significand, m_result_significand0;
+    sc_signal<sc_uint<32>> product;
+    sc_signal<bool> zero_flag;
+    sc_signal<sc_uint<32>> product_gated;
+    sc_signal<bool> s_a_sign, s_b_sign, s_result_sign;
+    sc_signal<sc_uint<8>> s_a_exp, s_b_exp, s_result_exp;
+    sc_signal<sc_uint<32>> s_a_significands, s_b_significands, s_result_significand;
+
+    // Activation forwarding, weight register and the valid / zero delay lines
+    void control_process() {
+        bool valid_delay[5] = {false, false, false, false, false};
+        bool zero_delay[2] = {false, false};
+        while (true) {
+            wait();
+            act_out.write(act_in.read());
+            act_valid_out.write(act_valid_in.read());
+
+            if (load.read()) {
+                weight.write(weight_in.read());
+                weight_out.write(weight_in.read());
+            }
+
+            psum_valid.write(valid_delay[4]);
+            for (int i = 4; i > 0; i--) {
+                valid_delay[i] = valid_delay[i - 1];
+            }
+            valid_delay[0] = act_valid_in.read();
+
+            zero_flag.write(zero_delay[1]);
+            zero_delay[1] = zero_delay[0];
+            zero_delay[0] = ((act_in.read() & 0x7FFFFFFF) == 0) || ((weight.read() & 0x7FFFFFFF) == 0);
+        }
+    }
+
+    // Zero-operand gating: the multiplier has no zero special case, so a zero
+    // activation or weight (including tile padding) forces the product to +0
+    void gate_process() {
+        product_gated.write(zero_flag.read() ? sc_uint<32>(0) : product.read());
+    }
+
+    SC_CTOR(ProcessingElement)
+        : act_in("act_in"),
+          act_valid_in("act_valid_in"),
+          psum_in("psum_in"),
+          weight_in("weight_in"),
+          load("load"),
+          act_out("act_out"),
+          act_valid_out("act_valid_out"),
+          psum_out("psum_out"),
+          psum_valid("psum_valid"),
+          weight_out("weight_out"),
+          clock("clock"),
+          mul_extractor("MulExtractor"),
+          multiplier("Multiplier"),
+          mul_normalizer("MulNormalizer"),
+          add_extractor("AddExtractor"),
+          adder("Adder"),
+          add_normaliser("AddNormalization") {
+        mul_extractor.a(act_in);
+        mul_extractor.b(weight);
+        mul_extractor.a_sign(m_a_sign);
+        mul_extractor.a_exp(m_a_exp);
+        mul_extractor.a_significand(m_a_significand);
+        mul_extractor.b_sign(m_b_sign);
+        mul_extractor.b_exp(m_b_exp);
+        mul_extractor.b_significand(m_b_significand);
+        mul_extractor.clock(clock);
+
+        multiplier.a_sign(m_a_sign);
+        multiplier.a_exp(m_a_exp);
+        multiplier.a_significand(m_a_significand);
+        multiplier.b_sign(m_b_sign);
+        multiplier.b_exp(m_b_exp);
+        multiplier.b_significand(m_b_significand);
+        multiplier.result_sign(m_result_sign);
+        multiplier.result_exp(m_result_exp);
+        multiplier.result_significand(m_result_significand);
+        multiplier.result_significand1(m_result_significand0);
+        multiplier.clock(clock);
+
+        mul_normalizer.result_sign(m_result_sign);
+        mul_normalizer.result_exp(m_result_exp);
+        mul_normalizer.result_significand(m_result_significand);
+        mul_normalizer.result_significand1(m_result_significand0);
+        mul_normalizer.normalized_result(product);
+        mul_normalizer.clock(clock);
+
+        add_extractor.a(product_gated);
+        add_extractor.b(psum_in);
+        add_extractor.a_sign(s_a_sign);
+        add_extractor.a_exp(s_a_exp);
+        add_extractor.a_significand(s_a_significands);
+        add_extractor.b_sign(s_b_sign);
+        add_extractor.b_exp(s_b_exp);
+        add_extractor.b_significand(s_b_significands);
+        add_extractor.clock(clock);
+
+        adder.a_sign(s_a_sign);
+        adder.a_exp(s_a_exp);
+        adder.a_significand(s_a_significands);
+        adder.b_sign(s_b_sign);
+        adder.b_exp(s_b_exp);
+        adder.b_significand(s_b_significands);
+        adder.result_sign(s_result_sign);
+        adder.result_exp(s_result_exp);
+        adder.result_significand(s_result_significand);
+        adder.clock(clock);
+
+        add_normaliser.result_sign(s_result_sign);
+        add_normaliser.result_exp(s_result_exp);
+        add_normaliser.result_significand(s_result_significand);
+        add_normaliser.nresult(psum_out);
+        add_normaliser.clock(clock);
+
+        SC_THREAD(control_process);
+        sensitive << clock.pos();
+        SC_METHOD(gate_process);
+        sensitive << product << zero_flag;
+    }
+};
+
+// Top-level Module: R x C weight-stationary systolic array
+// PE(r, c) holds W[r][c]. Activations of row r enter from the left after a skew of
+// 3r cycles (one adder latency per row), partial sums flow down the columns and
+// leave the bottom row, where column c is de-skewed by C - c cycles so a whole
+// output row appears at once. The top-row partial sums are fed from the driver,
+// which lets consecutive K tiles accumulate inside the array.
+SC_MODULE(Top) {
+    int rows;
+    int cols;
+    std::vector<ProcessingElement*> pe;
+    std::vector<SkewBuffer*> row_skew;
+    std::vector<SkewBuffer*> psum_skew;
+    std::vector<SkewBuffer*> drain;
+    std::vector<sc_signal<sc_uint<32>>*> act_in;
+    std::vector<sc_signal<sc_uint<32>>*> psum_top;
+    std::vector<sc_signal<sc_uint<32>>*> weight_in;
+    std::vector<sc_signal<sc_uint<32>>*> result;
+    std::vector<sc_signal<bool>*> result_valid;
+    sc_signal<bool> act_valid;
+    sc_signal<bool> load;
+    std::vector<sc_signal<sc_uint<32>>*> act;
+    std::vector<sc_signal<bool>*> act_valids;
+    std::vector<sc_signal<sc_uint<32>>*> psum;
+    std::vector<sc_signal<bool>*> psum_valids;
+    std::vector<sc_signal<sc_uint<32>>*> weights;
+    sc_signal<bool> high;
+    sc_clock clock;
+
+    // Signal grids: act/act_valids are rows x (cols + 1), psum/psum_valids are
+    // (rows + 1) x cols and weights (the weight_out of each PE) are rows x cols
+    template <class T> std::vector<sc_signal<T>*> make_signals(int n) {
+        std::vector<sc_signal<T>*> v(n);
+        for (int i = 0; i < n; i++) {
+            v[i] = new sc_signal<T>();
+        }
+        return v;
+    }
+
+    SC_HAS_PROCESS(Top);
+    Top(sc_module_name name, int rows, int cols)
+        : sc_module(name),
+          rows(rows),
+          cols(cols),
+          clock("clock", 1, SC_NS) {
+        act_in = make_signals<sc_uint<32>>(rows);
+        psum_top = make_signals<sc_uint<32>>(cols);
+        weight_in = make_signals<sc_uint<32>>(cols);
+        result = make_signals<sc_uint<32>>(cols);
+        result_valid = make_signals<bool>(cols);
+        act = make_signals<sc_uint<32>>(rows * (cols + 1));
+        act_valids = make_signals<bool>(rows * (cols + 1));
+        psum = make_signals<sc_uint<32>>((rows + 1) * cols);
+        psum_valids = make_signals<bool>((rows + 1) * cols);
+        weights = make_signals<sc_uint<32>>(rows * cols);
+        high.write(true);
+
+        for (int r = 0; r < rows; r++) {
+            SkewBuffer* skew = new SkewBuffer(("RowSkew" + std::to_string(r)).c_str(), 3 * r + 1);
+            skew->data_in(*act_in[r]);
+            skew->valid_in(act_valid);
+            skew->data_out(*act[r * (cols + 1)]);
+            skew->valid_out(*act_valids[r * (cols + 1)]);
+            skew->clock(clock);
+            row_skew.push_back(skew);
+        }
+        for (int c = 0; c < cols; c++) {
+            SkewBuffer* skew = new SkewBuffer(("PsumSkew" + std::to_string(c)).c_str(), c + 4);
+            skew->data_in(*psum_top[c]);
+            skew->valid_in(high);
+            skew->data_out(*psum[c]);
+            skew->valid_out(*psum_valids[c]);
+            skew->clock(clock);
+            psum_skew.push_back(skew);
+
+            SkewBuffer* out = new SkewBuffer(("Drain" + std::to_string(c)).c_str(), cols - c);
+            out->data_in(*psum[rows * cols + c]);
+            out->valid_in(*psum_valids[rows * cols + c]);
+            out->data_out(*result[c]);
+            out->valid_out(*result_valid[c]);
+            out->clock(clock);
+            drain.push_back(out);
+        }
+        for (int r = 0; r < rows; r++) {
+            for (int c = 0; c < cols; c++) {
+                ProcessingElement* p = new ProcessingElement(("PE_" + std::to_string(r) + "_" + std::to_string(c)).c_str());
+                p->act_in(*act[r * (cols + 1) + c]);
+                p->act_valid_in(*act_valids[r * (cols + 1) + c]);
+                p->act_out(*act[r * (cols + 1) + c + 1]);
+                p->act_valid_out(*act_valids[r * (cols + 1) + c + 1]);
+                p->psum_in(*psum[r * cols + c]);
+                p->psum_out(*psum[(r + 1) * cols + c]);
+                p->psum_valid(*psum_valids[(r + 1) * cols + c]);
+                p->weight_in((r == 0) ? *weight_in[c] : *weights[(r - 1) * cols + c]);
+                p->weight_out(*weights[r * cols + c]);
+                p->load(load);
+                p->clock(clock);
+                pe.push_back(p);
+            }
+        }
+    }
+};
+
+int sc_main(int argc, char* argv[]) {
+    int rows, cols, M, K, N;
+    cout << "Enter the array size (rows cols): ";
+    cin >> rows >> cols;
+    cout << "Enter the GEMM size (M K N): ";
+    cin >> M >> K >> N;
+    if (rows <= 0 || cols <= 0 || M <= 0 || K <= 0 || N <= 0) {
+        cout << "Invalid input" << endl;
+        return 1;
+    }
+
+    Top top("Top", rows, cols);
+
+    // Y[M x N] = X[M x K] * W[K x N], non-negative inputs
+    srand(1);
+    std::vector<float> X(M * K), W(K * N), Y(M * N, 0.0f);
+    for (int i = 0; i < M * K; i++) {
+        X[i] = static_cast<float>(rand()) / RAND_MAX;
+    }
+    for (int i = 0; i < K * N; i++) {
+        W[i] = static_cast<float>(rand()) / RAND_MAX;
+    }
+
+    long long cycles = 0;
+    long long load_cycles = 0;
+    int latency = 0;
+    int k_tiles = (K + rows - 1) / rows;
+    int n_tiles = (N + cols - 1) / cols;
+
+    // Driver: for every N tile, run the K tiles back to back with the previous
+    // partial sums fed into the top row
+    for (int nt = 0; nt < n_tiles; nt++) {
+        for (int kt = 0; kt < k_tiles; kt++) {
+            // Weight load: shift rows in bottom-first, one row per cycle
+            for (int s = 0; s < rows; s++) {
+                int k = kt * rows + (rows - 1 - s);
+                for (int c = 0; c < cols; c++) {
+                    int n = nt * cols + c;
+                    float w = (k < K && n < N) ? W[k * N + n] : 0.0f;
+                    unsigned int w_binary;
+                    memcpy(&w_binary, &w, sizeof(w_binary));
+                    top.weight_in[c]->write(w_binary);
+                }
+                top.load.write(true);
+                sc_start(1, SC_NS);
+                cycles++;
+                load_cycles++;
+            }
+            top.load.write(false);
+
+            // Stream the M activation rows, then drain the array
+            int received = 0;
+            for (int m = 0; received < M; m++) {
+                for (int r = 0; r < rows; r++) {
+                    int k = kt * rows + r;
+                    float x = (m < M && k < K) ? X[m * K + k] : 0.0f;
+                    unsigned int x_binary;
+                    memcpy(&x_binary, &x, sizeof(x_binary));
+                    top.act_in[r]->write(x_binary);
+                }
+                for (int c = 0; c < cols; c++) {
+                    int n = nt * cols + c;
+                    float p = (m < M && n < N) ? Y[m * N + n] : 0.0f;
+                    unsigned int p_binary;
+                    memcpy(&p_binary, &p, sizeof(p_binary));
+                    top.psum_top[c]->write(p_binary);
+                }
+                top.act_valid.write(m < M);
+                sc_start(1, SC_NS);
+                cycles++;
+
+                if (top.result_valid[0]->read()) {
+                    if (latency == 0) {
+                        latency = m + 1;
+                    }
+                    for (int c = 0; c < cols; c++) {
+                        int n = nt * cols + c;
+                        if (n < N) {
+                            unsigned int y_binary = top.result[c]->read();
+                            memcpy(&Y[received * N + n], &y_binary, sizeof(y_binary));
+                        }
+                    }
+                    received++;
+                }
+            }
+        }
+    }
+
+    // Host reference
+    double max_error = 0;
+    for (int m = 0; m < M; m++) {
+        for (int n = 0; n < N; n++) {
+            double ref = 0;
+            for (int k = 0; k < K; k++) {
+                ref += static_cast<double>(X[m * K + k]) * W[k * N + n];
+            }
+            double error = fabs(Y[m * N + n] - ref) / ((ref != 0) ? fabs(ref) : 1.0);
+            max_error = (error > max_error) ? error : max_error;
+        }
+    }
+
+    double macs = static_cast<double>(M) * K * N;
+    double utilisation = macs / (static_cast<double>(rows) * cols * cycles);
+    cout << "Array: " << rows << " x " << cols << " PEs, GEMM: " << M << " x " << K << " x " << N << endl;
+    cout << "Tiles: " << k_tiles * n_tiles << " (" << k_tiles << " K x " << n_tiles << " N)" << endl;
+    cout << "Pipeline latency: " << latency << " cycles, weight load: " << load_cycles << " cycles" << endl;
+    cout << "Total cycles: " << cycles << endl;
+    cout << "PE utilisation: " << utilisation * 100 << " %" << endl;
+    cout << "Throughput: " << 2 * macs / cycles << " GFLOP/s at 1 GHz (peak " << 2.0 * rows * cols << ")" << endl;
+    cout << "Max relative error vs host: " << max_error << endl;
+    return 0;
+}
@@ -0,0 +1,316 @@
+#include <systemc.h>
+#include <tlm.h>
+#include <tlm_utils/simple_initiator_socket.h>
+#include <tlm_utils/simple_target_socket.h>
+#include <tlm_utils/peq_with_cb_and_phase.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <deque>
+#include <map>
+#include "fpu_models.h"
+
+// An operation is one TLM_READ_COMMAND of 12 bytes at OPERATE: the initiator fills
+// bytes 0-7 with a and b, the target returns op(a, b) in bytes 8-11
+#define OPERATE 0x10
+#define OPERATION_BYTES 12
+
+enum FpuOp { FPU_ADD, FPU_SUB, FPU_MUL, FPU_DIV };
+const char* op_names[] = {"add", "sub", "mul", "div"};
+
+unsigned int operation_function(int op, unsigned int a, unsigned int b) {
+    switch (op) {
+    case FPU_ADD: return addition_function(a, b);
+    case FPU_SUB: return subtraction_function(a, b);
+    case FPU_MUL: return multiplication_function(a, b);
+    default: return division_function(a, b);
+    }
+}
+
+// FpuAtTarget Module
+// TLM-2.0 approximately-timed (4-phase) wrapper around one unit. A request is
+// accepted (END_REQ) one initiation interval after it enters the first stage and
+// its response (BEGIN_RESP) is sent after the extractor/op/normaliser latency.
+// A unit holds at most one operation per stage: when the response channel is
+// blocked the pipeline fills up and END_REQ is withheld, which is the
+// backpressure seen by the initiator.
+SC_MODULE(FpuAtTarget) {
+    tlm_utils::simple_target_socket<FpuAtTarget> socket;
+    tlm_utils::peq_with_cb_and_phase<FpuAtTarget> peq;
+    int op;
+    sc_time clock_period;
+    int latency_cycles;
+    std::deque<tlm::tlm_generic_payload*> requests;
+    std::deque<std::pair<tlm::tlm_generic_payload*, sc_time>> pipeline;
+    sc_event request_event;
+    sc_event response_event;
+    sc_event end_resp_event;
+    sc_event slot_event;
+    int in_flight;
+    int max_in_flight;
+    double occupancy_integral;
+    sc_time last_change;
+    sc_time stall_time;
+
+    // Time-weighted count of operations between BEGIN_REQ acceptance and END_RESP
+    void occupancy(int change) {
+        occupancy_integral += in_flight * (sc_time_stamp() - last_change).to_seconds();
+        last_change = sc_time_stamp();
+        in_flight += change;
+        max_in_flight = (in_flight > max_in_flight) ? in_flight : max_in_flight;
+    }
+
+    tlm::tlm_sync_enum nb_transport_fw(tlm::tlm_generic_payload& trans, tlm::tlm_phase& phase, sc_time& delay) {
+        if (phase == tlm::BEGIN_REQ) {
+            if (trans.get_address() != OPERATE || trans.get_data_length() != OPERATION_BYTES) {
+                trans.set_response_status(tlm::TLM_ADDRESS_ERROR_RESPONSE);
+                return tlm::TLM_COMPLETED;
+            }
+            peq.notify(trans, phase, delay);
+        } else if (phase == tlm::END_RESP) {
+            peq.notify(trans, phase, delay);
+        } else {
+            SC_REPORT_ERROR("FpuAtTarget", "illegal phase on forward path");
+        }
+        return tlm::TLM_ACCEPTED;
+    }
+
+    void peq_callback(tlm::tlm_generic_payload& trans, const tlm::tlm_phase& phase) {
+        if (phase == tlm::BEGIN_REQ) {
+            requests.push_back(&trans);
+            request_event.notify();
+        } else {
+            end_resp_event.notify();
+        }
+    }
+
+    // Request channel: one operation enters the first stage per initiation interval
+    void request_process() {
+        while (true) {
+            while (requests.empty()) {
+                wait(request_event);
+            }
+            tlm::tlm_generic_payload* trans = requests.front();
+            requests.pop_front();
+
+            sc_time arrival = sc_time_stamp();
+            while (in_flight >= latency_cycles) {
+                wait(slot_event);
+            }
+            stall_time += sc_time_stamp() - arrival;
+
+            unsigned char* data = trans->get_data_ptr();
+            unsigned int a, b, result;
+            memcpy(&a, data, 4);
+            memcpy(&b, data + 4, 4);
+            result = operation_function(op, a, b);
+            memcpy(data + 8, &result, 4);
+            occupancy(+1);
+            pipeline.push_back(std::make_pair(trans, sc_time_stamp() + clock_period * latency_cycles));
+            response_event.notify();
+
+            wait(clock_period);
+            tlm::tlm_phase phase = tlm::END_REQ;
+            sc_time delay = SC_ZERO_TIME;
+            socket->nb_transport_bw(*trans, phase, delay);
+        }
+    }
+
+    // Response channel: results leave in order, one BEGIN_RESP .. END_RESP at a time
+    void response_process() {
+        while (true) {
+            while (pipeline.empty()) {
+                wait(response_event);
+            }
+            tlm::tlm_generic_payload* trans = pipeline.front().first;
+            sc_time ready = pipeline.front().second;
+            if (sc_time_stamp() < ready) {
+                wait(ready - sc_time_stamp());
+            }
+            pipeline.pop_front();
+
+            trans->set_response_status(tlm::TLM_OK_RESPONSE);
+            tlm::tlm_phase phase = tlm::BEGIN_RESP;
+            sc_time delay = SC_ZERO_TIME;
+            tlm::tlm_sync_enum status = socket->nb_transport_bw(*trans, phase, delay);
+            if (status == tlm::TLM_ACCEPTED) {
+                wait(end_resp_event);
+            } else if (delay != SC_ZERO_TIME) {
+                wait(delay);
+            }
+            occupancy(-1);
+            slot_event.notify();
+        }
+    }
+
+    SC_HAS_PROCESS(FpuAtTarget);
+    FpuAtTarget(sc_module_name name, int op, sc_time clock_period, int latency_cycles)
+        : sc_module(name),
+          socket("socket"),
+          peq("peq", this, &FpuAtTarget::peq_callback),
+          op(op),
+          clock_period(clock_period),
+          latency_cycles(latency_cycles),
+          in_flight(0),
+          max_in_flight(0),
+          occupancy_integral(0) {
+        socket.register_nb_transport_fw(this, &FpuAtTarget::nb_transport_fw);
+        SC_THREAD(request_process);
+        SC_THREAD(response_process);
+    }
+};
+
+// Operation Record: payload, operand/result buffer, the result expected before
+// the operation is issued, and timestamps
+struct Operation {
+    tlm::tlm_generic_payload trans;
+    unsigned char data[OPERATION_BYTES];
+    unsigned int expected;
+    sc_time issued;
+    sc_time completed;
+};
+
+// FpuAtInitiator Module
+// Issues a stream of operations to one unit as fast as the protocol allows: a new
+// BEGIN_REQ only after the previous END_REQ. Each response is held for
+// response_delay before END_RESP, modelling a slow consumer upstream.
+SC_MODULE(FpuAtInitiator) {
+    tlm_utils::simple_initiator_socket<FpuAtInitiator> socket;
+    tlm_utils::peq_with_cb_and_phase<FpuAtInitiator> end_resp_peq;
+    std::vector<Operation> ops;
+    sc_time response_delay;
+    sc_event end_req_event;
+    sc_event done_event;
+    int completed;
+    std::map<tlm::tlm_generic_payload*, Operation*> lookup;
+
+    tlm::tlm_sync_enum nb_transport_bw(tlm::tlm_generic_payload& trans, tlm::tlm_phase& phase, sc_time& delay) {
+        if (phase == tlm::END_REQ) {
+            end_req_event.notify(delay);
+            return tlm::TLM_ACCEPTED;
+        }
+        if (phase == tlm::BEGIN_RESP) {
+            lookup[&trans]->completed = sc_time_stamp() + delay;
+            completed++;
+            done_event.notify(delay);
+            if (response_delay == SC_ZERO_TIME) {
+                phase = tlm::END_RESP;
+                return tlm::TLM_COMPLETED;
+            }
+            end_resp_peq.notify(trans, tlm::END_RESP, delay + response_delay);
+            return tlm::TLM_ACCEPTED;
+        }
+        SC_REPORT_ERROR("FpuAtInitiator", "illegal phase on backward path");
+        return tlm::TLM_COMPLETED;
+    }
+
+    void end_resp_callback(tlm::tlm_generic_payload& trans, const tlm::tlm_phase& phase) {
+        if (phase != tlm::END_RESP) {
+            SC_REPORT_ERROR("FpuAtInitiator", "illegal phase in the END_RESP queue");
+            return;
+        }
+        tlm::tlm_phase end_resp = phase;
+        sc_time delay = SC_ZERO_TIME;
+        socket->nb_transport_fw(trans, end_resp, delay);
+    }
+
+    void issue_process() {
+        for (size_t i = 0; i < ops.size(); i++) {
+            Operation& o = ops[i];
+            o.trans.set_command(tlm::TLM_READ_COMMAND);
+            o.trans.set_address(OPERATE);
+            o.trans.set_data_ptr(o.data);
+            o.trans.set_data_length(OPERATION_BYTES);
+            o.trans.set_streaming_width(OPERATION_BYTES);
+            o.trans.set_byte_enable_ptr(0);
+            o.trans.set_response_status(tlm::TLM_INCOMPLETE_RESPONSE);
+            lookup[&o.trans] = &o;
+
+            o.issued = sc_time_stamp();
+            tlm::tlm_phase phase = tlm::BEGIN_REQ;
+            sc_time delay = SC_ZERO_TIME;
+            tlm::tlm_sync_enum status = socket->nb_transport_fw(o.trans, phase, delay);
+            if (status == tlm::TLM_ACCEPTED) {
+                wait(end_req_event);
+            } else if (status == tlm::TLM_COMPLETED && o.trans.is_response_error()) {
+                SC_REPORT_ERROR("FpuAtInitiator", o.trans.get_response_string().c_str());
+            }
+        }
+        while (completed < static_cast<int>(ops.size())) {
+            wait(done_event);
+        }
+    }
+
+    SC_HAS_PROCESS(FpuAtInitiator);
+    FpuAtInitiator(sc_module_name name, sc_time response_delay)
+        : sc_module(name),
+          socket("socket"),
+          end_resp_peq("end_resp_peq", this, &FpuAtInitiator::end_resp_callback),
+          response_delay(response_delay),
+          completed(0) {
+        socket.register_nb_transport_bw(this, &FpuAtInitiator::nb_transport_bw);
+        SC_THREAD(issue_process);
+    }
+};
+
+int sc_main(int argc, char* argv[]) {
+    int n;
+    double response_delay;
+    cout << "Enter the number of operations per unit: ";
+    cin >> n;
+    cout << "Enter the response delay in ns (0 = responses consumed immediately): ";
+    cin >> response_delay;
+    if (n <= 0 || response_delay < 0) {
+        cout << "Invalid input" << endl;
+        return 1;
+    }
+
+    // Pipeline timing of the pin-level units: three 1 ns stages for add/sub/mul,
+    // extract + compute at 10 ns for division
+    sc_time period[4] = {sc_time(1, SC_NS), sc_time(1, SC_NS), sc_time(1, SC_NS), sc_time(10, SC_NS)};
+    int latency[4] = {3, 3, 3, 2};
+    FpuAtTarget* unit[4];
+    FpuAtInitiator* initiator[4];
+    srand(1);
+    for (int op = 0; op < 4; op++) {
+        unit[op] = new FpuAtTarget((std::string("Unit_") + op_names[op]).c_str(), op, period[op], latency[op]);
+        initiator[op] = new FpuAtInitiator((std::string("Initiator_") + op_names[op]).c_str(), sc_time(response_delay, SC_NS));
+        initiator[op]->socket.bind(unit[op]->socket);
+        initiator[op]->ops.resize(n);
+        for (int i = 0; i < n; i++) {
+            float a_float = ldexpf(static_cast<float>(rand()) / RAND_MAX, rand() % 16 - 8);
+            float b_float = ldexpf(static_cast<float>(rand()) / RAND_MAX, rand() % 16 - 8);
+            Operation& o = initiator[op]->ops[i];
+            unsigned int a, b;
+            memcpy(&a, &a_float, 4);
+            memcpy(&b, &b_float, 4);
+            memcpy(o.data, &a, 4);
+            memcpy(o.data + 4, &b, 4);
+            // The result bytes start as a NaN no operand pair here produces, so a
+            // response that never carried its result is caught
+            memset(o.data + 8, 0xFF, 4);
+            o.expected = operation_function(op, a, b);
+        }
+    }
+
+    sc_start();
+
+    for (int op = 0; op < 4; op++) {
+        std::vector<Operation>& ops = initiator[op]->ops;
+        sc_time last = SC_ZERO_TIME;
+        double latency_sum = 0;
+        int mismatches = 0;
+        for (int i = 0; i < n; i++) {
+            unsigned int result;
+            memcpy(&result, ops[i].data + 8, 4);
+            mismatches += (result != ops[i].expected || !ops[i].trans.is_response_ok());
+            latency_sum += (ops[i].completed - ops[i].issued) / period[op];
+            last = (ops[i].completed > last) ? ops[i].completed : last;
+        }
+        double cycles = last / period[op];
+        cout << op_names[op] << ": " << n << " ops in " << cycles << " cycles (" << n / cycles << " ops/cycle), mean latency "
+             << latency_sum / n << " cycles, in flight max " << unit[op]->max_in_flight << " avg "
+             << unit[op]->occupancy_integral / last.to_seconds() << ", request stall " << unit[op]->stall_time / period[op]
+             << " cycles, mismatches " << mismatches << endl;
+    }
+    return 0;
+}
@@ -0,0 +1,358 @@
+#include <systemc.h>
+#include <tlm.h>
+#include <tlm_utils/simple_initiator_socket.h>
+#include <tlm_utils/simple_target_socket.h>
+#include <tlm_utils/tlm_quantumkeeper.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include "fpu_models.h"
+#include "fpu_pipelines.h"
+
+// FPU register map, one target per unit. Data moves over a 64-bit bus, so every
+// 8 bytes cost one clock period.
+#define OPERAND_A 0x00     // write: a (an 8-byte write sets a and b)
+#define OPERAND_B 0x04     // write: b
+#define RESULT 0x08        // read: op(a, b)
+#define BATCH_COUNT 0x0C   // write: run op over the first n pairs of the batch window
+#define BATCH_BASE 0x1000  // batch window: BATCH_MAX (a, b) pairs, then BATCH_MAX results
+#define BATCH_MAX 1024
+
+enum FpuOp { FPU_ADD, FPU_SUB, FPU_MUL, FPU_DIV };
+const char* op_names[] = {"add", "sub", "mul", "div"};
+
+// FpuTarget Module
+// TLM-2.0 loosely-timed wrapper around one unit. b_transport runs the bit-exact
+// function and annotates the pin-level pipeline latency instead of clocking the
+// stages. The batch window can be accessed through DMI, so a whole operand
+// stream costs one control transaction.
+SC_MODULE(FpuTarget) {
+    tlm_utils::simple_target_socket<FpuTarget> socket;
+    int op;
+    sc_time clock_period;
+    int latency_cycles;
+    unsigned int operand_a;
+    unsigned int operand_b;
+    unsigned int batch[3 * BATCH_MAX];
+
+    unsigned int compute(unsigned int a, unsigned int b) {
+        switch (op) {
+        case FPU_ADD: return addition_function(a, b);
+        case FPU_SUB: return subtraction_function(a, b);
+        case FPU_MUL: return multiplication_function(a, b);
+        default: return division_function(a, b);
+        }
+    }
+
+    void b_transport(tlm::tlm_generic_payload& trans, sc_time& delay) {
+        tlm::tlm_command cmd = trans.get_command();
+        uint64_t addr = trans.get_address();
+        unsigned char* ptr = trans.get_data_ptr();
+        unsigned int len = trans.get_data_length();
+
+        if (trans.get_byte_enable_ptr() != 0 || trans.get_streaming_width() < len) {
+            trans.set_response_status(tlm::TLM_BYTE_ENABLE_ERROR_RESPONSE);
+            return;
+        }
+
+        // Batch window: plain memory for initiators that do not use DMI
+        if (addr >= BATCH_BASE && addr + len <= BATCH_BASE + sizeof(batch)) {
+            unsigned char* mem = reinterpret_cast<unsigned char*>(batch) + (addr - BATCH_BASE);
+            if (cmd == tlm::TLM_READ_COMMAND) {
+                memcpy(ptr, mem, len);
+            } else if (cmd == tlm::TLM_WRITE_COMMAND) {
+                memcpy(mem, ptr, len);
+            }
+            delay += clock_period * ((len + 7) / 8);
+            trans.set_dmi_allowed(true);
+            trans.set_response_status(tlm::TLM_OK_RESPONSE);
+            return;
+        }
+
+        if (cmd == tlm::TLM_WRITE_COMMAND && addr == OPERAND_A && (len == 4 || len == 8)) {
+            memcpy(&operand_a, ptr, 4);
+            if (len == 8) {
+                memcpy(&operand_b, ptr + 4, 4);
+            }
+            delay += clock_period;
+        } else if (cmd == tlm::TLM_WRITE_COMMAND && addr == OPERAND_B && len == 4) {
+            memcpy(&operand_b, ptr, 4);
+            delay += clock_period;
+        } else if (cmd == tlm::TLM_READ_COMMAND && addr == RESULT && len == 4) {
+            unsigned int result = compute(operand_a, operand_b);
+            memcpy(ptr, &result, 4);
+            delay += clock_period * latency_cycles;
+        } else if (cmd == tlm::TLM_WRITE_COMMAND && addr == BATCH_COUNT && len == 4) {
+            unsigned int n;
+            memcpy(&n, ptr, 4);
+            if (n > BATCH_MAX) {
+                trans.set_response_status(tlm::TLM_GENERIC_ERROR_RESPONSE);
+                return;
+            }
+            for (unsigned int i = 0; i < n; i++) {
+                batch[2 * BATCH_MAX + i] = compute(batch[2 * i], batch[2 * i + 1]);
+            }
+            // The pipeline accepts one pair per cycle
+            if (n > 0) {
+                delay += clock_period * (latency_cycles + n - 1);
+            }
+        } else {
+            trans.set_response_status(tlm::TLM_ADDRESS_ERROR_RESPONSE);
+            return;
+        }
+        trans.set_response_status(tlm::TLM_OK_RESPONSE);
+    }
+
+    // Only the batch window is plain memory. For an address outside it DMI is
+    // denied over the register block or the unmapped range above the window.
+    bool get_direct_mem_ptr(tlm::tlm_generic_payload& trans, tlm::tlm_dmi& dmi) {
+        uint64_t addr = trans.get_address();
+        if (addr < BATCH_BASE || addr >= BATCH_BASE + sizeof(batch)) {
+            dmi.set_granted_access(tlm::tlm_dmi::DMI_ACCESS_NONE);
+            if (addr < BATCH_BASE) {
+                dmi.set_start_address(0);
+                dmi.set_end_address(BATCH_BASE - 1);
+            } else {
+                dmi.set_start_address(BATCH_BASE + sizeof(batch));
+                dmi.set_end_address(~static_cast<uint64_t>(0));
+            }
+            return false;
+        }
+        dmi.set_dmi_ptr(reinterpret_cast<unsigned char*>(batch));
+        dmi.set_start_address(BATCH_BASE);
+        dmi.set_end_address(BATCH_BASE + sizeof(batch) - 1);
+        dmi.allow_read_write();
+        dmi.set_read_latency(clock_period);
+        dmi.set_write_latency(clock_period);
+        return true;
+    }
+
+    SC_HAS_PROCESS(FpuTarget);
+    FpuTarget(sc_module_name name, int op, sc_time clock_period, int latency_cycles)
+        : sc_module(name),
+          socket("socket"),
+          op(op),
+          clock_period(clock_period),
+          latency_cycles(latency_cycles),
+          operand_a(0),
+          operand_b(0) {
+        socket.register_b_transport(this, &FpuTarget::b_transport);
+        socket.register_get_direct_mem_ptr(this, &FpuTarget::get_direct_mem_ptr);
+    }
+};
+
+// CpuModel Module
+// Loosely-timed initiator with temporal decoupling: it runs ahead of simulated
+// time by up to one global quantum and only yields to the kernel on sync().
+SC_MODULE(CpuModel) {
+    tlm_utils::simple_initiator_socket<CpuModel> socket[4];
+    tlm_utils::tlm_quantumkeeper qk;
+    std::vector<unsigned int> a;
+    std::vector<unsigned int> b;
+    std::vector<unsigned int> lt_result;
+    std::vector<unsigned int> batch_result;
+    int syncs;
+
+    void sync_if_needed() {
+        if (qk.need_sync()) {
+            qk.sync();
+            syncs++;
+        }
+    }
+
+    void transport(int op, tlm::tlm_generic_payload& trans) {
+        sc_time delay = qk.get_local_time();
+        socket[op]->b_transport(trans, delay);
+        qk.set(delay);
+        if (trans.is_response_error()) {
+            SC_REPORT_ERROR("CpuModel", trans.get_response_string().c_str());
+        }
+    }
+
+    // One operation: 8-byte write of (a, b), then a read of the result
+    unsigned int fpu_call(int op, unsigned int x, unsigned int y) {
+        tlm::tlm_generic_payload trans;
+        unsigned int data[2] = {x, y};
+        trans.set_command(tlm::TLM_WRITE_COMMAND);
+        trans.set_address(OPERAND_A);
+        trans.set_data_ptr(reinterpret_cast<unsigned char*>(data));
+        trans.set_data_length(8);
+        trans.set_streaming_width(8);
+        trans.set_byte_enable_ptr(0);
+        trans.set_dmi_allowed(false);
+        trans.set_response_status(tlm::TLM_INCOMPLETE_RESPONSE);
+        transport(op, trans);
+
+        trans.set_command(tlm::TLM_READ_COMMAND);
+        trans.set_address(RESULT);
+        trans.set_data_length(4);
+        trans.set_streaming_width(4);
+        trans.set_response_status(tlm::TLM_INCOMPLETE_RESPONSE);
+        transport(op, trans);
+        sync_if_needed();
+        return data[0];
+    }
+
+    // Whole stream through the DMI batch window, BATCH_MAX pairs per control write
+    void fpu_batch(int op, tlm::tlm_dmi& dmi, const unsigned int* x, const unsigned int* y, unsigned int* out, int n) {
+        unsigned int* window = reinterpret_cast<unsigned int*>(dmi.get_dmi_ptr());
+        for (int base = 0; base < n; base += BATCH_MAX) {
+            unsigned int count = (n - base < BATCH_MAX) ? (n - base) : BATCH_MAX;
+            for (unsigned int i = 0; i < count; i++) {
+                window[2 * i] = x[base + i];
+                window[2 * i + 1] = y[base + i];
+            }
+            qk.inc(dmi.get_write_latency() * count);
+
+            tlm::tlm_generic_payload trans;
+            trans.set_command(tlm::TLM_WRITE_COMMAND);
+            trans.set_address(BATCH_COUNT);
+            trans.set_data_ptr(reinterpret_cast<unsigned char*>(&count));
+            trans.set_data_length(4);
+            trans.set_streaming_width(4);
+            trans.set_byte_enable_ptr(0);
+            trans.set_response_status(tlm::TLM_INCOMPLETE_RESPONSE);
+            transport(op, trans);
+
+            memcpy(out + base, window + 2 * BATCH_MAX, count * sizeof(unsigned int));
+            qk.inc(dmi.get_read_latency() * ((count + 1) / 2));
+            sync_if_needed();
+        }
+    }
+
+    void run() {
+        int n = a.size();
+        qk.reset();
+
+        // Loosely-timed path, one transaction pair per operation, cycling through the units
+        sc_time start = qk.get_current_time();
+        syncs = 0;
+        std::chrono::steady_clock::time_point host_start = std::chrono::steady_clock::now();
+        for (int i = 0; i < n; i++) {
+            lt_result[i] = fpu_call(i % 4, a[i], b[i]);
+        }
+        double host = std::chrono::duration<double>(std::chrono::steady_clock::now() - host_start).count();
+        sc_time simulated = qk.get_current_time() - start;
+        cout << "LT b_transport: " << n << " ops, simulated " << simulated << ", " << syncs << " syncs, host "
+             << host * 1e3 << " ms (" << host * 1e9 / n << " ns/op)" << endl;
+
+        // DMI batch path, one stream per unit
+        tlm::tlm_dmi dmi[4];
+        for (int op = 0; op < 4; op++) {
+            tlm::tlm_generic_payload trans;
+            trans.set_address(BATCH_BASE);
+            if (!socket[op]->get_direct_mem_ptr(trans, dmi[op])) {
+                SC_REPORT_ERROR("CpuModel", "DMI not granted");
+            }
+        }
+        std::vector<unsigned int> x[4], y[4], out[4];
+        for (int i = 0; i < n; i++) {
+            x[i % 4].push_back(a[i]);
+            y[i % 4].push_back(b[i]);
+        }
+        start = qk.get_current_time();
+        syncs = 0;
+        host_start = std::chrono::steady_clock::now();
+        for (int op = 0; op < 4; op++) {
+            out[op].resize(x[op].size());
+            fpu_batch(op, dmi[op], x[op].data(), y[op].data(), out[op].data(), x[op].size());
+        }
+        host = std::chrono::duration<double>(std::chrono::steady_clock::now() - host_start).count();
+        simulated = qk.get_current_time() - start;
+        for (int i = 0; i < n; i++) {
+            batch_result[i] = out[i % 4][i / 4];
+        }
+        cout << "DMI batch: " << n << " ops, simulated " << simulated << ", " << syncs << " syncs, host "
+             << host * 1e3 << " ms (" << host * 1e9 / n << " ns/op)" << endl;
+        qk.sync();
+    }
+
+    SC_CTOR(CpuModel) : syncs(0) {
+        SC_THREAD(run);
+    }
+};
+
+int sc_main(int argc, char* argv[]) {
+    int model, n;
+    double quantum;
+    cout << "Enter the model (1 = TLM units, 2 = pin-level adder Top): ";
+    cin >> model;
+    cout << "Enter the number of operations: ";
+    cin >> n;
+    if ((model != 1 && model != 2) || n <= 0) {
+        cout << "Invalid input" << endl;
+        return 1;
+    }
+
+    srand(1);
+    std::vector<unsigned int> a(n), b(n);
+    for (int i = 0; i < n; i++) {
+        float a_float = ldexpf(static_cast<float>(rand()) / RAND_MAX, rand() % 16 - 8);
+        float b_float = ldexpf(static_cast<float>(rand()) / RAND_MAX, rand() % 16 - 8);
+        memcpy(&a[i], &a_float, sizeof(a_float));
+        memcpy(&b[i], &b_float, sizeof(b_float));
+    }
+
+    if (model == 2) {
+        // Pin-level reference: one addition per 1 ns clock through the signal-level Top
+        addition::Top top("Top");
+        int mismatches = 0;
+        std::chrono::steady_clock::time_point host_start = std::chrono::steady_clock::now();
+        for (int cycle = 0; cycle < n + 2; cycle++) {
+            if (cycle < n) {
+                top.a.write(a[cycle]);
+                top.b.write(b[cycle]);
+            }
+            sc_start(1, SC_NS);
+            if (cycle >= 2) {
+                mismatches += (top.normalized_result.read() != addition_function(a[cycle - 2], b[cycle - 2]));
+            }
+        }
+        double host = std::chrono::duration<double>(std::chrono::steady_clock::now() - host_start).count();
+        cout << "Pin-level adder: " << n << " ops, simulated " << sc_time_stamp() << ", host " << host * 1e3
+             << " ms (" << host * 1e9 / n << " ns/op), mismatches vs addition_function: " << mismatches << endl;
+        return 0;
+    }
+
+    cout << "Enter the global quantum in ns: ";
+    cin >> quantum;
+    tlm_utils::tlm_quantumkeeper::set_global_quantum(sc_time(quantum, SC_NS));
+
+    // Latencies of the pin-level pipelines: three 1 ns stages for add/sub/mul,
+    // extract + compute at 10 ns for division
+    FpuTarget adder("Adder", FPU_ADD, sc_time(1, SC_NS), 3);
+    FpuTarget subtractor("Subtractor", FPU_SUB, sc_time(1, SC_NS), 3);
+    FpuTarget multiplier("Multiplier", FPU_MUL, sc_time(1, SC_NS), 3);
+    FpuTarget divider("Divider", FPU_DIV, sc_time(10, SC_NS), 2);
+    CpuModel cpu("Cpu");
+    cpu.socket[FPU_ADD].bind(adder.socket);
+    cpu.socket[FPU_SUB].bind(subtractor.socket);
+    cpu.socket[FPU_MUL].bind(multiplier.socket);
+    cpu.socket[FPU_DIV].bind(divider.socket);
+    cpu.a = a;
+    cpu.b = b;
+    cpu.lt_result.resize(n);
+    cpu.batch_result.resize(n);
+
+    sc_start();
+
+    // Both paths against the functional models, so a result taken from the wrong
+    // unit, register or batch slot shows up
+    unsigned int (*models[4])(unsigned int, unsigned int) = {
+        addition_function, subtraction_function, multiplication_function, division_function};
+    int lt_mismatches = 0, batch_mismatches = 0;
+    for (int i = 0; i < n; i++) {
+        unsigned int expected = models[i % 4](a[i], b[i]);
+        lt_mismatches += (cpu.lt_result[i] != expected);
+        batch_mismatches += (cpu.batch_result[i] != expected);
+    }
+    cout << "Mismatches vs functional models: LT " << lt_mismatches << ", DMI batch " << batch_mismatches << endl;
+    for (int op = 0; op < 4 && op < n; op++) {
+        float a_float, b_float, r_float;
+        memcpy(&a_float, &a[op], sizeof(a_float));
+        memcpy(&b_float, &b[op], sizeof(b_float));
+        memcpy(&r_float, &cpu.lt_result[op], sizeof(r_float));
+        cout << op_names[op] << " " << a_float << ", " << b_float << " = " << r_float << endl;
+    }
+    return 0;
+}
@@ -0,0 +1,286 @@
+#include <systemc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <float.h>
+#include <bitset>
+#include <chrono>
+#include <deque>
+#include <string>
+#include "fpu_models.h"
+#include "fpu_pipelines.h"
+#include "traced_float.h"
+
+enum FpuOp { FPU_ADD, FPU_SUB, FPU_MUL, FPU_DIV };
+const char* op_names[] = {"add", "sub", "mul", "div"};
+
+// Issue/result timing of each Top in 1 ns cycles, as in the simulation server
+const int issue_period[4] = {1, 1, 1, 10};
+const int result_delay[4] = {2, 2, 2, 10};
+#define QUEUE_DEPTH 16
+
+// IEEE exception classes of an operation, most significant first
+enum ExceptionClass {
+    CLASS_NAN_OPERAND, CLASS_INVALID, CLASS_DIVIDE_BY_ZERO, CLASS_INFINITE_OPERAND, CLASS_OVERFLOW,
+    CLASS_UNDERFLOW, CLASS_SUBNORMAL_OPERAND, CLASS_ZERO_OPERAND, CLASS_NORMAL, CLASS_COUNT
+};
+const char* class_names[] = {"NaN operand", "invalid", "divide by zero", "infinite operand", "overflow",
+                             "underflow", "subnormal operand", "zero operand", "normal"};
+
+int classify(int op, uint32_t a, uint32_t b) {
+    bool a_nan = (a & 0x7fffffff) > 0x7f800000, b_nan = (b & 0x7fffffff) > 0x7f800000;
+    bool a_inf = (a & 0x7fffffff) == 0x7f800000, b_inf = (b & 0x7fffffff) == 0x7f800000;
+    bool a_zero = (a & 0x7fffffff) == 0, b_zero = (b & 0x7fffffff) == 0;
+    bool a_sub = !a_zero && (a & 0x7f800000) == 0, b_sub = !b_zero && (b & 0x7f800000) == 0;
+    bool same_sign = ((a ^ b) & 0x80000000) == 0;
+    if (a_nan || b_nan) {
+        return CLASS_NAN_OPERAND;
+    }
+    if ((op == FPU_ADD && a_inf && b_inf && !same_sign) || (op == FPU_SUB && a_inf && b_inf && same_sign) ||
+        (op == FPU_MUL && ((a_inf && b_zero) || (a_zero && b_inf))) ||
+        (op == FPU_DIV && ((a_zero && b_zero) || (a_inf && b_inf)))) {
+        return CLASS_INVALID;
+    }
+    if (op == FPU_DIV && b_zero) {
+        return CLASS_DIVIDE_BY_ZERO;
+    }
+    if (a_inf || b_inf) {
+        return CLASS_INFINITE_OPERAND;
+    }
+    float a_float = fptrace::bits_float(a), b_float = fptrace::bits_float(b);
+    double exact = (op == FPU_ADD) ? double(a_float) + b_float
+                 : (op == FPU_SUB) ? double(a_float) - b_float
+                 : (op == FPU_MUL) ? double(a_float) * b_float
+                 : double(a_float) / b_float;
+    if (fabs(exact) > FLT_MAX) {
+        return CLASS_OVERFLOW;
+    }
+    if (exact != 0 && fabs(exact) < FLT_MIN) {
+        return CLASS_UNDERFLOW;
+    }
+    if (a_sub || b_sub) {
+        return CLASS_SUBNORMAL_OPERAND;
+    }
+    if (a_zero || b_zero) {
+        return CLASS_ZERO_OPERAND;
+    }
+    return CLASS_NORMAL;
+}
+
+struct TraceOp {
+    uint32_t a;
+    uint32_t b;
+    int exception_class;
+    long ready;
+};
+
+// ReplayEngine
+// Streams a trace through the four Tops. Records are dispatched in trace order
+// into per-unit queues; each unit issues one operation per period, so the units
+// run concurrently and a full queue stalls dispatch behind it.
+struct ReplayEngine {
+    addition::Top adder;
+    subtraction::Top subtractor;
+    multiplication::Top multiplier;
+    division::Top divider;
+    std::deque<TraceOp> waiting[4];
+    std::deque<TraceOp> in_flight[4];
+    long cycle;
+    long dispatch_stalls;
+    long issued[4];
+    long counts[4][CLASS_COUNT];
+    long ieee_mismatches[4][CLASS_COUNT];
+    long model_mismatches;
+
+    ReplayEngine() : adder("Adder"), subtractor("Subtractor"), multiplier("Multiplier"), divider("Divider"),
+                     cycle(0), dispatch_stalls(0), model_mismatches(0) {
+        memset(issued, 0, sizeof(issued));
+        memset(counts, 0, sizeof(counts));
+        memset(ieee_mismatches, 0, sizeof(ieee_mismatches));
+    }
+
+    void issue(int op, const TraceOp& t) {
+        switch (op) {
+        case FPU_ADD: adder.a.write(t.a); adder.b.write(t.b); break;
+        case FPU_SUB: subtractor.a.write(t.a); subtractor.b.write(t.b); break;
+        case FPU_MUL: multiplier.a.write(t.a); multiplier.b.write(t.b); break;
+        default: divider.a.write(t.a); divider.b.write(t.b); break;
+        }
+    }
+
+    uint32_t result(int op) {
+        switch (op) {
+        case FPU_ADD: return adder.normalized_result.read();
+        case FPU_SUB: return subtractor.normalized_result.read();
+        case FPU_MUL: return multiplier.normalized_result.read();
+        default: return divider.result.read();
+        }
+    }
+
+    void retire(int op, const TraceOp& t, uint32_t r) {
+        uint32_t model = (op == FPU_ADD) ? addition_function(t.a, t.b)
+                       : (op == FPU_SUB) ? subtraction_function(t.a, t.b)
+                       : (op == FPU_MUL) ? multiplication_function(t.a, t.b)
+                       : division_function(t.a, t.b);
+        float a_float = fptrace::bits_float(t.a), b_float = fptrace::bits_float(t.b);
+        float ieee = (op == FPU_ADD) ? a_float + b_float
+                   : (op == FPU_SUB) ? a_float - b_float
+                   : (op == FPU_MUL) ? a_float * b_float
+                   : a_float / b_float;
+        uint32_t ieee_bits = fptrace::float_bits(ieee);
+        bool both_nan = (r & 0x7fffffff) > 0x7f800000 && (ieee_bits & 0x7fffffff) > 0x7f800000;
+        model_mismatches += (r != model);
+        ieee_mismatches[op][t.exception_class] += (r != ieee_bits && !both_nan);
+    }
+
+    bool busy() {
+        for (int op = 0; op < 4; op++) {
+            if (!waiting[op].empty() || !in_flight[op].empty()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void run(fptrace::TraceReader& reader) {
+        fptrace::Opcode op;
+        TraceOp next;
+        bool pending = reader.next(op, next.a, next.b);
+        while (pending || busy()) {
+            // Dispatch in trace order until the next record's unit queue is full
+            while (pending && waiting[op].size() < QUEUE_DEPTH) {
+                next.exception_class = classify(op, next.a, next.b);
+                counts[op][next.exception_class]++;
+                waiting[op].push_back(next);
+                pending = reader.next(op, next.a, next.b);
+            }
+            dispatch_stalls += pending;
+
+            for (int u = 0; u < 4; u++) {
+                if (!waiting[u].empty() && cycle % issue_period[u] == 0) {
+                    TraceOp t = waiting[u].front();
+                    waiting[u].pop_front();
+                    t.ready = cycle + result_delay[u];
+                    issue(u, t);
+                    in_flight[u].push_back(t);
+                    issued[u]++;
+                }
+            }
+            sc_start(1, SC_NS);
+            for (int u = 0; u < 4; u++) {
+                if (!in_flight[u].empty() && in_flight[u].front().ready == cycle) {
+                    retire(u, in_flight[u].front(), result(u));
+                    in_flight[u].pop_front();
+                }
+            }
+            cycle++;
+        }
+    }
+};
+
+// Sample kernels standing in for an application: AXPY, a dot product, Horner
+// evaluation of exp(x), relative differences with some zero references, a decay
+// loop running into the subnormal range and a growth loop that overflows
+void record_sample_kernels(int n) {
+    using fptrace::traced_float;
+    std::vector<traced_float> x(n), y(n);
+    srand(1);
+    for (int i = 0; i < n; i++) {
+        x[i] = ldexpf(static_cast<float>(rand()) / RAND_MAX - 0.5f, rand() % 8 - 4);
+        y[i] = (i % 64 == 0) ? 0.0f : ldexpf(static_cast<float>(rand()) / RAND_MAX, rand() % 8 - 4);
+    }
+
+    std::vector<traced_float> reference = y;
+    traced_float alpha = 1.5f;
+    for (int i = 0; i < n; i++) {
+        y[i] = alpha * x[i] + y[i];
+    }
+
+    traced_float dot = 0.0f;
+    for (int i = 0; i < n; i++) {
+        dot += x[i] * y[i];
+    }
+
+    const float coefficients[] = {1.0f / 720, 1.0f / 120, 1.0f / 24, 1.0f / 6, 0.5f, 1.0f, 1.0f};
+    for (int i = 0; i < n; i++) {
+        traced_float p = coefficients[0];
+        for (int k = 1; k < 7; k++) {
+            p = p * x[i] + coefficients[k];
+        }
+        x[i] = p;
+    }
+
+    for (int i = 0; i < n; i++) {
+        x[i] = (x[i] - reference[i]) / reference[i];
+    }
+
+    for (int i = 0; i < n / 16; i++) {
+        traced_float v = y[i + 1];
+        for (int k = 0; k < 12; k++) {
+            v = v * 0.0001f;
+        }
+        traced_float w = x[i] + 4.0f;
+        for (int k = 0; k < 8; k++) {
+            w = w * w;
+        }
+        y[i] = v + w - w;
+    }
+}
+
+int sc_main(int argc, char* argv[]) {
+    std::string path;
+    int mode;
+    cout << "Enter the trace file: ";
+    cin >> path;
+    cout << "Enter 1 to record the sample kernels, 2 to replay the trace: ";
+    cin >> mode;
+
+    if (mode == 1) {
+        int n;
+        cout << "Enter the vector length: ";
+        cin >> n;
+        fptrace::TraceWriter writer;
+        if (n <= 0 || !writer.open(path.c_str())) {
+            cout << "Invalid input" << endl;
+            return 1;
+        }
+        record_sample_kernels(n);
+        if (!writer.close()) {
+            cout << "Writing the trace failed" << endl;
+            return 1;
+        }
+        cout << "Recorded " << writer.record_count() << " operations in " << writer.byte_count() << " bytes ("
+             << static_cast<double>(writer.byte_count()) / writer.record_count() << " bytes/op, 9 uncompressed)" << endl;
+        return 0;
+    }
+
+    fptrace::TraceReader reader;
+    if (mode != 2 || !reader.open(path.c_str())) {
+        cout << "Invalid input" << endl;
+        return 1;
+    }
+    ReplayEngine engine;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    engine.run(reader);
+    double host = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    long total = engine.issued[0] + engine.issued[1] + engine.issued[2] + engine.issued[3];
+    cout << "Replayed " << total << " operations in " << engine.cycle << " cycles (" << static_cast<double>(total) / engine.cycle
+         << " ops/cycle), dispatch stalled " << engine.dispatch_stalls << " cycles, host " << host * 1e3 << " ms" << endl;
+    for (int op = 0; op < 4; op++) {
+        cout << op_names[op] << ": " << engine.issued[op] << " ops, utilisation "
+             << 100.0 * engine.issued[op] * issue_period[op] / engine.cycle << "%" << endl;
+    }
+    cout << "Exception class        add      sub      mul      div   (differs from IEEE)" << endl;
+    for (int c = 0; c < CLASS_COUNT; c++) {
+        long differs = 0;
+        printf("%-18s", class_names[c]);
+        for (int op = 0; op < 4; op++) {
+            printf(" %8ld", engine.counts[op][c]);
+            differs += engine.ieee_mismatches[op][c];
+        }
+        printf("   (%ld)\n", differs);
+    }
+    cout << "Mismatches vs functional models: " << engine.model_mismatches << endl;
+    return 0;
+}
@@ -0,0 +1,710 @@
+#include <systemc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <limits.h>
+#include <bitset>
+#include <algorithm>
+#include <deque>
+#include <string>
+#include <vector>
+#include "fpu_models.h"
+#include "fpu_pipelines.h"
+
+enum Function { EXP2, LOG2, SIN, COS };
+const char* function_names[] = {"exp2", "log2", "sin", "cos"};
+enum Unit { MUL, ADD };
+
+// Compile-time tables, from series evaluated in double precision
+constexpr double const_exp(double x) {
+    double term = 1, sum = 1;
+    for (int k = 1; k < 30; k++) {
+        term *= x / k;
+        sum += term;
+    }
+    return sum;
+}
+
+// ln(y) = 2 atanh((y - 1) / (y + 1))
+constexpr double const_ln(double y) {
+    double z = (y - 1) / (y + 1), term = z, sum = 0;
+    for (int k = 1; k < 80; k += 2) {
+        sum += term / k;
+        term *= z * z;
+    }
+    return 2 * sum;
+}
+
+constexpr double const_sin(double x) {
+    double term = x, sum = 0;
+    for (int k = 1; k < 20; k++) {
+        sum += term;
+        term *= -x * x / ((2 * k) * (2 * k + 1));
+    }
+    return sum;
+}
+
+constexpr double const_cos(double x) {
+    double term = 1, sum = 0;
+    for (int k = 1; k < 20; k++) {
+        sum += term;
+        term *= -x * x / ((2 * k - 1) * (2 * k));
+    }
+    return sum;
+}
+
+constexpr double LN2 = const_ln(2.0);
+#define EXP2_BITS 6
+#define LOG2_BITS 6
+#define SINCOS_STEP 32   // sin/cos table points per radian
+#define SINCOS_HALF 26   // table covers -26..26 steps, past pi/4
+
+struct TranscendentalTables {
+    float exp2[1 << EXP2_BITS];             // 2^(j/64)
+    int log_inverse[1 << LOG2_BITS];        // 256/c, c the interval midpoint (halved for j >= 32)
+    float log_value[1 << LOG2_BITS];        // -log2(log_inverse/256)
+    float sin[2 * SINCOS_HALF + 1];         // sin(j/32)
+    float cos[2 * SINCOS_HALF + 1];         // cos(j/32)
+
+    constexpr TranscendentalTables() : exp2(), log_inverse(), log_value(), sin(), cos() {
+        for (int j = 0; j < (1 << EXP2_BITS); j++) {
+            exp2[j] = static_cast<float>(const_exp(LN2 * j / (1 << EXP2_BITS)));
+        }
+        for (int j = 0; j < (1 << LOG2_BITS); j++) {
+            double c = 1 + (j + 0.5) / (1 << LOG2_BITS);
+            c = (j >= (1 << (LOG2_BITS - 1))) ? c / 2 : c;
+            // The intervals either side of 1 use 1 itself, so that log2 stays
+            // accurate as it approaches zero
+            bool next_to_one = (j == 0 || j == (1 << LOG2_BITS) - 1);
+            log_inverse[j] = next_to_one ? 256 : static_cast<int>(256 / c + 0.5);
+            log_value[j] = static_cast<float>(-const_ln(log_inverse[j] / 256.0) / LN2);
+        }
+        for (int j = -SINCOS_HALF; j <= SINCOS_HALF; j++) {
+            sin[j + SINCOS_HALF] = static_cast<float>(const_sin(static_cast<double>(j) / SINCOS_STEP));
+            cos[j + SINCOS_HALF] = static_cast<float>(const_cos(static_cast<double>(j) / SINCOS_STEP));
+        }
+    }
+};
+
+constexpr TranscendentalTables tables;
+
+uint32_t float_bits(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, 4);
+    return bits;
+}
+
+float bits_float(uint32_t bits) {
+    float value;
+    memcpy(&value, &bits, 4);
+    return value;
+}
+
+// Signed fixed-point to float, round to nearest even; the magnitudes produced
+// by the reduction stage are always in the normal range
+uint32_t fixed_to_float(int64_t value, int fraction_bits) {
+    if (value == 0) {
+        return 0;
+    }
+    uint32_t sign = (value < 0) ? 0x80000000 : 0;
+    uint64_t m = (value < 0) ? -static_cast<uint64_t>(value) : value;
+    int msb = 63;
+    while (((m >> msb) & 1) == 0) {
+        msb--;
+    }
+    int exponent = msb - fraction_bits + 127;
+    if (msb > 23) {
+        int shift = msb - 23;
+        uint64_t rest = m & ((static_cast<uint64_t>(1) << shift) - 1), half = static_cast<uint64_t>(1) << (shift - 1);
+        m = m >> shift;
+        m += (rest > half || (rest == half && (m & 1)));
+        if (m == 0x1000000) {
+            m = m >> 1;
+            exponent++;
+        }
+    } else {
+        m = m << (23 - msb);
+    }
+    return sign | (exponent << 23) | (m & 0x7FFFFF);
+}
+
+// Datapath programs. The reduction stage fills the first slots with the reduced
+// argument, table values and coefficients; each step runs on the multiplier or
+// the adder and appends its result; the last slot goes to the output stage.
+#define INPUT_SLOTS 7
+
+struct Step {
+    int unit;
+    int a;
+    int b;
+};
+
+struct Program {
+    int inputs;
+    std::vector<Step> steps;
+};
+
+// The multiplier has no zero or underflow handling, so the reduction stage
+// never sends it a zero or tiny operand: arguments whose polynomial term is
+// below rounding bypass the datapath, and the sin/cos table point 0, where one
+// table value is zero, uses the plain polynomials.
+enum ProgramId { EXP2_TABLE, LOG2_TABLE, SINCOS_TABLE, SIN_POLY, COS_POLY };
+
+// EXP2_TABLE: 0 s, 1 T, 2..4 c1..c3.  y = T + T * s (c1 + s (c2 + s c3))
+// LOG2_TABLE: 0 r, 1 e, 2 -log2(t), 3..6 a1..a4.  y = (e - log2(t)) + r (a1 + r (a2 + r (a3 + r a4)))
+// SINCOS_TABLE: 0 s, 1 T1, 2 T2, 3..5 -1/6, 1/24, -1/2.
+//   y = T1 + (T1 (cos s - 1) + T2 sin s), sin s = s + s (s^2 / -6), cos s - 1 = s^2 (s^2 / 24 - 1/2)
+// SIN_POLY: 0 s, 1 -1/6, 2 1/120.  y = s + s (s^2 (-1/6 + s^2 / 120))
+// COS_POLY: 0 s, 1 1/24, 2 -1/2, 3 1.  y = 1 + s^2 (-1/2 + s^2 / 24)
+const Program programs[5] = {
+    {5, {{MUL, 0, 4}, {ADD, 5, 3}, {MUL, 0, 6}, {ADD, 7, 2}, {MUL, 0, 8}, {MUL, 1, 9}, {ADD, 1, 10}}},
+    {7, {{MUL, 0, 6}, {ADD, 7, 5}, {MUL, 0, 8}, {ADD, 9, 4}, {MUL, 0, 10}, {ADD, 11, 3}, {MUL, 0, 12},
+         {ADD, 1, 2}, {ADD, 14, 13}}},
+    {6, {{MUL, 0, 0}, {MUL, 6, 3}, {MUL, 0, 7}, {ADD, 0, 8}, {MUL, 6, 4}, {ADD, 10, 5}, {MUL, 6, 11},
+         {MUL, 1, 12}, {MUL, 2, 9}, {ADD, 13, 14}, {ADD, 1, 15}}},
+    {3, {{MUL, 0, 0}, {MUL, 3, 2}, {ADD, 4, 1}, {MUL, 3, 5}, {MUL, 0, 6}, {ADD, 0, 7}}},
+    {4, {{MUL, 0, 0}, {MUL, 4, 1}, {ADD, 5, 2}, {MUL, 4, 6}, {ADD, 3, 7}}},
+};
+
+struct Reduced {
+    uint32_t slots[INPUT_SLOTS];
+    int program;
+    bool bypass;              // result known at reduction, before scale and sign
+    uint32_t bypass_result;
+    int scale;                // exp2: power of two applied by the output stage
+    bool negate;              // sin/cos: quadrant and argument sign
+};
+
+// 2/pi to 256 bits, most significant word first: enough that the bits left of
+// the binary point of x * 2/pi that matter (mod 4) and 64 bits to the right of
+// it are exact for every finite float
+const uint32_t TWO_OVER_PI[8] = {0xA2F9836E, 0x4E441529, 0xFC2757D1, 0xF534DDC0,
+                                 0xDB629599, 0x3C439041, 0xFE5163AB, 0xDEBBC561};
+const int64_t PI_OVER_TWO = 0x6487ED5110B4611ALL;    // pi/2 * 2^62
+
+// Range reduction on the extracted sign, exponent and significand
+Reduced reduce(int function, uint32_t x) {
+    Reduced r;
+    memset(&r, 0, sizeof(r));
+    bool sign = (x & 0x80000000) != 0;
+    uint32_t exp = (x & 0x7F800000) >> 23, fraction = x & 0x7FFFFF;
+    uint64_t m = (exp == 0) ? fraction : (fraction | 0x800000);
+    r.bypass = true;
+
+    if (function == EXP2) {
+        if (exp == 255) {
+            r.bypass_result = (fraction != 0) ? 0x7FC00000 : sign ? 0 : 0x7F800000;
+        } else if (exp >= 135 || (!sign && exp >= 134)) {   // |x| >= 256, or x >= 128
+            r.bypass_result = sign ? 0 : 0x7F800000;
+        } else {
+            // x with 40 fraction bits: n = integer part, j = next 6 bits, s = the rest
+            int shift = int(exp ? exp : 1) - 110;
+            int64_t fixed = (shift >= 0) ? (m << shift) : (-shift >= 64) ? 0 : (m >> -shift);
+            fixed = sign ? -fixed : fixed;
+            int64_t f = fixed & ((static_cast<int64_t>(1) << 40) - 1);
+            int64_t rest = f & ((static_cast<int64_t>(1) << (40 - EXP2_BITS)) - 1);
+            r.program = EXP2_TABLE;
+            r.scale = static_cast<int>(fixed >> 40);
+            r.bypass = rest < (static_cast<int64_t>(1) << 15);   // s < 2^-25: 2^s rounds to 1
+            r.bypass_result = float_bits(tables.exp2[f >> (40 - EXP2_BITS)]);
+            r.slots[0] = fixed_to_float(rest, 40);
+            r.slots[1] = r.bypass_result;
+            r.slots[2] = float_bits(static_cast<float>(LN2));
+            r.slots[3] = float_bits(static_cast<float>(LN2 * LN2 / 2));
+            r.slots[4] = float_bits(static_cast<float>(LN2 * LN2 * LN2 / 6));
+        }
+        return r;
+    }
+
+    if (function == LOG2) {
+        if (exp == 255 && (fraction != 0 || !sign)) {
+            r.bypass_result = (fraction != 0) ? 0x7FC00000 : 0x7F800000;
+        } else if (m == 0) {
+            r.bypass_result = 0xFF800000;
+        } else if (sign || exp == 255) {
+            r.bypass_result = 0x7FC00000;
+        } else {
+            // x = 2^e m, m in [1, 2); from m >= 1.5 on, fold to m / 2 in [0.75, 1) and
+            // e + 1, then r = m t / 256 - 1 exactly in fixed point
+            int e = int(exp ? exp : 1) - 127;
+            while ((m & 0x800000) == 0) {
+                m = m << 1;
+                e--;
+            }
+            int j = (m >> (23 - LOG2_BITS)) & ((1 << LOG2_BITS) - 1);
+            bool folded = j >= (1 << (LOG2_BITS - 1));
+            int64_t product = static_cast<int64_t>(m) * tables.log_inverse[j];
+            int64_t reduced = product - (static_cast<int64_t>(1) << (folded ? 32 : 31));
+            r.program = LOG2_TABLE;
+            r.bypass = (reduced == 0);   // powers of two
+            r.bypass_result = fixed_to_float(e, 0);
+            r.slots[0] = fixed_to_float(reduced, folded ? 32 : 31);
+            r.slots[1] = fixed_to_float(e + folded, 0);
+            r.slots[2] = float_bits(tables.log_value[j]);
+            for (int k = 1; k <= 4; k++) {
+                r.slots[2 + k] = float_bits(static_cast<float>(((k & 1) ? 1 : -1) / (k * LN2)));
+            }
+        }
+        return r;
+    }
+
+    // sin / cos
+    if (exp == 255) {
+        r.bypass_result = 0x7FC00000;
+        return r;
+    }
+    if (exp < 115) {   // |x| < 2^-12: sin x rounds to x, cos x to 1
+        r.bypass_result = (function == SIN) ? x : 0x3F800000;
+        return r;
+    }
+    // |x| = k pi/2 + R, R in [-pi/4, pi/4] with 62 fraction bits; below 0.5 k is 0
+    int64_t reduced;
+    int k = 0;
+    if (exp < 126) {
+        reduced = m << (exp - 88);
+    } else {
+        // m * 2/pi as nine 32-bit words, least significant first; the binary
+        // point of x * 2/pi sits 256 - (exp - 150) bits up
+        uint32_t product[9];
+        uint64_t carry = 0;
+        for (int w = 0; w < 8; w++) {
+            carry += m * TWO_OVER_PI[7 - w];
+            product[w] = static_cast<uint32_t>(carry);
+            carry >>= 32;
+        }
+        product[8] = static_cast<uint32_t>(carry);
+        int point = 406 - int(exp);
+        uint64_t window = 0;   // two integer bits and 62 fraction bits
+        for (int bit = point + 1; bit >= point - 62; bit--) {
+            window = (window << 1) | ((bit < 288) ? (product[bit / 32] >> (bit % 32)) & 1 : 0);
+        }
+        k = static_cast<int>(window >> 62);
+        int64_t f62 = window & ((static_cast<uint64_t>(1) << 62) - 1);
+        if (f62 >= (static_cast<int64_t>(1) << 61)) {
+            k = (k + 1) & 3;
+            f62 -= static_cast<int64_t>(1) << 62;
+        }
+        reduced = static_cast<int64_t>((static_cast<__int128>(f62) * PI_OVER_TWO) >> 62);
+    }
+    int64_t one_step = static_cast<int64_t>(1) << 57;   // 2^62 / 32
+    int j = static_cast<int>((reduced + one_step / 2) >> 57);
+    int quadrant = (k + (function == COS)) & 3;
+    int64_t rest = reduced - j * one_step;
+    float t_sin = tables.sin[j + SINCOS_HALF], t_cos = tables.cos[j + SINCOS_HALF];
+    r.negate = ((quadrant & 2) != 0) != (function == SIN && sign);
+    r.slots[0] = fixed_to_float(rest, 62);
+    if (j == 0) {
+        // sin s rounds to s and cos s to 1 below 2^-12
+        r.program = (quadrant & 1) ? COS_POLY : SIN_POLY;
+        r.bypass = (rest < 0 ? -rest : rest) < (static_cast<int64_t>(1) << 50);
+        r.bypass_result = (quadrant & 1) ? 0x3F800000 : r.slots[0];
+        r.slots[1] = float_bits((quadrant & 1) ? 1.0f / 24 : -1.0f / 6);
+        r.slots[2] = float_bits((quadrant & 1) ? -0.5f : 1.0f / 120);
+        r.slots[3] = 0x3F800000;
+        return r;
+    }
+    // Below 2^-32 the correction to T1 is under a quarter of its last place
+    r.program = SINCOS_TABLE;
+    r.bypass = (rest < 0 ? -rest : rest) < (static_cast<int64_t>(1) << 30);
+    r.bypass_result = float_bits((quadrant & 1) ? t_cos : t_sin);
+    r.slots[1] = r.bypass_result;
+    r.slots[2] = float_bits((quadrant & 1) ? -t_sin : t_cos);
+    r.slots[3] = float_bits(-1.0f / 6);
+    r.slots[4] = float_bits(1.0f / 24);
+    r.slots[5] = float_bits(-0.5f);
+    return r;
+}
+
+// Output stage: exponent adjust by 2^scale, rounding to nearest even when the
+// result becomes subnormal, and the sin/cos sign
+uint32_t finish(int function, const Reduced& r, uint32_t y) {
+    y = r.bypass ? r.bypass_result : y;
+    if (function == SIN || function == COS) {
+        return r.negate ? (y ^ 0x80000000) : y;
+    }
+    if (function == LOG2 || r.scale == 0 || (y & 0x7FFFFFFF) == 0 || (y & 0x7F800000) == 0x7F800000) {
+        return y;
+    }
+    int exponent = int((y >> 23) & 0xFF) + r.scale;
+    if (exponent >= 255) {
+        return 0x7F800000;
+    }
+    if (exponent >= 1) {
+        return (y & 0x807FFFFF) | (exponent << 23);
+    }
+    int shift = 1 - exponent;
+    if (shift > 25) {
+        return 0;
+    }
+    uint32_t m = (y & 0x7FFFFF) | 0x800000, rest = m & ((1u << shift) - 1), half = 1u << (shift - 1);
+    m = m >> shift;
+    return m + (rest > half || (rest == half && (m & 1)));
+}
+
+uint32_t transcendental_function(int function, uint32_t x) {
+    Reduced r = reduce(function, x);
+    if (r.bypass) {
+        return finish(function, r, 0);
+    }
+    const Program& p = programs[r.program];
+    std::vector<uint32_t> slots(r.slots, r.slots + p.inputs);
+    for (size_t s = 0; s < p.steps.size(); s++) {
+        const Step& step = p.steps[s];
+        uint32_t a = slots[step.a], b = slots[step.b];
+        slots.push_back(step.unit == MUL ? multiplication_function(a, b) : addition_function(a, b));
+    }
+    return finish(function, r, slots.back());
+}
+
+// ReductionStage Module: range reduction and table reads in one cycle
+SC_MODULE(ReductionStage) {
+    sc_in<sc_uint<32>> a;
+    sc_in<sc_uint<2>> function;
+    sc_out<sc_uint<32>> slots[INPUT_SLOTS];
+    sc_out<sc_uint<3>> program;
+    sc_out<bool> bypass;
+    sc_out<sc_uint<32>> bypass_result;
+    sc_out<sc_int<16>> scale;
+    sc_out<bool> negate;
+    sc_in<bool> clock;
+
+    void reduction_process() {
+        while (true) {
+            wait();
+            Reduced r = reduce(function.read(), a.read());
+            for (int s = 0; s < INPUT_SLOTS; s++) {
+                slots[s].write(r.slots[s]);
+            }
+            program.write(r.program);
+            bypass.write(r.bypass);
+            bypass_result.write(r.bypass_result);
+            scale.write(r.scale);
+            negate.write(r.negate);
+        }
+    }
+
+    SC_CTOR(ReductionStage) {
+        SC_THREAD(reduction_process);
+        sensitive << clock.pos();
+    }
+};
+
+// OutputStage Module: applies the scale and sign carried alongside the datapath result
+SC_MODULE(OutputStage) {
+    sc_in<sc_uint<32>> y;
+    sc_in<sc_uint<2>> function;
+    sc_in<bool> bypass;
+    sc_in<sc_uint<32>> bypass_result;
+    sc_in<sc_int<16>> scale;
+    sc_in<bool> negate;
+    sc_out<sc_uint<32>> result;
+    sc_in<bool> clock;
+
+    void output_process() {
+        while (true) {
+            wait();
+            Reduced r;
+            r.bypass = bypass.read();
+            r.bypass_result = bypass_result.read();
+            r.scale = scale.read();
+            r.negate = negate.read();
+            result.write(finish(function.read(), r, y.read()));
+        }
+    }
+
+    SC_CTOR(OutputStage) {
+        SC_THREAD(output_process);
+        sensitive << clock.pos();
+    }
+};
+
+struct Element {
+    int function;
+    Reduced reduced;
+    long reduced_at;               // cycle from which the input slots are readable
+    std::vector<uint32_t> slots;
+    std::vector<long> ready;       // cycle from which each slot may issue
+    std::vector<char> issued;
+};
+
+struct InFlight {
+    long element;
+    int slot;
+    int pipe;
+    long done;
+};
+
+#define WINDOW 64
+
+// TranscendentalEngine
+// Streams arguments through the reduction stage, a pool of multiplier and adder
+// Tops and the output stage. Each cycle every pipeline takes the oldest ready
+// step in a window of WINDOW elements; results leave the output stage in order.
+struct TranscendentalEngine {
+    ReductionStage reduction;
+    OutputStage output;
+    std::vector<multiplication::Top*> multipliers;
+    std::vector<addition::Top*> adders;
+    sc_signal<sc_uint<32>> a, reduced_slots[INPUT_SLOTS], y, bypass_result_in, bypass_result_out, result;
+    sc_signal<sc_uint<2>> function_in, function_out;
+    sc_signal<sc_uint<3>> program_in;
+    sc_signal<bool> bypass_in, bypass_out, negate_in, negate_out;
+    sc_signal<sc_int<16>> scale_in, scale_out;
+    sc_clock clock;
+    long cycle;
+
+    TranscendentalEngine(int pipes) : reduction("Reduction"), output("Output"), clock("clock", 1, SC_NS), cycle(0) {
+        reduction.a(a);
+        reduction.function(function_in);
+        for (int s = 0; s < INPUT_SLOTS; s++) {
+            reduction.slots[s](reduced_slots[s]);
+        }
+        reduction.program(program_in);
+        reduction.bypass(bypass_in);
+        reduction.bypass_result(bypass_result_in);
+        reduction.scale(scale_in);
+        reduction.negate(negate_in);
+        reduction.clock(clock);
+
+        output.y(y);
+        output.function(function_out);
+        output.bypass(bypass_out);
+        output.bypass_result(bypass_result_out);
+        output.scale(scale_out);
+        output.negate(negate_out);
+        output.result(result);
+        output.clock(clock);
+
+        for (int p = 0; p < pipes; p++) {
+            multipliers.push_back(new multiplication::Top(("Multiplier" + std::to_string(p)).c_str()));
+            adders.push_back(new addition::Top(("Adder" + std::to_string(p)).c_str()));
+        }
+    }
+
+    void start_unit(int unit, int pipe, uint32_t x, uint32_t z) {
+        if (unit == MUL) {
+            multipliers[pipe]->a.write(x);
+            multipliers[pipe]->b.write(z);
+        } else {
+            adders[pipe]->a.write(x);
+            adders[pipe]->b.write(z);
+        }
+    }
+
+    uint32_t unit_result(int unit, int pipe) {
+        return (unit == MUL) ? multipliers[pipe]->normalized_result.read() : adders[pipe]->normalized_result.read();
+    }
+
+    // Runs the arguments and returns the number of cycles taken
+    long run(const std::vector<int>& functions, const std::vector<uint32_t>& args, std::vector<uint32_t>& results) {
+        long n = args.size(), next = 0, oldest = 0, start = cycle, reducing = -1, finishing = -1;
+        int pipes = multipliers.size();
+        std::vector<Element> elements(n);
+        std::deque<InFlight> in_flight[2];
+        while (oldest < n) {
+            // Reduction stage
+            reducing = -1;
+            if (next < n && next - oldest < WINDOW) {
+                a.write(args[next]);
+                function_in.write(functions[next]);
+                reducing = next++;
+            }
+
+            // Datapath issue: oldest element first, steps in program order
+            for (int unit = 0; unit < 2; unit++) {
+                for (int pipe = 0; pipe < pipes; pipe++) {
+                    bool issued = false;
+                    for (long e = oldest; e < next && !issued; e++) {
+                        Element& el = elements[e];
+                        if (el.slots.empty() || el.reduced_at > cycle) {
+                            continue;
+                        }
+                        const Program& p = programs[el.reduced.program];
+                        for (size_t s = 0; s < p.steps.size() && !issued; s++) {
+                            const Step& step = p.steps[s];
+                            if (step.unit != unit || el.issued[s] || el.ready[step.a] > cycle || el.ready[step.b] > cycle) {
+                                continue;
+                            }
+                            start_unit(unit, pipe, el.slots[step.a], el.slots[step.b]);
+                            el.issued[s] = 1;
+                            in_flight[unit].push_back({e, p.inputs + static_cast<int>(s), pipe, cycle + 2});
+                            issued = true;
+                        }
+                    }
+                }
+            }
+
+            // Output stage, in order
+            finishing = -1;
+            if (oldest < next && !elements[oldest].slots.empty() && elements[oldest].reduced_at <= cycle) {
+                Element& el = elements[oldest];
+                if (el.reduced.bypass || el.ready.back() <= cycle) {
+                    y.write(el.slots.back());
+                    function_out.write(el.function);
+                    bypass_out.write(el.reduced.bypass);
+                    bypass_result_out.write(el.reduced.bypass_result);
+                    scale_out.write(el.reduced.scale);
+                    negate_out.write(el.reduced.negate);
+                    finishing = oldest;
+                }
+            }
+
+            sc_start(1, SC_NS);
+
+            if (reducing >= 0) {
+                Element& el = elements[reducing];
+                el.function = functions[reducing];
+                el.reduced.program = program_in.read();
+                const Program& p = programs[el.reduced.program];
+                el.reduced.bypass = bypass_in.read();
+                el.reduced.bypass_result = bypass_result_in.read();
+                el.reduced.scale = scale_in.read();
+                el.reduced.negate = negate_in.read();
+                el.reduced_at = cycle + 1;
+                for (int s = 0; s < p.inputs; s++) {
+                    el.slots.push_back(reduced_slots[s].read());
+                }
+                el.slots.resize(p.inputs + p.steps.size());
+                el.ready.assign(p.inputs + p.steps.size(), cycle + 1);
+                for (size_t s = p.inputs; s < el.ready.size(); s++) {
+                    el.ready[s] = LONG_MAX;
+                }
+                el.issued.assign(p.steps.size(), el.reduced.bypass);
+            }
+            for (int unit = 0; unit < 2; unit++) {
+                while (!in_flight[unit].empty() && in_flight[unit].front().done == cycle) {
+                    InFlight f = in_flight[unit].front();
+                    in_flight[unit].pop_front();
+                    Element& el = elements[f.element];
+                    el.slots[f.slot] = unit_result(unit, f.pipe);
+                    el.ready[f.slot] = cycle + 1;
+                }
+            }
+            if (finishing >= 0) {
+                results[finishing] = result.read();
+                oldest++;
+            }
+            cycle++;
+        }
+        return cycle - start;
+    }
+};
+
+// Reference: the double-precision function rounded to float
+uint32_t reference(int function, uint32_t x) {
+    double value = bits_float(x);
+    double r = (function == EXP2) ? exp2(value) : (function == LOG2) ? log2(value) : (function == SIN) ? sin(value) : cos(value);
+    return float_bits(static_cast<float>(r));
+}
+
+bool is_nan(uint32_t x) {
+    return (x & 0x7FFFFFFF) > 0x7F800000;
+}
+
+long ulp_distance(uint32_t x, uint32_t y) {
+    if (is_nan(x) || is_nan(y)) {
+        return (is_nan(x) && is_nan(y)) ? 0 : LONG_MAX;
+    }
+    long a = (x & 0x80000000) ? -static_cast<long>(x & 0x7FFFFFFF) : static_cast<long>(x);
+    long b = (y & 0x80000000) ? -static_cast<long>(y & 0x7FFFFFFF) : static_cast<long>(y);
+    return labs(a - b);
+}
+
+struct Domain {
+    int function;
+    const char* name;
+    float low;
+    float high;
+    bool logarithmic;   // uniform in the exponent rather than the value
+};
+
+const Domain domains[] = {
+    {EXP2, "[-1, 1]", -1.0f, 1.0f, false},
+    {EXP2, "[-150, 128)", -150.0f, 127.99f, false},
+    {LOG2, "[0.5, 2]", 0.5f, 2.0f, false},
+    {LOG2, "all positive", 1e-45f, 3.4e38f, true},
+    {SIN, "[-pi, pi]", -3.1415927f, 3.1415927f, false},
+    {SIN, "|x| < 2^16", -65536.0f, 65536.0f, false},
+    {SIN, "all positive", 1e-45f, 3.4e38f, true},
+    {COS, "[-pi, pi]", -3.1415927f, 3.1415927f, false},
+    {COS, "|x| < 2^16", -65536.0f, 65536.0f, false},
+    {COS, "all positive", 1e-45f, 3.4e38f, true},
+};
+
+uint32_t random_argument(const Domain& d) {
+    if (d.logarithmic) {
+        double exponent = log2(d.low) + (log2(d.high) - log2(d.low)) * rand() / RAND_MAX;
+        return float_bits(static_cast<float>(exp2(exponent)));
+    }
+    return float_bits(d.low + (d.high - d.low) * static_cast<float>(rand()) / RAND_MAX);
+}
+
+int sc_main(int argc, char* argv[]) {
+    long n;
+    int pipes;
+    cout << "Enter the number of arguments per function: ";
+    cin >> n;
+    cout << "Enter the number of multiplier and adder pipelines: ";
+    cin >> pipes;
+    if (n <= 0 || pipes <= 0) {
+        cout << "Invalid input" << endl;
+        return 1;
+    }
+
+    // Error bounds on the functional model
+    cout << "Function  domain          max ULP   mean ULP   (vs correctly rounded, 10^6 arguments)" << endl;
+    srand(1);
+    for (size_t d = 0; d < sizeof(domains) / sizeof(domains[0]); d++) {
+        long max_ulp = 0;
+        double total = 0;
+        const long count = 1000000;
+        for (long i = 0; i < count; i++) {
+            uint32_t x = random_argument(domains[d]);
+            long ulp = ulp_distance(transcendental_function(domains[d].function, x), reference(domains[d].function, x));
+            max_ulp = std::max(max_ulp, ulp);
+            total += ulp;
+        }
+        printf("%-9s %-15s %7ld %10.3f\n", function_names[domains[d].function], domains[d].name, max_ulp, total / count);
+    }
+    long special_mismatches = 0;
+    const float specials[] = {0.0f, -0.0f, 1.0f, -1.0f, INFINITY, -INFINITY, NAN, 1e-40f, 1e-10f, -1e-10f, 128.0f, -150.0f, 1e30f};
+    for (int f = 0; f < 4; f++) {
+        for (size_t i = 0; i < sizeof(specials) / sizeof(specials[0]); i++) {
+            uint32_t x = float_bits(specials[i]);
+            special_mismatches += ulp_distance(transcendental_function(f, x), reference(f, x)) > 2;
+        }
+    }
+    cout << "Special and edge arguments off by more than 2 ULP: " << special_mismatches << endl << endl;
+
+    // Pin-level throughput and latency
+    TranscendentalEngine engine(pipes);
+    const int table_program[4] = {EXP2_TABLE, LOG2_TABLE, SINCOS_TABLE, SINCOS_TABLE};
+    const int stream_domain[4] = {1, 3, 5, 8};   // the wide-range domain of each function
+    cout << "Function  mul/add steps   latency   cycles   results/cycle   mismatches vs functional model" << endl;
+    for (int f = 0; f < 4; f++) {
+        std::vector<int> functions(n, f);
+        std::vector<uint32_t> args(n), results(n), single(1);
+        for (long i = 0; i < n; i++) {
+            args[i] = random_argument(domains[stream_domain[f]]);
+        }
+        // Latency of one argument on the table path
+        long first = 0;
+        while (reduce(f, args[first]).bypass || reduce(f, args[first]).program != table_program[f]) {
+            first++;
+        }
+        long latency = engine.run(std::vector<int>(1, f), std::vector<uint32_t>(1, args[first]), single);
+        long cycles = engine.run(functions, args, results);
+        long mismatches = 0, muls = 0;
+        for (long i = 0; i < n; i++) {
+            mismatches += results[i] != transcendental_function(f, args[i]);
+        }
+        const Program& p = programs[table_program[f]];
+        for (size_t s = 0; s < p.steps.size(); s++) {
+            muls += p.steps[s].unit == MUL;
+        }
+        printf("%-9s %5ld/%-9ld %7ld %8ld %15.3f %10ld\n", function_names[f], muls, p.steps.size() - muls, latency,
+               cycles, static_cast<double>(n) / cycles, mismatches);
+    }
+    return 0;
+}
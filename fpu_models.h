@@ -0,0 +1,346 @@
+#ifndef FPU_MODELS_H
+#define FPU_MODELS_H
+
+// Bit-exact functional models of the pin-level pipelines. Each function follows the
+// extractor, operation and normaliser processes of its Final file step by step,
+// including their special-case encodings, so results match the signal-level Tops.
+// The Final files that check a pipeline against its model include this header
+// rather than carrying their own copy.
+
+#include <stdint.h>
+
+// FloatingPointNormaliser::normal_process (Addition Final and Subtract Final)
+inline unsigned int normaliser_function(bool ans_sign, unsigned int ans_exp, unsigned int ans_significand) {
+    /* Normalization */
+    int i;
+    for (i = 31; i > 0 && ((ans_significand >> i) == 0); i--) {;}
+
+    if (i > 23) {
+        //Rounding
+        unsigned int twentyfourth = ((ans_significand & (1 << (i - 23 - 1))) >> (i - 23 - 1));
+        unsigned int twentyfifth = ((ans_significand & ((1u << (i - 23 - 1)) - 1)) != 0);
+
+        if ((int(ans_exp) + (i - 23) - 7) > 0 && (int(ans_exp) + (i - 23) - 7) < 255) {
+            ans_significand = (ans_significand >> (i - 23));
+            ans_exp = ans_exp + (i - 23) - 7;
+            if (twentyfourth == 1 && twentyfifth == 1) {
+                ans_significand += 1;
+            } else if ((ans_significand & 1) == 1 && twentyfourth == 1 && twentyfifth == 0) {
+                ans_significand += 1;
+            }
+            if ((ans_significand >> 24) == 1) {
+                ans_significand = (ans_significand >> 1);
+                ans_exp += 1;
+            }
+        }
+        //Overflow
+        else if (int(ans_exp) + (i - 23) - 7 >= 255) {
+            ans_significand = (1 << 23);
+            ans_exp = 255;
+        }
+    }
+    // Cancellation: shift the exact remaining bits up to the hidden-bit position
+    else if (i > 0) {
+        int shifted_exp = int(ans_exp) + (i - 23) - 7;
+        ans_significand = ans_significand << (23 - i);
+        if (shifted_exp > 0) {
+            ans_exp = shifted_exp;
+        } else {
+            ans_significand = (1 - shifted_exp > 24) ? 0 : (ans_significand >> (1 - shifted_exp));
+            ans_exp = 0;
+        }
+    }
+
+    //When answer is zero
+    if (i == 0 && ans_exp < 255) {
+        ans_exp = 0;
+    }
+    return (ans_sign << 31) | (ans_exp << 23) | (ans_significand & (0x7FFFFF));
+}
+
+// Addition Final: FloatingPointExtractor -> FloatingPointAdder -> FloatingPointNormaliser
+inline unsigned int addition_function(unsigned int a, unsigned int b) {
+    //Extraction
+    bool a_sign0 = (a & 0x80000000) >> 31;
+    unsigned int a_exp0 = (a & 0x7f800000) >> 23;
+    unsigned int a_significand0 = (a & 0x7fffff);
+    bool b_sign0 = (b & 0x80000000) >> 31;
+    unsigned int b_exp0 = (b & 0x7f800000) >> 23;
+    unsigned int b_significand0 = (b & 0x7fffff);
+
+    bool a_sign, b_sign;
+    unsigned int a_exp, b_exp, a_significand, b_significand;
+    //Special Cases
+    if ((a_exp0 == 255 && a_significand0 != 0) || (b_exp0 == 255 && b_significand0 != 0) ||
+        (a_exp0 == 255 && a_significand0 == 0 && b_exp0 == 255 && b_significand0 == 0 && a_sign0 != b_sign0)) {
+        a_sign = true; a_exp = 0x7F; a_significand = 0x7fffffff;
+        b_sign = true; b_exp = 0x7F; b_significand = 0x7fffffff;
+    } else if (a_exp0 == 255 && a_significand0 == 0) {
+        a_sign = a_sign0; a_exp = a_exp0; a_significand = a_significand0;
+        b_sign = true; b_exp = 0x7F; b_significand = 0x7fffffff;
+    } else if (b_exp0 == 255 && b_significand0 == 0) {
+        a_sign = true; a_exp = 0x7F; a_significand = 0x7fffffff;
+        b_sign = b_sign0; b_exp = b_exp0; b_significand = b_significand0;
+    } else {
+        a_sign = a_sign0;
+        a_exp = (a_exp0 == 0) ? 1 : a_exp0;
+        a_significand = ((a_exp0 >= 1) ? (a_significand0 | (1 << 23)) : a_significand0) << 7;
+        b_sign = b_sign0;
+        b_exp = (b_exp0 == 0) ? 1 : b_exp0;
+        b_significand = ((b_exp0 >= 1) ? (b_significand0 | (1 << 23)) : b_significand0) << 7;
+    }
+
+    //Exponent Shifting
+    unsigned int ans_exp;
+    unsigned int ans_significand;
+    bool ans_sign;
+    unsigned int a_significand3 = a_significand;
+    unsigned int b_significand3 = b_significand;
+    if (a_exp >= b_exp) {
+        unsigned int shift = a_exp - b_exp;
+        b_significand3 = (b_significand >> ((shift > 31) ? 31 : shift));
+        ans_exp = a_exp;
+    } else {
+        unsigned int shift = b_exp - a_exp;
+        a_significand3 = (a_significand >> ((shift > 31) ? 31 : shift));
+        ans_exp = b_exp;
+    }
+    //Significand shifting and adding
+    if (a_sign == b_sign) {
+        ans_significand = a_significand3 + b_significand3;
+        ans_sign = a_sign;
+    } else if (a_significand3 > b_significand3) {
+        ans_sign = a_sign;
+        ans_significand = a_significand3 - b_significand3;
+    } else if (a_significand3 < b_significand3) {
+        ans_sign = b_sign;
+        ans_significand = b_significand3 - a_significand3;
+    } else {
+        ans_sign = false;
+        ans_significand = 0;
+    }
+
+    return normaliser_function(ans_sign, ans_exp, ans_significand);
+}
+
+// Subtract Final: FloatingPointExtractor -> FloatingPointSubtractor -> FloatingPointNormaliser
+inline unsigned int subtraction_function(unsigned int a, unsigned int b) {
+    //Extraction
+    bool a_sign0 = (a & 0x80000000) >> 31;
+    unsigned int a_exp0 = (a & 0x7F800000) >> 23;
+    unsigned int a_significand0 = (a & 0x7FFFFF);
+    bool b_sign0 = (b & 0x80000000) >> 31;
+    unsigned int b_exp0 = (b & 0x7F800000) >> 23;
+    unsigned int b_significand0 = (b & 0x7FFFFF);
+
+    bool a_sign, b_sign;
+    unsigned int a_exp, b_exp, a_significand, b_significand;
+    //Special Cases
+    if ((a_exp0 == 255 && a_significand0 != 0) || (b_exp0 == 255 && b_significand0 != 0) ||
+        (a_exp0 == 255 && a_significand0 == 0 && b_exp0 == 255 && b_significand0 == 0 && a_sign0 != b_sign0)) {
+        a_sign = true; a_exp = 0x7F; a_significand = 0x7fffffff;
+        b_sign = true; b_exp = 0x7F; b_significand = 0x7fffffff;
+    } else if (a_exp0 == 255 && a_significand0 == 0) {
+        a_sign = a_sign0; a_exp = 0x7F; a_significand = 0x7fffffff;
+        b_sign = true; b_exp = 0x7F; b_significand = 0x7fffffff;
+    } else if (b_exp0 == 255 && b_significand0 == 0) {
+        a_sign = true; a_exp = 0x7F; a_significand = 0x7fffffff;
+        b_sign = b_sign0; b_exp = 0x7F; b_significand = 0x7fffffff;
+    } else {
+        a_sign = a_sign0;
+        a_exp = (a_exp0 == 0) ? 1 : a_exp0;
+        a_significand = ((a_exp0 >= 1) ? (a_significand0 | (1 << 23)) : a_significand0) << 7;
+        b_sign = b_sign0;
+        b_exp = (b_exp0 == 0) ? 1 : b_exp0;
+        b_significand = ((b_exp0 >= 1) ? (b_significand0 | (1 << 23)) : b_significand0) << 7;
+    }
+
+    //Exponent shifting
+    unsigned int ans_exp;
+    unsigned int ans_significand;
+    bool ans_sign;
+    unsigned int a_significand3 = a_significand;
+    unsigned int b_significand3 = b_significand;
+    if (a_exp >= b_exp) {
+        unsigned int shift = a_exp - b_exp;
+        b_significand3 = (b_significand >> ((shift > 31) ? 31 : shift));
+        ans_exp = a_exp;
+    } else {
+        unsigned int shift = b_exp - a_exp;
+        a_significand3 = (a_significand >> ((shift > 31) ? 31 : shift));
+        ans_exp = b_exp;
+    }
+    //Significand shifting and adding and sign change of second input
+    if (a_sign != b_sign) {
+        ans_significand = a_significand3 + b_significand3;
+        ans_sign = a_sign;
+    } else if (a_significand3 >= b_significand3) {
+        ans_sign = a_sign;
+        ans_significand = a_significand3 - b_significand3;
+    } else {
+        ans_sign = !a_sign;
+        ans_significand = b_significand3 - a_significand3;
+    }
+
+    return normaliser_function(ans_sign, ans_exp, ans_significand);
+}
+
+// Multiplication Final: FloatingPointExtractor -> FloatingPointMultiplier -> FloatingPointNormalizer
+// The pin-level normaliser tests rounding flags it never assigns; this model takes
+// them as clear, i.e. the significand is truncated.
+inline unsigned int multiplication_function(unsigned int a, unsigned int b) {
+    //Extraction
+    bool a_sign0 = (a & 0x80000000) >> 31;
+    unsigned int a_exp0 = (a & 0x7f800000) >> 23;
+    unsigned int a_significand0 = (a & 0x7fffff);
+    bool b_sign0 = (b & 0x80000000) >> 31;
+    unsigned int b_exp0 = (b & 0x7f800000) >> 23;
+    unsigned int b_significand0 = (b & 0x7fffff);
+
+    bool aSign, bSign;
+    unsigned int aExponent, bExponent, aSignificand, bSignificand;
+    // Special cases
+    if ((a_exp0 == 255 && a_significand0 != 0) || (b_exp0 == 255 && b_significand0 != 0) ||
+        (a_exp0 == 255 && a_significand0 == 0 && b_exp0 == 255 && b_significand0 == 0 && a_sign0 != b_sign0)) {
+        aSign = true; aExponent = 255; aSignificand = 0x7fffffff;
+        bSign = true; bExponent = 255; bSignificand = 0x7fffffff;
+    } else if (a_exp0 == 255 && a_significand0 == 0) {
+        aSign = a_sign0; aExponent = 255; aSignificand = 0x7fffffff;
+        bSign = true; bExponent = 255; bSignificand = 0x7fffffff;
+    } else if (b_exp0 == 255 && b_significand0 == 0) {
+        aSign = true; aExponent = 255; aSignificand = 0x7fffffff;
+        bSign = b_sign0; bExponent = 255; bSignificand = 0x7fffffff;
+    } else {
+        aSign = a_sign0; aExponent = a_exp0; aSignificand = a_significand0;
+        bSign = b_sign0; bExponent = b_exp0; bSignificand = b_significand0;
+    }
+
+    // compute sign bit and exponent
+    bool resultSign = aSign ^ bSign;
+    unsigned int resultExponent = (aExponent + bExponent - 0x7F) & 0xFF;
+
+    // add implicit `1' bit
+    aSignificand = (aSignificand | 0x00800000) << 7;
+    bSignificand = (bSignificand | 0x00800000) << 8;
+    uint64_t resultSignificand = static_cast<uint64_t>(aSignificand) * static_cast<uint64_t>(bSignificand);
+    unsigned int resultSignificand0 = static_cast<uint32_t>(resultSignificand >> 32);
+    unsigned int resultSignificand1 = static_cast<uint32_t>(resultSignificand & 0xFFFFFFFF);
+
+    // check if we overflowed into more than 23-bits and handle accordingly
+    resultSignificand0 |= (resultSignificand1 != 0);
+    if (0 <= static_cast<int32_t>(resultSignificand0 << 1)) {
+        resultSignificand0 <<= 1;
+        resultExponent--;
+    }
+    return (resultSign << 31) | ((resultExponent << 23) + (resultSignificand0 >> 7));
+}
+
+// Rounding tail shared by Division Final's ComputeModule and Div Sqrt Final's
+// DivSqrtModule: r holds the 25 result bits, the 24-bit significand followed by
+// the round bit, and sticky whether the recurrence left a nonzero remainder
+inline uint32_t recurrence_round(uint32_t r, uint32_t result_exp, uint8_t sticky) {
+    uint8_t odd, rnd;
+
+    if ((result_exp >= 1) && (result_exp <= 254)) { // normal, may overflow to infinity
+        rnd = r & 1;
+        odd = (r & 0x2) != 0;
+        r = (r >> 1) + (rnd & (sticky | odd));
+        r = (result_exp << 23) + (r - 0x00800000);
+    } else if (result_exp > 254) { // overflow: infinity
+        r = 0x7F800000;
+    } else { // underflow: result is zero, subnormal, or smallest normal
+        uint8_t shift = (uint8_t)(1 - result_exp);
+        if (shift > 25) shift = 25;
+        sticky = sticky | ((r & ((1u << shift) - 1)) != 0);
+        r = r >> shift;
+        rnd = r & 1;
+        odd = (r & 0x2) != 0;
+        r = (r >> 1) + (rnd & (sticky | odd));
+    }
+    return r;
+}
+
+// Division Final: ExtractModule -> ComputeModule
+inline unsigned int division_function(unsigned int a, unsigned int b) {
+    // Extract biased exponents, sign and significands
+    uint32_t a_exp = (a & 0x7F800000) >> 23;
+    uint32_t b_exp = (b & 0x7F800000) >> 23;
+    bool a_sign = (a & 0x80000000) != 0;
+    uint32_t x_val = (a & 0x007FFFFF) | 0x00800000;
+    uint32_t y_val = (b & 0x007FFFFF) | 0x00800000;
+
+    uint32_t r, result_exp;
+    uint8_t i;
+
+    // Compute exponent of result
+    result_exp = a_exp - b_exp + 127;
+
+    // Dividend may not be smaller than divisor: normalize
+    if (x_val < y_val) {
+        x_val = x_val << 1;
+        result_exp--;
+    }
+
+    // Generate quotient one bit at a time
+    r = 0;
+    for (i = 0; i < 25; i++) {
+        r = r << 1;
+        if (x_val >= y_val) {
+            x_val = x_val - y_val;
+            r = r | 1;
+        }
+        x_val = x_val << 1;
+    }
+
+    r = recurrence_round(r, result_exp, x_val != 0);
+
+    // Combine sign bit with combo of exponent and significand
+    return r | (a_sign ? 0x80000000 : 0);
+}
+
+
+// Div Sqrt Final: ExtractModule -> DivSqrtModule with the square root selected
+inline unsigned int sqrt_function(unsigned int a) {
+    uint32_t a_exp = (a & 0x7F800000) >> 23;
+    uint32_t a_fraction = a & 0x007FFFFF;
+    bool a_sign = (a & 0x80000000) != 0;
+    uint32_t r;
+
+    // Zero, infinity, NaN and negative radicands
+    if (a_exp == 255 || (a_exp == 0 && a_fraction == 0) || a_sign) {
+        r = (a_exp == 0 && a_fraction == 0) ? 0 : (a_exp == 255 && a_fraction == 0 && !a_sign) ? 0x7F800000 : 0x7FC00000;
+        return r | (a_sign ? 0x80000000 : 0);
+    }
+
+    // Normalize a subnormal radicand, then make the unbiased exponent even
+    int exponent = int(a_exp) - 127;
+    uint32_t m = a_fraction | 0x00800000;
+    if (a_exp == 0) {
+        m = a_fraction;
+        exponent = -126;
+        while ((m & 0x00800000) == 0) {
+            m = m << 1;
+            exponent--;
+        }
+    }
+    if (exponent & 1) {
+        m = m << 1;
+        exponent--;
+    }
+
+    // 25 root bits of m * 2^25 give the 24-bit significand and a round bit
+    uint64_t radicand = static_cast<uint64_t>(m) << 25, x_val = 0, y_val;
+    r = 0;
+    for (int i = 0; i < 25; i++) {
+        x_val = (x_val << 2) | ((radicand >> (48 - 2 * i)) & 3);
+        y_val = (static_cast<uint64_t>(r) << 2) | 1;
+        r = r << 1;
+        if (x_val >= y_val) {
+            x_val = x_val - y_val;
+            r = r | 1;
+        }
+    }
+    return recurrence_round(r, exponent / 2 + 127, x_val != 0);
+}
+
+#endif
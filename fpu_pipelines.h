@@ -0,0 +1,1184 @@
+#ifndef FPU_PIPELINES_H
+#define FPU_PIPELINES_H
+
+// Pin-level pipelines of Addition Final, Subtract Final, Multiplication Final and
+// Division Final, each in its own namespace with the Top that wires and clocks it.
+// The Final files that instantiate a baseline pipeline include this header rather
+// than carrying their own copy; fpu_models.h holds the matching functional models.
+//
+// Every stage that handles denormals takes an optional per-instance flush-to-zero /
+// denormals-are-zero flag, off by default. With ftz set, subnormal operands read as
+// signed zeros, results below the smallest normal leave as signed zeros and the
+// denormal paths of each stage are not used. A Top also takes its clock period,
+// by default that of its Final file.
+
+#include <systemc.h>
+#include <stdint.h>
+
+// Adder pipeline from Addition Final
+namespace addition {
+
+// FloatingPointExtractor Module
+SC_MODULE(FloatingPointExtractor) {
+    sc_in<sc_uint<32>> a;
+    sc_in<sc_uint<32>> b;
+    sc_out<bool> a_sign;
+    sc_out<sc_uint<8>> a_exp;
+    sc_out<sc_uint<32>> a_significand;
+    sc_out<bool> b_sign;
+    sc_out<sc_uint<8>> b_exp;
+    sc_out<sc_uint<32>> b_significand;
+    sc_in<bool> clock;
+    bool ftz;
+
+    void extraction_process() {
+        while (true) {
+            wait();
+            //Extraction
+            bool a_sign0 = (a.read() & 0x80000000) >> 31;
+            unsigned int a_exp0 = (a.read() & 0x7f800000) >> 23;
+            unsigned int a_significand0 = (a.read() & 0x7fffff);
+
+            bool b_sign0 = (b.read() & 0x80000000) >> 31;
+            unsigned int b_exp0 = (b.read() & 0x7f800000) >> 23;
+            unsigned int b_significand0 = (b.read() & 0x7fffff);
+
+            //Denormals are zero: a zero exponent field reads as zero, otherwise the hidden bit is set
+            unsigned int a_significand1 = ftz ? ((a_exp0 == 0) ? 0 : (a_significand0 | (1 << 23)))
+                                              : ((a_exp0 >= 1) ? (a_significand0 | (1 << 23)) : a_significand0);
+            unsigned int b_significand1 = ftz ? ((b_exp0 == 0) ? 0 : (b_significand0 | (1 << 23)))
+                                              : ((b_exp0 >= 1) ? (b_significand0 | (1 << 23)) : b_significand0);
+
+            unsigned int a_significand2 = (a_significand1 << 7);
+            unsigned int b_significand2 = (b_significand1 << 7);
+
+            unsigned int a_exp1 = (ftz || a_exp0 != 0) ? a_exp0 : 1;
+            unsigned int b_exp1 = (ftz || b_exp0 != 0) ? b_exp0 : 1;
+            //Special Cases
+            if (a_exp0 == 255 && a_significand0 != 0) {
+                a_sign.write(true);
+                a_exp.write(0x7F);
+                a_significand.write(0x7fffffff);
+                b_sign.write(true);
+                b_exp.write(0x7F);
+                b_significand.write(0x7fffffff);
+            } else if (b_exp0 == 255 && b_significand0 != 0) {
+                a_sign.write(true);
+                a_exp.write(0x7F);
+                a_significand.write(0x7fffffff);
+                b_sign.write(true);
+                b_exp.write(0x7F);
+                b_significand.write(0x7fffffff);
+            } else if (a_exp0 == 255 && a_significand0 == 0 && b_exp0 == 255 && b_significand0 == 0 && a_sign0 != b_sign0) {
+                a_sign.write(true);
+                a_exp.write(0x7F);
+                a_significand.write(0x7fffffff);
+                b_sign.write(true);
+                b_exp.write(0x7F);
+                b_significand.write(0x7fffffff);
+            } else if (a_exp0 == 255 && a_significand0 == 0) {
+                a_sign.write(a_sign0);
+                a_exp.write(a_exp0);
+                a_significand.write(a_significand0);
+                b_sign.write(true);
+                b_exp.write(0x7F);
+                b_significand.write(0x7fffffff);
+            } else if (b_exp0 == 255 && b_significand0 == 0) {
+                a_sign.write(true);
+                a_exp.write(0x7F);
+                a_significand.write(0x7fffffff);
+                b_sign.write(b_sign0);
+                b_exp.write(b_exp0);
+                b_significand.write(b_significand0);
+            } else {
+    
+                a_sign.write(a_sign0);
+                a_exp.write(static_cast<sc_uint<8>>(a_exp1));
+                a_significand.write(a_significand2);
+                b_sign.write(b_sign0);
+                b_exp.write(static_cast<sc_uint<8>>(b_exp1));
+                b_significand.write(b_significand2);
+            }
+        }
+    }
+    //Constructor
+    SC_HAS_PROCESS(FloatingPointExtractor);
+    FloatingPointExtractor(sc_module_name name, bool ftz = false)
+        : sc_module(name),
+          a("a"),
+          b("b"),
+          a_sign("a_sign"),
+          a_exp("a_exp"),
+          a_significand("a_significand"),
+          b_sign("b_sign"),
+          b_exp("b_exp"),
+          b_significand("b_significand"),
+          clock("clock"),
+          ftz(ftz) {
+        SC_THREAD(extraction_process);
+        sensitive << clock.pos();     //Clock signal
+    }
+};
+
+// FloatingPointAdder Module
+SC_MODULE(FloatingPointAdder) {
+    sc_in<bool> a_sign;
+    sc_in<sc_uint<8>> a_exp;
+    sc_in<sc_uint<32>> a_significand;
+    sc_in<bool> b_sign;
+    sc_in<sc_uint<8>> b_exp;
+    sc_in<sc_uint<32>> b_significand;
+    sc_out<bool> result_sign;
+    sc_out<sc_uint<8>> result_exp;
+    sc_out<sc_uint<32>> result_significand;
+    sc_in<bool> clock;
+
+    void addition_process() {
+        while (true) {
+            wait();
+
+            unsigned int ans_exp;
+            unsigned int ans_significand;
+            bool ans_sign;
+            unsigned int a_significand3 = a_significand.read();
+            unsigned int b_significand3 = b_significand.read();
+        //Exponent Shifting
+            if (a_exp.read() >= b_exp.read()) {
+                unsigned int shift = a_exp.read() - b_exp.read();
+                b_significand3 = (b_significand.read() >> ((shift > 31) ? 31 : shift));
+                ans_exp = a_exp.read();
+            } else {
+                unsigned int shift = b_exp.read() - a_exp.read();
+                a_significand3 = (a_significand.read() >> ((shift > 31) ? 31 : shift));
+                ans_exp = b_exp.read();
+            }
+         //Significand shifting and adding
+            if (a_sign.read() == b_sign.read()) {
+                ans_significand = a_significand3 + b_significand3;
+                ans_sign = a_sign.read();
+            } else {
+                if (a_significand3 > b_significand3) {
+                    ans_sign = a_sign.read();
+                    ans_significand = a_significand3 - b_significand3;
+                } else if (a_significand3 < b_significand3) {
+                    ans_sign = b_sign.read();
+                    ans_significand = b_significand3 - a_significand3;
+                } else if (a_significand3 == b_significand3) {
+                    ans_sign = false;
+                    ans_significand = a_significand3 - b_significand3;
+                }
+            }
+
+            result_sign.write(ans_sign);
+            result_exp.write(static_cast<sc_uint<8>>(ans_exp));
+            result_significand.write(ans_significand);
+        }
+    }
+
+    SC_CTOR(FloatingPointAdder)
+        : a_sign("a_sign"),
+          a_exp("a_exp"),
+          a_significand("a_significand"),
+          b_sign("b_sign"),
+          b_exp("b_exp"),
+          b_significand("b_significand"),
+          result_sign("result_sign"),
+          result_exp("result_exp"),
+          result_significand("result_significand"),
+          clock("clock") {
+        SC_THREAD(addition_process);
+        sensitive << clock.pos();
+    }
+};
+
+SC_MODULE(FloatingPointNormaliser) {
+    sc_in<bool> result_sign;
+    sc_in<sc_uint<8>> result_exp;
+    sc_in<sc_uint<32>> result_significand;
+    sc_out<sc_uint<32>> nresult;
+    sc_in<bool> clock;
+    bool ftz;
+    void normal_process() {
+    
+    
+
+        while (true) {
+            wait();
+
+            unsigned int ans_exp = result_exp.read();
+            unsigned int ans_significand = result_significand.read();
+            bool ans_sign = result_sign.read();
+    /* Normalization */
+    int i;
+    for (i=31; i>0 && ((ans_significand>>i) == 0); i-- ){;}
+
+    //Flush to zero: a result below the smallest normal keeps only its sign
+    if (ftz && ans_exp < 255 && (i == 0 || (int(ans_exp) + (i-23) - 7) <= 0)) {
+        nresult.write(ans_sign << 31);
+        continue;
+    }
+    
+    if (i>23){
+
+        //Rounding
+        unsigned int twentyfourth = ((ans_significand&(1<<(i-23-1)))>>(i-23-1));
+
+        unsigned int twentyfifth = 0;
+        for(int j=0;j<i-23-1;j++){
+            twentyfifth = twentyfifth | ((ans_significand & (1<<j))>>j);
+        }
+
+        if ((int(ans_exp) + (i-23) - 7) > 0 && (int(ans_exp) + (i-23) - 7) < 255){
+
+            ans_significand = (ans_significand>>(i-23));
+
+            ans_exp = ans_exp + (i-23) - 7;
+
+            if (twentyfourth==1 && twentyfifth == 1){
+        
+                ans_significand += 1;
+
+            }
+            else if ((ans_significand&1)==1 && twentyfourth ==1 && twentyfifth == 0){
+   
+                ans_significand += 1;
+
+            }
+
+            if ((ans_significand>>24)==1){
+                ans_significand = (ans_significand>>1);
+                ans_exp += 1;
+
+            }
+        }
+
+        //Overflow
+        else if (int(ans_exp) + (i-23) - 7 >= 255){
+            ans_significand = (1<<23);
+            ans_exp = 255;
+        }
+}
+    // Cancellation: 23 or fewer significant bits are left, all of them exact;
+    // shift them up to the hidden-bit position
+    else if (i > 0) {
+        int shifted_exp = int(ans_exp) + (i - 23) - 7;
+        ans_significand = ans_significand << (23 - i);
+        if (shifted_exp > 0) {
+            ans_exp = shifted_exp;
+        } else {
+            ans_significand = (1 - shifted_exp > 24) ? 0 : (ans_significand >> (1 - shifted_exp));
+            ans_exp = 0;
+        }
+    }
+
+
+    //When answer is zero
+     if (i==0 && ans_exp < 255){
+        ans_exp = 0;
+    }
+    
+    /* Constructing floating point number from sign, exponent and significand */
+
+    unsigned int ans = (ans_sign<<31) | (ans_exp<<23) | (ans_significand& (0x7FFFFF));
+    nresult.write(ans);
+    }
+}
+
+
+    SC_HAS_PROCESS(FloatingPointNormaliser);
+    FloatingPointNormaliser(sc_module_name name, bool ftz = false) : sc_module(name), ftz(ftz) {
+        SC_THREAD(normal_process);
+        sensitive << clock.pos();
+    }
+};
+
+// Top-level Module
+SC_MODULE(Top) {
+    FloatingPointExtractor extractor;
+    FloatingPointAdder adder;
+    FloatingPointNormaliser normalization;
+    sc_signal<bool> a_sign;
+    sc_signal<sc_uint<8>> a_exp;
+    sc_signal<sc_uint<32>> a_significands;
+    sc_signal<bool> b_sign;
+    sc_signal<sc_uint<8>> b_exp;
+    sc_signal<sc_uint<32>> b_significands;
+    sc_signal<bool> result_sign;
+    sc_signal<sc_uint<8>> result_exp;
+    sc_signal<sc_uint<32>> result_significand;
+    sc_signal<sc_uint<32>> a;
+    sc_signal<sc_uint<32>> b;
+    sc_signal<sc_uint<32>> normalized_result;
+    sc_clock clock;
+
+    SC_HAS_PROCESS(Top);
+    Top(sc_module_name name, bool ftz = false, sc_time period = sc_time(1, SC_NS))
+        : sc_module(name),
+          extractor("Extractor", ftz),
+          adder("Adder"),
+          normalization("Normalization", ftz),
+          clock("clock", period) {
+        extractor.a(a);
+        extractor.b(b);
+        extractor.a_sign(a_sign);
+        extractor.a_exp(a_exp);
+        extractor.a_significand(a_significands);
+        extractor.b_sign(b_sign);
+        extractor.b_exp(b_exp);
+        extractor.b_significand(b_significands);
+        extractor.clock(clock);
+
+        adder.a_sign(a_sign);
+        adder.a_exp(a_exp);
+        adder.a_significand(a_significands);
+        adder.b_sign(b_sign);
+        adder.b_exp(b_exp);
+        adder.b_significand(b_significands);
+        adder.result_sign(result_sign);
+        adder.result_exp(result_exp);
+        adder.result_significand(result_significand);
+        adder.clock(clock);
+
+        normalization.result_sign(result_sign);
+        normalization.result_exp(result_exp);
+        normalization.result_significand(result_significand);
+        normalization.nresult(normalized_result);
+        normalization.clock(clock);
+    }
+};
+}
+
+// Subtractor pipeline from Subtract Final
+namespace subtraction {
+
+// FloatingPointExtractor Module
+SC_MODULE(FloatingPointExtractor) {
+    sc_in<sc_uint<32>> a;
+    sc_in<sc_uint<32>> b;
+    sc_out<bool> a_sign;
+    sc_out<sc_uint<8>> a_exp;
+    sc_out<sc_uint<32>> a_significand;
+    sc_out<bool> b_sign;
+    sc_out<sc_uint<8>> b_exp;
+    sc_out<sc_uint<32>> b_significand;
+    sc_in<bool> clock;
+    bool ftz;
+
+    void extraction_process() {
+        while (true) {
+            wait();
+         //Extraction
+            bool a_sign0 = (a.read() & 0x80000000) >> 31;
+            unsigned int a_exp0 = (a.read() & 0x7F800000) >> 23;
+            unsigned int a_significand0 = (a.read() & 0x7FFFFF);
+
+            bool b_sign0 = (b.read() & 0x80000000) >> 31;
+            unsigned int b_exp0 = (b.read() & 0x7F800000) >> 23;
+            unsigned int b_significand0 = (b.read() & 0x7FFFFF);
+
+            //Denormals are zero: a zero exponent field reads as zero, otherwise the hidden bit is set
+            unsigned int a_significand1 = ftz ? ((a_exp0 == 0) ? 0 : (a_significand0 | (1 << 23)))
+                                              : ((a_exp0 >= 1) ? (a_significand0 | (1 << 23)) : a_significand0);
+            unsigned int b_significand1 = ftz ? ((b_exp0 == 0) ? 0 : (b_significand0 | (1 << 23)))
+                                              : ((b_exp0 >= 1) ? (b_significand0 | (1 << 23)) : b_significand0);
+
+            unsigned int a_significand2 = (a_significand1 << 7);
+            unsigned int b_significand2 = (b_significand1 << 7);
+
+            unsigned int a_exp1 = (ftz || a_exp0 != 0) ? a_exp0 : 1;
+            unsigned int b_exp1 = (ftz || b_exp0 != 0) ? b_exp0 : 1;
+  //Special Cases
+            if (a_exp0 == 255 && a_significand0 != 0) {
+                a_sign.write(true);
+                a_exp.write(0x7F);
+                a_significand.write(0x7fffffff);
+                b_sign.write(true);
+                b_exp.write(0x7F);
+                b_significand.write(0x7fffffff);
+            } else if (b_exp0 == 255 && b_significand0 != 0) {
+                a_sign.write(true);
+                a_exp.write(0x7F);
+                a_significand.write(0x7fffffff);
+                b_sign.write(true);
+                b_exp.write(0x7F);
+                b_significand.write(0x7fffffff);
+            } else if (a_exp0 == 255 && a_significand0 == 0 && b_exp0 == 255 && b_significand0 == 0 && a_sign0 != b_sign0) {
+                a_sign.write(true);
+                a_exp.write(0x7F);
+                a_significand.write(0x7fffffff);
+                b_sign.write(true);
+                b_exp.write(0x7F);
+                b_significand.write(0x7fffffff);
+            } else if (a_exp0 == 255 && a_significand0 == 0) {
+                a_sign.write(a_sign0);
+                a_exp.write(0x7F);
+                a_significand.write(0x7fffffff);
+                b_sign.write(true);
+                b_exp.write(0x7F);
+                b_significand.write(0x7fffffff);
+            } else if (b_exp0 == 255 && b_significand0 == 0) {
+                a_sign.write(true);
+                a_exp.write(0x7F);
+                a_significand.write(0x7fffffff);
+                b_sign.write(b_sign0);
+                b_exp.write(0x7F);
+                b_significand.write(0x7fffffff);
+            } else {
+                a_sign.write(a_sign0);
+                a_exp.write(a_exp1);
+                a_significand.write(a_significand2);
+                b_sign.write(b_sign0);
+                b_exp.write(b_exp1);
+                b_significand.write(b_significand2);
+            }
+        }
+    }
+ //Constructor
+    SC_HAS_PROCESS(FloatingPointExtractor);
+    FloatingPointExtractor(sc_module_name name, bool ftz = false)
+        : sc_module(name), a("a"), b("b"), a_sign("a_sign"), a_exp("a_exp"), a_significand("a_significand"),
+          b_sign("b_sign"), b_exp("b_exp"), b_significand("b_significand"), clock("clock"), ftz(ftz) {
+        SC_THREAD(extraction_process);
+        sensitive << clock.pos();  //clock signal
+    }
+};
+
+// FloatingPointSubtractor Module
+SC_MODULE(FloatingPointSubtractor) {
+    sc_in<bool> a_sign;
+    sc_in<sc_uint<8>> a_exp;
+    sc_in<sc_uint<32>> a_significand;
+    sc_in<bool> b_sign;
+    sc_in<sc_uint<8>> b_exp;
+    sc_in<sc_uint<32>> b_significand;
+    sc_out<bool> result_sign;
+    sc_out<sc_uint<8>> result_exp;
+    sc_out<sc_uint<32>> result_significand;
+    sc_in<bool> clock;
+
+    void subtraction_process() {
+        while (true) {
+            wait();
+
+            unsigned int ans_exp;
+            unsigned int ans_significand;
+            bool ans_sign;
+            unsigned int a_significand3 = a_significand.read();
+            unsigned int b_significand3 = b_significand.read();
+  //Exponent shifting
+            if (a_exp.read() >= b_exp.read()) {
+                unsigned int shift = a_exp.read() - b_exp.read();
+                b_significand3 = (b_significand.read() >> ((shift > 31) ? 31 : shift));
+                ans_exp = a_exp.read();
+            } else {
+                unsigned int shift = b_exp.read() - a_exp.read();
+                a_significand3 = (a_significand.read() >> ((shift > 31) ? 31 : shift));
+                ans_exp = b_exp.read();
+            }
+//Significand shifting and adding and sign change of second input
+            if (a_sign.read() != b_sign.read()) {
+                ans_significand = a_significand3 + b_significand3;
+                ans_sign = a_sign.read();
+            } else {
+                if (a_significand3 >= b_significand3) {
+                    ans_sign = a_sign.read();
+                    ans_significand = a_significand3 - b_significand3;
+                } else {
+                    ans_sign = !a_sign.read();
+                    ans_significand = b_significand3 - a_significand3;
+                }
+            }
+
+            result_sign.write(ans_sign);
+            result_exp.write(ans_exp);
+            result_significand.write(ans_significand);
+        }
+    }
+
+    SC_CTOR(FloatingPointSubtractor) : a_sign("a_sign"), a_exp("a_exp"), a_significand("a_significand"),
+                                       b_sign("b_sign"), b_exp("b_exp"), b_significand("b_significand"),
+                                       result_sign("result_sign"), result_exp("result_exp"),
+                                       result_significand("result_significand"), clock("clock") {
+        SC_THREAD(subtraction_process);
+        sensitive << clock.pos();
+    }
+};
+
+// FloatingPointNormaliser Module
+SC_MODULE(FloatingPointNormaliser) {
+    sc_in<bool> result_sign;
+    sc_in<sc_uint<8>> result_exp;
+    sc_in<sc_uint<32>> result_significand;
+    sc_out<sc_uint<32>> nresult;
+    sc_in<bool> clock;
+    bool ftz;
+    void normal_process() {
+        while (true) {
+            wait();
+
+            unsigned int ans_exp = result_exp.read();
+            unsigned int ans_significand = result_significand.read();
+            bool ans_sign = result_sign.read();
+    /* Normalization */
+    int i;
+    for (i=31; i>0 && ((ans_significand>>i) == 0); i-- ){;}
+
+    //Flush to zero: a result below the smallest normal keeps only its sign
+    if (ftz && ans_exp < 255 && (i == 0 || (int(ans_exp) + (i-23) - 7) <= 0)) {
+        nresult.write(ans_sign << 31);
+        continue;
+    }
+    
+    if (i>23){
+
+        //Rounding
+        unsigned int twentyfourth = ((ans_significand&(1<<(i-23-1)))>>(i-23-1));
+
+        unsigned int twentyfifth = 0;
+        for(int j=0;j<i-23-1;j++){
+            twentyfifth = twentyfifth | ((ans_significand & (1<<j))>>j);
+        }
+
+        if ((int(ans_exp) + (i-23) - 7) > 0 && (int(ans_exp) + (i-23) - 7) < 255){
+
+            ans_significand = (ans_significand>>(i-23));
+
+            ans_exp = ans_exp + (i-23) - 7;
+
+            if (twentyfourth==1 && twentyfifth == 1){
+        
+                ans_significand += 1;
+
+            }
+            else if ((ans_significand&1)==1 && twentyfourth ==1 && twentyfifth == 0){
+   
+                ans_significand += 1;
+
+            }
+
+            if ((ans_significand>>24)==1){
+                ans_significand = (ans_significand>>1);
+                ans_exp += 1;
+
+            }
+        }
+
+        //Overflow
+        else if (int(ans_exp) + (i-23) - 7 >= 255){
+            ans_significand = (1<<23);
+            ans_exp = 255;
+        }
+}
+    // Cancellation: 23 or fewer significant bits are left, all of them exact;
+    // shift them up to the hidden-bit position
+    else if (i > 0) {
+        int shifted_exp = int(ans_exp) + (i - 23) - 7;
+        ans_significand = ans_significand << (23 - i);
+        if (shifted_exp > 0) {
+            ans_exp = shifted_exp;
+        } else {
+            ans_significand = (1 - shifted_exp > 24) ? 0 : (ans_significand >> (1 - shifted_exp));
+            ans_exp = 0;
+        }
+    }
+
+
+    //When answer is zero
+     if (i==0 && ans_exp < 255){
+        ans_exp = 0;
+    }
+    
+    /* Constructing floating point number from sign, exponent and significand */
+
+    unsigned int ans = (ans_sign<<31) | (ans_exp<<23) | (ans_significand& (0x7FFFFF));
+    nresult.write(ans);
+    }
+}
+
+
+    SC_HAS_PROCESS(FloatingPointNormaliser);
+    FloatingPointNormaliser(sc_module_name name, bool ftz = false) : sc_module(name), ftz(ftz) {
+        SC_THREAD(normal_process);
+        sensitive << clock.pos();
+    }
+};
+
+
+SC_MODULE(Top) {
+    FloatingPointExtractor extractor;
+    FloatingPointSubtractor subtractor;
+    FloatingPointNormaliser normalization;
+    sc_signal<bool> a_sign;
+    sc_signal<sc_uint<8>> a_exp;
+    sc_signal<sc_uint<32>> a_significands;
+    sc_signal<bool> b_sign;
+    sc_signal<sc_uint<8>> b_exp;
+    sc_signal<sc_uint<32>> b_significands;
+    sc_signal<bool> result_sign;
+    sc_signal<sc_uint<8>> result_exp;
+    sc_signal<sc_uint<32>> result_significand;
+    sc_signal<sc_uint<32>> a;
+    sc_signal<sc_uint<32>> b;
+    sc_signal<sc_uint<32>> normalized_result;
+    sc_clock clock;
+
+    SC_HAS_PROCESS(Top);
+    Top(sc_module_name name, bool ftz = false, sc_time period = sc_time(1, SC_NS))
+        : sc_module(name), extractor("Extractor", ftz), subtractor("Subtractor"), normalization("Normalization", ftz), clock("clock", period) {
+        extractor.a(a);
+        extractor.b(b);
+        extractor.a_sign(a_sign);
+        extractor.a_exp(a_exp);
+        extractor.a_significand(a_significands);
+        extractor.b_sign(b_sign);
+        extractor.b_exp(b_exp);
+        extractor.b_significand(b_significands);
+        extractor.clock(clock);
+
+        subtractor.a_sign(a_sign);
+        subtractor.a_exp(a_exp);
+        subtractor.a_significand(a_significands);
+        subtractor.b_sign(b_sign);
+        subtractor.b_exp(b_exp);
+        subtractor.b_significand(b_significands);
+        subtractor.result_sign(result_sign);
+        subtractor.result_exp(result_exp);
+        subtractor.result_significand(result_significand);
+        subtractor.clock(clock);
+
+        normalization.result_sign(result_sign);
+        normalization.result_exp(result_exp);
+        normalization.result_significand(result_significand);
+        normalization.nresult(normalized_result);
+        normalization.clock(clock);
+    }
+};
+}
+
+// Multiplier pipeline from Multiplication Final
+namespace multiplication {
+
+// FloatingPointExtractor Module
+SC_MODULE(FloatingPointExtractor) {
+    sc_in<sc_uint<32>> a;
+    sc_in<sc_uint<32>> b;
+    sc_out<bool> a_sign;
+    sc_out<sc_uint<8>> a_exp;
+    sc_out<sc_uint<32>> a_significand;
+    sc_out<bool> b_sign;
+    sc_out<sc_uint<8>> b_exp;
+    sc_out<sc_uint<32>> b_significand;
+    sc_in<bool> clock;
+    bool ftz;
+
+    void extraction_process() {
+        while (true) {
+            wait();
+     //Extraction
+            bool a_sign0 = (a.read() & 0x80000000) >> 31;
+            unsigned int a_exp0 = (a.read() & 0x7f800000) >> 23;
+            unsigned int a_significand0 = (a.read() & 0x7fffff);
+
+            bool b_sign0 = (b.read() & 0x80000000) >> 31;
+            unsigned int b_exp0 = (b.read() & 0x7f800000) >> 23;
+            unsigned int b_significand0 = (b.read() & 0x7fffff);
+
+            // Special cases
+            if (a_exp0 == 255 && a_significand0 != 0) {
+                // Case when a is NaN
+                a_sign.write(true);
+                a_exp.write(255);
+                a_significand.write(0x7fffffff);
+                b_sign.write(true);
+                b_exp.write(255);
+                b_significand.write(0x7fffffff);
+            } else if (b_exp0 == 255 && b_significand0 != 0) {
+                // Case when b is NaN
+                a_sign.write(true);
+                a_exp.write(255);
+                a_significand.write(0x7fffffff);
+                b_sign.write(true);
+                b_exp.write(255);
+                b_significand.write(0x7fffffff);
+            } else if (a_exp0 == 255 && a_significand0 == 0 && b_exp0 == 255 && b_significand0 == 0 && a_sign0 != b_sign0) {
+                // Case when Infinity - Infinity
+                a_sign.write(true);
+                a_exp.write(255);
+                a_significand.write(0x7fffffff);
+                b_sign.write(true);
+                b_exp.write(255);
+                b_significand.write(0x7fffffff);
+            } else if (a_exp0 == 255 && a_significand0 == 0) {
+                // Case when a is Infinity
+                a_sign.write(a_sign0);
+                a_exp.write(255);
+                a_significand.write(0x7fffffff);
+                b_sign.write(true);
+                b_exp.write(255);
+                b_significand.write(0x7fffffff);
+            } else if (b_exp0 == 255 && b_significand0 == 0) {
+                // Case when b is Infinity
+                a_sign.write(true);
+                a_exp.write(255);
+                a_significand.write(0x7fffffff);
+                b_sign.write(b_sign0);
+                b_exp.write(255);
+                b_significand.write(0x7fffffff);
+            } else {
+                // Normal case; with denormals are zero the hidden bit is set here and
+                // a zero exponent field reads as a zero significand
+                a_sign.write(a_sign0);
+                a_exp.write(a_exp0);
+                a_significand.write(!ftz ? a_significand0 : (a_exp0 == 0) ? 0 : (a_significand0 | 0x00800000));
+                b_sign.write(b_sign0);
+                b_exp.write(b_exp0);
+                b_significand.write(!ftz ? b_significand0 : (b_exp0 == 0) ? 0 : (b_significand0 | 0x00800000));
+            }
+        }
+    }
+
+    SC_HAS_PROCESS(FloatingPointExtractor);
+    FloatingPointExtractor(sc_module_name name, bool ftz = false)
+        : sc_module(name), a("a"), b("b"), a_sign("a_sign"), a_exp("a_exp"), a_significand("a_significand"),
+          b_sign("b_sign"), b_exp("b_exp"), b_significand("b_significand"), clock("clock"), ftz(ftz) {
+        SC_THREAD(extraction_process);
+        sensitive << clock.pos();
+    }
+};
+
+// FloatingPointMultiplier Module
+SC_MODULE(FloatingPointMultiplier) {
+    sc_in<bool> a_sign;
+    sc_in<sc_uint<8>> a_exp;
+    sc_in<sc_uint<32>> a_significand;
+    sc_in<bool> b_sign;
+    sc_in<sc_uint<8>> b_exp;
+    sc_in<sc_uint<32>> b_significand;
+    sc_out<bool> result_sign;
+    sc_out<sc_uint<8>> result_exp;
+    sc_out<sc_uint<32>> result_significand;
+    sc_out<sc_uint<32>> result_significand1;
+    sc_in<bool> clock;
+    bool ftz;
+
+    void multiply_process() {
+        while (true) {
+            wait();
+            bool aSign = a_sign.read();
+            unsigned int aExponent = a_exp.read();
+            unsigned int aSignificand = a_significand.read();
+
+            bool bSign = b_sign.read();
+            unsigned int bExponent = b_exp.read();
+            unsigned int bSignificand = b_significand.read();
+
+            // compute sign bit
+            bool resultSign = aSign ^ bSign;
+
+            // compute exponent
+            unsigned int resultExponent = aExponent + bExponent - 0x7F;
+
+            // add implicit `1' bit (already in place when flushing to zero)
+            aSignificand = (ftz ? aSignificand : (aSignificand | 0x00800000)) << 7;
+            bSignificand = (ftz ? bSignificand : (bSignificand | 0x00800000)) << 8;
+
+            uint64_t resultSignificand = static_cast<uint64_t>(aSignificand) * static_cast<uint64_t>(bSignificand);
+
+            // flush to zero: the final exponent is one higher for products in [2, 4);
+            // a zero operand already gives a zero product
+            if (ftz && int(aExponent) + int(bExponent) - 0x7F + int(resultSignificand >> 62) <= 0) {
+                resultSignificand = 0;
+            }
+
+            uint32_t resultSignificand0 = static_cast<uint32_t>(resultSignificand >> 32);
+            uint32_t resultSignificand1 = static_cast<uint32_t>(resultSignificand & 0xFFFFFFFF);
+
+            result_sign.write(resultSign);
+            result_exp.write(resultExponent);
+            result_significand.write(resultSignificand0);
+            result_significand1.write(resultSignificand1);
+        }
+    }
+
+    SC_HAS_PROCESS(FloatingPointMultiplier);
+    FloatingPointMultiplier(sc_module_name name, bool ftz = false)
+        : sc_module(name), a_sign("a_sign"), a_exp("a_exp"), a_significand("a_significand"),
+          b_sign("b_sign"), b_exp("b_exp"), b_significand("b_significand"),
+          result_sign("result_sign"), result_exp("result_exp"),
+          result_significand("result_significand"), clock("clock"), ftz(ftz) {
+        SC_THREAD(multiply_process);
+        sensitive << clock.pos();
+    }
+};
+
+// FloatingPointNormalizer Module
+SC_MODULE(FloatingPointNormalizer) {
+    sc_in<bool> result_sign;
+    sc_in<sc_uint<8>> result_exp;
+    sc_in<sc_uint<32>> result_significand;
+    sc_in<sc_uint<32>> result_significand1;
+    sc_out<sc_uint<32>> normalized_result;
+    sc_in<bool> clock;
+    bool ftz;
+    
+void normalize_process() { int check=0,check1=0;
+    while (true) {
+        wait();
+
+        bool resultSign = result_sign.read();
+        unsigned int resultExponent = result_exp.read();
+        unsigned int resultSignificand0 = result_significand.read();
+        unsigned int resultSignificand1 = result_significand1.read();
+        // a flushed product leaves as a signed zero
+        if (ftz && resultSignificand0 == 0 && resultSignificand1 == 0) {
+            normalized_result.write(resultSign << 31);
+            continue;
+        }
+        // check if we overflowed into more than 23-bits and handle accordingly
+        resultSignificand0 |= (resultSignificand1 != 0);
+        if (0 <= static_cast<int32_t>(resultSignificand0 << 1)) {
+            resultSignificand0 <<= 1;
+            resultExponent--;
+        }
+
+        
+        
+        int bit_value;
+           int arr[23];
+        int j=22,k=0;
+    for (int i = 29; i >= 7; --i) {
+   int bit_value = (resultSignificand0 >> i) & 1;
+ k++;
+   arr[j]=bit_value;
+   j--;
+       }
+       
+unsigned int temp1;
+        for (int i = 22; i >=0; --i) {
+        temp1 = (temp1 << 1) | arr[i];
+    }
+    
+
+
+bool bit24,bit25;
+
+  
+  
+    
+if(bit24 ==1 & bit25==1 || bit24==1 && bit25==0)
+  temp1+=1;
+
+
+
+int arr1[23];
+for(int k=22;k>=0;--k)
+{
+   arr1[k]=(temp1>>k)&1;
+  }
+
+
+int f=22;
+for (int l = 29; l >= 7; l--)
+{
+   // Check if f is within bounds
+  if (f >= 0)
+  {
+      // Shift and copy arr1[f] to the l-th position
+       resultSignificand0 |= (arr1[f]) << l;
+
+      // Update f
+      f--;
+  }
+}
+        
+ uint32_t result_value = (resultSign << 31) | ((resultExponent << 23) + (resultSignificand0>>7));
+check++;
+        normalized_result.write(result_value);
+    }
+}
+
+    
+    SC_HAS_PROCESS(FloatingPointNormalizer);
+    FloatingPointNormalizer(sc_module_name name, bool ftz = false) : sc_module(name), result_sign("result_sign"), result_exp("result_exp"),
+    result_significand("result_significand"), normalized_result("normalized_result"),
+    clock("clock"), ftz(ftz) {
+        SC_THREAD(normalize_process);
+        sensitive << clock.pos();
+    }
+};
+
+SC_MODULE(Top) {
+    FloatingPointExtractor extractor;
+    FloatingPointMultiplier multiplier;
+    FloatingPointNormalizer normalizer;
+    sc_signal<bool> a_sign;
+    sc_signal<sc_uint<8>> a_exp;
+    sc_signal<sc_uint<32>> a_significand;
+    sc_signal<bool> b_sign;
+    sc_signal<sc_uint<8>> b_exp;
+    sc_signal<sc_uint<32>> b_significand;
+    sc_signal<bool> result_sign;
+    sc_signal<sc_uint<8>> result_exp;
+    sc_signal<sc_uint<32>> result_significand;
+    sc_signal<sc_uint<32>> result_significand0;
+    sc_signal<sc_uint<32>> a;
+    sc_signal<sc_uint<32>> b;
+    sc_signal<sc_uint<32>> normalized_result;
+    sc_clock clock;
+
+    SC_HAS_PROCESS(Top);
+    Top(sc_module_name name, bool ftz = false, sc_time period = sc_time(1, SC_NS))
+        : sc_module(name), extractor("Extractor", ftz), multiplier("Multiplier", ftz), normalizer("Normalizer", ftz), clock("clock", period) {
+        extractor.a(a);
+        extractor.b(b);
+        extractor.a_sign(a_sign);
+        extractor.a_exp(a_exp);
+        extractor.a_significand(a_significand);
+        extractor.b_sign(b_sign);
+        extractor.b_exp(b_exp);
+        extractor.b_significand(b_significand);
+        extractor.clock(clock);
+
+        multiplier.a_sign(a_sign);
+        multiplier.a_exp(a_exp);
+        multiplier.a_significand(a_significand);
+        multiplier.b_sign(b_sign);
+        multiplier.b_exp(b_exp);
+        multiplier.b_significand(b_significand);
+        multiplier.result_sign(result_sign);
+        multiplier.result_exp(result_exp);
+        multiplier.result_significand(result_significand);
+        multiplier.result_significand1(result_significand0);
+        multiplier.clock(clock);
+
+        normalizer.result_sign(result_sign);
+        normalizer.result_exp(result_exp);
+        normalizer.result_significand(result_significand);
+        normalizer.result_significand1(result_significand0);
+        normalizer.normalized_result(normalized_result);
+        normalizer.clock(clock);
+    }
+};
+}
+
+// Divider stages from Division Final, wrapped in a Top with its 10 ns clock
+namespace division {
+
+SC_MODULE(ExtractModule) {
+    sc_in<sc_uint<32>> a;
+    sc_in<sc_uint<32>> b;
+    sc_out<sc_uint<32>> a_significand;
+    sc_out<sc_uint<32>> b_significand;
+    sc_out<bool> a_sign;
+    sc_out<bool> b_sign;
+    sc_out<sc_uint<8>> a_exp; // Change to 8 bits for exponent
+    sc_out<sc_uint<8>> b_exp; // Change to 8 bits for exponent
+    sc_in_clk clock; // Clock input
+    bool ftz;
+
+    void extract() {
+        while (true) {
+            wait(); // Wait for the rising edge of the clock
+
+            uint32_t a_val = a.read();
+            uint32_t b_val = b.read();
+
+            // Extract biased exponents and sign bits
+            a_exp.write((a_val & 0x7F800000) >> 23);
+            b_exp.write((b_val & 0x7F800000) >> 23);
+            a_sign.write((a_val & 0x80000000) != 0);
+            b_sign.write((b_val & 0x80000000) != 0);
+
+            // Extract significands; with denormals are zero a zero exponent field
+            // reads as a zero significand
+            bool a_zero = ftz && (a_val & 0x7F800000) == 0;
+            bool b_zero = ftz && (b_val & 0x7F800000) == 0;
+            a_significand.write(a_zero ? 0 : ((a_val & 0x007FFFFF) | 0x00800000));
+            b_significand.write(b_zero ? 0 : ((b_val & 0x007FFFFF) | 0x00800000));
+        }
+    }
+
+    SC_HAS_PROCESS(ExtractModule);
+    ExtractModule(sc_module_name name, bool ftz = false) : sc_module(name), ftz(ftz) {
+        SC_THREAD(extract);
+        sensitive << clock.pos();
+    }
+};
+
+SC_MODULE(ComputeModule) {
+    sc_in<sc_uint<32>> a_significand;
+    sc_in<sc_uint<32>> b_significand;
+    sc_in<bool> a_sign;
+    sc_in<bool> b_sign;
+    sc_in<sc_uint<8>> a_exp; // Change to 8 bits for exponent
+    sc_in<sc_uint<8>> b_exp; // Change to 8 bits for exponent
+    sc_out<sc_uint<32>> result;
+    sc_in_clk clock; // Clock input
+    bool ftz;
+
+    void compute() {
+        while (true) {
+            wait(); // Wait for the rising edge of the clock
+
+            uint32_t r, result_exp;
+            uint8_t i, odd, rnd, sticky;
+
+            // Compute exponent of result
+            result_exp = a_exp.read() - b_exp.read() + 127;
+
+            // Dividend may not be smaller than divisor: normalize
+            sc_uint<32> x_val = a_significand.read();
+            sc_uint<32> y_val = b_significand.read();
+
+            if (x_val < y_val) {
+                x_val = x_val << 1;
+                result_exp--;
+            }
+
+            // Generate quotient one bit at a time
+            r = 0;
+            for (i = 0; i < 25; i++) {
+                r = r << 1;
+                if (x_val >= y_val) {
+                    x_val = x_val - y_val;
+                    r = r | 1;
+                }
+                x_val = x_val << 1;
+            }
+
+            sticky = (x_val != 0);
+            if (ftz && (a_significand.read() == 0 || b_significand.read() == 0)) { // zero operand
+                r = (b_significand.read() != 0) ? 0 : (a_significand.read() != 0) ? 0x7F800000 : 0x7FC00000;
+            } else if ((result_exp >= 1) && (result_exp <= 254)) { // normal, may overflow to infinity
+                // Extract round and lsb bits: the 25 quotient bits are the 24-bit
+                // significand followed by the round bit
+                rnd = r & 1;
+                odd = (r & 0x2) != 0;
+
+                // Remove round bit from quotient and round to-nearest-even
+                r = (r >> 1) + (rnd & (sticky | odd));
+
+                // Combine exponent and significand
+                r = (result_exp << 23) + (r - 0x00800000);
+            } else if (ftz && static_cast<int32_t>(result_exp) <= 0) { // flush to zero: no denormalisation
+                r = 0;
+            } else if (result_exp > 254) { // overflow: infinity
+                r = 0x7F800000;
+            } else { // underflow: result is zero, subnormal, or smallest normal
+                uint8_t shift = (uint8_t)(1 - result_exp);
+
+                // Clamp shift count
+                if (shift > 25) shift = 25;
+
+                // OR shifted-off bits of significand into sticky bit
+                sticky = sticky | ((r & ((1u << shift) - 1)) != 0);
+
+                // Denormalize significand
+                r = r >> shift;
+
+                // Extract round and lsb bits
+                rnd = r & 1;
+                odd = (r & 0x2) != 0;
+
+                // Remove round bit from quotient and round to-nearest-even
+                r = (r >> 1) + (rnd & (sticky | odd));
+            }
+
+            // Combine sign bit with combo of exponent and significand
+            r = r | (a_sign.read() ? 0x80000000 : 0);
+            result.write(r);
+        }
+    }
+
+    SC_HAS_PROCESS(ComputeModule);
+    ComputeModule(sc_module_name name, bool ftz = false) : sc_module(name), ftz(ftz) {
+        SC_THREAD(compute);
+        sensitive << clock.pos();
+    }
+};
+
+SC_MODULE(NormalizationModule) {
+    sc_in<sc_uint<32>> result;
+    sc_in<sc_uint<8>> a_exp; // Change to 8 bits for exponent
+    sc_out<bool> normalized;
+    sc_in_clk clock; // Clock input
+
+    void normalize() {
+        while (true) {
+            wait(); // Wait for the rising edge of the clock
+
+            uint32_t result_val = result.read();
+            uint8_t a_exp_val = a_exp.read();
+
+            // Perform normalization check
+            if ((result_val & 0x7F800000) == 0x7F800000) {
+                // Exponent is all 1s, indicating infinity or NaN
+                normalized.write(false);
+            } else if ((result_val & 0x7F800000) == 0) {
+                // Exponent is all 0s, indicating a subnormal or zero
+                normalized.write(false);
+            } else {
+                // Normalized result
+                normalized.write(true);
+            }
+        }
+    }
+
+    SC_CTOR(NormalizationModule) {
+        SC_THREAD(normalize);
+        sensitive << clock.pos();
+    }
+};
+
+// Top-level Module
+SC_MODULE(Top) {
+    ExtractModule extract_module;
+    ComputeModule compute_module;
+    NormalizationModule normalization_module;
+    sc_signal<sc_uint<32>> a;
+    sc_signal<sc_uint<32>> b;
+    sc_signal<sc_uint<32>> a_significand;
+    sc_signal<sc_uint<32>> b_significand;
+    sc_signal<sc_uint<32>> result;
+    sc_signal<bool> a_sign;
+    sc_signal<bool> b_sign;
+    sc_signal<bool> normalized;
+    sc_signal<sc_uint<8>> a_exp;
+    sc_signal<sc_uint<8>> b_exp;
+    sc_clock clock;
+
+    SC_HAS_PROCESS(Top);
+    Top(sc_module_name name, bool ftz = false, sc_time period = sc_time(10, SC_NS))
+        : sc_module(name),
+          extract_module("ExtractModule", ftz),
+          compute_module("ComputeModule", ftz),
+          normalization_module("NormalizationModule"),
+          clock("clock", period) {
+        extract_module.a(a);
+        extract_module.b(b);
+        extract_module.a_significand(a_significand);
+        extract_module.b_significand(b_significand);
+        extract_module.a_sign(a_sign);
+        extract_module.b_sign(b_sign);
+        extract_module.a_exp(a_exp);
+        extract_module.b_exp(b_exp);
+        extract_module.clock(clock);
+
+        compute_module.a_significand(a_significand);
+        compute_module.b_significand(b_significand);
+        compute_module.a_sign(a_sign);
+        compute_module.b_sign(b_sign);
+        compute_module.a_exp(a_exp);
+        compute_module.b_exp(b_exp);
+        compute_module.result(result);
+        compute_module.clock(clock);
+
+        normalization_module.result(result);
+        normalization_module.a_exp(a_exp);
+        normalization_module.normalized(normalized);
+        normalization_module.clock(clock);
+    }
+};
+}
+
+#endif
@@ -0,0 +1,251 @@
+#ifndef TRACED_FLOAT_H
+#define TRACED_FLOAT_H
+
+// Header-only operand trace capture. Replace float with traced_float in a kernel,
+// open a TraceWriter, and every +, -, * and / is logged as its opcode plus the raw
+// 32-bit operands. Trace Replay Final streams the file back through the pipelines.
+//
+// File format: the magic "FPTR" followed by one record per operation. A record is
+// one tag byte, then the changed bytes of each operand:
+//   tag bits 0-1 : opcode (0 add, 1 sub, 2 mul, 3 div)
+//   tag bits 2-4 : significant bytes of a XOR the previous a of this opcode (0-4)
+//   tag bits 5-7 : significant bytes of b XOR the previous b of this opcode (0-4)
+// The low bytes of each XOR follow, least significant first. Operands repeated or
+// close to the previous one (same sign and exponent) take 0-3 bytes instead of 4.
+// Tracing is not thread-safe; one writer is active per process. A failed write is
+// reported on stderr and stops tracing, and close() then returns false, so a full
+// disk never leaves a silently truncated trace.
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+namespace fptrace {
+
+enum Opcode { TRACE_ADD, TRACE_SUB, TRACE_MUL, TRACE_DIV };
+
+inline uint32_t float_bits(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+inline float bits_float(uint32_t bits) {
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+inline int significant_bytes(uint32_t value) {
+    return (value == 0) ? 0 : (value < 0x100) ? 1 : (value < 0x10000) ? 2 : (value < 0x1000000) ? 3 : 4;
+}
+
+// TraceWriter
+class TraceWriter {
+public:
+    TraceWriter() : file(NULL), failed(false), records(0), bytes(0) {}
+    ~TraceWriter() { close(); }
+
+    bool open(const char* path) {
+        close();
+        file = fopen(path, "wb");
+        if (!file) {
+            return false;
+        }
+        failed = false;
+        if (fwrite("FPTR", 1, 4, file) != 4) {
+            fail();
+            return false;
+        }
+        memset(previous, 0, sizeof(previous));
+        records = 0;
+        bytes = 4;
+        active() = this;
+        return true;
+    }
+
+    // Returns false if any write since open failed, including the final flush
+    bool close() {
+        if (file) {
+            if (fclose(file) != 0 && !failed) {
+                perror("traced_float: closing the trace failed");
+                failed = true;
+            }
+            file = NULL;
+        }
+        if (active() == this) {
+            active() = NULL;
+        }
+        return !failed;
+    }
+
+    void record(Opcode op, uint32_t a, uint32_t b) {
+        unsigned char buffer[9];
+        uint32_t a_xor = a ^ previous[op][0];
+        uint32_t b_xor = b ^ previous[op][1];
+        int a_bytes = significant_bytes(a_xor);
+        int b_bytes = significant_bytes(b_xor);
+        int length = 0;
+        buffer[length++] = static_cast<unsigned char>(op | (a_bytes << 2) | (b_bytes << 5));
+        for (int i = 0; i < a_bytes; i++) {
+            buffer[length++] = static_cast<unsigned char>(a_xor >> (8 * i));
+        }
+        for (int i = 0; i < b_bytes; i++) {
+            buffer[length++] = static_cast<unsigned char>(b_xor >> (8 * i));
+        }
+        if (!file) {
+            return;
+        }
+        if (fwrite(buffer, 1, length, file) != static_cast<size_t>(length)) {
+            fail();
+            return;
+        }
+        previous[op][0] = a;
+        previous[op][1] = b;
+        records++;
+        bytes += length;
+    }
+
+    uint64_t record_count() const { return records; }
+    uint64_t byte_count() const { return bytes; }
+
+    // Writer that traced_float operations log to, or NULL when tracing is off
+    static TraceWriter*& active() {
+        static TraceWriter* writer = NULL;
+        return writer;
+    }
+
+private:
+    // Reports the error, drops the partial trace file handle and stops tracing
+    void fail() {
+        perror("traced_float: writing the trace failed");
+        failed = true;
+        fclose(file);
+        file = NULL;
+        if (active() == this) {
+            active() = NULL;
+        }
+    }
+
+    FILE* file;
+    bool failed;
+    uint32_t previous[4][2];
+    uint64_t records;
+    uint64_t bytes;
+};
+
+// TraceReader
+class TraceReader {
+public:
+    TraceReader() : file(NULL) {}
+    ~TraceReader() { close(); }
+
+    bool open(const char* path) {
+        char magic[4];
+        close();
+        file = fopen(path, "rb");
+        if (!file) {
+            return false;
+        }
+        if (fread(magic, 1, 4, file) != 4 || memcmp(magic, "FPTR", 4) != 0) {
+            close();
+            return false;
+        }
+        memset(previous, 0, sizeof(previous));
+        return true;
+    }
+
+    void close() {
+        if (file) {
+            fclose(file);
+            file = NULL;
+        }
+    }
+
+    // Returns false at the end of the trace, on a truncated record or on a tag
+    // with a byte count above 4
+    bool next(Opcode& op, uint32_t& a, uint32_t& b) {
+        if (!file) {
+            return false;
+        }
+        int tag = fgetc(file);
+        if (tag == EOF) {
+            return false;
+        }
+        op = static_cast<Opcode>(tag & 3);
+        int a_bytes = (tag >> 2) & 7;
+        int b_bytes = (tag >> 5) & 7;
+        if (a_bytes > 4 || b_bytes > 4) {
+            return false;
+        }
+        uint32_t a_xor = 0, b_xor = 0;
+        for (int i = 0; i < a_bytes; i++) {
+            int c = fgetc(file);
+            if (c == EOF) {
+                return false;
+            }
+            a_xor |= static_cast<uint32_t>(c) << (8 * i);
+        }
+        for (int i = 0; i < b_bytes; i++) {
+            int c = fgetc(file);
+            if (c == EOF) {
+                return false;
+            }
+            b_xor |= static_cast<uint32_t>(c) << (8 * i);
+        }
+        a = previous[op][0] ^ a_xor;
+        b = previous[op][1] ^ b_xor;
+        previous[op][0] = a;
+        previous[op][1] = b;
+        return true;
+    }
+
+private:
+    FILE* file;
+    uint32_t previous[4][2];
+};
+
+// traced_float
+// Drop-in float whose arithmetic is logged. The conversion back to float is
+// explicit so that mixed expressions such as x * 2.0f stay traced.
+class traced_float {
+public:
+    traced_float() : value(0.0f) {}
+    traced_float(float value) : value(value) {}
+
+    explicit operator float() const { return value; }
+    float get() const { return value; }
+
+    friend traced_float operator+(traced_float a, traced_float b) { return apply(TRACE_ADD, a.value, b.value, a.value + b.value); }
+    friend traced_float operator-(traced_float a, traced_float b) { return apply(TRACE_SUB, a.value, b.value, a.value - b.value); }
+    friend traced_float operator*(traced_float a, traced_float b) { return apply(TRACE_MUL, a.value, b.value, a.value * b.value); }
+    friend traced_float operator/(traced_float a, traced_float b) { return apply(TRACE_DIV, a.value, b.value, a.value / b.value); }
+    traced_float operator-() const { return traced_float(-value); }
+
+    traced_float& operator+=(traced_float b) { return *this = *this + b; }
+    traced_float& operator-=(traced_float b) { return *this = *this - b; }
+    traced_float& operator*=(traced_float b) { return *this = *this * b; }
+    traced_float& operator/=(traced_float b) { return *this = *this / b; }
+
+    friend bool operator<(traced_float a, traced_float b) { return a.value < b.value; }
+    friend bool operator>(traced_float a, traced_float b) { return a.value > b.value; }
+    friend bool operator<=(traced_float a, traced_float b) { return a.value <= b.value; }
+    friend bool operator>=(traced_float a, traced_float b) { return a.value >= b.value; }
+    friend bool operator==(traced_float a, traced_float b) { return a.value == b.value; }
+    friend bool operator!=(traced_float a, traced_float b) { return a.value != b.value; }
+
+private:
+    static traced_float apply(Opcode op, float a, float b, float result) {
+        if (TraceWriter* writer = TraceWriter::active()) {
+            writer->record(op, float_bits(a), float_bits(b));
+        }
+        return traced_float(result);
+    }
+
+    float value;
+};
+
+}
+
+#endif